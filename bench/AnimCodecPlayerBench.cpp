@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkString.h"
+#include "include/utils/SkAnimCodecPlayer.h"
+#include "tools/Resources.h"
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// Plays an animation through once in each of several players, as when the same animated image
+// is shown in several places, or each loop is played by a new player. Players that share frames
+// decode each frame once between them; the others decode every frame themselves.
+class AnimCodecPlayerBench : public Benchmark {
+public:
+    AnimCodecPlayerBench(const char* path, int players, bool shared)
+            : fPath(path), fPlayers(players), fShared(shared) {
+        SkString baseName = SkString(path);
+        baseName.remove(0, strlen("images/"));
+        fName.printf("AnimCodecPlayer_loop_%s_%dplayers_%s", baseName.c_str(), players,
+                     shared ? "shared" : "unshared");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fPath);
+        if (!fData) {
+            return;
+        }
+
+        // Seek to the start of each frame.
+        std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+        uint32_t msec = 0;
+        for (const SkCodec::FrameInfo& info : codec->getFrameInfo()) {
+            fFrameTimes.push_back(msec);
+            msec += info.fDuration;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+        for (int i = 0; i < loops; i++) {
+            for (int p = 0; p < fPlayers; p++) {
+                std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+                auto player = fShared
+                        ? std::make_unique<SkAnimCodecPlayer>(std::move(codec), fData)
+                        : std::make_unique<SkAnimCodecPlayer>(std::move(codec));
+                for (uint32_t msec : fFrameTimes) {
+                    player->seek(msec);
+                    player->getFrame();
+                }
+            }
+        }
+    }
+
+private:
+    const char*           fPath;
+    const int             fPlayers;
+    const bool            fShared;
+    SkString              fName;
+    sk_sp<SkData>         fData;
+    std::vector<uint32_t> fFrameTimes;
+};
+
+DEF_BENCH(return new AnimCodecPlayerBench("images/alphabetAnim.gif", 4, false);)
+DEF_BENCH(return new AnimCodecPlayerBench("images/alphabetAnim.gif", 4, true);)
+DEF_BENCH(return new AnimCodecPlayerBench("images/flightAnim.gif", 4, false);)
+DEF_BENCH(return new AnimCodecPlayerBench("images/flightAnim.gif", 4, true);)
@@ -8,9 +8,14 @@
 #include "bench/Benchmark.h"
 #include "bench/BigPath.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkPath.h"
+#include "include/core/SkSurface.h"
+#include "src/base/SkRandom.h"
 #include "tools/ToolUtils.h"
 
+#include <memory>
+
 enum Align {
     kLeft_Align,
     kMiddle_Align,
@@ -83,3 +88,68 @@ DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
 DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
 DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
 DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+
+// A country border: one filled contour of 200K jagged line segments covering most of the canvas.
+// Fills this big rasterize in bands when the device has an executor for them, so comparing the
+// 1 thread bench (no executor, one pass) with the others shows what splitting them up buys.
+class BigPathFillBench : public Benchmark {
+    SkPath                      fPath;
+    SkString                    fName;
+    int                         fThreads;
+    std::unique_ptr<SkExecutor> fExecutor;
+    sk_sp<SkSurface>            fSurface;
+
+public:
+    BigPathFillBench(int threads) : fThreads(threads) {
+        fName.printf("bigpath_fill_threads_%d", threads);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    SkISize onGetSize() override {
+        return SkISize::Make(1024, 1024);
+    }
+
+    void onDelayedSetup() override {
+        constexpr int kSegments = 200000;
+        SkRandom rand;
+        for (int i = 0; i < kSegments; i++) {
+            SkScalar angle = 2 * SK_ScalarPI * i / kSegments,
+                     r     = 380 + 60 * SkScalarSin(angle * 17) + 40 * SkScalarSin(angle * 131) +
+                             rand.nextRangeF(-6, 6);
+            SkPoint p = {512 + r * SkScalarCos(angle), 512 + r * SkScalarSin(angle)};
+            i ? fPath.lineTo(p) : fPath.moveTo(p);
+        }
+        fPath.close();
+
+        // We draw into our own surface so that we can hand it the executor.
+        fSurface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(1024, 1024));
+        if (fThreads > 1) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+            SkSurfaces::SetPathFillExecutor(fSurface.get(), fExecutor.get());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        this->setupPaint(&paint);
+
+        for (int i = 0; i < loops; i++) {
+            fSurface->getCanvas()->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    using INHERITED = Benchmark;
+};
+
+DEF_BENCH( return new BigPathFillBench(1); )
+DEF_BENCH( return new BigPathFillBench(2); )
+DEF_BENCH( return new BigPathFillBench(4); )
+DEF_BENCH( return new BigPathFillBench(8); )
@@ -0,0 +1,47 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkColorPriv.h"
+#include "include/core/SkString.h"
+#include "src/core/SkBlitRow.h"
+
+class BlitRowBench : public Benchmark {
+public:
+    BlitRowBench(bool color32, int count) : fColor32(color32), fCount(count) {
+        fName.printf("SkOpts::%s_%d", color32 ? "blit_row_color32" : "blit_row_s32a_opaque",
+                     count);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+    void onDraw(int loops, SkCanvas*) override {
+        static const int K = 1023;
+        SkPMColor dst[K], src[K];
+        for (int i = 0; i < fCount; i++) {
+            dst[i] = SkPackARGB32(0xFF, i & 0xFF, (i >> 2) & 0xFF, 0x40);
+            src[i] = SkPackARGB32(0x80, 0x40, i & 0x7F, 0x20);
+        }
+        while (loops --> 0) {
+            if (fColor32) {
+                SkOpts::blit_row_color32(dst, fCount, SkPackARGB32(0x80, 0x40, 0x20, 0x10));
+            } else {
+                SkOpts::blit_row_s32a_opaque(dst, src, fCount, 0xFF);
+            }
+        }
+    }
+private:
+    bool     fColor32;
+    int      fCount;
+    SkString fName;
+};
+
+// 1023 is a non-power-of-two, to trip up SIMD; 7 is shorter than any vector.
+DEF_BENCH(return new BlitRowBench(/*color32=*/true,     7);)
+DEF_BENCH(return new BlitRowBench(/*color32=*/true,  1023);)
+DEF_BENCH(return new BlitRowBench(/*color32=*/false,    7);)
+DEF_BENCH(return new BlitRowBench(/*color32=*/false, 1023);)
@@ -13,6 +13,10 @@
 #include "include/core/SkString.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkBlurMask.h"
+#include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
+
+#include <vector>
 
 #define MINI    0.01f
 #define SMALL   SkIntToScalar(2)
@@ -102,3 +106,49 @@ DEF_BENCH(return new BlurBench(REAL, kOuter_SkBlurStyle);)
 DEF_BENCH(return new BlurBench(REAL, kInner_SkBlurStyle);)
 
 DEF_BENCH(return new BlurBench(0, kNormal_SkBlurStyle);)
+
+// Blurs one A8 mask directly with SkMaskBlurFilter, so the numbers track the blur itself and not
+// the drawing or caching around it. Sigmas of 2 and up all take the box filter path.
+class MaskBlurFilterBench : public Benchmark {
+public:
+    MaskBlurFilterBench(double sigma) : fSigma(sigma) {
+        fName.printf("blur_mask_filter_sigma_%d", (int)sigma);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        fPixels.resize(kSize * kSize);
+        for (uint8_t& a : fPixels) {
+            a = rand.nextBool() ? 0xFF : 0x00;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const SkMask src(fPixels.data(), SkIRect::MakeWH(kSize, kSize), kSize,
+                         SkMask::kA8_Format);
+        const SkMaskBlurFilter filter{fSigma, fSigma};
+        for (int i = 0; i < loops; i++) {
+            SkMaskBuilder dst;
+            filter.blur(src, &dst);
+            SkMaskBuilder::FreeImage(dst.image());
+        }
+    }
+
+private:
+    static constexpr int kSize = 256;
+
+    double               fSigma;
+    SkString             fName;
+    std::vector<uint8_t> fPixels;
+};
+
+DEF_BENCH(return new MaskBlurFilterBench(2);)
+DEF_BENCH(return new MaskBlurFilterBench(5);)
+DEF_BENCH(return new MaskBlurFilterBench(10);)
+DEF_BENCH(return new MaskBlurFilterBench(25);)
+DEF_BENCH(return new MaskBlurFilterBench(50);)
+DEF_BENCH(return new MaskBlurFilterBench(100);)
@@ -73,9 +73,28 @@ private:
     using INHERITED = BlurRectsBench;
 };
 
+// A rect with a small hole can't be drawn as a nine-patch, so these blur the whole mask, with
+// masks and sigmas large enough to show how the blur scales.
+class BlurRectsSigmaBench: public BlurRectsBench {
+public:
+    BlurRectsSigmaBench(SkScalar sigma)
+        : INHERITED(SkRect::MakeXYWH(10, 10, 300, 300), SkRect::MakeXYWH(150, 150, 10, 10), sigma) {
+        this->setName(SkStringPrintf("blurrects_sigma_%d", SkScalarRoundToInt(sigma)));
+    }
+private:
+    using INHERITED = BlurRectsBench;
+};
+
 DEF_BENCH(return new BlurRectsNinePatchBench(SkRect::MakeXYWH(10, 10, 100, 100),
                                              SkRect::MakeXYWH(20, 20, 60, 60),
                                              2.3f);)
 DEF_BENCH(return new BlurRectsNonNinePatchBench(SkRect::MakeXYWH(10, 10, 100, 100),
                                                 SkRect::MakeXYWH(50, 50, 10, 10),
                                                 4.3f);)
+
+DEF_BENCH(return new BlurRectsSigmaBench(2);)
+DEF_BENCH(return new BlurRectsSigmaBench(5);)
+DEF_BENCH(return new BlurRectsSigmaBench(10);)
+DEF_BENCH(return new BlurRectsSigmaBench(25);)
+DEF_BENCH(return new BlurRectsSigmaBench(50);)
+DEF_BENCH(return new BlurRectsSigmaBench(100);)
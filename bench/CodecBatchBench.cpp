@@ -0,0 +1,95 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/codec/SkCodec.h"
+#include "include/codec/SkCodecBatch.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkString.h"
+#include "src/core/SkOSFile.h"
+#include "src/utils/SkOSPath.h"
+#include "tools/Resources.h"
+
+#include <memory>
+#include <vector>
+
+// Decodes every image in resources/images that SkCodec can decode, up to a megapixel, once per
+// loop: images/sec is the number of images (logged in setup) over the time per loop. The 1by1
+// variant decodes each image with its own codec, as a client would without SkCodecBatch; the
+// others use a batch, on the calling thread or on a thread pool.
+class CodecBatchBench : public Benchmark {
+public:
+    // threads < 0 decodes without a batch; 0 uses a batch on the calling thread.
+    explicit CodecBatchBench(int threads) : fThreads(threads) {
+        if (threads < 0) {
+            fName.set("CodecBatch_resources_images_1by1");
+        } else {
+            fName.printf("CodecBatch_resources_images_%dthreads", threads);
+        }
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        static constexpr int kMaxPixels = 1024 * 1024;
+
+        const SkString dir = GetResourcePath("images");
+        SkOSFile::Iter it(dir.c_str());
+        for (SkString file; it.next(&file);) {
+            sk_sp<SkData> data = SkData::MakeFromFileName(SkOSPath::Join(dir.c_str(),
+                                                                         file.c_str()).c_str());
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+            if (!codec || codec->dimensions().area() > kMaxPixels) {
+                continue;
+            }
+            SkBitmap bm;
+            bm.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType)
+                                           .makeAlphaType(kPremul_SkAlphaType));
+            if (codec->getPixels(bm.pixmap()) != SkCodec::kSuccess) {
+                continue;
+            }
+            fImages.push_back({std::move(data), bm.pixmap()});
+            fBitmaps.push_back(std::move(bm));
+        }
+        SkDebugf("%s: %zu images\n", fName.c_str(), fImages.size());
+
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        if (fThreads >= 0) {
+            fBatch = std::make_unique<SkCodecBatch>(fExecutor.get());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            if (fBatch) {
+                fBatch->decode(fImages);
+                continue;
+            }
+            for (const SkCodecBatch::Image& image : fImages) {
+                SkCodec::MakeFromData(image.fData)->getPixels(image.fDst);
+            }
+        }
+    }
+
+private:
+    const int                        fThreads;
+    SkString                         fName;
+    std::vector<SkCodecBatch::Image> fImages;
+    std::vector<SkBitmap>            fBitmaps;  // Owns the pixels of each fImages[i].fDst.
+    std::unique_ptr<SkExecutor>      fExecutor;
+    std::unique_ptr<SkCodecBatch>    fBatch;
+};
+
+DEF_BENCH(return new CodecBatchBench(-1);)
+DEF_BENCH(return new CodecBatchBench(0);)
+DEF_BENCH(return new CodecBatchBench(4);)
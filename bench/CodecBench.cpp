@@ -9,9 +9,19 @@
 #include "bench/CodecBenchPriv.h"
 #include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkStream.h"
+#include "include/encode/SkPngEncoder.h"
 #include "src/core/SkOSFile.h"
+#include "tools/Resources.h"
 #include "tools/flags/CommandLineFlags.h"
 
+#include <memory>
+
 // Actually zeroing the memory would throw off timing, so we just lie.
 static DEFINE_bool(zero_init, false,
                    "Pretend our destination is zero-intialized, simulating Android?");
@@ -64,3 +74,114 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
                  || result == SkCodec::kIncompleteInput);
     }
 }
+
+// Decodes a 12 megapixel JPEG with a restart marker every MCU row, serially (threads == 0) or in
+// restart bands on a pool of the given number of threads.
+class JpegRestartBandsBench : public Benchmark {
+public:
+    JpegRestartBandsBench(int threads) : fThreads(threads) {
+        fName.printf("Codec_jpeg_restart_bands_threads_%d", threads);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData("images/iphone_13_pro.jpeg");
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+        if (fData) {
+            fInfo = SkCodec::MakeFromData(fData)->getInfo().makeColorSpace(nullptr);
+            fPixelStorage.reset(fInfo.computeMinByteSize());
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+        SkCodec::Options options;
+        options.fExecutor = fExecutor.get();
+        for (int i = 0; i < loops; i++) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+            codec->getPixels(fInfo, fPixelStorage.get(), fInfo.minRowBytes(), &options);
+        }
+    }
+
+private:
+    const int                   fThreads;
+    SkString                    fName;
+    sk_sp<SkData>               fData;
+    std::unique_ptr<SkExecutor> fExecutor;
+    SkImageInfo                 fInfo;
+    SkAutoMalloc                fPixelStorage;
+};
+
+DEF_BENCH(return new JpegRestartBandsBench(0);)
+DEF_BENCH(return new JpegRestartBandsBench(2);)
+DEF_BENCH(return new JpegRestartBandsBench(4);)
+DEF_BENCH(return new JpegRestartBandsBench(8);)
+
+// Decodes a 1920x1080 PNG whose rows were all filtered with the one given filter, at zlib level 1
+// so that inflating takes little of the time. Comparing the filters shows the cost of unfiltering
+// each, which SkOpts::png_unfilter_row() does when Skia builds libpng for x86, and otherwise
+// libpng does with its own code.
+class PngUnfilterBench : public Benchmark {
+public:
+    PngUnfilterBench(const char* name, SkPngEncoder::FilterFlag filter) : fFilter(filter) {
+        fName.printf("Codec_png_unfilter_%s_1920x1080", name);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        sk_sp<SkImage> image = GetResourceAsImage("images/mandrill_512.png");
+        if (!image) {
+            return;
+        }
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(1920, 1080);
+        SkCanvas canvas(bitmap);
+        canvas.drawImageRect(image, SkRect::MakeWH(1920, 1080), SkSamplingOptions());
+
+        SkPngEncoder::Options options;
+        options.fFilterFlags = fFilter;
+        options.fZLibLevel = 1;
+        SkDynamicMemoryWStream stream;
+        if (!SkPngEncoder::Encode(&stream, bitmap.pixmap(), options)) {
+            return;
+        }
+        fData = stream.detachAsData();
+        if (!SkCodec::MakeFromData(fData)) {
+            fData = nullptr;
+            return;
+        }
+        fInfo = bitmap.info();
+        fPixelStorage.reset(fInfo.computeMinByteSize());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+        for (int i = 0; i < loops; i++) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(fData);
+            codec->getPixels(fInfo, fPixelStorage.get(), fInfo.minRowBytes());
+        }
+    }
+
+private:
+    const SkPngEncoder::FilterFlag fFilter;
+    SkString                       fName;
+    sk_sp<SkData>                  fData;
+    SkImageInfo                    fInfo;
+    SkAutoMalloc                   fPixelStorage;
+};
+
+DEF_BENCH(return new PngUnfilterBench("none",  SkPngEncoder::FilterFlag::kNone);)
+DEF_BENCH(return new PngUnfilterBench("sub",   SkPngEncoder::FilterFlag::kSub);)
+DEF_BENCH(return new PngUnfilterBench("up",    SkPngEncoder::FilterFlag::kUp);)
+DEF_BENCH(return new PngUnfilterBench("avg",   SkPngEncoder::FilterFlag::kAvg);)
+DEF_BENCH(return new PngUnfilterBench("paeth", SkPngEncoder::FilterFlag::kPaeth);)
@@ -7,12 +7,23 @@
 
 #include "bench/Benchmark.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/core/SkPngFilters.h"
 #include "tools/Resources.h"
 
+#include <cstdint>
+#include <memory>
+
 // Like other Benchmark subclasses, Encoder benchmarks are run by:
 // nanobench --match ^Encode_
 //
@@ -123,3 +134,167 @@ DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 3), "PNG_3n"));
 DEF_BENCH(return new EncodeBench(srcs[1], PNG(kNone, 1), "PNG_1n"));
 
 #undef PNG
+
+// Encodes a 3840x2160 image, the size of a 4K screenshot, as PNG: serially (threads == 0), or in
+// bands on a pool of the given number of threads. A serial encode goes through libpng unless
+// skiaFilters asks for Skia's own filters. The source is 3840 * 2160 * 4 bytes = 33.2 MB, so its
+// throughput in MB/s is 33.2 divided by the time per loop in seconds.
+class PngThreadsEncodeBench : public Benchmark {
+public:
+    PngThreadsEncodeBench(int threads, int zlibLevel, bool skiaFilters = false)
+            : fThreads(threads), fZLibLevel(zlibLevel), fSkiaFilters(skiaFilters) {
+        fName.printf("Encode_PNG_%d_3840x2160_threads_%d%s", zlibLevel, threads,
+                     skiaFilters ? "_skia_filters" : "");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(3840, 2160);
+        SkCanvas canvas(fBitmap);
+        canvas.clear(SK_ColorWHITE);
+        // Photos on the left, flat colors on the right.
+        if (sk_sp<SkImage> image = GetResourceAsImage(srcs[0])) {
+            canvas.drawImageRect(image, SkRect::MakeWH(1920, 2160), SkSamplingOptions());
+        }
+        if (sk_sp<SkImage> image = GetResourceAsImage(srcs[1])) {
+            canvas.drawImageRect(image, SkRect::MakeXYWH(1920, 0, 1920, 1080),
+                                 SkSamplingOptions());
+        }
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkPngEncoder::Options options;
+        options.fZLibLevel = fZLibLevel;
+        options.fExecutor = fExecutor.get();
+        options.fUseSkiaFilters = fSkiaFilters;
+        while (loops-- > 0) {
+            SkNullWStream dst;
+            SkAssertResult(SkPngEncoder::Encode(&dst, fBitmap.pixmap(), options));
+        }
+    }
+
+private:
+    const int                   fThreads;
+    const int                   fZLibLevel;
+    const bool                  fSkiaFilters;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new PngThreadsEncodeBench(0, 6);)
+DEF_BENCH(return new PngThreadsEncodeBench(0, 6, /*skiaFilters=*/true);)
+DEF_BENCH(return new PngThreadsEncodeBench(2, 6);)
+DEF_BENCH(return new PngThreadsEncodeBench(4, 6);)
+DEF_BENCH(return new PngThreadsEncodeBench(8, 6);)
+DEF_BENCH(return new PngThreadsEncodeBench(0, 1);)
+DEF_BENCH(return new PngThreadsEncodeBench(0, 1, /*skiaFilters=*/true);)
+DEF_BENCH(return new PngThreadsEncodeBench(8, 1);)
+
+// Encodes a 3840x2160 photo as a JPEG, in restart-interval strips when there are threads. Each
+// loop is 8.3 megapixels, so the throughput in MP/s is 8.3 over the time per loop.
+class JpegThreadsEncodeBench : public Benchmark {
+public:
+    JpegThreadsEncodeBench(int threads) : fThreads(threads) {
+        fName.printf("Encode_JPEG_3840x2160_threads_%d", threads);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(3840, 2160);
+        SkCanvas canvas(fBitmap);
+        canvas.clear(SK_ColorWHITE);
+        if (sk_sp<SkImage> image = GetResourceAsImage(srcs[0])) {
+            canvas.drawImageRect(image, SkRect::MakeWH(3840, 2160), SkSamplingOptions());
+        }
+        if (fThreads > 0) {
+            fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkJpegEncoder::Options options;
+        options.fQuality = 90;
+        options.fExecutor = fExecutor.get();
+        while (loops-- > 0) {
+            SkNullWStream dst;
+            SkAssertResult(SkJpegEncoder::Encode(&dst, fBitmap.pixmap(), options));
+        }
+    }
+
+private:
+    const int                   fThreads;
+    SkString                    fName;
+    SkBitmap                    fBitmap;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH(return new JpegThreadsEncodeBench(0);)
+DEF_BENCH(return new JpegThreadsEncodeBench(2);)
+DEF_BENCH(return new JpegThreadsEncodeBench(4);)
+DEF_BENCH(return new JpegThreadsEncodeBench(8);)
+
+// Filters every row of a 3840x2160 RGBA image with SkOpts' PNG filters, with one filter type, or
+// with all five and the cost of each as a kAll encode would to choose among them. This is the
+// filtering part of Encode_PNG_*_3840x2160_threads_*, without the compression.
+class PngFilterRowsBench : public Benchmark {
+public:
+    PngFilterRowsBench(const char* name, int filterFlags) : fFilterFlags(filterFlags) {
+        fName.printf("Encode_PNG_filter_rows_%s_3840x2160", name);
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(3840, 2160);
+        SkCanvas canvas(fBitmap);
+        canvas.clear(SK_ColorWHITE);
+        if (sk_sp<SkImage> image = GetResourceAsImage(srcs[0])) {
+            canvas.drawImageRect(image, SkRect::MakeWH(3840, 2160), SkSamplingOptions());
+        }
+        fFiltered.reset(fBitmap.rowBytes());
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const size_t rowBytes = fBitmap.rowBytes();
+        while (loops-- > 0) {
+            for (int y = 1; y < fBitmap.height(); y++) {
+                const uint8_t* row = static_cast<const uint8_t*>(fBitmap.getAddr(0, y));
+                const uint8_t* prev = static_cast<const uint8_t*>(fBitmap.getAddr(0, y - 1));
+                for (int type = kNone_SkPngFilterType; type <= kLast_SkPngFilterType; type++) {
+                    const int flag = (int)SkPngEncoder::FilterFlag::kNone << type;
+                    if (!(fFilterFlags & flag)) {
+                        continue;
+                    }
+                    SkOpts::png_filter_row(static_cast<SkPngFilterType>(type), row, prev,
+                                           rowBytes, 4, fFiltered.get());
+                    if (fFilterFlags != flag) {
+                        fCost += SkOpts::png_filtered_row_cost(fFiltered.get(), rowBytes,
+                                                               UINT64_MAX);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    const int                          fFilterFlags;
+    SkString                           fName;
+    SkBitmap                           fBitmap;
+    skia_private::AutoTMalloc<uint8_t> fFiltered;
+    uint64_t                           fCost = 0;
+};
+
+DEF_BENCH(return new PngFilterRowsBench("sub",   (int)SkPngEncoder::FilterFlag::kSub);)
+DEF_BENCH(return new PngFilterRowsBench("up",    (int)SkPngEncoder::FilterFlag::kUp);)
+DEF_BENCH(return new PngFilterRowsBench("avg",   (int)SkPngEncoder::FilterFlag::kAvg);)
+DEF_BENCH(return new PngFilterRowsBench("paeth", (int)SkPngEncoder::FilterFlag::kPaeth);)
+DEF_BENCH(return new PngFilterRowsBench("all",   (int)SkPngEncoder::FilterFlag::kAll);)
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+#include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkString.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <atomic>
+
+// Measures how well each SkExecutor copes with lots of tiny tasks, where the cost of queueing
+// (and contending on the queue) dominates the cost of the work itself.
+class ExecutorBench : public Benchmark {
+public:
+    enum class Pool { kFIFO, kLIFO, kWorkStealing };
+
+    ExecutorBench(Pool pool, bool nested) : fPool(pool), fNested(nested) {
+        static const char* kNames[] = { "fifo", "lifo", "workstealing" };
+        fName.printf("executor_%s_%s", kNames[(int)pool], nested ? "nested" : "flat");
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onPerCanvasPreDraw(SkCanvas*) override {
+        switch (fPool) {
+            case Pool::kFIFO:         fExecutor = SkExecutor::MakeFIFOThreadPool();         break;
+            case Pool::kLIFO:         fExecutor = SkExecutor::MakeLIFOThreadPool();         break;
+            case Pool::kWorkStealing: fExecutor = SkExecutor::MakeWorkStealingThreadPool(); break;
+        }
+    }
+
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        fExecutor.reset();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        static constexpr int kTasks = 1000;
+        std::atomic<int> counter{0};
+        for (int i = 0; i < loops; i++) {
+            SkTaskGroup group(*fExecutor);
+            if (fNested) {
+                // Each outer task fans out its own batch and waits on it.
+                group.batch(kTasks / 50, [&](int) {
+                    SkTaskGroup inner(*fExecutor);
+                    inner.batch(50, [&](int) {
+                        counter.fetch_add(1, std::memory_order_relaxed);
+                    });
+                });
+            } else {
+                group.batch(kTasks, [&](int) {
+                    counter.fetch_add(1, std::memory_order_relaxed);
+                });
+            }
+            group.wait();
+        }
+    }
+
+private:
+    SkString                    fName;
+    Pool                        fPool;
+    bool                        fNested;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kFIFO,         false); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kLIFO,         false); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kWorkStealing, false); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kFIFO,         true); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kLIFO,         true); )
+DEF_BENCH( return new ExecutorBench(ExecutorBench::Pool::kWorkStealing, true); )
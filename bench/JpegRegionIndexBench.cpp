@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+
+#if defined(SK_CODEC_DECODES_JPEG)
+#include "include/codec/SkAndroidCodec.h"
+#include "include/codec/SkCodec.h"
+#include "include/codec/SkJpegDecoder.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkData.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkString.h"
+#include "tools/Resources.h"
+
+#include <memory>
+#include <utility>
+
+// Like BitmapRegionDecoderBench, decodes a 512x512 tile of a 12 megapixel JPEG, with a new codec
+// for each tile as a tiled viewer would. With a region index (built once up front, as a client
+// would cache it with the image), the decode starts at the closest restart marker above the tile
+// instead of decoding every row above it. Comparing the _indexed and _unindexed variants of the
+// bottom tile shows what the index saves.
+class JpegRegionIndexBench : public Benchmark {
+public:
+    JpegRegionIndexBench(bool bottom, int sampleSize, bool indexed)
+            : fBottom(bottom), fSampleSize(sampleSize), fIndexed(indexed) {
+        fName.printf("JpegRegionIndex_%s_%d_%s", bottom ? "bottom" : "top", sampleSize,
+                     indexed ? "indexed" : "unindexed");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData("images/iphone_13_pro.jpeg");
+        if (!fData) {
+            return;
+        }
+        std::unique_ptr<SkCodec> codec = SkJpegDecoder::Decode(fData, nullptr);
+        if (fIndexed) {
+            fIndex = SkJpegDecoder::BuildRegionIndex(codec.get());
+        }
+        const SkISize dims = codec->dimensions();
+        fSubset = SkIRect::MakeXYWH(dims.width() / 2 - 256, fBottom ? dims.height() - 512 : 0,
+                                    512, 512);
+        auto androidCodec = SkAndroidCodec::MakeFromCodec(std::move(codec));
+        fBitmap.allocPixels(androidCodec->getInfo().makeDimensions(
+                androidCodec->getSampledSubsetDimensions(fSampleSize, fSubset)));
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fData) {
+            return;
+        }
+        SkAndroidCodec::AndroidOptions options;
+        options.fSubset = &fSubset;
+        options.fSampleSize = fSampleSize;
+        for (int i = 0; i < loops; i++) {
+            std::unique_ptr<SkCodec> codec = SkJpegDecoder::Decode(fData, nullptr);
+            if (fIndex) {
+                SkJpegDecoder::AttachRegionIndex(codec.get(), *fIndex);
+            }
+            auto androidCodec = SkAndroidCodec::MakeFromCodec(std::move(codec));
+            androidCodec->getAndroidPixels(fBitmap.info(), fBitmap.getPixels(), fBitmap.rowBytes(),
+                                           &options);
+        }
+    }
+
+private:
+    const bool    fBottom;
+    const int     fSampleSize;
+    const bool    fIndexed;
+    SkString      fName;
+    sk_sp<SkData> fData;
+    sk_sp<SkData> fIndex;
+    SkIRect       fSubset;
+    SkBitmap      fBitmap;
+};
+
+DEF_BENCH(return new JpegRegionIndexBench(false, 1, false);)
+DEF_BENCH(return new JpegRegionIndexBench(false, 1, true);)
+DEF_BENCH(return new JpegRegionIndexBench(true,  1, false);)
+DEF_BENCH(return new JpegRegionIndexBench(true,  1, true);)
+DEF_BENCH(return new JpegRegionIndexBench(true,  2, false);)
+DEF_BENCH(return new JpegRegionIndexBench(true,  2, true);)
+#endif  // SK_CODEC_DECODES_JPEG
@@ -7,12 +7,17 @@
 
 #include "bench/Benchmark.h"
 
+#include "include/core/SkAnnotation.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
+#include "include/core/SkFont.h"
 #include "include/core/SkImage.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkString.h"
 #include "include/effects/SkGradientShader.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkRandom.h"
@@ -21,6 +26,8 @@
 #include "src/utils/SkFloatToDecimal.h"
 #include "tools/Resources.h"
 
+#include <algorithm>
+
 namespace {
 struct WStreamWriteTextBenchmark : public Benchmark {
     std::unique_ptr<SkWStream> fWStream;
@@ -76,6 +83,7 @@ DEF_BENCH(return new PDFScalarBench("PDFScalar_random", next_any);)
 
 #ifdef SK_SUPPORT_PDF
 
+#include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFBitmap.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFShader.h"
@@ -185,6 +193,55 @@ private:
     std::unique_ptr<SkStreamAsset> fAsset;
 };
 
+/** Compares SkDeflateWStream, which feeds zlib 4K at a time, with SkDeflateZlibCompressor(), which
+    compresses a whole buffer at once, at each SkPDF::Metadata::CompressionLevel. Runs on the 78k
+    command stream and on a 400 byte prefix of it, the size of a typical small PDF object. */
+class PDFDeflateBench : public Benchmark {
+public:
+    PDFDeflateBench(SkPDF::Metadata::CompressionLevel level, bool buffered, bool small)
+            : fLevel(SkToInt(level)), fBuffered(buffered), fSmall(small) {
+        fName.printf("PDFDeflate_%s_%d%s", buffered ? "buffer" : "stream", fLevel,
+                     small ? "_small" : "");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        fData = GetResourceAsData("pdf_command_stream.txt");
+        if (fData && fSmall) {
+            fData = SkData::MakeSubset(fData.get(), 0, std::min<size_t>(400, fData->size()));
+        }
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        SkASSERT(fData);
+        if (!fData) { return; }
+        // Small objects are many, so compress as many of them as one large one.
+        int repeat = fSmall ? 200 : 1;
+        while (loops-- > 0) {
+            for (int i = 0; i < repeat; ++i) {
+                SkNullWStream wStream;
+                if (fBuffered) {
+                    SkDeflateZlibCompressor()->compress(fData->data(), fData->size(), fLevel,
+                                                        SkDeflateStrategy::kDefault, &wStream);
+                } else {
+                    SkDeflateWStream deflateWStream(&wStream, fLevel);
+                    deflateWStream.write(fData->data(), fData->size());
+                }
+            }
+        }
+    }
+
+private:
+    SkString fName;
+    int fLevel;
+    bool fBuffered;
+    bool fSmall;
+    sk_sp<SkData> fData;
+};
+
 struct PDFColorComponentBench : public Benchmark {
     bool isSuitableFor(Backend b) override {
         return b == kNonRendering_Backend;
@@ -303,14 +360,78 @@ struct PDFClipPathBenchmark : public Benchmark {
     }
 };
 
+// Compares writing a report of many small tables, which has many small objects, with and without
+// object streams.  Prints the size of each document once, next to the time from nanobench.
+struct PDFObjectStreamBench : public Benchmark {
+    bool fObjectStreams;
+    std::unique_ptr<SkExecutor> fExecutor;
+    explicit PDFObjectStreamBench(bool objectStreams) : fObjectStreams(objectStreams) {}
+    const char* onGetName() override {
+        return fObjectStreams ? "PDFObjectStream_packed" : "PDFObjectStream_xref_table";
+    }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    void onDelayedSetup() override {
+        fExecutor = SkExecutor::MakeFIFOThreadPool();
+        SkNullWStream wStream;
+        this->writeReport(&wStream);
+        SkDebugf("%s: %zu bytes\n", this->onGetName(), wStream.bytesWritten());
+    }
+    void writeReport(SkWStream* wStream) {
+        SkPDF::Metadata metadata;
+        metadata.fExecutor = fExecutor.get();
+        metadata.fUseObjectStreams = fObjectStreams;
+        auto doc = SkPDF::MakeDocument(wStream, metadata);
+        sk_sp<SkData> url = SkData::MakeWithCString("https://skia.org/");
+        SkFont font;
+        SkPaint border;
+        border.setStyle(SkPaint::kStroke_Style);
+        for (int page = 0; page < 50; ++page) {
+            SkCanvas* canvas = doc->beginPage(612, 792);
+            for (int row = 0; row < 24; ++row) {
+                for (int column = 0; column < 4; ++column) {
+                    SkRect cell = SkRect::MakeXYWH(36 + 135 * column, 36 + 30 * row, 135, 30);
+                    SkPaint fill;
+                    fill.setColor(SkColorSetARGB(0x40 + 8 * column, 0, 0x80, row * 10));
+                    canvas->drawRect(cell, fill);
+                    canvas->drawRect(cell, border);
+                    canvas->drawString("Cell", cell.left() + 4, cell.bottom() - 8, font, SkPaint());
+                }
+                SkAnnotateRectWithURL(canvas, SkRect::MakeXYWH(36, 36 + 30 * row, 540, 30),
+                                      url.get());
+            }
+        }
+        doc->close();
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            SkNullWStream wStream;
+            this->writeReport(&wStream);
+        }
+    }
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
 DEF_BENCH(return new PDFCompressionBench;)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::LowButFast, false, false);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::LowButFast, true, false);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::Average, false, false);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::Average, true, false);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::HighButSlow, false, false);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::HighButSlow, true, false);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::LowButFast, false, true);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::LowButFast, true, true);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::Average, false, true);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::Average, true, true);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::HighButSlow, false, true);)
+DEF_BENCH(return new PDFDeflateBench(SkPDF::Metadata::CompressionLevel::HighButSlow, true, true);)
 DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
 DEF_BENCH(return new PDFClipPathBenchmark;)
+DEF_BENCH(return new PDFObjectStreamBench(false);)
+DEF_BENCH(return new PDFObjectStreamBench(true);)
 
 #ifdef SK_PDF_ENABLE_SLOW_TESTS
 #include "include/core/SkExecutor.h"
@@ -21,6 +21,7 @@
 
 #include "src/core/SkDraw.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkScan.h"
 
 using namespace skia_private;
 
@@ -1286,3 +1287,107 @@ DEF_BENCH( return new CommonConvexBench(200, 16, false, false); )
 DEF_BENCH( return new CommonConvexBench(200, 16, true,  false); )
 DEF_BENCH( return new CommonConvexBench(200, 16, false, true); )
 DEF_BENCH( return new CommonConvexBench(200, 16, true,  true); )
+
+// Compares the anti-aliased scan converters on the same fills: AAA, supersampling, and sparse
+// strips. The glyphs and map workloads are many small contours, where sparse strips should
+// shine; the circle is one big, mostly solid shape.
+class ScanConverterBench : public Benchmark {
+public:
+    enum class Engine { kAnalytic, kSupersampled, kSparseStrips };
+    enum class Workload { kGlyphs, kMap, kCircle };
+
+    ScanConverterBench(Engine engine, Workload workload) : fEngine(engine), fWorkload(workload) {
+        static const char* kEngines[]   = {"aaa", "saa", "sparse_strips"};
+        static const char* kWorkloads[] = {"glyphs", "map", "circle"};
+        fName.printf("scan_converter_%s_%s", kWorkloads[(int)workload], kEngines[(int)engine]);
+    }
+
+protected:
+    bool isSuitableFor(Backend backend) override { return backend == kRaster_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkRandom rand;
+        switch (fWorkload) {
+            case Workload::kGlyphs:
+                // Lines of 12px "text": each glyph a curvy outer contour and a counter.
+                for (int line = 0; line < 40; line++) {
+                    for (int glyph = 0; glyph < 80; glyph++) {
+                        float x = 4 + glyph * 7.5f + rand.nextRangeF(0, 0.5f),
+                              y = 14 + line * 15.0f;
+                        fPath.moveTo(x, y)
+                             .cubicTo(x, y - 12, x + 6, y - 12, x + 6, y - 6)
+                             .quadTo(x + 6, y, x + 3, y)
+                             .close();
+                        fPath.addCircle(x + 3, y - 6, 1.5f, SkPathDirection::kCCW);
+                    }
+                }
+                break;
+            case Workload::kMap:
+                // Blocks of a street map: small jittered polygons a few pixels apart.
+                for (int i = 0; i < 2000; i++) {
+                    float cx = rand.nextRangeF(10, 590),
+                          cy = rand.nextRangeF(10, 590);
+                    int sides = 4 + rand.nextULessThan(6);
+                    for (int j = 0; j < sides; j++) {
+                        float angle = 2 * SK_ScalarPI * j / sides,
+                              r     = rand.nextRangeF(3, 8);
+                        SkPoint p = {cx + r * SkScalarCos(angle), cy + r * SkScalarSin(angle)};
+                        j ? fPath.lineTo(p) : fPath.moveTo(p);
+                    }
+                    fPath.close();
+                }
+                break;
+            case Workload::kCircle:
+                fPath.addCircle(300.3f, 300.7f, 280);
+                break;
+        }
+    }
+
+    void onPreDraw(SkCanvas*) override {
+        fUseAnalyticAA   = gSkUseAnalyticAA;
+        fForceAnalyticAA = gSkForceAnalyticAA;
+        fUseSparseStrips = gSkUseSparseStripAA;
+        gSkUseAnalyticAA    = fEngine == Engine::kAnalytic;
+        gSkForceAnalyticAA  = fEngine == Engine::kAnalytic;
+        gSkUseSparseStripAA = fEngine == Engine::kSparseStrips;
+    }
+
+    void onPostDraw(SkCanvas*) override {
+        gSkUseAnalyticAA    = fUseAnalyticAA;
+        gSkForceAnalyticAA  = fForceAnalyticAA;
+        gSkUseSparseStripAA = fUseSparseStrips;
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < loops; i++) {
+            canvas->drawPath(fPath, paint);
+        }
+    }
+
+private:
+    Engine   fEngine;
+    Workload fWorkload;
+    SkString fName;
+    SkPath   fPath;
+    bool     fUseAnalyticAA   = false,
+             fForceAnalyticAA = false,
+             fUseSparseStrips = false;
+};
+
+using Engine   = ScanConverterBench::Engine;
+using Workload = ScanConverterBench::Workload;
+
+DEF_BENCH( return new ScanConverterBench(Engine::kAnalytic,     Workload::kGlyphs); )
+DEF_BENCH( return new ScanConverterBench(Engine::kSupersampled, Workload::kGlyphs); )
+DEF_BENCH( return new ScanConverterBench(Engine::kSparseStrips, Workload::kGlyphs); )
+
+DEF_BENCH( return new ScanConverterBench(Engine::kAnalytic,     Workload::kMap); )
+DEF_BENCH( return new ScanConverterBench(Engine::kSupersampled, Workload::kMap); )
+DEF_BENCH( return new ScanConverterBench(Engine::kSparseStrips, Workload::kMap); )
+
+DEF_BENCH( return new ScanConverterBench(Engine::kAnalytic,     Workload::kCircle); )
+DEF_BENCH( return new ScanConverterBench(Engine::kSupersampled, Workload::kCircle); )
+DEF_BENCH( return new ScanConverterBench(Engine::kSparseStrips, Workload::kCircle); )
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkGraphics.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkString.h"
+#include "src/base/SkRandom.h"
+
+// Like RectBench, lots of small solid-color rects with a new color for each, but drawn into
+// a bitmap whose color type always takes the raster pipeline blitter. The rects are small enough
+// that setting up the blitter dominates, so comparing the _cached and _uncached variants shows
+// what the compiled pipeline cache saves per draw.
+class RasterPipelineCacheBench : public Benchmark {
+public:
+    RasterPipelineCacheBench(SkColorType ct, bool opaque, bool cached)
+            : fColorType(ct), fOpaque(opaque), fCached(cached) {
+        fName.printf("raster_pipeline_cache_%s_%s_%s",
+                     ct == kRGBA_F16_SkColorType ? "f16" : "565",
+                     opaque ? "opaque" : "translucent",
+                     cached ? "cached" : "uncached");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fBitmap.allocPixels(SkImageInfo::Make(W, H, fColorType,
+                                              fColorType == kRGB_565_SkColorType
+                                                      ? kOpaque_SkAlphaType
+                                                      : kPremul_SkAlphaType));
+        fBitmap.eraseColor(SK_ColorWHITE);
+
+        SkRandom rand;
+        for (int i = 0; i < N; i++) {
+            fRects[i] = SkRect::MakeXYWH(rand.nextULessThan(W - 16), rand.nextULessThan(H - 16),
+                                         2 + rand.nextULessThan(14), 2 + rand.nextULessThan(14));
+            // Opaque colors draw with Src (often a memset), translucent ones with SrcOver.
+            fColors[i] = (rand.nextU() & 0x00FFFFFF) | (fOpaque ? 0xFF000000 : 0x80000000);
+        }
+    }
+
+    void onPreDraw(SkCanvas*) override {
+        fPrevLimit = SkGraphics::SetRasterPipelineCacheCountLimit(fCached ? 32 : 0);
+    }
+
+    void onPostDraw(SkCanvas*) override {
+        SkGraphics::SetRasterPipelineCacheCountLimit(fPrevLimit);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas canvas(fBitmap);
+        SkPaint paint;
+        for (int i = 0; i < loops; i++) {
+            paint.setColor(fColors[i % N]);
+            canvas.drawRect(fRects[i % N], paint);
+        }
+    }
+
+private:
+    enum {
+        W = 640,
+        H = 480,
+        N = 300,
+    };
+
+    SkColorType fColorType;
+    bool        fOpaque;
+    bool        fCached;
+    int         fPrevLimit = 0;
+    SkString    fName;
+    SkBitmap    fBitmap;
+    SkRect      fRects[N];
+    SkColor     fColors[N];
+};
+
+DEF_BENCH(return new RasterPipelineCacheBench(kRGBA_F16_SkColorType, true,  true);)
+DEF_BENCH(return new RasterPipelineCacheBench(kRGBA_F16_SkColorType, true,  false);)
+DEF_BENCH(return new RasterPipelineCacheBench(kRGBA_F16_SkColorType, false, true);)
+DEF_BENCH(return new RasterPipelineCacheBench(kRGBA_F16_SkColorType, false, false);)
+DEF_BENCH(return new RasterPipelineCacheBench(kRGB_565_SkColorType,  true,  true);)
+DEF_BENCH(return new RasterPipelineCacheBench(kRGB_565_SkColorType,  true,  false);)
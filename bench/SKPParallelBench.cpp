@@ -0,0 +1,62 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/SKPParallelBench.h"
+
+#include "include/core/SkCanvas.h"
+#include "include/private/base/SkAssert.h"
+
+SKPParallelBench::SKPParallelBench(const char* name, const SkPicture* pic, const SkIRect& clip,
+                                   SkScalar scale, int threads, SkISize tileSize)
+    : fPic(SkRef(pic))
+    , fClip(clip)
+    , fScale(scale)
+    , fThreads(threads)
+    , fTileSize(tileSize)
+    , fName(name) {
+    fUniqueName.printf("%s_%.2g_parallel_%dthreads", name, scale, threads);
+}
+
+const char* SKPParallelBench::onGetName() {
+    return fName.c_str();
+}
+
+const char* SKPParallelBench::onGetUniqueName() {
+    return fUniqueName.c_str();
+}
+
+bool SKPParallelBench::isSuitableFor(Backend backend) {
+    // playbackParallel() only goes parallel when it can write straight into raster pixels.
+    return backend == kRaster_Backend;
+}
+
+void SKPParallelBench::onPerCanvasPreDraw(SkCanvas* canvas) {
+    // Draw the same area that SKPBench draws, so their numbers compare.
+    fBounds = canvas->getDeviceClipBounds();
+    fBounds.intersect(fClip);
+    fBounds.intersect(fPic->cullRect().roundOut());
+    SkAssertResult(!fBounds.isEmpty());
+
+    fExecutor = SkExecutor::MakeFIFOThreadPool(fThreads);
+}
+
+void SKPParallelBench::onPerCanvasPostDraw(SkCanvas*) {
+    fExecutor.reset();
+}
+
+SkISize SKPParallelBench::onGetSize() {
+    return SkISize::Make(fClip.width(), fClip.height());
+}
+
+void SKPParallelBench::onDraw(int loops, SkCanvas* canvas) {
+    SkAutoCanvasRestore acr(canvas, true);
+    canvas->clipIRect(fBounds);
+    canvas->scale(fScale, fScale);
+    for (int i = 0; i < loops; i++) {
+        fPic->playbackParallel(canvas, *fExecutor, fTileSize);
+    }
+}
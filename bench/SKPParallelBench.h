@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKPParallelBench_DEFINED
+#define SKPParallelBench_DEFINED
+
+#include "bench/Benchmark.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkScalar.h"
+#include "include/core/SkSize.h"
+#include "include/core/SkString.h"
+
+#include <memory>
+
+/**
+ * Runs an SkPicture as a benchmark by drawing it straight into the raster canvas with
+ * SkPicture::playbackParallel() on a fixed number of threads.  Comparing the same SKP across
+ * thread counts shows how well tiled playback scales.
+ */
+class SKPParallelBench : public Benchmark {
+public:
+    SKPParallelBench(const char* name, const SkPicture*, const SkIRect& devClip, SkScalar scale,
+                     int threads, SkISize tileSize);
+
+    int threads() const { return fThreads; }
+
+protected:
+    const char* onGetName() override;
+    const char* onGetUniqueName() override;
+    bool isSuitableFor(Backend backend) override;
+    void onPerCanvasPreDraw(SkCanvas*) override;
+    void onPerCanvasPostDraw(SkCanvas*) override;
+    void onDraw(int loops, SkCanvas* canvas) override;
+    SkISize onGetSize() override;
+
+private:
+    sk_sp<const SkPicture>      fPic;
+    const SkIRect               fClip;
+    SkIRect                     fBounds;
+    const SkScalar              fScale;
+    const int                   fThreads;
+    const SkISize               fTileSize;
+    SkString                    fName;
+    SkString                    fUniqueName;
+    std::unique_ptr<SkExecutor> fExecutor;
+};
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "bench/Benchmark.h"
+#include "include/core/SkColorType.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkString.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/core/SkRasterPipeline.h"
+#include "src/core/SkRasterPipelineOpContexts.h"
+
+#include <functional>
+#include <vector>
+
+extern bool gForceHighPrecisionRasterPipeline;
+
+// Per-stage benchmarks for SkRasterPipeline. Each bench runs a short load -> stage -> store
+// pipeline over one row of pixels. Comparing a run of nanobench against one with --noskx shows
+// what the AVX-512 stages buy over the HSW ones, stage by stage.
+
+namespace {
+
+// Arbitrary, but nice to be a non-power-of-two to exercise the tail of each stride.
+static constexpr int kWidth = 1023;
+
+enum class Stage {
+    k8888,
+    kF16,
+    kF32,
+    kSrcOver8888,
+    kSrcOverF16,
+    kMatrix,
+    kEvenlySpacedGradient,
+    kGradient,
+};
+
+static const char* stage_name(Stage stage) {
+    switch (stage) {
+        case Stage::k8888:                 return "load_store_8888";
+        case Stage::kF16:                  return "load_store_f16";
+        case Stage::kF32:                  return "load_store_f32";
+        case Stage::kSrcOver8888:          return "srcover_8888";
+        case Stage::kSrcOverF16:           return "srcover_f16";
+        case Stage::kMatrix:               return "seed_shader_matrix";
+        case Stage::kEvenlySpacedGradient: return "evenly_spaced_gradient";
+        case Stage::kGradient:             return "gradient";
+    }
+    SkUNREACHABLE;
+}
+
+class SkRasterPipelineStageBench : public Benchmark {
+public:
+    SkRasterPipelineStageBench(Stage stage, bool highp, int stops = 0)
+            : fStage(stage), fHighp(highp), fStops(stops) {
+        fName.printf("SkRasterPipeline_%s", stage_name(stage));
+        if (fStops) {
+            fName.appendf("_%d", fStops);
+        }
+        fName.append(highp ? "_highp" : "_lowp");
+    }
+
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        fSrc.assign(4 * kWidth, 0x3f003f003f003f00);  // Half-opaque f16, or any bits for 8888.
+        fDst.assign(4 * kWidth, 0x3c003c003c003c00);
+        fSrcCtx = {fSrc.data(), 0};
+        fDstCtx = {fDst.data(), 0};
+
+        SkRasterPipeline p(&fAlloc);
+        switch (fStage) {
+            case Stage::k8888:
+                p.append(SkRasterPipelineOp::load_8888, &fSrcCtx);
+                p.append(SkRasterPipelineOp::store_8888, &fDstCtx);
+                break;
+            case Stage::kF16:
+                p.append(SkRasterPipelineOp::load_f16, &fSrcCtx);
+                p.append(SkRasterPipelineOp::store_f16, &fDstCtx);
+                break;
+            case Stage::kF32:
+                p.append(SkRasterPipelineOp::load_f32, &fSrcCtx);
+                p.append(SkRasterPipelineOp::store_f32, &fDstCtx);
+                break;
+            case Stage::kSrcOver8888:
+                p.append(SkRasterPipelineOp::load_8888, &fSrcCtx);
+                p.append(SkRasterPipelineOp::load_8888_dst, &fDstCtx);
+                p.append(SkRasterPipelineOp::srcover);
+                p.append(SkRasterPipelineOp::store_8888, &fDstCtx);
+                break;
+            case Stage::kSrcOverF16:
+                p.append(SkRasterPipelineOp::load_f16, &fSrcCtx);
+                p.append(SkRasterPipelineOp::load_f16_dst, &fDstCtx);
+                p.append(SkRasterPipelineOp::srcover);
+                p.append(SkRasterPipelineOp::store_f16, &fDstCtx);
+                break;
+            case Stage::kMatrix:
+                p.append(SkRasterPipelineOp::seed_shader);
+                p.append_matrix(&fAlloc, SkMatrix::MakeAll(0.5f, 0.25f, 3, -0.25f, 2, 7, 0, 0, 1));
+                p.append(SkRasterPipelineOp::store_f32, &fDstCtx);
+                break;
+            case Stage::kEvenlySpacedGradient:
+            case Stage::kGradient:
+                p.append(SkRasterPipelineOp::seed_shader);
+                p.append_matrix(&fAlloc, SkMatrix::Scale(1.0f / kWidth, 1));
+                p.append(fStage == Stage::kGradient ? SkRasterPipelineOp::gradient
+                                                    : SkRasterPipelineOp::evenly_spaced_gradient,
+                         this->makeGradientCtx());
+                p.append(SkRasterPipelineOp::store_8888, &fDstCtx);
+                break;
+        }
+
+        bool wasHighp = gForceHighPrecisionRasterPipeline;
+        gForceHighPrecisionRasterPipeline = fHighp;
+        fRun = p.compile();
+        gForceHighPrecisionRasterPipeline = wasHighp;
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops --> 0) {
+            fRun(0, 0, kWidth, 1);
+        }
+    }
+
+private:
+    SkRasterPipeline_GradientCtx* makeGradientCtx() {
+        auto ctx = fAlloc.make<SkRasterPipeline_GradientCtx>();
+        // Like SkGradientBaseShader, pad the stop arrays so they can be read 8 at a time.
+        int count = std::max(fStops + 1, 8);
+        for (int c = 0; c < 4; ++c) {
+            ctx->fs[c] = fAlloc.makeArray<float>(count);
+            ctx->bs[c] = fAlloc.makeArray<float>(count);
+            for (int i = 0; i < fStops; ++i) {
+                ctx->fs[c][i] = 0.25f * c;
+                ctx->bs[c][i] = (float)i / fStops;
+            }
+        }
+        ctx->ts = fAlloc.makeArray<float>(count);
+        for (int i = 0; i < fStops; ++i) {
+            ctx->ts[i] = (float)i / fStops;
+        }
+        ctx->stopCount = fStops;
+        return ctx;
+    }
+
+    Stage       fStage;
+    bool        fHighp;
+    int         fStops;
+    SkString    fName;
+
+    SkSTArenaAlloc<1024>       fAlloc;
+    std::vector<uint64_t>      fSrc, fDst;
+    SkRasterPipeline_MemoryCtx fSrcCtx, fDstCtx;
+    std::function<void(size_t, size_t, size_t, size_t)> fRun;
+};
+
+}  // namespace
+
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::k8888,        /*highp=*/true);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::k8888,        /*highp=*/false);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kF16,         /*highp=*/true);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kF32,         /*highp=*/true);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kSrcOver8888, /*highp=*/true);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kSrcOver8888, /*highp=*/false);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kSrcOverF16,  /*highp=*/true);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kMatrix,      /*highp=*/true);)
+
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kEvenlySpacedGradient, true,   4);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kEvenlySpacedGradient, true,  12);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kEvenlySpacedGradient, true,  32);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kEvenlySpacedGradient, false, 12);)
+DEF_BENCH(return new SkRasterPipelineStageBench(Stage::kGradient,             true,  12);)
@@ -19,6 +19,7 @@
 #include "bench/ResultsWriter.h"
 #include "bench/SKPAnimationBench.h"
 #include "bench/SKPBench.h"
+#include "bench/SKPParallelBench.h"
 #include "bench/SkGlyphCacheBench.h"
 #include "bench/SkSLBench.h"
 #include "include/codec/SkAndroidCodec.h"
@@ -38,7 +39,10 @@
 #include "src/base/SkLeanWindows.h"
 #include "src/base/SkTime.h"
 #include "src/core/SkColorSpacePriv.h"
+#include "src/core/SkCpu.h"
 #include "src/core/SkOSFile.h"
+#include "src/core/SkRasterPipeline.h"
+#include "src/core/SkTHash.h"
 #include "src/core/SkTaskGroup.h"
 #include "src/core/SkTraceEvent.h"
 #include "src/utils/SkJSONWriter.h"
@@ -83,6 +87,7 @@
 
 extern bool gSkForceRasterPipelineBlitter;
 extern bool gForceHighPrecisionRasterPipeline;
+extern bool gDisableRasterPipelineStageFusion;
 
 #ifndef SK_BUILD_FOR_WIN
     #include <unistd.h>
@@ -142,6 +147,10 @@ static DEFINE_string(zoom, "1.0,0",
                      "function that ping-pongs between 1.0 and zoomMax.");
 static DEFINE_bool(bbh, true, "Build a BBH for SKPs?");
 static DEFINE_bool(loopSKP, true, "Loop SKPs like we do for micro benches?");
+static DEFINE_int(parallelSKP, 0,
+                  "If >0, also time SkPicture::playbackParallel() of each SKP on 1, 2, 4, ... "
+                  "up to this many threads, and report the speedup over 1 thread.");
+static DEFINE_int(parallelSKPTile, 256, "Square tile size used by --parallelSKP.");
 static DEFINE_int(flushEvery, 10, "Flush --outResultsFile every Nth run.");
 static DEFINE_bool(gpuStats, false, "Print GPU stats after each gpu benchmark?");
 static DEFINE_bool(gpuStatsDump, false, "Dump GPU stats after each benchmark to json");
@@ -156,6 +165,17 @@ static DEFINE_string(benchType,  "",
 
 static DEFINE_bool(forceRasterPipeline, false, "sets gSkForceRasterPipelineBlitter");
 static DEFINE_bool(forceRasterPipelineHP, false, "sets gSkForceRasterPipelineBlitter and gForceHighPrecisionRasterPipeline");
+static DEFINE_bool(skx, true, "Use AVX-512 (SKX) opts if the CPU has them? "
+                             "Run with --noskx to compare against the HSW opts.");
+static DEFINE_bool(stageFusion, true, "Fuse common runs of SkRasterPipeline stages? "
+                                      "Run with --nostageFusion to measure what fusion buys.");
+static DEFINE_string(stageHistogram, "",
+                     "If given, record which runs of SkRasterPipeline stages draw the most pixels "
+                     "and write them here, to help pick which runs to fuse.");
+static DEFINE_bool(stageProfile, false,
+                   "Count cycles, calls and pixels for each SkRasterPipeline stage while timing "
+                   "each bench. Prints them after the bench, records them in --outResultsFile, "
+                   "and traces them as counters. Inflates the bench times.");
 
 static DEFINE_bool2(pre_log, p, false,
                     "Log before running each test. May be incomprehensible when threading");
@@ -762,6 +782,54 @@ static void cleanup_run(Target* target) {
     delete target;
 }
 
+static void log_stage_profile(NanoJSONResultsWriter* log,
+                              const std::vector<SkRasterPipeline::StageProfile>& profile) {
+    log->beginObject("stage_profile");
+    for (const SkRasterPipeline::StageProfile& stage : profile) {
+        log->beginObject(SkRasterPipeline::GetOpName(stage.op));
+        log->appendU64("calls",  stage.calls);
+        log->appendU64("pixels", stage.pixels);
+        log->appendU64("cycles", stage.cycles);
+        log->endObject();
+    }
+    log->endObject(); // stage_profile
+}
+
+static void print_stage_profile(const std::vector<SkRasterPipeline::StageProfile>& profile,
+                                const char* name) {
+    uint64_t total = 0;
+    for (const SkRasterPipeline::StageProfile& stage : profile) {
+        total += stage.cycles;
+    }
+    for (const SkRasterPipeline::StageProfile& stage : profile) {
+        SkDebugf("\t%5.1f%%\t%8.2f cycles/px\t%12" PRIu64 " px\t%10" PRIu64 " calls\t%s\t%s\n",
+                 sk_ieee_double_divide(100.0 * stage.cycles, total),
+                 sk_ieee_double_divide(stage.cycles, stage.pixels),
+                 stage.pixels,
+                 stage.calls,
+                 SkRasterPipeline::GetOpName(stage.op),
+                 name);
+    }
+}
+
+// With Perfetto tracing, SkPerfettoTrace turns each of these into a "<op>-cycles" and a
+// "<op>-pixels" counter track.
+static void trace_stage_profile(const std::vector<SkRasterPipeline::StageProfile>& profile) {
+    SkEventTracer* tracer = SkEventTracer::GetInstance();
+    const uint8_t* enabled = tracer->getCategoryGroupEnabled("skia.rasterpipeline");
+    if (!*enabled) {
+        return;
+    }
+    for (const SkRasterPipeline::StageProfile& stage : profile) {
+        const char* argNames[] = {"cycles", "pixels"};
+        const uint8_t argTypes[] = {TRACE_VALUE_TYPE_UINT, TRACE_VALUE_TYPE_UINT};
+        const uint64_t argValues[] = {stage.cycles, stage.pixels};
+        tracer->addTraceEvent(TRACE_EVENT_PHASE_COUNTER, enabled,
+                              SkRasterPipeline::GetOpName(stage.op), /*id=*/0,
+                              2, argNames, argTypes, argValues, TRACE_EVENT_FLAG_NONE);
+    }
+}
+
 static void collect_files(const CommandLineFlags::StringArray& paths,
                           const char*                          ext,
                           TArray<SkString>*                  list) {
@@ -835,6 +903,16 @@ public:
         return SkPicture::MakeFromStream(stream.get());
     }
 
+    // The SKPs we read off disk don't have a BBH.  Re-record so they grow one.
+    static sk_sp<SkPicture> RerecordWithBBH(const sk_sp<SkPicture>& pic) {
+        SkRTreeFactory factory;
+        SkPictureRecorder recorder;
+        pic->playback(recorder.beginRecording(pic->cullRect().width(),
+                                              pic->cullRect().height(),
+                                              &factory));
+        return recorder.finishRecordingAsPicture();
+    }
+
     static std::unique_ptr<MSKPPlayer> ReadMSKP(const char* path) {
         // Not strictly necessary, as it will be checked again later,
         // but helps to avoid a lot of pointless work if we're going to skip it.
@@ -976,13 +1054,7 @@ public:
                 }
 
                 if (FLAGS_bbh) {
-                    // The SKP we read off disk doesn't have a BBH.  Re-record so it grows one.
-                    SkRTreeFactory factory;
-                    SkPictureRecorder recorder;
-                    pic->playback(recorder.beginRecording(pic->cullRect().width(),
-                                                          pic->cullRect().height(),
-                                                          &factory));
-                    pic = recorder.finishRecordingAsPicture();
+                    pic = RerecordWithBBH(pic);
                 }
                 SkString name = SkOSPath::Basename(path.c_str());
                 fSourceType = "skp";
@@ -1001,8 +1073,39 @@ public:
                 }
             }
 
+            // Then play back each SKP in parallel on 1, 2, 4, ... --parallelSKP threads.
+            while (FLAGS_parallelSKP > 0 && fCurrentParallelSKP < fSKPs.size()) {
+                if (!fParallelPic) {
+                    fParallelPic = ReadPicture(fSKPs[fCurrentParallelSKP].c_str());
+                    if (!fParallelPic) {
+                        fCurrentParallelSKP++;
+                        continue;
+                    }
+                    // playbackParallel() relies on the BBH to skip ops outside each tile.
+                    fParallelPic = RerecordWithBBH(fParallelPic);
+                    fNextParallelThreads = 1;
+                }
+                if (fNextParallelThreads > FLAGS_parallelSKP) {
+                    fParallelPic = nullptr;
+                    fCurrentParallelSKP++;
+                    continue;
+                }
+                fParallelThreads = fNextParallelThreads;
+                fNextParallelThreads = fParallelThreads < FLAGS_parallelSKP
+                                             ? std::min(2 * fParallelThreads, FLAGS_parallelSKP)
+                                             : fParallelThreads + 1;
+
+                SkString name = SkOSPath::Basename(fSKPs[fCurrentParallelSKP].c_str());
+                fSourceType = "skp";
+                fBenchType = "parallel_playback";
+                return new SKPParallelBench(name.c_str(), fParallelPic.get(), fClip,
+                                            fScales[fCurrentScale], fParallelThreads,
+                                            {FLAGS_parallelSKPTile, FLAGS_parallelSKPTile});
+            }
+
             fCurrentSKP = 0;
             fCurrentSVG = 0;
+            fCurrentParallelSKP = 0;
             fCurrentScale++;
         }
 
@@ -1247,6 +1350,11 @@ public:
         }
     }
 
+    // If the current bench is timing SkPicture::playbackParallel(), how many threads it uses.
+    int currentParallelThreads() const {
+        return 0 == strcmp(fBenchType, "parallel_playback") ? fParallelThreads : 0;
+    }
+
     void fillCurrentMetrics(NanoJSONResultsWriter& log) const {
         if (0 == strcmp(fBenchType, "recording")) {
             log.appendMetric("bytes", fSKPBytes);
@@ -1292,6 +1400,10 @@ private:
     int fCurrentScale = 0;
     int fCurrentSKP = 0;
     int fCurrentSVG = 0;
+    int fCurrentParallelSKP = 0;
+    int fParallelThreads = 0;
+    int fNextParallelThreads = 0;
+    sk_sp<SkPicture> fParallelPic;
     int fCurrentTextBlobTrace = 0;
     int fCurrentCodec = 0;
     int fCurrentAndroidCodec = 0;
@@ -1341,6 +1453,9 @@ int main(int argc, char** argv) {
     cd_Documents();
 #endif
     SetupCrashHandler();
+    if (!FLAGS_skx) {
+        SkCpu::DisableRuntimeFeaturesForTesting(SkCpu::SKX);
+    }
     SkGraphics::Init();
 
     // Our benchmarks only currently decode .png or .jpg files
@@ -1433,6 +1548,11 @@ int main(int argc, char** argv) {
 
     gSkForceRasterPipelineBlitter     = FLAGS_forceRasterPipelineHP || FLAGS_forceRasterPipeline;
     gForceHighPrecisionRasterPipeline = FLAGS_forceRasterPipelineHP;
+    gDisableRasterPipelineStageFusion = !FLAGS_stageFusion;
+    if (!FLAGS_stageHistogram.isEmpty()) {
+        SkRasterPipeline::SetStageHistogramEnabled(true);
+    }
+    SkRasterPipeline::SetStageProfilingEnabled(FLAGS_stageProfile);
 
     // The SkSL memory benchmark must run before any GPU painting occurs. SkSL allocates memory for
     // its modules the first time they are accessed, and this test is trying to measure the size of
@@ -1444,6 +1564,8 @@ int main(int argc, char** argv) {
     int runs = 0;
     BenchmarkStream benchStream;
     AutoreleasePool pool;
+    // Single-threaded median time of each --parallelSKP bench, keyed by config and SKP name.
+    THashMap<SkString, double> parallelBaselines;
     while (Benchmark* b = benchStream.next()) {
         std::unique_ptr<Benchmark> bench(b);
         if (CommandLineFlags::ShouldSkip(FLAGS_match, bench->getUniqueName())) {
@@ -1508,6 +1630,9 @@ int main(int argc, char** argv) {
                 } while (now_ms() < stop);
             }
 
+            if (FLAGS_stageProfile) {
+                SkRasterPipeline::ResetStageProfile();
+            }
             if (FLAGS_ms) {
                 samples.clear();
                 auto stop = now_ms() + FLAGS_ms;
@@ -1523,6 +1648,11 @@ int main(int argc, char** argv) {
                 }
             }
 
+            std::vector<SkRasterPipeline::StageProfile> stageProfile;
+            if (FLAGS_stageProfile) {
+                stageProfile = SkRasterPipeline::GetStageProfile();
+            }
+
             // Scale each result to the benchmark's own units, time/unit.
             for (double& sample : samples) {
                 sample *= (1.0 / bench->getUnits());
@@ -1574,6 +1704,16 @@ int main(int argc, char** argv) {
             }
             log.endArray(); // samples
             benchStream.fillCurrentMetrics(log);
+            double parallelSpeedup = 0;
+            if (int threads = benchStream.currentParallelThreads()) {
+                SkString key = SkStringPrintf("%s %s", config, bench->getName());
+                if (threads == 1) {
+                    parallelBaselines.set(key, stats.median);
+                } else if (const double* baseline = parallelBaselines.find(key)) {
+                    parallelSpeedup = *baseline / stats.median;
+                    log.appendMetric("parallel_speedup", parallelSpeedup);
+                }
+            }
             if (!keys.empty()) {
                 // dump to json, only SKPBench currently returns valid keys / values
                 SkASSERT(keys.size() == values.size());
@@ -1581,6 +1721,9 @@ int main(int argc, char** argv) {
                     log.appendMetric(keys[j].c_str(), values[j]);
                 }
             }
+            if (FLAGS_stageProfile) {
+                log_stage_profile(&log, stageProfile);
+            }
 
             log.endObject(); // config
 
@@ -1637,6 +1780,16 @@ int main(int argc, char** argv) {
                         );
             }
 
+            if (parallelSpeedup > 0) {
+                SkDebugf("\t%.2fx speedup over 1 thread\t%s\t%s\n",
+                         parallelSpeedup, bench->getUniqueName(), config);
+            }
+
+            if (FLAGS_stageProfile) {
+                print_stage_profile(stageProfile, bench->getUniqueName());
+                trace_stage_profile(stageProfile);
+            }
+
             if (FLAGS_gpuStats && Benchmark::kGPU_Backend == configs[i].backend) {
                 target->dumpStats();
             }
@@ -1661,6 +1814,11 @@ int main(int argc, char** argv) {
         combinedDMSAAStats.dump();
     }
 
+    if (!FLAGS_stageHistogram.isEmpty()) {
+        SkFILEWStream histogram(FLAGS_stageHistogram[0]);
+        SkRasterPipeline::DumpStageHistogram(&histogram);
+    }
+
     SkGraphics::PurgeAllCaches();
 
     log.beginBench("memory_usage", 0, 0);
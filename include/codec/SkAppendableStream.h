@@ -0,0 +1,76 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAppendableStream_DEFINED
+#define SkAppendableStream_DEFINED
+
+#include "include/core/SkStream.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ *  A stream of encoded data that is still arriving, e.g. over the network. The producer append()s
+ *  data as it arrives and calls finish() after the last of it, while an SkCodec reads from the
+ *  stream. Reading stops at the end of the data appended so far, so after each append() the client
+ *  can call SkCodec::incrementalDecode() again to decode the rows that the new data completes.
+ *
+ *  append() and finish() may be called on a different thread than the one reading the stream.
+ */
+class SK_API SkAppendableStream : public SkStreamSeekable {
+public:
+    SkAppendableStream();
+    ~SkAppendableStream() override;
+
+    /**
+     *  Adds |size| bytes to the end of the stream. Must not be called after finish().
+     */
+    void append(const void* data, size_t size);
+
+    /**
+     *  Marks that no more data will be appended.
+     */
+    void finish();
+
+    bool isFinished() const;
+
+    /**
+     *  The number of bytes appended so far.
+     */
+    size_t bytesAppended() const;
+
+    size_t read(void* buffer, size_t size) override;
+    size_t peek(void* buffer, size_t size) const override;
+
+    /**
+     *  Returns true only once finish() has been called and all of the data has been read.
+     */
+    bool isAtEnd() const override;
+
+    bool rewind() override;
+    size_t getPosition() const override;
+    bool seek(size_t position) override;
+    bool move(long offset) override;
+
+private:
+    // The data may still grow, so it cannot be shared with a copy of the stream.
+    SkStreamSeekable* onDuplicate() const override { return nullptr; }
+    SkStreamSeekable* onFork() const override { return nullptr; }
+
+    mutable SkMutex fMutex;
+    std::vector<uint8_t> fData SK_GUARDED_BY(fMutex);
+    bool fFinished SK_GUARDED_BY(fMutex) = false;
+
+    // Only the reader moves the position, so it does not need the lock.
+    size_t fPosition = 0;
+};
+
+#endif  // SkAppendableStream_DEFINED
@@ -27,7 +27,9 @@
 #include <tuple>
 #include <vector>
 
+class SkCodecScratch;
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -298,6 +300,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -341,6 +344,17 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, getPixels may split the decode into pieces that run concurrently on
+         *  this executor. It still returns only once the whole image is decoded, and the
+         *  pixels are the same as they would be without it.
+         *
+         *  Currently only full-size decodes of sequential JPEGs with restart markers, from
+         *  encoded data in memory, are split up. Everything else, and scanline and incremental
+         *  decodes, ignore this.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -469,12 +483,21 @@ public:
      *      been completely decoded. kIncompleteInput otherwise.
      */
     Result incrementalDecode(int* rowsDecoded = nullptr) {
-        if (!fStartedIncrementalDecode) {
-            return kInvalidParameters;
-        }
-        return this->onIncrementalDecode(rowsDecoded);
+        return this->incrementalDecode(rowsDecoded, nullptr);
     }
 
+    /**
+     *  Like incrementalDecode(int*), and also reports which rows of the destination this call
+     *  wrote, so that a client showing the image while its data arrives can redraw just those.
+     *
+     *  PNG and JPEG only decode the rows that the newly arrived data completes. A progressive
+     *  JPEG rewrites the whole image once each scan is complete, and not in between.
+     *
+     *  @param dirtyRows Optional output variable, set to the full-width rows of dst that were
+     *      written (possibly empty). Codecs that do not track this report all of dst.
+     */
+    Result incrementalDecode(int* rowsDecoded, SkIRect* dirtyRows);
+
     /**
      * The remaining functions revolve around decoding scanlines.
      */
@@ -749,6 +772,19 @@ public:
         return this->onGetRepetitionCount();
     }
 
+    /**
+     *  Return the number of bytes of encoded data that the last decode copied out of the stream
+     *  into intermediate buffers, counting from the call to getPixels(), startScanlineDecode() or
+     *  startIncrementalDecode() that began it.
+     *
+     *  Most codecs read a stream that is backed by memory (see SkStream::getMemoryBase()), such
+     *  as one made from SkData::MakeFromFileName(), where it is, so for those this is typically
+     *  zero. Some still copy from such streams: a JPEG decoded in parallel bands copies the
+     *  headers that it gives each band, and GIFs and RLE-compressed BMPs are read through
+     *  buffers of their own.
+     */
+    size_t bytesCopiedFromStream() const { return fBytesCopiedFromStream; }
+
     // Register a decoder at runtime by passing two function pointers:
     //    - peek() to return true if the span of bytes appears to be your encoded format;
     //    - make() to attempt to create an SkCodec from the given stream.
@@ -839,6 +875,27 @@ protected:
         return fStream.get();
     }
 
+    /**
+     *  Where subclasses add up the bytes that they copy out of the stream while decoding, as
+     *  reported by bytesCopiedFromStream().
+     */
+    size_t* bytesCopiedFromStreamCounter() {
+        return &fBytesCopiedFromStream;
+    }
+
+    /**
+     *  For onIncrementalDecode() implementations that know which rows of dst they write: adds
+     *  [top, bottom) to the rows reported by incrementalDecode(). Calling it with an empty range
+     *  reports that nothing was written.
+     */
+    void markIncrementalRowsDirty(int top, int bottom);
+
+    /**
+     *  Storage and caches lent to this codec while it decodes as part of an SkCodecBatch, to share
+     *  with the batch's other decodes on the same thread. Null otherwise.
+     */
+    SkCodecScratch* scratch() const { return fScratch; }
+
     /**
      *  The remaining functions revolve around decoding scanlines.
      */
@@ -916,12 +973,24 @@ private:
 
     bool fStartedIncrementalDecode = false;
 
+    // The rows written by the current call to incrementalDecode(), if the codec tracks them.
+    bool fTrackedIncrementalDirtyRows = false;
+    int  fIncrementalDirtyTop = 0;
+    int  fIncrementalDirtyBottom = 0;
+
+    size_t fBytesCopiedFromStream = 0;
+
+    SkCodecScratch* fScratch = nullptr;
+
     // Allows SkAndroidCodec to call handleFrameIndex (potentially decoding a prior frame and
     // clearing to transparent) without SkCodec itself calling it, too.
     bool fUsingCallbackForHandleFrameIndex = false;
 
     bool initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Alpha, bool srcIsOpaque);
 
+    // Resets bytesCopiedFromStream() at the start of a decode.
+    void startReadingStream();
+
     /**
      *  Return whether these dimensions are supported as a scale.
      *
@@ -1012,6 +1081,7 @@ private:
     friend class SkSampledCodec;
     friend class SkIcoCodec;
     friend class SkAndroidCodec; // for fEncodedInfo
+    friend class SkCodecBatch;   // for fScratch
 };
 
 namespace SkCodecs {
@@ -0,0 +1,59 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodecBatch_DEFINED
+#define SkCodecBatch_DEFINED
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/core/SkPixmap.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
+#include "include/core/SkTypes.h"
+
+#include <memory>
+#include <vector>
+
+class SkCodecScratch;
+class SkExecutor;
+
+/**
+ *  Decodes many encoded images at once, for clients that decode a steady stream of (typically
+ *  small) images. The images are decoded concurrently on an SkExecutor, and decodes on the same
+ *  thread share their row buffers and the color transform decisions for ICC profiles seen
+ *  before, rather than each codec setting them up from scratch.
+ *
+ *  A batch keeps that shared state between calls to decode(), so it is best to make one and
+ *  reuse it. An SkCodecBatch is not thread safe: only one call to decode() may run at a time.
+ */
+class SK_API SkCodecBatch {
+public:
+    struct Image {
+        sk_sp<SkData> fData;  // The encoded image.
+        SkPixmap      fDst;   // Where to decode it, as with SkCodec::getPixels().
+    };
+
+    /**
+     *  Decodes on executor, or on the calling thread if it is null. The executor must outlive
+     *  the batch.
+     */
+    explicit SkCodecBatch(SkExecutor* executor = nullptr);
+    ~SkCodecBatch();
+
+    /**
+     *  Decodes each image into its fDst with a codec from SkCodec::MakeFromData(), converting
+     *  as SkCodec::getPixels() does, and returns each image's result in the same order. Images
+     *  that no codec recognizes get kInvalidInput. Blocks until every image has been decoded.
+     */
+    std::vector<SkCodec::Result> decode(SkSpan<const Image> images);
+
+private:
+    SkExecutor*                                  fExecutor;
+    std::vector<std::unique_ptr<SkCodecScratch>> fScratch;  // One per worker.
+};
+
+#endif  // SkCodecBatch_DEFINED
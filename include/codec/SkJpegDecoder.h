@@ -35,6 +35,29 @@ SK_API std::unique_ptr<SkCodec> Decode(sk_sp<SkData>,
                                        SkCodec::Result*,
                                        SkCodecs::DecodeContext = nullptr);
 
+/**
+ *  Builds an index of the points partway down a JPEG where decoding can start, for a codec
+ *  returned by Decode(). Returns nullptr if the JPEG has none, or if the codec's encoded data is
+ *  not in memory.
+ *
+ *  The index is attached to the codec. With an index, a scanline decode that starts by skipping
+ *  rows (as SkAndroidCodec does for a subset) skips to the closest point above its first row,
+ *  rather than decoding every row above it. This makes decoding a region near the bottom of a
+ *  large image about as cheap as one near the top.
+ *
+ *  Currently the points are the restart markers of sequential JPEGs, where the decoder's state
+ *  is reset by the format itself, so the index is just a table of offsets. It is a small fraction
+ *  of the size of the JPEG, and can be cached with it and attached to later codecs for the same
+ *  data with AttachRegionIndex().
+ */
+SK_API sk_sp<SkData> BuildRegionIndex(SkCodec*);
+
+/**
+ *  Attaches an index from BuildRegionIndex() to a codec returned by Decode() for the same data.
+ *  Returns false, and attaches nothing, if the index does not match the codec's data.
+ */
+SK_API bool AttachRegionIndex(SkCodec*, const SkData& index);
+
 inline SkCodecs::Decoder Decoder() {
     return { "jpeg", IsJpeg, Decode };
 }
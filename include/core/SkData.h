@@ -168,6 +168,7 @@ public:
 
 private:
     friend class SkNVRefCnt<SkData>;
+    friend class SkDataPriv;
     ReleaseProc fReleaseProc;
     void*       fReleaseProcContext;
     const void* fPtr;
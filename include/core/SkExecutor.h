@@ -21,6 +21,12 @@ public:
                                                           bool allowBorrowing = true);
     static std::unique_ptr<SkExecutor> MakeLIFOThreadPool(int threads = 0,
                                                           bool allowBorrowing = true);
+    // Each thread has its own lock-free deque of work, and idle threads steal from the others.
+    // Work added from inside a task stays on that thread's deque, so this scales best for
+    // fine-grained and nested SkTaskGroup work.  Pool threads waiting on an SkTaskGroup always
+    // run queued work themselves, even if allowBorrowing is false, so nested waits can't deadlock.
+    static std::unique_ptr<SkExecutor> MakeWorkStealingThreadPool(int threads = 0,
+                                                                  bool allowBorrowing = true);
 
     // There is always a default SkExecutor available by calling SkExecutor::GetDefault().
     static SkExecutor& GetDefault();
@@ -32,6 +38,10 @@ public:
     // If it makes sense for this executor, use this thread to execute work for a little while.
     virtual void borrow() {}
 
+    // How many pieces of work this executor can run at once, or 0 if that's not known.
+    // An executor that runs work immediately on the calling thread in add() returns 1.
+    virtual int concurrency() const { return 0; }
+
 protected:
     SkExecutor() = default;
     SkExecutor(const SkExecutor&) = delete;
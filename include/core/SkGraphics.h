@@ -113,6 +113,29 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  The CPU backend caches the compiled pipelines it builds for paints, keyed on the
+     *  destination and on the paint's color, shader, color filter and blender, and reuses them
+     *  across draws on any thread. Paints with effects are cached once they have been drawn
+     *  twice. These return how many draws were set up from the cache, and how many had to build
+     *  their pipelines from scratch.
+     */
+    static size_t GetRasterPipelineCacheHits();
+    static size_t GetRasterPipelineCacheMisses();
+
+    /**
+     *  These get/set the maximum number of entries in the raster pipeline cache. Setting the
+     *  limit purges the cache, and a limit of zero turns it off. Set returns the previous limit.
+     */
+    static int GetRasterPipelineCacheCountLimit();
+    static int SetRasterPipelineCacheCountLimit(int count);
+
+    /**
+     *  For debugging purposes, this will attempt to purge the raster pipeline cache. It
+     *  does not change the limit.
+     */
+    static void PurgeRasterPipelineCache();
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -106,6 +106,20 @@ SK_API sk_sp<SkImage> RasterFromCompressedTextureData(sk_sp<SkData> data,
 SK_API sk_sp<SkImage> DeferredFromEncodedData(sk_sp<SkData> encoded,
                                               std::optional<SkAlphaType> alphaType = std::nullopt);
 
+/**
+ *  Like DeferredFromEncodedData(), but when the codec can decode to YUVA planes (as JPEG can),
+ *  draws on the raster backend keep the planes in the cache instead of an RGBA copy, converting
+ *  them to RGB as they are sampled. The planes take half the memory or less and skip the codec's
+ *  color conversion, at the cost of converting on every draw.
+ *
+ *  Images that can't be decoded to planes, or whose planes need rotation or offset chroma, are
+ *  drawn from RGBA pixels as usual. Subsets of the image are decoded to RGBA.
+ *
+ *  @param encoded  the encoded data
+ *  @return         created SkImage, or nullptr
+ */
+SK_API sk_sp<SkImage> DeferredYUVAFromEncodedData(sk_sp<SkData> encoded);
+
 /** Creates SkImage from data returned by imageGenerator. The image data will not be created
     (on either the CPU or GPU) until the image is actually drawn.
     Generated data is owned by SkImage and may not be shared or accessed.
@@ -11,6 +11,7 @@
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkShader.h"  // IWYU pragma: keep
+#include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 
 #include <atomic>
@@ -19,6 +20,7 @@
 
 class SkCanvas;
 class SkData;
+class SkExecutor;
 class SkMatrix;
 class SkStream;
 class SkWStream;
@@ -135,6 +137,29 @@ public:
     */
     virtual void playback(SkCanvas* canvas, AbortCallback* callback = nullptr) const = 0;
 
+    /** Replays the drawing commands on a raster-backed canvas using several threads.
+        The canvas's device clip bounds are split into tiles of tileSize, and each tile
+        replays only the commands whose bounds intersect it, all drawing straight into
+        the canvas's pixels. Blocks until every tile has been drawn.
+
+        Output is identical to playback(). Tiles are clipped in the same device space as
+        canvas, so device-space effects like dithering and shader coordinates match. Rects,
+        images and glyph masks under a scale and translate matrix draw the same through any
+        tile, but other anti-aliased geometry, paths and glyphs drawn as paths are scan
+        converted against the clip, so each must fit inside one tile.
+
+        Falls back to playback() if canvas has no directly accessible pixels, if its clip is
+        not a rectangle, if its matrix has perspective, or if SkPicture has geometry that
+        would draw differently through the tiles, or reads pixels outside of those it draws,
+        e.g. with an image filter.
+
+        @param canvas    raster-backed receiver of drawing commands
+        @param executor  runs the tiles
+        @param tileSize  size of each tile in device pixels
+    */
+    void playbackParallel(SkCanvas* canvas, SkExecutor& executor,
+                          SkISize tileSize = {256, 256}) const;
+
     /** Returns cull SkRect for this picture, passed in when SkPicture was created.
         Returned SkRect does not specify clipping SkRect for SkPicture; cull is hint
         of SkPicture bounds.
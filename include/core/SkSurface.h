@@ -30,6 +30,7 @@ class SkBitmap;
 class SkCanvas;
 class SkCapabilities;
 class SkColorSpace;
+class SkExecutor;
 class SkPaint;
 class SkSurface;
 struct SkIRect;
@@ -145,6 +146,18 @@ SK_API sk_sp<SkSurface> WrapPixels(const SkImageInfo& imageInfo,
                                    PixelsReleaseProc,
                                    void* context,
                                    const SkSurfaceProps* surfaceProps = nullptr);
+
+/** Lets a raster SkSurface fill big, complex paths in horizontal bands, in parallel on executor.
+    The pixels are exactly those of filling each path in one pass. Fills that can't be split up
+    exactly, or aren't worth it, still draw in one pass. Pass nullptr to stop.
+
+    executor must outlive the surface, or be unset first.
+
+    @param surface   raster SkSurface
+    @param executor  runs the bands; may be nullptr
+    @return          false, changing nothing, if surface is not a raster SkSurface
+*/
+SK_API bool SetPathFillExecutor(SkSurface* surface, SkExecutor* executor);
 }  // namespace SkSurfaces
 
 /** \class SkSurface
@@ -5,11 +5,13 @@
 
 #include "include/core/SkDocument.h"
 
+#include <cstddef>
 #include <vector>
 
 #include "include/core/SkColor.h"
 #include "include/core/SkMilestone.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkString.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "src/base/SkTime.h"
@@ -19,7 +21,9 @@
 
 class SkExecutor;
 class SkPDFArray;
+class SkPicture;
 class SkPDFTagTree;
+class SkWStream;
 
 namespace SkPDF {
 
@@ -77,6 +81,48 @@ struct DateTime {
     void toISO8601(SkString* dst) const;
 };
 
+/** Counts of the work done and objects saved by Metadata::fDeduplicateByContent.
+*/
+struct DeduplicationStats {
+    int fImagesHashed = 0;        //!< images whose contents were hashed
+    int fImageHits = 0;           //!< images that reused the image XObject of another image
+    int fImagePatternHits = 0;    //!< image shaders that reused the pattern of another image
+    int fFormXObjectsHashed = 0;  //!< form XObjects whose contents were hashed
+    int fFormXObjectHits = 0;     //!< form XObjects that reused an identical form XObject
+};
+
+/** How a Compressor searches for repeated data, as zlib's strategies. The best
+    choice depends on the data, not on the compression level.
+
+    Experimental.
+*/
+enum class DeflateStrategy {
+    kDefault,      //!< text-like data: content streams, fonts, cross-reference data
+    kFiltered,     //!< many small values and few long repeats, e.g. pixel rows
+    kRLE,          //!< only runs of one repeated byte; fast, and suits masks
+    kHuffmanOnly,  //!< no repeats at all, only entropy coding
+};
+
+/** Compresses the contents of PDF streams for the FlateDecode filter, e.g. with
+    a faster Deflate implementation than zlib's.
+
+    Experimental.
+*/
+class SK_API Compressor {
+public:
+    virtual ~Compressor() = default;
+
+    /** Writes the size bytes at data to dst as one zlib (RFC 1950) stream.
+        Returns false if the data could not be compressed, in which case nothing
+        was written to dst. Called concurrently if Metadata::fExecutor is set.
+
+        @param compressionLevel  1 is best speed; 9 is best compression; -1 is
+                                 the implementation's default. Never 0.
+    */
+    virtual bool compress(const void* data, size_t size, int compressionLevel,
+                          DeflateStrategy strategy, SkWStream* dst) const = 0;
+};
+
 /** Optional metadata to be passed into the PDF factory function.
 */
 struct Metadata {
@@ -148,10 +194,18 @@ struct Metadata {
     /** Executor to handle threaded work within PDF Backend. If this is nullptr,
         then all work will be done serially on the main thread. To have worker
         threads assist with various tasks, set this to a valid SkExecutor
-        instance. Currently used for executing Deflate algorithm in parallel.
+        instance. Currently used for executing Deflate algorithm in parallel,
+        and for drawing pages concurrently in SkPDF::DrawPages().
 
         If set, the PDF output will be non-reproducible in the order and
-        internal numbering of objects, but should render the same.
+        internal numbering of objects, but should render the same. Pages
+        drawn with SkPDF::DrawPages() are numbered in page order, so a
+        document made only with DrawPages() is reproducible.
+
+        To keep it so, once DrawPages() has been called the executor is only
+        used by later calls to DrawPages(). Streams of pages added with
+        SkDocument::beginPage() afterwards, and fonts and other objects
+        written by close(), are compressed on the calling thread.
 
         Experimental.
     */
@@ -168,6 +222,14 @@ struct Metadata {
         HighButSlow = 9,
     } fCompressionLevel = CompressionLevel::Default;
 
+    /** If not nullptr, compresses the PDF streams that are held in memory, at
+        fCompressionLevel. Otherwise, or for streams too large to copy into one
+        buffer, zlib is used. The caller should retain ownership.
+
+        Experimental.
+    */
+    const Compressor* fCompressor = nullptr;
+
     /** Preferred Subsetter. Only respected if both are compiled in.
 
         The Sfntly subsetter is deprecated.
@@ -178,6 +240,35 @@ struct Metadata {
         kHarfbuzz_Subsetter,
         kSfntly_Subsetter,
     } fSubsetter = kHarfbuzz_Subsetter;
+
+    /** If true, write a PDF 1.5 file in which objects other than streams are
+        packed into compressed object streams, indexed by a cross-reference
+        stream. This makes documents with many small objects, such as pages,
+        annotations and fonts, noticeably smaller. The object streams are
+        compressed on fExecutor if set, with fCompressionLevel.
+
+        Ignored if fPDFA is true: PDF/A-1 does not allow object streams, so
+        PDF/A documents are always written with a PDF 1.4 cross-reference table.
+
+        Experimental.
+    */
+    bool fUseObjectStreams = false;
+
+    /** If true, images, image shader patterns and form XObjects are keyed by
+        a hash of their contents, so that distinct objects with the same
+        contents (e.g. the same logo decoded separately for every page) are
+        written to the PDF only once. Images are hashed on fExecutor if set.
+
+        Experimental.
+    */
+    bool fDeduplicateByContent = false;
+
+    /** If fDeduplicateByContent is set and this is not nullptr, it is filled in
+        when the document is closed. The caller should retain ownership.
+
+        Experimental.
+    */
+    DeduplicationStats* fDeduplicationStats = nullptr;
 };
 
 /** Associate a node ID with subsequent drawing commands in an
@@ -209,6 +300,24 @@ static inline sk_sp<SkDocument> MakeDocument(SkWStream* stream) {
     return MakeDocument(stream, Metadata());
 }
 
+/** Add a page to the document for each picture, the size of its cull rect,
+    after any pages already added.  Pictures with an empty cull rect are
+    skipped, like empty pages in SkDocument::beginPage().  Ends the current
+    page, if any.
+
+    If the document's Metadata::fExecutor is set, the pages are drawn
+    concurrently on it.  Either way, once pages have been added this way the
+    document's output no longer depends on thread timing: the same pictures
+    give the same bytes.  For that, the executor is no longer used outside of
+    DrawPages(), so the rest of the document is written on the calling thread.
+
+    Experimental.
+
+    @param document  A document made by MakeDocument().
+    @param pages     The content of the pages.
+*/
+SK_API void DrawPages(SkDocument* document, SkSpan<const sk_sp<SkPicture>> pages);
+
 }  // namespace SkPDF
 
 #undef SKPDF_STRING
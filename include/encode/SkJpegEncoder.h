@@ -16,6 +16,7 @@
 class SkColorSpace;
 class SkData;
 class SkEncoder;
+class SkExecutor;
 class SkPixmap;
 class SkWStream;
 class SkImage;
@@ -86,6 +87,17 @@ struct Options {
      */
     const skcms_ICCProfile* fICCProfile = nullptr;
     const char* fICCProfileDescription = nullptr;
+
+    /**
+     *  If set, Encode() may compress horizontal strips of a large image concurrently on this
+     *  executor. Each strip is a restart interval, and the strips are joined with restart markers
+     *  into an ordinary baseline JPEG of the same quality. The strips share the standard Huffman
+     *  tables rather than ones computed for the image, so the result is larger than a serial
+     *  encode, typically by a few percent for photos.
+     *
+     *  Small images, and the incremental encoders returned by Make(), ignore this.
+     */
+    SkExecutor* fExecutor = nullptr;
 };
 
 /**
@@ -19,6 +19,7 @@
 
 class GrDirectContext;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkPixmap;
 class SkWStream;
@@ -80,6 +81,26 @@ struct Options {
      */
     const skcms_ICCProfile* fICCProfile = nullptr;
     const char* fICCProfileDescription = nullptr;
+
+    /**
+     *  If set, Encode() may filter and compress bands of rows concurrently on this executor.
+     *  Each band is compressed on its own and ends on a byte boundary, so the bands join into
+     *  a single zlib stream, and the result is an ordinary PNG. It is usually a little larger
+     *  than a serial encode, and not the same bytes.
+     *
+     *  Small images, and the incremental encoders returned by Make(), ignore this.
+     */
+    SkExecutor* fExecutor = nullptr;
+
+    /**
+     *  If true, Encode() filters rows with Skia's own SIMD code, including choosing among
+     *  filters for FilterFlag::kAll, and compresses them itself rather than through libpng.
+     *  This is usually faster. The result is still an ordinary PNG, but not the same bytes
+     *  that libpng would write. Encodes with fExecutor always do this.
+     *
+     *  The incremental encoders returned by Make() ignore this.
+     */
+    bool fUseSkiaFilters = false;
 };
 
 /**
@@ -13,17 +13,42 @@
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSize.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+class SkData;
 class SkImage;
+class SkResourceCache;
 
 class SkAnimCodecPlayer {
 public:
+    /**
+     *  Decoded frames of an animation are kept in Skia's resource cache, where they count towards
+     *  SkGraphics::GetResourceCacheTotalBytesUsed(), and may be purged to stay within its limit
+     *  (or discarded, if the cache uses discardable memory). Purged frames are decoded again
+     *  when they are needed.
+     */
     SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec);
+
+    /**
+     *  Like SkAnimCodecPlayer(codec), but shares decoded frames with every other player made with
+     *  the same encoded data, so an animation that is shown in several places, or played again by
+     *  a new player, is decoded only once. data must be the encoded animation that codec reads.
+     *  Players find each other's frames by a hash of data, and only use them if their data is
+     *  byte for byte the same.
+     */
+    SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, sk_sp<SkData> data);
+
     ~SkAnimCodecPlayer();
 
+    /**
+     *  Returns the number of bytes that the decoded frames of all players take up in the
+     *  resource cache.
+     */
+    static size_t CachedFrameBytes();
+
     /**
      *  Returns the current frame of the animation. This defaults to the first frame for
      *  animated codecs (i.e. msec = 0). Calling this multiple times (without calling seek())
@@ -53,14 +78,33 @@ public:
 
 
 private:
+    friend class SkAnimCodecPlayerPriv;
+
+    // Shares frames with other players of the same data under animationID, unless data is null.
+    // Keeps frames in localCache, or in the global resource cache if localCache is null.
+    SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, sk_sp<SkData> data, uint64_t animationID,
+                      SkResourceCache* localCache);
+
+    static size_t CachedFrameBytes(SkResourceCache* localCache);
+
     std::unique_ptr<SkCodec>        fCodec;
     SkImageInfo                     fImageInfo;
     std::vector<SkCodec::FrameInfo> fFrameInfos;
-    std::vector<sk_sp<SkImage> >    fImages;
+    // The image of a static image. Animations keep their frames in the resource cache.
+    sk_sp<SkImage>                  fStaticImage;
+    // The frame that getFrameAt() returned last. It is held here so that the next frame can be
+    // decoded on top of it, even if the cache has purged it.
+    sk_sp<SkImage>                  fLastImage;
+    int                             fLastIndex = -1;
     int                             fCurrIndex = 0;
     uint32_t                        fTotalDuration;
+    // The encoded data that this player shares frames for, or null if its frames are its own.
+    sk_sp<SkData>                   fSharedData;
+    uint64_t                        fAnimationID;
+    SkResourceCache*                fLocalCache;
 
     sk_sp<SkImage> getFrameAt(int index);
+    sk_sp<SkImage> decodeFrame(int index);
 };
 
 #endif
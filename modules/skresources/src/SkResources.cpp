@@ -107,13 +107,16 @@ ImageAsset::FrameData ImageAsset::getFrameData(float t) {
 }
 
 sk_sp<MultiFrameImageAsset> MultiFrameImageAsset::Make(sk_sp<SkData> data, bool predecode) {
-    if (auto codec = SkCodec::MakeFromData(std::move(data))) {
-        return sk_sp<MultiFrameImageAsset>(
-              new MultiFrameImageAsset(std::make_unique<SkAnimCodecPlayer>(std::move(codec)),
-                                                                             predecode));
+    auto codec = SkCodec::MakeFromData(data);
+    if (!codec) {
+        return nullptr;
     }
 
-    return nullptr;
+    // Assets of the same animation share its decoded frames.
+    auto player = codec->getFrameCount() > 1
+            ? std::make_unique<SkAnimCodecPlayer>(std::move(codec), data)
+            : std::make_unique<SkAnimCodecPlayer>(std::move(codec));
+    return sk_sp<MultiFrameImageAsset>(new MultiFrameImageAsset(std::move(player), predecode));
 }
 
 MultiFrameImageAsset::MultiFrameImageAsset(std::unique_ptr<SkAnimCodecPlayer> player,
@@ -5,9 +5,11 @@ SKIA_PUBLIC_HDRS = [
     "include/android/SkAndroidFrameworkUtils.h",
     "include/android/SkAnimatedImage.h",
     "include/codec/SkAndroidCodec.h",
+    "include/codec/SkAppendableStream.h",
     "include/codec/SkAvifDecoder.h",
     "include/codec/SkBmpDecoder.h",
     "include/codec/SkCodecAnimation.h",
+    "include/codec/SkCodecBatch.h",
     "include/codec/SkCodec.h",
     "include/codec/SkEncodedImageFormat.h",
     "include/codec/SkEncodedOrigin.h",
@@ -395,6 +397,7 @@ BASE_SRCS_ALL = [
     "src/core/SkBlitRow_D32.cpp",
     "src/core/SkBlitRow_opts.cpp",
     "src/core/SkBlitRow_opts_hsw.cpp",
+    "src/core/SkBlitRow_opts_skx.cpp",
     "src/core/SkBlitter.cpp",
     "src/core/SkBlitter.h",
     "src/core/SkBlitter_A8.cpp",
@@ -438,6 +441,7 @@ BASE_SRCS_ALL = [
     "src/core/SkCubicClipper.h",
     "src/core/SkCubicMap.cpp",
     "src/core/SkData.cpp",
+    "src/core/SkDataPriv.h",
     "src/core/SkDataTable.cpp",
     "src/core/SkDebug.cpp",
     "src/core/SkDebugUtils.h",
@@ -519,6 +523,9 @@ BASE_SRCS_ALL = [
     "src/core/SkMask.h",
     "src/core/SkMaskBlurFilter.cpp",
     "src/core/SkMaskBlurFilter.h",
+    "src/core/SkMaskBlurFilter_opts.cpp",
+    "src/core/SkMaskBlurFilter_opts_hsw.cpp",
+    "src/core/SkMaskBlurFilter_opts_skx.cpp",
     "src/core/SkMaskCache.cpp",
     "src/core/SkMaskCache.h",
     "src/core/SkMaskFilter.cpp",
@@ -534,6 +541,7 @@ BASE_SRCS_ALL = [
     "src/core/SkMemset_opts.cpp",
     "src/core/SkMemset_opts_avx.cpp",
     "src/core/SkMemset_opts_erms.cpp",
+    "src/core/SkMemset_opts_skx.cpp",
     "src/core/SkMesh.cpp",
     "src/core/SkMeshPriv.h",
     "src/core/SkMessageBus.h",
@@ -580,6 +588,10 @@ BASE_SRCS_ALL = [
     "src/core/SkPixelRefPriv.h",
     "src/core/SkPixmap.cpp",
     "src/core/SkPixmapDraw.cpp",
+    "src/core/SkPngFilters.h",
+    "src/core/SkPngFilters_opts.cpp",
+    "src/core/SkPngFilters_opts_hsw.cpp",
+    "src/core/SkPngFilters_opts_ssse3.cpp",
     "src/core/SkPoint.cpp",
     "src/core/SkPoint3.cpp",
     "src/core/SkPointPriv.h",
@@ -646,6 +658,7 @@ BASE_SRCS_ALL = [
     "src/core/SkScan_Hairline.cpp",
     "src/core/SkScan_Path.cpp",
     "src/core/SkScan_SAAPath.cpp",
+    "src/core/SkScan_SparseStripPath.cpp",
     "src/core/SkSpecialImage.cpp",
     "src/core/SkSpecialImage.h",
     "src/core/SkSpecialSurface.cpp",
@@ -673,6 +686,7 @@ BASE_SRCS_ALL = [
     "src/core/SkSwizzlePriv.h",
     "src/core/SkSwizzler_opts.cpp",
     "src/core/SkSwizzler_opts_hsw.cpp",
+    "src/core/SkSwizzler_opts_skx.cpp",
     "src/core/SkSwizzler_opts_ssse3.cpp",
     "src/core/SkTDynamicHash.h",
     "src/core/SkTHash.h",
@@ -1290,7 +1304,9 @@ BASE_SRCS_ALL = [
     "src/opts/SkBitmapProcState_opts.h",
     "src/opts/SkBlitMask_opts.h",
     "src/opts/SkBlitRow_opts.h",
+    "src/opts/SkMaskBlurFilter_opts.h",
     "src/opts/SkMemset_opts.h",
+    "src/opts/SkPngFilters_opts.h",
     "src/opts/SkOpts_RestoreTarget.h",
     "src/opts/SkOpts_SetTarget.h",
     "src/opts/SkRasterPipeline_opts.h",
@@ -1369,6 +1385,8 @@ BASE_SRCS_ALL = [
     "src/pdf/SkPDFDocumentPriv.h",
     "src/pdf/SkPDFFont.cpp",
     "src/pdf/SkPDFFont.h",
+    "src/pdf/SkPDFFontCache.cpp",
+    "src/pdf/SkPDFFontCache.h",
     "src/pdf/SkPDFFormXObject.cpp",
     "src/pdf/SkPDFFormXObject.h",
     "src/pdf/SkPDFGlyphUse.h",
@@ -1710,6 +1728,7 @@ BASE_SRCS_ALL = [
     "src/text/StrikeForGPU.h",
     "src/text/TextBlobMailbox.h",
     "src/utils/SkAnimCodecPlayer.cpp",
+    "src/utils/SkAnimCodecPlayerPriv.h",
     "src/utils/SkBase64.cpp",
     "src/utils/SkBitSet.h",
     "src/utils/SkCallableTraits.h",
@@ -1800,6 +1819,7 @@ CODEC_SRCS_LIMITED = [
     "src/codec/SkAndroidCodec.cpp",
     "src/codec/SkAndroidCodecAdapter.cpp",
     "src/codec/SkAndroidCodecAdapter.h",
+    "src/codec/SkAppendableStream.cpp",
     "src/codec/SkBmpBaseCodec.cpp",
     "src/codec/SkBmpBaseCodec.h",
     "src/codec/SkBmpCodec.cpp",
@@ -1811,9 +1831,12 @@ CODEC_SRCS_LIMITED = [
     "src/codec/SkBmpStandardCodec.cpp",
     "src/codec/SkBmpStandardCodec.h",
     "src/codec/SkCodec.cpp",
+    "src/codec/SkCodecBatch.cpp",
     "src/codec/SkCodecImageGenerator.cpp",
     "src/codec/SkCodecImageGenerator.h",
     "src/codec/SkCodecPriv.h",
+    "src/codec/SkCodecScratch.cpp",
+    "src/codec/SkCodecScratch.h",
     "src/codec/SkColorPalette.cpp",
     "src/codec/SkColorPalette.h",
     "src/codec/SkEncodedInfo.cpp",
@@ -1823,6 +1846,10 @@ CODEC_SRCS_LIMITED = [
     "src/codec/SkJpegDecoderMgr.cpp",
     "src/codec/SkJpegDecoderMgr.h",
     "src/codec/SkJpegPriv.h",
+    "src/codec/SkJpegRestartBands.cpp",
+    "src/codec/SkJpegRestartBands.h",
+    "src/codec/SkJpegSegmentScan.cpp",
+    "src/codec/SkJpegSegmentScan.h",
     "src/codec/SkJpegSourceMgr.cpp",
     "src/codec/SkJpegSourceMgr.h",
     "src/codec/SkJpegUtility.cpp",
@@ -256,6 +256,7 @@ std::unique_ptr<SkAndroidCodec> SkAndroidCodec::MakeFromData(sk_sp<SkData> data,
         return nullptr;
     }
 
+    sk_read_ahead_if_file_mapped(*data);
     return MakeFromStream(SkMemoryStream::Make(std::move(data)), chunkReader);
 }
 
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/codec/SkAppendableStream.h"
+
+#include <algorithm>
+#include <cstring>
+
+SkAppendableStream::SkAppendableStream() = default;
+
+SkAppendableStream::~SkAppendableStream() = default;
+
+void SkAppendableStream::append(const void* data, size_t size) {
+    SkAutoMutexExclusive lock(fMutex);
+    SkASSERT(!fFinished);
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    fData.insert(fData.end(), bytes, bytes + size);
+}
+
+void SkAppendableStream::finish() {
+    SkAutoMutexExclusive lock(fMutex);
+    fFinished = true;
+}
+
+bool SkAppendableStream::isFinished() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fFinished;
+}
+
+size_t SkAppendableStream::bytesAppended() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fData.size();
+}
+
+size_t SkAppendableStream::read(void* buffer, size_t size) {
+    SkAutoMutexExclusive lock(fMutex);
+    size = std::min(size, fData.size() - fPosition);
+    if (buffer) {
+        memcpy(buffer, fData.data() + fPosition, size);
+    }
+    fPosition += size;
+    return size;
+}
+
+size_t SkAppendableStream::peek(void* buffer, size_t size) const {
+    SkASSERT(buffer);
+    SkAutoMutexExclusive lock(fMutex);
+    size = std::min(size, fData.size() - fPosition);
+    memcpy(buffer, fData.data() + fPosition, size);
+    return size;
+}
+
+bool SkAppendableStream::isAtEnd() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fFinished && fPosition == fData.size();
+}
+
+bool SkAppendableStream::rewind() {
+    fPosition = 0;
+    return true;
+}
+
+size_t SkAppendableStream::getPosition() const {
+    return fPosition;
+}
+
+bool SkAppendableStream::seek(size_t position) {
+    SkAutoMutexExclusive lock(fMutex);
+    fPosition = std::min(position, fData.size());
+    return true;
+}
+
+bool SkAppendableStream::move(long offset) {
+    if (offset < 0 && static_cast<size_t>(-offset) > fPosition) {
+        return this->rewind();
+    }
+    return this->seek(fPosition + offset);
+}
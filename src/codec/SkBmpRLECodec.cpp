@@ -145,6 +145,7 @@ bool SkBmpRLECodec::initializeStreamBuffer() {
         SkCodecPrintf("Error: could not read RLE image data.\n");
         return false;
     }
+    *this->bytesCopiedFromStreamCounter() += fBytesBuffered;
     fCurrRLEByte = 0;
     return true;
 }
@@ -170,6 +171,7 @@ size_t SkBmpRLECodec::checkForMoreData() {
     // bytes of additional space remaining in the buffer, assuming that we
     // have already copied remainingBytes to the start of the buffer.
     size_t additionalBytes = this->stream()->read(buffer, fCurrRLEByte);
+    *this->bytesCopiedFromStreamCounter() += additionalBytes;
 
     // Update counters and return the number of bytes we currently have
     // available.  We are at the start of the buffer again.
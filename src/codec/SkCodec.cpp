@@ -21,9 +21,13 @@
 #include "modules/skcms/skcms.h"
 #include "src/base/SkNoDestructor.h"
 #include "src/codec/SkCodecPriv.h"
+#include "src/codec/SkCodecScratch.h"
 #include "src/codec/SkFrameHolder.h"
 #include "src/codec/SkSampler.h"
+#include "src/core/SkDataPriv.h"
+#include "src/core/SkOSFile.h"
 
+#include <algorithm>
 #include <string_view>
 #include <utility>
 
@@ -214,10 +218,21 @@ std::unique_ptr<SkCodec> SkCodec::MakeFromStream(
     return nullptr;
 }
 
+// Files smaller than this are read in a few page faults anyway.
+static constexpr size_t kMinReadaheadBytes = 64 * 1024;
+
+void sk_read_ahead_if_file_mapped(const SkData& data) {
+    // Other data is already in memory, so there is nothing to read ahead.
+    if (SkDataPriv::IsFileMapped(data) && data.size() >= kMinReadaheadBytes) {
+        sk_fmadvise_sequential(data.data(), data.size());
+    }
+}
+
 std::unique_ptr<SkCodec> SkCodec::MakeFromData(sk_sp<SkData> data, SkPngChunkReader* reader) {
     if (!data) {
         return nullptr;
     }
+    sk_read_ahead_if_file_mapped(*data);
     return MakeFromStream(SkMemoryStream::Make(std::move(data)), nullptr, reader);
 }
 
@@ -437,6 +452,10 @@ SkCodec::Result SkCodec::handleFrameIndex(const SkImageInfo& info, void* pixels,
         ? kSuccess : kInvalidConversion;
 }
 
+void SkCodec::startReadingStream() {
+    fBytesCopiedFromStream = 0;
+}
+
 SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
                                    const Options* options) {
     if (kUnknown_SkColorType == info.colorType()) {
@@ -464,6 +483,7 @@ SkCodec::Result SkCodec::getPixels(const SkImageInfo& info, void* pixels, size_t
         }
     }
 
+    this->startReadingStream();
     const Result frameIndexResult = this->handleFrameIndex(info, pixels, rowBytes,
                                                            *options);
     if (frameIndexResult != kSuccess) {
@@ -557,6 +577,7 @@ SkCodec::Result SkCodec::startIncrementalDecode(const SkImageInfo& info, void* p
         }
     }
 
+    this->startReadingStream();
     const Result frameIndexResult = this->handleFrameIndex(info, pixels, rowBytes,
                                                            *options);
     if (frameIndexResult != kSuccess) {
@@ -587,6 +608,41 @@ SkCodec::Result SkCodec::startIncrementalDecode(const SkImageInfo& info, void* p
 }
 
 
+SkCodec::Result SkCodec::incrementalDecode(int* rowsDecoded, SkIRect* dirtyRows) {
+    if (!fStartedIncrementalDecode) {
+        return kInvalidParameters;
+    }
+    fTrackedIncrementalDirtyRows = false;
+    const Result result = this->onIncrementalDecode(rowsDecoded);
+    if (dirtyRows) {
+        const SkISize size = fOptions.fSubset ? fOptions.fSubset->size() : fDstInfo.dimensions();
+        if (fTrackedIncrementalDirtyRows) {
+            *dirtyRows = SkIRect::MakeLTRB(0, fIncrementalDirtyTop,
+                                           size.width(), fIncrementalDirtyBottom);
+        } else {
+            *dirtyRows = SkIRect::MakeSize(size);
+        }
+    }
+    return result;
+}
+
+void SkCodec::markIncrementalRowsDirty(int top, int bottom) {
+    if (!fTrackedIncrementalDirtyRows) {
+        fTrackedIncrementalDirtyRows = true;
+        fIncrementalDirtyTop = fIncrementalDirtyBottom = 0;
+    }
+    if (top >= bottom) {
+        return;
+    }
+    if (fIncrementalDirtyTop >= fIncrementalDirtyBottom) {
+        fIncrementalDirtyTop = top;
+        fIncrementalDirtyBottom = bottom;
+    } else {
+        fIncrementalDirtyTop = std::min(fIncrementalDirtyTop, top);
+        fIncrementalDirtyBottom = std::max(fIncrementalDirtyBottom, bottom);
+    }
+}
+
 SkCodec::Result SkCodec::startScanlineDecode(const SkImageInfo& info,
         const SkCodec::Options* options) {
     // Reset fCurrScanline in case of failure.
@@ -614,6 +670,8 @@ SkCodec::Result SkCodec::startScanlineDecode(const SkImageInfo& info,
         return kUnimplemented;
     }
 
+    this->startReadingStream();
+
     // The void* dst and rowbytes in handleFrameIndex or only used for decoding prior
     // frames, which is not supported here anyway, so it is safe to pass nullptr/0.
     const Result frameIndexResult = this->handleFrameIndex(info, nullptr, 0, *options);
@@ -777,9 +835,9 @@ bool SkCodec::initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Al
             if (!srcProfile) {
                 srcProfile = skcms_sRGB_profile();
             }
-            if (!skcms_ApproximatelyEqualProfiles(srcProfile, &fDstProfile) ) {
-                needsColorXform = true;
-            }
+            needsColorXform = fScratch
+                    ? fScratch->needsColorXform(srcProfile, &fDstProfile)
+                    : !skcms_ApproximatelyEqualProfiles(srcProfile, &fDstProfile);
         }
     }
 
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/codec/SkCodecBatch.h"
+
+#include "include/core/SkExecutor.h"
+#include "src/codec/SkCodecScratch.h"
+#include "src/core/SkTaskGroup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+SkCodecBatch::SkCodecBatch(SkExecutor* executor) : fExecutor(executor) {}
+
+SkCodecBatch::~SkCodecBatch() = default;
+
+std::vector<SkCodec::Result> SkCodecBatch::decode(SkSpan<const Image> images) {
+    std::vector<SkCodec::Result> results(images.size(), SkCodec::kInvalidInput);
+    if (images.empty()) {
+        return results;
+    }
+
+    // Each worker decodes images until there are none left, lending its scratch to each codec in
+    // turn. When the executor doesn't know its concurrency, this guesses as SkParallelFor does.
+    static constexpr int kUnknownConcurrency = 8;
+    int workers = 1;
+    if (fExecutor) {
+        const int concurrency = fExecutor->concurrency();
+        workers = std::min(images.size(),
+                           static_cast<size_t>(concurrency > 0 ? concurrency
+                                                               : kUnknownConcurrency));
+    }
+    while (fScratch.size() < static_cast<size_t>(workers)) {
+        fScratch.push_back(std::make_unique<SkCodecScratch>());
+    }
+
+    std::atomic<size_t> nextImage{0};
+    auto work = [&](SkCodecScratch* scratch) {
+        for (size_t i; (i = nextImage.fetch_add(1, std::memory_order_relaxed)) < images.size();) {
+            std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(images[i].fData);
+            if (!codec) {
+                continue;
+            }
+            codec->fScratch = scratch;
+            results[i] = codec->getPixels(images[i].fDst);
+        }
+    };
+
+    if (workers == 1) {
+        work(fScratch[0].get());
+    } else {
+        SkParallelFor(*fExecutor, workers, 1, [&](int firstWorker, int endWorker) {
+            for (int w = firstWorker; w < endWorker; w++) {
+                work(fScratch[w].get());
+            }
+        });
+    }
+    return results;
+}
@@ -10,6 +10,7 @@
 
 #include "include/codec/SkEncodedOrigin.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkTypes.h"
 #include "include/private/SkColorData.h"
 #include "include/private/SkEncodedInfo.h"
@@ -17,6 +18,8 @@
 
 #include <string_view>
 
+class SkData;
+
 #ifdef SK_PRINT_CODEC_MESSAGES
     #define SkCodecPrintf SkDebugf
 #else
@@ -27,6 +30,11 @@
 bool sk_select_xform_format(SkColorType colorType, bool forColorTable,
                             skcms_PixelFormat* outFormat);
 
+// Defined in SkCodec.cpp. Hints that data, if it is a file mapped by SkData::MakeFromFileName(),
+// is about to be decoded, so that the OS reads it ahead of the decoder rather than a page fault at
+// a time. This covers the whole file, since decodes may rewind, so it is done once per codec.
+void sk_read_ahead_if_file_mapped(const SkData& data);
+
 // FIXME: Consider sharing with dm, nanbench, and tools.
 static inline float get_scale_from_sample_size(int sampleSize) {
     return 1.0f / ((float) sampleSize);
@@ -139,6 +147,26 @@ static inline size_t compute_row_bytes(int width, uint32_t bitsPerPixel) {
     }
 }
 
+/*
+ * Read up to size bytes from stream, and return how many were read. If the stream is in memory,
+ * *bytes points to them where they are. Otherwise they are copied into buffer, which must hold
+ * size bytes, and counted in *bytesCopied, if it is not null.
+ */
+static inline size_t read_in_place(SkStream* stream, void* buffer, size_t size,
+                                   const uint8_t** bytes, size_t* bytesCopied) {
+    const void* base = stream->getMemoryBase();
+    if (base && stream->hasPosition()) {
+        *bytes = static_cast<const uint8_t*>(base) + stream->getPosition();
+        return stream->skip(size);
+    }
+    const size_t bytesRead = stream->read(buffer, size);
+    *bytes = static_cast<const uint8_t*>(buffer);
+    if (bytesCopied) {
+        *bytesCopied += bytesRead;
+    }
+    return bytesRead;
+}
+
 /*
  * Get a byte from a buffer
  * This method is unsafe, the caller is responsible for performing a check
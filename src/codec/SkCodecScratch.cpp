@@ -0,0 +1,81 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkCodecScratch.h"
+
+#include "include/core/SkSpan.h"
+#include "modules/skcms/skcms.h"
+
+#include <cstring>
+
+// Room for the fields of a parametric profile that profile_bytes() copies.
+struct ParametricProfileBytes {
+    uint8_t fBytes[sizeof(uint32_t) + 3 * sizeof(skcms_TransferFunction) +
+                   sizeof(skcms_Matrix3x3)];
+};
+
+// The bytes of everything that skcms_ApproximatelyEqualProfiles() looks at in profile, or an
+// empty span if those can't be had cheaply. A profile parsed from ICC data is identified by the
+// data. Otherwise only profiles made of parametric curves and a matrix, like those from
+// SkColorSpace::toProfile(), are identified, by copying those fields into storage.
+static SkSpan<const uint8_t> profile_bytes(const skcms_ICCProfile& profile,
+                                           ParametricProfileBytes* storage) {
+    if (profile.buffer) {
+        return {profile.buffer, profile.size};
+    }
+    if (profile.has_A2B || profile.has_B2A || !profile.has_trc || !profile.has_toXYZD50) {
+        return {};
+    }
+    uint8_t* bytes = storage->fBytes;
+    memcpy(bytes, &profile.data_color_space, sizeof(profile.data_color_space));
+    bytes += sizeof(profile.data_color_space);
+    for (const skcms_Curve& curve : profile.trc) {
+        if (curve.table_entries != 0) {
+            return {};
+        }
+        memcpy(bytes, &curve.parametric, sizeof(curve.parametric));
+        bytes += sizeof(curve.parametric);
+    }
+    memcpy(bytes, &profile.toXYZD50, sizeof(profile.toXYZD50));
+    return {storage->fBytes, sizeof(storage->fBytes)};
+}
+
+static bool equals(const SkData& data, SkSpan<const uint8_t> bytes) {
+    return data.size() == bytes.size() && memcmp(data.data(), bytes.data(), bytes.size()) == 0;
+}
+
+void* SkCodecScratch::rowStorage(size_t bytes) {
+    if (bytes > fRowStorageBytes) {
+        fRowStorage.reset(bytes);
+        fRowStorageBytes = bytes;
+    }
+    return fRowStorage.get();
+}
+
+bool SkCodecScratch::needsColorXform(const skcms_ICCProfile* src, const skcms_ICCProfile* dst) {
+    ParametricProfileBytes srcStorage, dstStorage;
+    const SkSpan<const uint8_t> srcBytes = profile_bytes(*src, &srcStorage),
+                                dstBytes = profile_bytes(*dst, &dstStorage);
+    if (srcBytes.empty() || dstBytes.empty()) {
+        return !skcms_ApproximatelyEqualProfiles(src, dst);
+    }
+    const ProfilePair key = {SkChecksum::Hash64(srcBytes.data(), srcBytes.size()),
+                             SkChecksum::Hash64(dstBytes.data(), dstBytes.size())};
+    if (const CachedPair* cached = fNeedsColorXform.find(key)) {
+        if (equals(*cached->fSrc, srcBytes) && equals(*cached->fDst, dstBytes)) {
+            return cached->fNeedsColorXform;
+        }
+        // The hashes collided. The newer pair replaces the older one below.
+    } else if (fNeedsColorXform.count() >= kMaxCachedProfilePairs) {
+        fNeedsColorXform.reset();
+    }
+    const bool needsColorXform = !skcms_ApproximatelyEqualProfiles(src, dst);
+    fNeedsColorXform.set(key, {SkData::MakeWithCopy(srcBytes.data(), srcBytes.size()),
+                               SkData::MakeWithCopy(dstBytes.data(), dstBytes.size()),
+                               needsColorXform});
+    return needsColorXform;
+}
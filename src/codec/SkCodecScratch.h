@@ -0,0 +1,79 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCodecScratch_DEFINED
+#define SkCodecScratch_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkTHash.h"
+
+#include <cstddef>
+#include <cstdint>
+
+struct skcms_ICCProfile;
+
+/**
+ *  Memory and color state that a run of decodes on one thread can share, so that decoding many
+ *  small images does not set all of it up again for every image. An SkCodecBatch gives one to
+ *  each of its workers, and lends it to each codec the worker decodes with. Only one codec may
+ *  use a scratch at a time.
+ */
+class SkCodecScratch {
+public:
+    /**
+     *  Returns at least bytes of storage for a codec's row buffers, valid until the next call.
+     *  The storage from the last call is reused when it is large enough.
+     */
+    void* rowStorage(size_t bytes);
+
+    /**
+     *  Returns storage for a codec's row buffers: scratch's when the codec has been lent one, or
+     *  else the codec's own storage.
+     */
+    static void* RowStorage(SkCodecScratch* scratch, skia_private::AutoTMalloc<uint8_t>* storage,
+                            size_t bytes) {
+        return scratch ? scratch->rowStorage(bytes) : storage->reset(bytes);
+    }
+
+    /**
+     *  Returns whether pixels in src need a color transform to dst, i.e. whether they are not
+     *  approximately equal profiles. The answer is remembered for each pair of profiles, along with
+     *  a copy of what was compared, so that images sharing an ICC profile only compare it to the
+     *  destination once.
+     */
+    bool needsColorXform(const skcms_ICCProfile* src, const skcms_ICCProfile* dst);
+
+private:
+    // More pairs than a batch of images tends to have. When there are more, the cache starts over.
+    static constexpr int kMaxCachedProfilePairs = 64;
+
+    struct ProfilePair {
+        uint64_t fSrc;
+        uint64_t fDst;
+
+        bool operator==(const ProfilePair& that) const {
+            return fSrc == that.fSrc && fDst == that.fDst;
+        }
+    };
+
+    // A pair of profiles hashing to a ProfilePair, and whether they need a color transform. The
+    // bytes are checked on every hit, so two pairs with the same hashes are never confused.
+    struct CachedPair {
+        sk_sp<SkData> fSrc;
+        sk_sp<SkData> fDst;
+        bool          fNeedsColorXform;
+    };
+
+    skia_private::AutoTMalloc<uint8_t>                          fRowStorage;
+    size_t                                                      fRowStorageBytes = 0;
+    skia_private::THashMap<ProfilePair, CachedPair, SkGoodHash> fNeedsColorXform;
+};
+
+#endif  // SkCodecScratch_DEFINED
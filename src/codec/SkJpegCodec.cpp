@@ -12,6 +12,7 @@
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
@@ -22,13 +23,17 @@
 #include "include/private/base/SkAlign.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
 #include "src/codec/SkCodecPriv.h"
+#include "src/codec/SkCodecScratch.h"
 #include "src/codec/SkJpegConstants.h"
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkJpegPriv.h"
+#include "src/codec/SkJpegRestartBands.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkTaskGroup.h"
 
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
 #include "include/private/SkGainmapInfo.h"
@@ -38,7 +43,9 @@
 #include "src/codec/SkJpegXmp.h"
 #endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <csetjmp>
 #include <cstring>
 #include <utility>
@@ -375,7 +382,9 @@ SkJpegCodec::SkJpegCodec(SkEncodedInfo&& info,
                          SkEncodedOrigin origin)
         : INHERITED(std::move(info), skcms_PixelFormat_RGBA_8888, std::move(stream), origin)
         , fDecoderMgr(decoderMgr)
-        , fReadyState(decoderMgr->dinfo()->global_state) {}
+        , fReadyState(decoderMgr->dinfo()->global_state) {
+    fDecoderMgr->getSourceMgr()->setBytesCopiedCounter(this->bytesCopiedFromStreamCounter());
+}
 SkJpegCodec::~SkJpegCodec() = default;
 
 /*
@@ -446,6 +455,8 @@ bool SkJpegCodec::onRewind() {
     }
     SkASSERT(nullptr != decoderMgr);
     fDecoderMgr.reset(decoderMgr);
+    fDecoderMgr->getSourceMgr()->setBytesCopiedCounter(this->bytesCopiedFromStreamCounter());
+    fStartedAtCheckpoint = false;
 
     fSwizzler.reset(nullptr);
     fSwizzleSrcRow = nullptr;
@@ -564,10 +575,13 @@ bool SkJpegCodec::onDimensionsSupported(const SkISize& size) {
 }
 
 int SkJpegCodec::readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
-                          const Options& opts) {
+                          const Options& opts, bool* hadError) {
     // Set the jump location for libjpeg-turbo errors
     skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
     if (setjmp(jmp)) {
+        if (hadError) {
+            *hadError = true;
+        }
         return 0;
     }
 
@@ -652,6 +666,12 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
         return kUnimplemented;
     }
 
+    fRestartBandsDecoded = 0;
+    if (options.fExecutor &&
+        this->decodeRestartBands(dstInfo, dst, dstRowBytes, *options.fExecutor)) {
+        return kSuccess;
+    }
+
     // Get a pointer to the decompress info since we will use it quite frequently
     jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
 
@@ -687,6 +707,257 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+// Bands are at least this many rows tall, so that each is worth a task of its own.
+static constexpr int kMinRestartBandHeight = 256;
+
+bool SkJpegCodec::decodeRestartBands(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                     SkExecutor& executor) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (executor.concurrency() == 1 || dstInfo.dimensions() != this->dimensions() ||
+        dstInfo.height() < 2 * kMinRestartBandHeight ||
+        needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                            this->getEncodedInfo().profile(), this->colorXform())) {
+        return false;
+    }
+    SkJpegRestartBands::Geometry geometry;
+    if (!this->getRestartGeometry(&geometry)) {
+        return false;
+    }
+    if (!fRestartBands) {
+        sk_sp<SkData> data = this->getEncodedData();
+        if (!data) {
+            return false;
+        }
+        fRestartBands = SkJpegRestartBands::Make(std::move(data), geometry);
+        if (!fRestartBands) {
+            return false;
+        }
+    }
+    const SkJpegRestartBands* bands = fRestartBands.get();
+    const int mcuHeight = geometry.mcuHeight;
+
+    const int checkpointRows = bands->checkpointRows();
+    const int groups = (geometry.mcuRows + checkpointRows - 1) / checkpointRows;
+    int bandCount = std::min(groups, dstInfo.height() / kMinRestartBandHeight);
+    if (executor.concurrency() > 0) {
+        bandCount = std::min(bandCount, executor.concurrency());
+    }
+    if (bandCount < 2) {
+        return false;
+    }
+
+    // Fancy upsampling of vertically subsampled chroma blends each row with the rows above and
+    // below it. So that band edges match the serial decode exactly, each band also decodes the
+    // checkpoint rows on either side of it, and throws away their pixels.
+    const int overlap = dinfo->max_v_samp_factor > 1 ? checkpointRows : 0;
+
+    // Each band reads the entropy-coded data in place, but has a copy of the headers.
+    *this->bytesCopiedFromStreamCounter() += bandCount * bands->bandHeaderSize();
+
+    std::atomic<bool> succeeded{true};
+    SkParallelFor(executor, bandCount, 1, [&](int firstBand, int endBand) {
+        for (int band = firstBand; band < endBand && succeeded; band++) {
+            const int startRow = band * groups / bandCount * checkpointRows;
+            const int endRow = std::min((band + 1) * groups / bandCount * checkpointRows,
+                                        geometry.mcuRows);
+            const int decodeStart = std::max(startRow - overlap, 0);
+            const int decodeEnd = std::min(endRow + overlap, geometry.mcuRows);
+
+            const int top = startRow * mcuHeight;
+            const int bottom = std::min(endRow * mcuHeight, dstInfo.height());
+            if (!this->decodeRestartBand(bands->makeBand(decodeStart, decodeEnd),
+                                         (startRow - decodeStart) * mcuHeight, bottom - top,
+                                         dstInfo, SkTAddOffset<void>(dst, top * rowBytes),
+                                         rowBytes)) {
+                succeeded = false;
+            }
+        }
+    });
+    if (!succeeded) {
+        return false;
+    }
+    fRestartBandsDecoded = bandCount;
+    return true;
+}
+
+bool SkJpegCodec::decodeRestartBand(std::unique_ptr<SkJpegSourceMgr> band, int skipRows,
+                                    int count, const SkImageInfo& dstInfo, void* dst,
+                                    size_t rowBytes) const {
+    JpegDecoderMgr decoderMgr(std::move(band));
+
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr.errorMgr());
+    if (setjmp(jmp)) {
+        return decoderMgr.returnFalse("decodeRestartBand");
+    }
+
+    decoderMgr.init();
+    jpeg_decompress_struct* dinfo = decoderMgr.dinfo();
+    if (JPEG_HEADER_OK != jpeg_read_header(dinfo, true)) {
+        return false;
+    }
+
+    // Decode with the same settings as the serial decode.
+    const jpeg_decompress_struct* settings = fDecoderMgr->dinfo();
+    dinfo->out_color_space = settings->out_color_space;
+    dinfo->dither_mode = settings->dither_mode;
+    dinfo->dct_method = settings->dct_method;
+    dinfo->do_fancy_upsampling = settings->do_fancy_upsampling;
+    if (!jpeg_start_decompress(dinfo) || SkToInt(dinfo->output_width) != dstInfo.width()) {
+        return false;
+    }
+
+    // Rows we throw away, and rows that the color xform will widen or narrow, are decoded here.
+    skia_private::AutoTMalloc<uint8_t> scratch(get_row_bytes(dinfo));
+    JSAMPLE* scratchRow = scratch.get();
+    const bool xformFromScratch =
+            this->colorXform() && sizeof(uint32_t) != dstInfo.bytesPerPixel();
+
+    for (int y = 0; y < skipRows; y++) {
+        if (1 != jpeg_read_scanlines(dinfo, &scratchRow, 1)) {
+            return false;
+        }
+    }
+    for (int y = 0; y < count; y++) {
+        JSAMPLE* decodeDst = xformFromScratch ? scratchRow : static_cast<JSAMPLE*>(dst);
+        if (1 != jpeg_read_scanlines(dinfo, &decodeDst, 1)) {
+            return false;
+        }
+        if (this->colorXform()) {
+            this->applyColorXform(dst, decodeDst, dstInfo.width());
+        }
+        dst = SkTAddOffset<void>(dst, rowBytes);
+    }
+    return true;
+}
+
+sk_sp<SkData> SkJpegCodec::getEncodedData() {
+    SkStream* stream = this->stream();
+    if (!stream->getMemoryBase() || !stream->hasLength()) {
+        return nullptr;
+    }
+    return SkData::MakeWithoutCopy(stream->getMemoryBase(), stream->getLength());
+}
+
+bool SkJpegCodec::getRestartGeometry(SkJpegRestartBands::Geometry* geometry) {
+    // These fields describe the image, so they are the same in any decoder made by ReadHeader(),
+    // at any point in the decode.
+    const jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (dinfo->progressive_mode || dinfo->arith_code || dinfo->restart_interval == 0 ||
+        dinfo->comps_in_scan != dinfo->num_components) {
+        return false;
+    }
+
+    // An MCU of an interleaved scan covers max_h_samp_factor x max_v_samp_factor blocks of the
+    // image, and a scan of a single component has one block per MCU.
+    int mcuWidth = DCTSIZE,
+        mcuHeight = DCTSIZE;
+    if (dinfo->comps_in_scan > 1) {
+        mcuWidth *= dinfo->max_h_samp_factor;
+        mcuHeight *= dinfo->max_v_samp_factor;
+    }
+    const SkEncodedInfo& info = this->getEncodedInfo();
+    geometry->mcusPerRow = (info.width() + mcuWidth - 1) / mcuWidth;
+    geometry->mcuRows = (info.height() + mcuHeight - 1) / mcuHeight;
+    geometry->mcuHeight = mcuHeight;
+    geometry->restartInterval = SkToInt(dinfo->restart_interval);
+    return true;
+}
+
+sk_sp<SkData> SkJpegCodec::buildRegionIndex() {
+    SkJpegRestartBands::Geometry geometry;
+    sk_sp<SkData> data = this->getEncodedData();
+    if (!data || !this->getRestartGeometry(&geometry)) {
+        return nullptr;
+    }
+    if (!fRestartBands) {
+        fRestartBands = SkJpegRestartBands::Make(std::move(data), geometry);
+        if (!fRestartBands) {
+            return nullptr;
+        }
+    }
+    return fRestartBands->serialize();
+}
+
+bool SkJpegCodec::attachRegionIndex(const SkData& index) {
+    SkJpegRestartBands::Geometry geometry;
+    sk_sp<SkData> data = this->getEncodedData();
+    if (!data || !this->getRestartGeometry(&geometry)) {
+        return false;
+    }
+    std::unique_ptr<SkJpegRestartBands> bands =
+            SkJpegRestartBands::MakeFromIndex(std::move(data), geometry, index);
+    if (!bands) {
+        return false;
+    }
+    fRestartBands = std::move(bands);
+    return true;
+}
+
+bool SkJpegCodec::startAtCheckpoint(int* rowsToSkip) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    SkJpegRestartBands::Geometry geometry;
+    if (!fRestartBands || fStartedAtCheckpoint || dinfo->output_scanline != 0 ||
+        !this->getRestartGeometry(&geometry)) {
+        return false;
+    }
+
+    // With DCT scaling each MCU row still decodes to a whole number of output rows.
+    const int mcuOutputHeight = geometry.mcuHeight * dinfo->scale_num / dinfo->scale_denom;
+    if (mcuOutputHeight * dinfo->scale_denom != geometry.mcuHeight * dinfo->scale_num) {
+        return false;
+    }
+
+    // As in decodeRestartBands(), vertically subsampled chroma needs the checkpoint rows above
+    // the first row we keep to be decoded too.
+    const int checkpointRows = fRestartBands->checkpointRows();
+    const int checkpointHeight = checkpointRows * mcuOutputHeight;
+    int checkpoint = *rowsToSkip / checkpointHeight;
+    if (dinfo->max_v_samp_factor > 1) {
+        checkpoint--;
+    }
+    if (checkpoint <= 0) {
+        return false;
+    }
+    const int startRow = checkpoint * checkpointRows;
+
+    auto decoderMgr = std::make_unique<JpegDecoderMgr>(
+            fRestartBands->makeBand(startRow, geometry.mcuRows));
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(decoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return decoderMgr->returnFalse("startAtCheckpoint");
+    }
+
+    decoderMgr->init();
+    jpeg_decompress_struct* bandInfo = decoderMgr->dinfo();
+    if (JPEG_HEADER_OK != jpeg_read_header(bandInfo, true)) {
+        return false;
+    }
+    bandInfo->out_color_space = dinfo->out_color_space;
+    bandInfo->dither_mode = dinfo->dither_mode;
+    bandInfo->dct_method = dinfo->dct_method;
+    bandInfo->do_fancy_upsampling = dinfo->do_fancy_upsampling;
+    bandInfo->scale_num = dinfo->scale_num;
+    bandInfo->scale_denom = dinfo->scale_denom;
+    if (!jpeg_start_decompress(bandInfo)) {
+        return false;
+    }
+    if (const SkIRect* subset = this->options().fSubset) {
+        // This crops exactly as onStartScanlineDecode() did, since the band is just as wide.
+        uint32_t startX = subset->x();
+        uint32_t width = subset->width();
+        jpeg_crop_scanline(bandInfo, &startX, &width);
+    }
+    if (bandInfo->output_width != dinfo->output_width) {
+        return false;
+    }
+
+    fDecoderMgr = std::move(decoderMgr);
+    fStartedAtCheckpoint = true;
+    *this->bytesCopiedFromStreamCounter() += fRestartBands->bandHeaderSize();
+    *rowsToSkip -= startRow * mcuOutputHeight;
+    return true;
+}
+
 bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
     int dstWidth = dstInfo.width();
 
@@ -705,12 +976,14 @@ bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
 
     size_t totalBytes = swizzleBytes + xformBytes;
     if (totalBytes > 0) {
-        if (!fStorage.reset(totalBytes)) {
+        uint8_t* storage = static_cast<uint8_t*>(
+                SkCodecScratch::RowStorage(this->scratch(), &fStorage, totalBytes));
+        if (!storage) {
             return false;
         }
-        fSwizzleSrcRow = (swizzleBytes > 0) ? fStorage.get() : nullptr;
+        fSwizzleSrcRow = (swizzleBytes > 0) ? storage : nullptr;
         fColorXformSrcRow = (xformBytes > 0) ?
-                SkTAddOffset<uint32_t>(fStorage.get(), swizzleBytes) : nullptr;
+                SkTAddOffset<uint32_t>(storage, swizzleBytes) : nullptr;
     }
     return true;
 }
@@ -764,7 +1037,7 @@ void SkJpegCodec::initializeSwizzler(const SkImageInfo& dstInfo, const Options&
 
 SkSampler* SkJpegCodec::getSampler(bool createIfNecessary) {
     if (!createIfNecessary || fSwizzler) {
-        SkASSERT(!fSwizzler || (fSwizzleSrcRow && fStorage.get() == fSwizzleSrcRow));
+        SkASSERT(!fSwizzler || fSwizzleSrcRow);
         return fSwizzler.get();
     }
 
@@ -855,6 +1128,8 @@ int SkJpegCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
 }
 
 bool SkJpegCodec::onSkipScanlines(int count) {
+    this->startAtCheckpoint(&count);
+
     // Set the jump location for libjpeg errors
     skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
     if (setjmp(jmp)) {
@@ -864,6 +1139,170 @@ bool SkJpegCodec::onSkipScanlines(int count) {
     return (uint32_t) count == jpeg_skip_scanlines(fDecoderMgr->dinfo(), count);
 }
 
+SkCodec::Result SkJpegCodec::onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst,
+        size_t rowBytes, const Options& options) {
+    if (options.fSubset) {
+        // Subsets are not supported.
+        return kUnimplemented;
+    }
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+
+    // Set the jump location for libjpeg errors
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        return fDecoderMgr->returnFailure("setjmp", kInvalidInput);
+    }
+
+    // Otherwise jpeg_start_decompress() would wait for every scan before it could output a row.
+    dinfo->buffered_image = jpeg_has_multiple_scans(dinfo);
+    if (!jpeg_start_decompress(dinfo)) {
+        return fDecoderMgr->returnFailure("startDecompress", kInvalidInput);
+    }
+
+    if (needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                            this->getEncodedInfo().profile(), this->colorXform())) {
+        this->initializeSwizzler(dstInfo, options, true);
+    }
+
+    if (!this->allocateStorage(dstInfo)) {
+        return kInternalError;
+    }
+
+    fDecoderMgr->getSourceMgr()->setSuspending(true);
+    fIncrementalDst = dst;
+    fIncrementalRowBytes = rowBytes;
+    fIncrementalOutputScan = 0;
+    fIncrementalFinishingOutput = false;
+    return kSuccess;
+}
+
+int SkJpegCodec::incrementalRowsBefore(int srcRow) const {
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    const int startRow = get_start_coord(sampleY);
+    if (srcRow <= startRow) {
+        return 0;
+    }
+    const int rowsNeeded = get_scaled_dimension(fDecoderMgr->dinfo()->output_height, sampleY);
+    return std::min(rowsNeeded, (srcRow - startRow + sampleY - 1) / sampleY);
+}
+
+bool SkJpegCodec::readIncrementalRows(bool* hadError) {
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+
+    // Set the jump location for libjpeg errors
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        *hadError = true;
+        return false;
+    }
+
+    const int height = dinfo->output_height;
+    const int sampleY = fSwizzler ? fSwizzler->sampleY() : 1;
+    while (SkToInt(dinfo->output_scanline) < height) {
+        const int srcRow = dinfo->output_scanline;
+        const int dstRow = this->incrementalRowsBefore(srcRow);
+        if (sampleY == 1) {
+            // Every row is kept, so read as many as the input allows in one go.
+            const int count = height - srcRow;
+            void* dst = SkTAddOffset<void>(fIncrementalDst, fIncrementalRowBytes * dstRow);
+            if (this->readRows(this->dstInfo(), dst, fIncrementalRowBytes, count, this->options(),
+                               hadError) < count) {
+                return false;
+            }
+        } else if (fSwizzler->rowNeeded(srcRow) && dstRow < this->incrementalRowsBefore(height)) {
+            void* dst = SkTAddOffset<void>(fIncrementalDst, fIncrementalRowBytes * dstRow);
+            if (this->readRows(this->dstInfo(), dst, fIncrementalRowBytes, 1, this->options(),
+                               hadError) < 1) {
+                return false;
+            }
+        } else {
+            JSAMPLE* row = fSwizzleSrcRow;
+            if (0 == jpeg_read_scanlines(dinfo, &row, 1)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+SkCodec::Result SkJpegCodec::onIncrementalDecode(int* rowsDecoded) {
+    int unusedRowsDecoded;
+    if (!rowsDecoded) {
+        rowsDecoded = &unusedRowsDecoded;
+    }
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    const int height = dinfo->output_height;
+    bool hadError = false;
+
+    if (!dinfo->buffered_image) {
+        // Decode the rows that the data received so far completes.
+        const int firstRow = this->incrementalRowsBefore(dinfo->output_scanline);
+        bool done = this->readIncrementalRows(&hadError);
+        while (!done && !hadError && fDecoderMgr->resumeInput()) {
+            done = this->readIncrementalRows(&hadError);
+        }
+        const int rows = this->incrementalRowsBefore(dinfo->output_scanline);
+        this->markIncrementalRowsDirty(firstRow, rows);
+        if (done) {
+            return kSuccess;
+        }
+        *rowsDecoded = rows;
+        return hadError ? fDecoderMgr->returnFailure("readIncrementalRows", kErrorInInput)
+                        : kIncompleteInput;
+    }
+
+    // Set the jump location for libjpeg errors
+    skjpeg_error_mgr::AutoPushJmpBuf jmp(fDecoderMgr->errorMgr());
+    if (setjmp(jmp)) {
+        *rowsDecoded = fIncrementalOutputScan > 0 ? this->incrementalRowsBefore(height) : 0;
+        return fDecoderMgr->returnFailure("setjmp", kErrorInInput);
+    }
+
+    this->markIncrementalRowsDirty(0, 0);
+    while (true) {
+        // Read all of the data that has arrived, then show the last scan that it completes.
+        int status;
+        do {
+            status = jpeg_consume_input(dinfo);
+        } while (status != JPEG_SUSPENDED && status != JPEG_REACHED_EOI);
+
+        if (!fIncrementalFinishingOutput || jpeg_finish_output(dinfo)) {
+            fIncrementalFinishingOutput = false;
+
+            const bool inputComplete = jpeg_input_complete(dinfo);
+            int lastCompleteScan = dinfo->input_scan_number;
+            if (!inputComplete && dinfo->input_iMCU_row < dinfo->total_iMCU_rows) {
+                lastCompleteScan--;
+            }
+
+            if (lastCompleteScan > fIncrementalOutputScan) {
+                // Since the scan is complete, this does not wait for more input.
+                if (!jpeg_start_output(dinfo, lastCompleteScan) ||
+                    !this->readIncrementalRows(&hadError)) {
+                    *rowsDecoded = fIncrementalOutputScan > 0 ? this->incrementalRowsBefore(height)
+                                                              : 0;
+                    return fDecoderMgr->returnFailure("readIncrementalRows", kErrorInInput);
+                }
+                fIncrementalOutputScan = dinfo->output_scan_number;
+                fIncrementalFinishingOutput = true;
+                this->markIncrementalRowsDirty(0, this->incrementalRowsBefore(height));
+                continue;
+            }
+
+            if (inputComplete && fIncrementalOutputScan == dinfo->input_scan_number) {
+                return kSuccess;
+            }
+        }
+
+        if (!fDecoderMgr->resumeInput()) {
+            *rowsDecoded = fIncrementalOutputScan > 0 ? this->incrementalRowsBefore(height) : 0;
+            return kIncompleteInput;
+        }
+    }
+}
+
 static bool is_yuv_supported(const jpeg_decompress_struct* dinfo,
                              const SkJpegCodec& codec,
                              const SkYUVAPixmapInfo::SupportedDataTypes* supportedDataTypes,
@@ -1411,6 +1850,24 @@ std::unique_ptr<SkCodec> Decode(sk_sp<SkData> data,
     return Decode(SkMemoryStream::Make(std::move(data)), outResult, nullptr);
 }
 
+// SkJpegCodec is the only codec that reports kJPEG.
+static SkJpegCodec* as_jpeg_codec(SkCodec* codec) {
+    if (!codec || codec->getEncodedFormat() != SkEncodedImageFormat::kJPEG) {
+        return nullptr;
+    }
+    return static_cast<SkJpegCodec*>(codec);
+}
+
+sk_sp<SkData> BuildRegionIndex(SkCodec* codec) {
+    SkJpegCodec* jpegCodec = as_jpeg_codec(codec);
+    return jpegCodec ? jpegCodec->buildRegionIndex() : nullptr;
+}
+
+bool AttachRegionIndex(SkCodec* codec, const SkData& index) {
+    SkJpegCodec* jpegCodec = as_jpeg_codec(codec);
+    return jpegCodec && jpegCodec->attachRegionIndex(index);
+}
+
 }  // namespace SkJpegDecoder
 
 namespace SkJpegPriv {
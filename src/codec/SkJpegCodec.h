@@ -12,17 +12,22 @@
 #include "include/codec/SkEncodedImageFormat.h"
 #include "include/codec/SkEncodedOrigin.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 #include "include/core/SkYUVAPixmaps.h"
 #include "include/private/SkEncodedInfo.h"
 #include "include/private/base/SkTemplates.h"
+#include "src/codec/SkJpegRestartBands.h"
 
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 
 class JpegDecoderMgr;
+class SkData;
+class SkExecutor;
+class SkJpegSourceMgr;
 class SkSampler;
 class SkStream;
 class SkSwizzler;
@@ -46,6 +51,20 @@ public:
      */
     static std::unique_ptr<SkCodec> MakeFromStream(std::unique_ptr<SkStream>, Result*);
 
+    /*
+     * Implement SkJpegDecoder::BuildRegionIndex() and SkJpegDecoder::AttachRegionIndex().
+     */
+    sk_sp<SkData> buildRegionIndex();
+    bool attachRegionIndex(const SkData& index);
+
+    /*
+     * For tests: the number of bands the last getPixels() decoded in parallel, or 0 if it
+     * decoded serially, and whether the current scanline decode started at a region index
+     * checkpoint rather than at the top of the image.
+     */
+    int restartBandsDecodedForTesting() const { return fRestartBandsDecoded; }
+    bool startedAtCheckpointForTesting() const { return fStartedAtCheckpoint; }
+
 protected:
 
     /*
@@ -129,7 +148,37 @@ private:
     void initializeSwizzler(const SkImageInfo& dstInfo, const Options& options,
                             bool needsCMYKToRGB);
     [[nodiscard]] bool allocateStorage(const SkImageInfo& dstInfo);
-    int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&);
+    // Returns the number of rows read. If libjpeg reports an error, this sets *hadError (if not
+    // null) and stops; otherwise fewer than |count| rows means that the input ran out.
+    int readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count, const Options&,
+                 bool* hadError = nullptr);
+
+    /*
+     * Decodes the whole image in bands that start at restart markers, concurrently on |executor|.
+     * Returns false, having written nothing or only pixels that a serial decode will overwrite,
+     * if the image or the dst does not allow that.
+     */
+    bool decodeRestartBands(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                            SkExecutor& executor);
+    bool decodeRestartBand(std::unique_ptr<SkJpegSourceMgr> band, int skipRows, int count,
+                           const SkImageInfo& dstInfo, void* dst, size_t rowBytes) const;
+
+    /*
+     * Returns the encoded data if the stream holds it in memory, or nullptr.
+     */
+    sk_sp<SkData> getEncodedData();
+
+    /*
+     * Returns false if the image cannot be split into bands at its restart markers.
+     */
+    bool getRestartGeometry(SkJpegRestartBands::Geometry*);
+
+    /*
+     * Called at the start of a scanline decode that first skips *rowsToSkip rows. If there is a
+     * region index with a checkpoint far enough down, this switches to a decoder that starts
+     * there, and subtracts the rows above it from *rowsToSkip.
+     */
+    bool startAtCheckpoint(int* rowsToSkip);
 
     /*
      * Scanline decoding.
@@ -140,7 +189,29 @@ private:
     int onGetScanlines(void* dst, int count, size_t rowBytes) override;
     bool onSkipScanlines(int count) override;
 
+    /*
+     * Incremental decoding. A progressive (or other multi-scan) image is decoded in libjpeg's
+     * buffered-image mode, and shown once for each scan that has completely arrived.
+     */
+    Result onStartIncrementalDecode(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+            const Options&) override;
+    Result onIncrementalDecode(int* rowsDecoded) override;
+
+    /*
+     * Reads the rest of libjpeg's current output pass into fIncrementalDst, keeping the rows that
+     * the swizzler samples. Returns false if it stopped early, setting *hadError if that was due
+     * to an error rather than running out of input.
+     */
+    bool readIncrementalRows(bool* hadError);
+
+    // The number of rows of fIncrementalDst that come before source row |srcRow|.
+    int incrementalRowsBefore(int srcRow) const;
+
     std::unique_ptr<JpegDecoderMgr>    fDecoderMgr;
+    // Whether startAtCheckpoint() has switched fDecoderMgr to a band.
+    bool                               fStartedAtCheckpoint = false;
+    // How many bands decodeRestartBands() decoded for the last getPixels().
+    int                                fRestartBandsDecoded = 0;
 
     // We will save the state of the decompress struct after reading the header.
     // This allows us to safely call onGetScaledDimensions() at any time.
@@ -158,6 +229,18 @@ private:
 
     std::unique_ptr<SkSwizzler>        fSwizzler;
 
+    // Incremental decoding state. fIncrementalOutputScan is the scan of a multi-scan image that
+    // was last written to fIncrementalDst (0 if none), and fIncrementalFinishingOutput is set while
+    // jpeg_finish_output() waits for the next scan to start.
+    void*                              fIncrementalDst = nullptr;
+    size_t                             fIncrementalRowBytes = 0;
+    int                                fIncrementalOutputScan = 0;
+    bool                               fIncrementalFinishingOutput = false;
+
+    // The checkpoints of a region index, if one was built or attached, or the restart bands of
+    // the last parallel decode.
+    std::unique_ptr<SkJpegRestartBands> fRestartBands;
+
     friend class SkRawCodec;
 
     using INHERITED = SkCodec;
@@ -89,8 +89,15 @@ SkJpegSourceMgr* JpegDecoderMgr::getSourceMgr() {
     return fSrcMgr.fSourceMgr.get();
 }
 
+bool JpegDecoderMgr::resumeInput() {
+    return fSrcMgr.fSourceMgr->resumeInputBuffer(fSrcMgr.next_input_byte, fSrcMgr.bytes_in_buffer);
+}
+
 JpegDecoderMgr::JpegDecoderMgr(SkStream* stream)
-        : fSrcMgr(SkJpegSourceMgr::Make(stream)), fInit(false) {
+        : JpegDecoderMgr(SkJpegSourceMgr::Make(stream)) {}
+
+JpegDecoderMgr::JpegDecoderMgr(std::unique_ptr<SkJpegSourceMgr> sourceMgr)
+        : fSrcMgr(std::move(sourceMgr)), fInit(false) {
     // Error manager must be set before any calls to libjeg in order to handle failures
     fDInfo.err = jpeg_std_error(&fErrorMgr);
     fErrorMgr.error_exit = skjpeg_err_exit;
@@ -136,6 +143,10 @@ void JpegDecoderMgr::SourceMgr::SkipInputData(j_decompress_ptr dinfo, long num_b
 boolean JpegDecoderMgr::SourceMgr::FillInputBuffer(j_decompress_ptr dinfo) {
     JpegDecoderMgr::SourceMgr* src = (JpegDecoderMgr::SourceMgr*)dinfo->src;
     if (!src->fSourceMgr->fillInputBuffer(src->next_input_byte, src->bytes_in_buffer)) {
+        if (src->fSourceMgr->isSuspending()) {
+            // Leave the input where libjpeg will back up to, for resumeInput().
+            return false;
+        }
         SkCodecPrintf("Failure to fill input buffer.\n");
         src->next_input_byte = nullptr;
         src->bytes_in_buffer = 0;
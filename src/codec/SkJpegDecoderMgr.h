@@ -42,6 +42,11 @@ public:
      */
     JpegDecoderMgr(SkStream* stream);
 
+    /*
+     * Create the decode manager to read from sourceMgr
+     */
+    JpegDecoderMgr(std::unique_ptr<SkJpegSourceMgr> sourceMgr);
+
     /*
      * Initialize decompress struct
      * Initialize the source manager
@@ -72,6 +77,10 @@ public:
     // Get the source manager.
     SkJpegSourceMgr* getSourceMgr();
 
+    // After libjpeg suspends, give it the data that has arrived since. Returns false if there is
+    // none. See SkJpegSourceMgr::setSuspending().
+    bool resumeInput();
+
 private:
     // Wrapper that calls into the full SkJpegSourceMgr interface.
     struct SourceMgr : jpeg_source_mgr {
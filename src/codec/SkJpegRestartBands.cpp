@@ -0,0 +1,362 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkJpegRestartBands.h"
+
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTFitsIn.h"
+#include "include/private/base/SkTo.h"
+#include "src/codec/SkCodecPriv.h"
+#include "src/codec/SkJpegConstants.h"
+#include "src/codec/SkJpegSegmentScan.h"
+#include "src/codec/SkJpegSourceMgr.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// Baseline and extended sequential Huffman-coded frames. Every other frame type (progressive,
+// lossless, hierarchical and arithmetic-coded) is left to the serial decoder.
+static constexpr uint8_t kJpegMarkerBaselineFrame = 0xC0;
+static constexpr uint8_t kJpegMarkerExtendedFrame = 0xC1;
+// The restart markers RST0 through RST7, which count up modulo 8 through the scan.
+static constexpr uint8_t kJpegMarkerRestart0 = 0xD0;
+static constexpr uint8_t kJpegMarkerRestart7 = 0xD7;
+static constexpr int kJpegRestartMarkerCount = 8;
+// The image height follows the StartOfFrame marker, length, and sample precision.
+static constexpr size_t kJpegFrameHeightOffset = kJpegMarkerCodeSize +
+                                                 kJpegSegmentParameterLengthSize + 1;
+
+// serialize() writes these, the fields of the bands, and then each checkpoint offset, all as
+// native uint32_t.
+static constexpr uint32_t kIndexMagic = SkSetFourByteTag('S', 'k', 'J', 'R');
+static constexpr uint32_t kIndexVersion = 1;
+
+static bool is_frame_marker(uint8_t marker) {
+    // SOF0 through SOF15, except for DHT (0xC4), JPG (0xC8) and DAC (0xCC).
+    return marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+}
+
+static bool is_sequential_huffman_frame(uint8_t marker) {
+    return marker == kJpegMarkerBaselineFrame || marker == kJpegMarkerExtendedFrame;
+}
+
+static int read_frame_height(const uint8_t* sof) {
+    return (sof[kJpegFrameHeightOffset] << 8) | sof[kJpegFrameHeightOffset + 1];
+}
+
+// Returns the MCU row step between checkpoints: the rows that start a run of MCUs that is a
+// multiple of 8 restart intervals long.
+static int checkpoint_rows(const SkJpegRestartBands::Geometry& geometry) {
+    const int restartRun = kJpegRestartMarkerCount * geometry.restartInterval;
+    return restartRun / std::gcd(restartRun, geometry.mcusPerRow);
+}
+
+static bool valid_geometry(const SkJpegRestartBands::Geometry& geometry) {
+    return geometry.mcusPerRow > 0 && geometry.mcuRows > 0 && geometry.mcuHeight > 0 &&
+           geometry.restartInterval > 0 && geometry.restartInterval <= 0xFFFF;
+}
+
+static bool valid_image_height(const SkJpegRestartBands::Geometry& geometry, int height) {
+    return height > (geometry.mcuRows - 1) * geometry.mcuHeight &&
+           height <= geometry.mcuRows * geometry.mcuHeight;
+}
+
+bool SkJpegRestartBands::Geometry::operator==(const Geometry& that) const {
+    return mcusPerRow == that.mcusPerRow && mcuRows == that.mcuRows &&
+           mcuHeight == that.mcuHeight && restartInterval == that.restartInterval;
+}
+
+size_t SkJpegRestartBands::CountCheckpoints(const Geometry& geometry, int checkpointRows) {
+    return (geometry.mcuRows - 1) / checkpointRows;
+}
+
+std::unique_ptr<SkJpegRestartBands> SkJpegRestartBands::Make(sk_sp<SkData> jpeg,
+                                                             const Geometry& geometry) {
+    if (!jpeg || !valid_geometry(geometry)) {
+        return nullptr;
+    }
+    const int checkpointRows = checkpoint_rows(geometry);
+    const size_t checkpoints = CountCheckpoints(geometry, checkpointRows);
+    if (checkpoints == 0) {
+        return nullptr;
+    }
+
+    SkJpegSegmentScanner scanner(kJpegMarkerEndOfImage);
+    scanner.onBytes(jpeg->data(), jpeg->size());
+    if (!scanner.isDone()) {
+        return nullptr;
+    }
+
+    const uint8_t* bytes = jpeg->bytes();
+    const std::vector<SkJpegSegment>& segments = scanner.getSegments();
+    const SkJpegSegment* sof = nullptr;
+    const SkJpegSegment* sos = nullptr;
+    size_t eoiOffset = 0;
+    std::vector<size_t> restartOffsets;
+    for (const SkJpegSegment& segment : segments) {
+        if (!sos) {
+            if (is_frame_marker(segment.marker)) {
+                if (sof || !is_sequential_huffman_frame(segment.marker)) {
+                    return nullptr;
+                }
+                sof = &segment;
+            } else if (segment.marker == kJpegMarkerStartOfScan) {
+                sos = &segment;
+            }
+            continue;
+        }
+
+        // After the one scan there may only be its restart markers, then EndOfImage.
+        if (segment.marker == kJpegMarkerEndOfImage) {
+            eoiOffset = segment.offset;
+            break;
+        }
+        if (segment.marker !=
+            kJpegMarkerRestart0 + (restartOffsets.size() % kJpegRestartMarkerCount)) {
+            return nullptr;
+        }
+        SkASSERT(bytes[segment.offset] == 0xFF && bytes[segment.offset + 1] == segment.marker);
+        restartOffsets.push_back(segment.offset);
+    }
+    if (!sof || !sos || !eoiOffset ||
+        sof->parameterLength < kJpegFrameHeightOffset + 2 - kJpegMarkerCodeSize) {
+        return nullptr;
+    }
+
+    const int64_t mcus = (int64_t)geometry.mcusPerRow * geometry.mcuRows;
+    const int64_t intervals = (mcus + geometry.restartInterval - 1) / geometry.restartInterval;
+    if ((int64_t)restartOffsets.size() != intervals - 1) {
+        SkCodecPrintf("Found %zu restart markers, expected %lld.\n",
+                      restartOffsets.size(), (long long)(intervals - 1));
+        return nullptr;
+    }
+
+    const int imageHeight = read_frame_height(bytes + sof->offset);
+    if (!valid_image_height(geometry, imageHeight)) {
+        return nullptr;
+    }
+
+    // Keep just the markers that end the interval before each checkpoint.
+    std::vector<size_t> checkpointOffsets(checkpoints);
+    for (size_t i = 0; i < checkpoints; i++) {
+        const int64_t row = (int64_t)(i + 1) * checkpointRows;
+        const int64_t interval = row * geometry.mcusPerRow / geometry.restartInterval;
+        checkpointOffsets[i] = restartOffsets[interval - 1];
+    }
+
+    const size_t headerSize = sos->offset + kJpegMarkerCodeSize + sos->parameterLength;
+    return std::unique_ptr<SkJpegRestartBands>(new SkJpegRestartBands(
+            std::move(jpeg), geometry, checkpointRows, imageHeight, sof->offset, headerSize,
+            eoiOffset, std::move(checkpointOffsets)));
+}
+
+std::unique_ptr<SkJpegRestartBands> SkJpegRestartBands::MakeFromIndex(sk_sp<SkData> jpeg,
+                                                                      const Geometry& geometry,
+                                                                      const SkData& index) {
+    if (!jpeg || !valid_geometry(geometry)) {
+        return nullptr;
+    }
+    const int checkpointRows = checkpoint_rows(geometry);
+    const size_t checkpoints = CountCheckpoints(geometry, checkpointRows);
+
+    enum { kMagic, kVersion, kJpegSize, kMCUsPerRow, kMCURows, kMCUHeight, kRestartInterval,
+           kImageHeight, kSOFOffset, kHeaderSize, kEOIOffset, kCheckpoints, kFieldCount };
+    uint32_t fields[kFieldCount];
+    if (checkpoints == 0 || index.size() != sizeof(fields) + checkpoints * sizeof(uint32_t)) {
+        return nullptr;
+    }
+    memcpy(fields, index.data(), sizeof(fields));
+    const Geometry indexGeometry = {SkToInt(fields[kMCUsPerRow]), SkToInt(fields[kMCURows]),
+                                    SkToInt(fields[kMCUHeight]),
+                                    SkToInt(fields[kRestartInterval])};
+    if (fields[kMagic] != kIndexMagic || fields[kVersion] != kIndexVersion ||
+        fields[kJpegSize] != jpeg->size() || !(indexGeometry == geometry) ||
+        fields[kCheckpoints] != checkpoints) {
+        return nullptr;
+    }
+
+    // Check that the index points at the markers it says it does, so a stale or damaged index
+    // cannot send the decoder into the middle of the entropy-coded data.
+    const uint8_t* bytes = jpeg->bytes();
+    const size_t sofOffset = fields[kSOFOffset];
+    const size_t headerSize = fields[kHeaderSize];
+    const size_t eoiOffset = fields[kEOIOffset];
+    if (sofOffset + kJpegFrameHeightOffset + 2 > headerSize || headerSize > eoiOffset ||
+        eoiOffset + kJpegMarkerCodeSize > jpeg->size() ||
+        bytes[sofOffset] != 0xFF || !is_sequential_huffman_frame(bytes[sofOffset + 1]) ||
+        bytes[eoiOffset] != 0xFF || bytes[eoiOffset + 1] != kJpegMarkerEndOfImage) {
+        return nullptr;
+    }
+    const int imageHeight = read_frame_height(bytes + sofOffset);
+    if (SkToU32(imageHeight) != fields[kImageHeight] || !valid_image_height(geometry, imageHeight)) {
+        return nullptr;
+    }
+
+    std::vector<size_t> checkpointOffsets(checkpoints);
+    size_t previous = headerSize;
+    for (size_t i = 0; i < checkpoints; i++) {
+        uint32_t offset;
+        memcpy(&offset, index.bytes() + sizeof(fields) + i * sizeof(uint32_t), sizeof(offset));
+        if (offset < previous || offset + kJpegMarkerCodeSize > eoiOffset ||
+            bytes[offset] != 0xFF || bytes[offset + 1] != kJpegMarkerRestart7) {
+            return nullptr;
+        }
+        checkpointOffsets[i] = offset;
+        previous = offset + kJpegMarkerCodeSize;
+    }
+
+    return std::unique_ptr<SkJpegRestartBands>(new SkJpegRestartBands(
+            std::move(jpeg), geometry, checkpointRows, imageHeight, sofOffset, headerSize,
+            eoiOffset, std::move(checkpointOffsets)));
+}
+
+SkJpegRestartBands::SkJpegRestartBands(sk_sp<SkData> jpeg, const Geometry& geometry,
+                                       int checkpointRows, int imageHeight, size_t sofOffset,
+                                       size_t headerSize, size_t eoiOffset,
+                                       std::vector<size_t> checkpointOffsets)
+        : fJpeg(std::move(jpeg))
+        , fGeometry(geometry)
+        , fCheckpointRows(checkpointRows)
+        , fImageHeight(imageHeight)
+        , fSOFOffset(sofOffset)
+        , fHeaderSize(headerSize)
+        , fEOIOffset(eoiOffset)
+        , fCheckpointOffsets(std::move(checkpointOffsets)) {}
+
+sk_sp<SkData> SkJpegRestartBands::serialize() const {
+    if (!SkTFitsIn<uint32_t>(fJpeg->size())) {
+        return nullptr;
+    }
+    const uint32_t fields[] = {
+        kIndexMagic,
+        kIndexVersion,
+        SkToU32(fJpeg->size()),
+        SkToU32(fGeometry.mcusPerRow),
+        SkToU32(fGeometry.mcuRows),
+        SkToU32(fGeometry.mcuHeight),
+        SkToU32(fGeometry.restartInterval),
+        SkToU32(fImageHeight),
+        SkToU32(fSOFOffset),
+        SkToU32(fHeaderSize),
+        SkToU32(fEOIOffset),
+        SkToU32(fCheckpointOffsets.size()),
+    };
+    sk_sp<SkData> index = SkData::MakeUninitialized(
+            sizeof(fields) + fCheckpointOffsets.size() * sizeof(uint32_t));
+    uint8_t* dst = static_cast<uint8_t*>(index->writable_data());
+    memcpy(dst, fields, sizeof(fields));
+    dst += sizeof(fields);
+    for (size_t offset : fCheckpointOffsets) {
+        const uint32_t offset32 = SkToU32(offset);
+        memcpy(dst, &offset32, sizeof(offset32));
+        dst += sizeof(offset32);
+    }
+    return index;
+}
+
+namespace {
+// Feeds libjpeg a band as a few spans of memory in turn: the band's copy of the headers, the
+// entropy-coded data where it is in the original JPEG, and an EndOfImage marker.
+class BandSourceMgr final : public SkJpegSourceMgr {
+public:
+    BandSourceMgr(sk_sp<SkData> jpeg, sk_sp<SkData> header, size_t entropyStart,
+                  size_t entropySize)
+            : SkJpegSourceMgr(nullptr), fJpeg(std::move(jpeg)), fHeader(std::move(header)) {
+        fSpans[0] = {fHeader->bytes(), fHeader->size()};
+        fSpans[1] = {fJpeg->bytes() + entropyStart, entropySize};
+        fSpans[2] = {kEndOfImage, sizeof(kEndOfImage)};
+    }
+
+    void initSource(const uint8_t*& nextInputByte, size_t& bytesInBuffer) override {
+        fNextSpan = 0;
+        bytesInBuffer = 0;
+        this->fillInputBuffer(nextInputByte, bytesInBuffer);
+    }
+    bool fillInputBuffer(const uint8_t*& nextInputByte, size_t& bytesInBuffer) override {
+        // libjpeg needs at least one byte.
+        while (fNextSpan < kSpanCount) {
+            const Span& span = fSpans[fNextSpan++];
+            if (span.fSize > 0) {
+                nextInputByte = span.fBytes;
+                bytesInBuffer = span.fSize;
+                return true;
+            }
+        }
+        SkCodecPrintf("Hit end of band.\n");
+        return false;
+    }
+    bool skipInputBytes(size_t bytesToSkip,
+                        const uint8_t*& nextInputByte,
+                        size_t& bytesInBuffer) override {
+        while (bytesToSkip > bytesInBuffer) {
+            bytesToSkip -= bytesInBuffer;
+            if (!this->fillInputBuffer(nextInputByte, bytesInBuffer)) {
+                return false;
+            }
+        }
+        nextInputByte += bytesToSkip;
+        bytesInBuffer -= bytesToSkip;
+        return true;
+    }
+
+#ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
+    // Bands are only decoded, so they are never asked for segments.
+    const std::vector<SkJpegSegment>& getAllSegments() override { return fNoSegments; }
+    sk_sp<SkData> getSubsetData(size_t, size_t, bool*) override { return nullptr; }
+    sk_sp<SkData> getSegmentParameters(const SkJpegSegment&) override { return nullptr; }
+#endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
+
+private:
+    static constexpr uint8_t kEndOfImage[] = {0xFF, kJpegMarkerEndOfImage};
+    static constexpr int kSpanCount = 3;
+
+    struct Span {
+        const uint8_t* fBytes;
+        size_t         fSize;
+    };
+
+    const sk_sp<SkData> fJpeg;
+    const sk_sp<SkData> fHeader;
+    Span                fSpans[kSpanCount];
+    int                 fNextSpan = 0;
+#ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
+    const std::vector<SkJpegSegment> fNoSegments;
+#endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
+};
+}  // namespace
+
+std::unique_ptr<SkJpegSourceMgr> SkJpegRestartBands::makeBand(int startRow, int endRow) const {
+    SkASSERT(0 <= startRow && startRow < endRow && endRow <= fGeometry.mcuRows);
+    SkASSERT(startRow % fCheckpointRows == 0);
+    SkASSERT(endRow % fCheckpointRows == 0 || endRow == fGeometry.mcuRows);
+
+    // The data before checkpoint i + 1 ends at fCheckpointOffsets[i], and the data after it
+    // starts just past that marker.
+    const int startCheckpoint = startRow / fCheckpointRows;
+    const int endCheckpoint = endRow / fCheckpointRows;
+    const size_t entropyStart =
+            startCheckpoint == 0 ? fHeaderSize
+                                 : fCheckpointOffsets[startCheckpoint - 1] + kJpegMarkerCodeSize;
+    const size_t entropyEnd = endRow == fGeometry.mcuRows ? fEOIOffset
+                                                          : fCheckpointOffsets[endCheckpoint - 1];
+    SkASSERT(entropyStart <= entropyEnd);
+
+    sk_sp<SkData> header = SkData::MakeWithCopy(fJpeg->bytes(), fHeaderSize);
+    uint8_t* dst = static_cast<uint8_t*>(header->writable_data());
+    const int height = std::min(endRow * fGeometry.mcuHeight, fImageHeight) -
+                       startRow * fGeometry.mcuHeight;
+    dst[fSOFOffset + kJpegFrameHeightOffset]     = static_cast<uint8_t>(height >> 8);
+    dst[fSOFOffset + kJpegFrameHeightOffset + 1] = static_cast<uint8_t>(height);
+
+    return std::make_unique<BandSourceMgr>(fJpeg, std::move(header), entropyStart,
+                                           entropyEnd - entropyStart);
+}
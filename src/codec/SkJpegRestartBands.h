@@ -0,0 +1,106 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkJpegRestartBands_codec_DEFINED
+#define SkJpegRestartBands_codec_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class SkJpegSourceMgr;
+
+/*
+ * Splits a sequential, single-scan JPEG at its restart markers, so that horizontal bands of MCU
+ * rows can be decoded independently of each other. Entropy decoding restarts from scratch after
+ * every restart marker: the bit buffer is flushed and the DC predictors are reset. So the data
+ * between two markers needs nothing from the data before it.
+ *
+ * Bands start at checkpoints: MCU rows that begin right after a restart marker, and after a
+ * multiple of 8 restart intervals. The markers count RST0 through RST7 and back, so the data from
+ * a checkpoint on is numbered just as libjpeg-turbo expects at the start of a scan. Each band is
+ * repackaged as a JPEG of its own: the headers of the original with the image height cut down to
+ * the band, then the band's entropy-coded data, and an EndOfImage marker.
+ */
+class SkJpegRestartBands {
+public:
+    // The layout of the scan, as computed by libjpeg-turbo from the headers.
+    struct Geometry {
+        // The number of MCUs in each row, and the number of MCU rows in the image.
+        int mcusPerRow = 0;
+        int mcuRows = 0;
+        // The height of an MCU row in pixels.
+        int mcuHeight = 0;
+        // The number of MCUs between restart markers.
+        int restartInterval = 0;
+
+        bool operator==(const Geometry&) const;
+    };
+
+    /*
+     * Returns nullptr unless |jpeg| is a single scan with a restart marker after every
+     * |restartInterval| MCUs, and has at least one checkpoint after the first MCU row.
+     */
+    static std::unique_ptr<SkJpegRestartBands> Make(sk_sp<SkData> jpeg, const Geometry& geometry);
+
+    /*
+     * Recreates the bands of |jpeg| from serialize(), without scanning it. Returns nullptr if
+     * |index| is not from serialize(), or does not match |jpeg| and |geometry|.
+     */
+    static std::unique_ptr<SkJpegRestartBands> MakeFromIndex(sk_sp<SkData> jpeg,
+                                                             const Geometry& geometry,
+                                                             const SkData& index);
+
+    /*
+     * Returns the checkpoints in a form that can be stored with the encoded data and passed to
+     * MakeFromIndex().
+     */
+    sk_sp<SkData> serialize() const;
+
+    /*
+     * Bands start and end on multiples of this many MCU rows.
+     */
+    int checkpointRows() const { return fCheckpointRows; }
+
+    /*
+     * Returns a source of a JPEG of MCU rows [startRow, endRow) of the image. Both must be
+     * multiples of checkpointRows(), except that endRow may be the last MCU row of the image.
+     * The source copies the headers, to cut the height down to the band, and reads the band's
+     * entropy-coded data in place.
+     */
+    std::unique_ptr<SkJpegSourceMgr> makeBand(int startRow, int endRow) const;
+
+    /*
+     * The number of bytes that makeBand() copies.
+     */
+    size_t bandHeaderSize() const { return fHeaderSize; }
+
+private:
+    SkJpegRestartBands(sk_sp<SkData> jpeg, const Geometry& geometry, int checkpointRows,
+                       int imageHeight, size_t sofOffset, size_t headerSize, size_t eoiOffset,
+                       std::vector<size_t> checkpointOffsets);
+
+    // Returns the number of checkpoints after the first MCU row.
+    static size_t CountCheckpoints(const Geometry&, int checkpointRows);
+
+    const sk_sp<SkData>       fJpeg;
+    const Geometry            fGeometry;
+    const int                 fCheckpointRows;
+    const int                 fImageHeight;
+    // The offset of the StartOfFrame segment, which holds the image height.
+    const size_t              fSOFOffset;
+    // Everything before the entropy-coded data, through the end of the StartOfScan segment.
+    const size_t              fHeaderSize;
+    const size_t              fEOIOffset;
+    // The offset of the restart marker just before each checkpoint after the first MCU row.
+    const std::vector<size_t> fCheckpointOffsets;
+};
+
+#endif
@@ -18,6 +18,9 @@
 #include "src/codec/SkJpegSegmentScan.h"
 #endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
 
+#include <cstring>
+#include <utility>
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 // SkStream helpers.
 
@@ -132,12 +135,19 @@ public:
         bytesInBuffer = 0;
     }
     bool fillInputBuffer(const uint8_t*& nextInputByte, size_t& bytesInBuffer) override {
+        if (fSuspending) {
+            // Reading over fBuffer would lose the bytes that libjpeg backs up to when it suspends.
+            return false;
+        }
         size_t bytesRead = fStream->read(fBuffer->writable_data(), fBuffer->size());
         if (bytesRead == 0) {
             // Fail if we read zero bytes (libjpeg will accept any non-zero number of bytes).
             SkCodecPrintf("Hit end of file reading a buffered stream.\n");
             return false;
         }
+        if (fBytesCopied) {
+            *fBytesCopied += bytesRead;
+        }
         nextInputByte = fBuffer->bytes();
         bytesInBuffer = bytesRead;
         return true;
@@ -153,6 +163,14 @@ public:
         }
         bytesToSkip -= bytesInBuffer;
 
+        if (fSuspending) {
+            // libjpeg cannot suspend in the middle of a skip, so finish it when resuming.
+            fPendingSkip = bytesToSkip;
+            bytesInBuffer = 0;
+            nextInputByte = fBuffer->bytes();
+            return true;
+        }
+
         // Fail if we skip past the end of the stream.
         if (fStream->skip(bytesToSkip) != bytesToSkip) {
             SkCodecPrintf("Failed to skip through buffered stream.\n");
@@ -163,6 +181,42 @@ public:
         nextInputByte = fBuffer->bytes();
         return true;
     }
+    bool resumeInputBuffer(const uint8_t*& nextInputByte, size_t& bytesInBuffer) override {
+        if (fPendingSkip > 0) {
+            fPendingSkip -= fStream->skip(fPendingSkip);
+            if (fPendingSkip > 0) {
+                return false;
+            }
+        }
+
+        // Move the bytes libjpeg has not consumed to the front of fBuffer, growing it if they
+        // leave little room, since libjpeg needs a whole marker segment or MCU before it can
+        // make progress.
+        if (bytesInBuffer > fBuffer->size() / 2) {
+            sk_sp<SkData> buffer = SkData::MakeUninitialized(2 * fBuffer->size());
+            memcpy(buffer->writable_data(), nextInputByte, bytesInBuffer);
+            fBuffer = std::move(buffer);
+        } else if (bytesInBuffer > 0) {
+            memmove(fBuffer->writable_data(), nextInputByte, bytesInBuffer);
+        }
+        nextInputByte = fBuffer->bytes();
+
+        uint8_t* const data = static_cast<uint8_t*>(fBuffer->writable_data());
+        size_t bytesRead = 0;
+        while (bytesInBuffer + bytesRead < fBuffer->size()) {
+            const size_t n = fStream->read(data + bytesInBuffer + bytesRead,
+                                           fBuffer->size() - bytesInBuffer - bytesRead);
+            if (n == 0) {
+                break;
+            }
+            bytesRead += n;
+        }
+        if (fBytesCopied) {
+            *fBytesCopied += bytesRead;
+        }
+        bytesInBuffer += bytesRead;
+        return bytesRead > 0;
+    }
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
     const std::vector<SkJpegSegment>& getAllSegments() override {
         if (fScanner) {
@@ -243,6 +297,9 @@ public:
 
 private:
     sk_sp<SkData> fBuffer;
+
+    // Bytes that libjpeg skipped past the end of fBuffer while suspending.
+    size_t fPendingSkip = 0;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -402,6 +459,9 @@ private:
             SkCodecPrintf("Hit end of file reading an unseekable stream.\n");
             return false;
         }
+        if (fBytesCopied) {
+            *fBytesCopied += fLastReadSize;
+        }
         fScanner->onBytes(fBuffer->bytes(), fLastReadSize);
         return true;
     }
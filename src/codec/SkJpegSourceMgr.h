@@ -48,6 +48,20 @@ public:
                                 const uint8_t*& nextInputByte,
                                 size_t& bytesInBuffer) = 0;
 
+    // Adds the number of bytes that this copies out of the stream into its own buffer to
+    // *counter. Sources that read the stream where it is in memory copy nothing.
+    void setBytesCopiedCounter(size_t* counter) { fBytesCopied = counter; }
+
+    // While suspending, running out of data makes libjpeg suspend (rather than fail), with its
+    // input pointers left at the point it will resume from. resumeInputBuffer() then adds the data
+    // that the stream has received since, keeping the unconsumed bytes libjpeg will back up to. It
+    // returns false if there is no new data, or if this source cannot resume.
+    void setSuspending(bool suspending) { fSuspending = suspending; }
+    bool isSuspending() const { return fSuspending; }
+    virtual bool resumeInputBuffer(const uint8_t*& nextInputByte, size_t& bytesInBuffer) {
+        return false;
+    }
+
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
     // Parse this stream all the way through its EndOfImage marker and return the list of segments.
     // Return false if there is an error or if no EndOfImage marker is found.
@@ -67,6 +81,8 @@ public:
 protected:
     SkJpegSourceMgr(SkStream* stream);
     SkStream* const fStream;  // unowned
+    size_t* fBytesCopied = nullptr;  // unowned
+    bool fSuspending = false;
 
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
     // The segment scanner is lazily creatd only when needed.
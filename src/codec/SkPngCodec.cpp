@@ -20,13 +20,16 @@
 #include "include/core/SkTypes.h"
 #include "include/private/SkEncodedInfo.h"
 #include "include/private/base/SkNoncopyable.h"
+#include "include/private/base/SkOnce.h"
 #include "include/private/base/SkTemplates.h"
 #include "modules/skcms/skcms.h"
 #include "src/codec/SkCodecPriv.h"
+#include "src/codec/SkCodecScratch.h"
 #include "src/codec/SkColorPalette.h"
 #include "src/codec/SkPngPriv.h"
 #include "src/codec/SkSwizzler.h"
 #include "src/core/SkMemset.h"
+#include "src/core/SkPngFilters.h"
 #include "src/core/SkSwizzlePriv.h"
 
 #include <csetjmp>
@@ -37,6 +40,10 @@
 #include <png.h>
 #include <pngconf.h>
 
+#if defined(SK_LIBPNG_HAS_SKIA_FILTERS)
+    #include "skia_png_filters.h"
+#endif
+
 using namespace skia_private;
 
 class SkSampler;
@@ -148,18 +155,27 @@ static inline bool is_chunk(const png_byte* chunk, const char* tag) {
     return memcmp(chunk + 4, tag, 4) == 0;
 }
 
-static inline bool process_data(png_structp png_ptr, png_infop info_ptr,
-        SkStream* stream, void* buffer, size_t bufferSize, size_t length) {
-    while (length > 0) {
-        const size_t bytesToProcess = std::min(bufferSize, length);
-        const size_t bytesRead = stream->read(buffer, bytesToProcess);
-        png_process_data(png_ptr, info_ptr, (png_bytep) buffer, bytesRead);
+// libpng only reads the data that it is given, so that may be the stream's own memory. Returns
+// how many of the length bytes were processed, which is fewer if the stream ran out.
+static inline size_t process_data(png_structp png_ptr, png_infop info_ptr,
+        SkStream* stream, void* buffer, size_t bufferSize, size_t length, size_t* bytesCopied) {
+    if (stream->getMemoryBase() && stream->hasPosition()) {
+        // Nothing is copied into buffer, so there is no need to stop at its size.
+        bufferSize = length;
+    }
+    size_t bytesProcessed = 0;
+    while (bytesProcessed < length) {
+        const size_t bytesToProcess = std::min(bufferSize, length - bytesProcessed);
+        const uint8_t* bytes;
+        const size_t bytesRead =
+                read_in_place(stream, buffer, bytesToProcess, &bytes, bytesCopied);
+        png_process_data(png_ptr, info_ptr, const_cast<png_bytep>(bytes), bytesRead);
+        bytesProcessed += bytesRead;
         if (bytesRead < bytesToProcess) {
-            return false;
+            break;
         }
-        length -= bytesToProcess;
     }
-    return true;
+    return bytesProcessed;
 }
 
 bool AutoCleanPng::decodeBounds() {
@@ -176,23 +192,24 @@ bool AutoCleanPng::decodeBounds() {
     constexpr size_t kBufferSize = 4096;
     char buffer[kBufferSize];
 
+    const uint8_t* bytes;
     {
         // Parse the signature.
-        if (fStream->read(buffer, 8) < 8) {
+        if (read_in_place(fStream, buffer, 8, &bytes, nullptr) < 8) {
             return false;
         }
 
-        png_process_data(fPng_ptr, fInfo_ptr, (png_bytep) buffer, 8);
+        png_process_data(fPng_ptr, fInfo_ptr, const_cast<png_bytep>(bytes), 8);
     }
 
     while (true) {
         // Parse chunk length and type.
-        if (fStream->read(buffer, 8) < 8) {
+        if (read_in_place(fStream, buffer, 8, &bytes, nullptr) < 8) {
             // We have read to the end of the input without decoding bounds.
             break;
         }
 
-        png_byte* chunk = reinterpret_cast<png_byte*>(buffer);
+        png_byte* chunk = const_cast<png_byte*>(bytes);
         const size_t length = png_get_uint_32(chunk);
 
         if (is_chunk(chunk, "IDAT")) {
@@ -202,7 +219,8 @@ bool AutoCleanPng::decodeBounds() {
 
         png_process_data(fPng_ptr, fInfo_ptr, chunk, 8);
         // Process the full chunk + CRC.
-        if (!process_data(fPng_ptr, fInfo_ptr, fStream, buffer, kBufferSize, length + 4)) {
+        if (process_data(fPng_ptr, fInfo_ptr, fStream, buffer, kBufferSize, length + 4,
+                         nullptr) < length + 4) {
             return false;
         }
     }
@@ -231,33 +249,42 @@ bool SkPngCodec::processData() {
     constexpr size_t kBufferSize = 4096;
     char buffer[kBufferSize];
 
-    bool iend = false;
-    while (true) {
-        size_t length;
-        if (fDecodedIdat) {
-            // Parse chunk length and type.
-            if (this->stream()->read(buffer, 8) < 8) {
-                break;
-            }
+    size_t* bytesCopied = this->bytesCopiedFromStreamCounter();
+    while (!fChunkIsIend || fChunkBytesLeft > 0) {
+        if (0 == fChunkBytesLeft) {
+            if (fDecodedIdat) {
+                // Parse chunk length and type. When the data is arriving incrementally, these
+                // may be split across calls.
+                const uint8_t* bytes;
+                const size_t bytesRead = read_in_place(this->stream(), buffer,
+                                                       kChunkHeaderSize - fChunkHeaderBytes,
+                                                       &bytes, bytesCopied);
+                memcpy(fChunkHeader + fChunkHeaderBytes, bytes, bytesRead);
+                fChunkHeaderBytes += bytesRead;
+                if (fChunkHeaderBytes < kChunkHeaderSize) {
+                    break;
+                }
+                fChunkHeaderBytes = 0;
 
-            png_byte* chunk = reinterpret_cast<png_byte*>(buffer);
-            png_process_data(fPng_ptr, fInfo_ptr, chunk, 8);
-            if (is_chunk(chunk, "IEND")) {
-                iend = true;
+                png_process_data(fPng_ptr, fInfo_ptr, fChunkHeader, kChunkHeaderSize);
+                fChunkIsIend = is_chunk(fChunkHeader, "IEND");
+                fChunkBytesLeft = png_get_uint_32(fChunkHeader);
+            } else {
+                png_byte idat[] = {0, 0, 0, 0, 'I', 'D', 'A', 'T'};
+                png_save_uint_32(idat, fIdatLength);
+                png_process_data(fPng_ptr, fInfo_ptr, idat, 8);
+                fDecodedIdat = true;
+                fChunkBytesLeft = fIdatLength;
             }
-
-            length = png_get_uint_32(chunk);
-        } else {
-            length = fIdatLength;
-            png_byte idat[] = {0, 0, 0, 0, 'I', 'D', 'A', 'T'};
-            png_save_uint_32(idat, length);
-            png_process_data(fPng_ptr, fInfo_ptr, idat, 8);
-            fDecodedIdat = true;
+            // The CRC follows the chunk.
+            fChunkBytesLeft += 4;
         }
 
-        // Process the full chunk + CRC.
-        if (!process_data(fPng_ptr, fInfo_ptr, this->stream(), buffer, kBufferSize, length + 4)
-                || iend) {
+        // Process the rest of the chunk + CRC, or as much of it as the stream has.
+        const size_t bytesProcessed = process_data(fPng_ptr, fInfo_ptr, this->stream(), buffer,
+                                                   kBufferSize, fChunkBytesLeft, bytesCopied);
+        fChunkBytesLeft -= bytesProcessed;
+        if (fChunkBytesLeft > 0) {
             break;
         }
     }
@@ -461,8 +488,8 @@ void SkPngCodec::allocateStorage(const SkImageInfo& dstInfo) {
             // extra precision.  Otherwise, we will swizzle to RGBA_8888 before transforming.
             const size_t bytesPerPixel = (bitsPerPixel > 32) ? bitsPerPixel / 8 : 4;
             const size_t colorXformBytes = dstInfo.width() * bytesPerPixel;
-            fStorage.reset(colorXformBytes);
-            fColorXformSrcRow = fStorage.get();
+            fColorXformSrcRow = SkCodecScratch::RowStorage(this->scratch(), &fStorage,
+                                                           colorXformBytes);
             break;
         }
     }
@@ -498,6 +525,30 @@ void SkPngCodec::applyXformRow(void* dst, const void* src) {
     }
 }
 
+void SkPngCodec::applyXformRows(void* dst, size_t dstRowBytes, const void* src,
+                                size_t srcRowBytes, int count) {
+    switch (fXformMode) {
+        case kSwizzleOnly_XformMode:
+            fSwizzler->swizzleRows(dst, dstRowBytes, (const uint8_t*) src, srcRowBytes, count);
+            return;
+        case kColorOnly_XformMode:
+            if (srcRowBytes * 8 == (size_t) fXformWidth * this->getEncodedInfo().bitsPerPixel() &&
+                dstRowBytes == this->dstInfo().minRowBytes()) {
+                // Transform rows with no padding between them in one go.
+                this->applyColorXform(dst, src, fXformWidth * count);
+                return;
+            }
+            break;
+        case kSwizzleColor_XformMode:
+            break;
+    }
+    for (int y = 0; y < count; y++) {
+        this->applyXformRow(dst, src);
+        dst = SkTAddOffset<void>(dst, dstRowBytes);
+        src = SkTAddOffset<const void>(src, srcRowBytes);
+    }
+}
+
 static SkCodec::Result log_and_return_error(bool success) {
     if (success) return SkCodec::kIncompleteInput;
 #ifdef SK_BUILD_FOR_ANDROID_FRAMEWORK
@@ -587,7 +638,9 @@ private:
             fRowsNeeded = get_scaled_dimension(fLastRow - fFirstRow + 1, sampleY);
         }
 
+        const int firstNewRow = fRowsWrittenToOutput;
         const bool success = this->processData();
+        this->markIncrementalRowsDirty(firstNewRow, fRowsWrittenToOutput);
         if (success && fRowsWrittenToOutput == fRowsNeeded) {
             return kSuccess;
         }
@@ -634,6 +687,8 @@ public:
         , fLinesDecoded(0)
         , fInterlacedComplete(false)
         , fPng_rowbytes(0)
+        , fDirtyBegin(0)
+        , fDirtyEnd(0)
     {}
 
     static void InterlacedRowCallback(png_structp png_ptr, png_bytep row, png_uint_32 rowNum, int pass) {
@@ -652,6 +707,10 @@ private:
     size_t                  fPng_rowbytes;
     AutoTMalloc<png_byte> fInterlaceBuffer;
 
+    // The rows of fInterlaceBuffer that have changed since they were last written to fDst.
+    int                     fDirtyBegin;
+    int                     fDirtyEnd;
+
     using INHERITED = SkPngCodec;
 
     // FIXME: Currently sharing interlaced callback for all rows and subset. It's not
@@ -665,6 +724,18 @@ private:
 
         png_bytep oldRow = fInterlaceBuffer.get() + (rowNum - fFirstRow) * fPng_rowbytes;
         png_progressive_combine_row(this->png_ptr(), oldRow, row);
+        if (row) {
+            // libpng passes no row for rows that this pass does not touch.
+            // A new pass starts over at the top, so this may be above the current range.
+            const int bufferRow = rowNum - fFirstRow;
+            if (fDirtyBegin == fDirtyEnd) {
+                fDirtyBegin = bufferRow;
+                fDirtyEnd = bufferRow + 1;
+            } else {
+                fDirtyBegin = std::min(fDirtyBegin, bufferRow);
+                fDirtyEnd = std::max(fDirtyEnd, bufferRow + 1);
+            }
+        }
 
         if (0 == pass) {
             // The first pass initializes all rows.
@@ -699,13 +770,7 @@ private:
         fLinesDecoded = 0;
 
         const bool success = this->processData();
-        png_bytep srcRow = fInterlaceBuffer.get();
-        // FIXME: When resuming, this may rewrite rows that did not change.
-        for (int rowNum = 0; rowNum < fLinesDecoded; rowNum++) {
-            this->applyXformRow(dst, srcRow);
-            dst = SkTAddOffset<void>(dst, rowBytes);
-            srcRow = SkTAddOffset<png_byte>(srcRow, fPng_rowbytes);
-        }
+        this->applyXformRows(dst, rowBytes, fInterlaceBuffer.get(), fPng_rowbytes, fLinesDecoded);
         if (success && fInterlacedComplete) {
             return kSuccess;
         }
@@ -731,8 +796,8 @@ private:
     Result decode(int* rowsDecoded) override {
         const bool success = this->processData();
 
-        // Now apply Xforms on all the rows that were decoded.
         if (!fLinesDecoded) {
+            this->markIncrementalRowsDirty(0, 0);
             if (rowsDecoded) {
                 *rowsDecoded = 0;
             }
@@ -742,22 +807,26 @@ private:
         const int sampleY = this->swizzler() ? this->swizzler()->sampleY() : 1;
         const int rowsNeeded = get_scaled_dimension(fLastRow - fFirstRow + 1, sampleY);
 
-        // FIXME: For resuming interlace, we may swizzle a row that hasn't changed. But it
-        // may be too tricky/expensive to handle that correctly.
-
-        // Offset srcRow by get_start_coord rows. We do not need to account for fFirstRow,
-        // since the first row in fInterlaceBuffer corresponds to fFirstRow.
-        int srcRow = get_start_coord(sampleY);
-        void* dst = fDst;
-        int rowsWrittenToOutput = 0;
-        while (rowsWrittenToOutput < rowsNeeded && srcRow < fLinesDecoded) {
-            png_bytep src = SkTAddOffset<png_byte>(fInterlaceBuffer.get(), fPng_rowbytes * srcRow);
-            this->applyXformRow(dst, src);
-            dst = SkTAddOffset<void>(dst, fRowBytes);
-
-            rowsWrittenToOutput++;
-            srcRow += sampleY;
+        // Output row y comes from row startRow + y * sampleY of fInterlaceBuffer. We do not need
+        // to account for fFirstRow, since the first row in fInterlaceBuffer corresponds to it.
+        const int startRow = get_start_coord(sampleY);
+        auto outputRowsBefore = [&](int bufferRow) {
+            return bufferRow <= startRow
+                    ? 0 : std::min(rowsNeeded, (bufferRow - startRow + sampleY - 1) / sampleY);
+        };
+
+        // Only write the rows that changed since the last call, all at once.
+        const int firstDirtyRow = outputRowsBefore(fDirtyBegin),
+                  endDirtyRow = outputRowsBefore(fDirtyEnd);
+        if (firstDirtyRow < endDirtyRow) {
+            this->applyXformRows(
+                    SkTAddOffset<void>(fDst, fRowBytes * firstDirtyRow), fRowBytes,
+                    fInterlaceBuffer.get() + fPng_rowbytes * (startRow + firstDirtyRow * sampleY),
+                    fPng_rowbytes * sampleY, endDirtyRow - firstDirtyRow);
         }
+        this->markIncrementalRowsDirty(firstDirtyRow, endDirtyRow);
+        fDirtyBegin = fDirtyEnd = 0;
+        const int rowsWrittenToOutput = outputRowsBefore(fLinesDecoded);
 
         if (success && fInterlacedComplete) {
             return kSuccess;
@@ -773,6 +842,7 @@ private:
         fPng_rowbytes = png_get_rowbytes(this->png_ptr(), this->info_ptr());
         fInterlaceBuffer.reset(fPng_rowbytes * height);
         fInterlacedComplete = false;
+        fDirtyBegin = fDirtyEnd = 0;
     }
 };
 
@@ -795,6 +865,21 @@ private:
 static SkCodec::Result read_header(SkStream* stream, SkPngChunkReader* chunkReader,
                                    SkCodec** outCodec,
                                    png_structp* png_ptrp, png_infop* info_ptrp) {
+#if defined(SK_LIBPNG_HAS_SKIA_FILTERS)
+    // Every PNG we read goes through here first, so this installs SkOpts' unfilter functions
+    // before we read any rows. Other code reading PNGs with libpng, perhaps at the same time,
+    // picks them up for images it starts after this.
+    static SkOnce once;
+    once([] {
+        SkOpts::Init_PngFilters();
+        skia_png_set_unfilter_row([](int filter, unsigned char* row, const unsigned char* prev,
+                                     size_t rowBytes, size_t bpp) {
+            SkOpts::png_unfilter_row(static_cast<SkPngFilterType>(filter), row, prev, rowBytes,
+                                     bpp);
+        });
+    });
+#endif
+
     // The image is known to be a PNG. Decode enough to know the SkImageInfo.
     png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr,
                                                  sk_error_fn, sk_warning_fn);
@@ -1012,6 +1097,9 @@ SkPngCodec::SkPngCodec(SkEncodedInfo&& encodedInfo, std::unique_ptr<SkStream> st
     , fBitDepth(bitDepth)
     , fIdatLength(0)
     , fDecodedIdat(false)
+    , fChunkHeaderBytes(0)
+    , fChunkBytesLeft(0)
+    , fChunkIsIend(false)
 {}
 
 SkPngCodec::~SkPngCodec() {
@@ -1165,6 +1253,9 @@ bool SkPngCodec::onRewind() {
     fPng_ptr = png_ptr;
     fInfo_ptr = info_ptr;
     fDecodedIdat = false;
+    fChunkHeaderBytes = 0;
+    fChunkBytesLeft = 0;
+    fChunkIsIend = false;
     return true;
 }
 
@@ -61,6 +61,8 @@ protected:
 
     SkSampler* getSampler(bool createIfNecessary) override;
     void applyXformRow(void* dst, const void* src);
+    void applyXformRows(void* dst, size_t dstRowBytes, const void* src, size_t srcRowBytes,
+                        int count);
 
     voidp png_ptr() { return fPng_ptr; }
     voidp info_ptr() { return fInfo_ptr; }
@@ -123,6 +125,14 @@ private:
     size_t                         fIdatLength;
     bool                           fDecodedIdat;
 
+    // The chunk that processData() was in the middle of when the stream ran out of data, so that
+    // it can pick up where it left off once more has arrived.
+    static constexpr size_t        kChunkHeaderSize = 8;
+    uint8_t                        fChunkHeader[kChunkHeaderSize];
+    size_t                         fChunkHeaderBytes;
+    size_t                         fChunkBytesLeft;
+    bool                           fChunkIsIend;
+
     using INHERITED = SkCodec;
 };
 #endif  // SkPngCodec_DEFINED
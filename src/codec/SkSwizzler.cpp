@@ -26,7 +26,9 @@
     #include "include/android/SkAndroidFrameworkUtils.h"
 #endif
 
+#include <cstdint>
 #include <cstring>
+#include <limits>
 
 static void copy(void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -1249,3 +1251,23 @@ void SkSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     fActualProc(SkTAddOffset<void>(dst, fDstOffsetBytes), src, fSwizzleWidth, fSrcBPP,
             fSampleX * fSrcBPP, fSrcOffsetUnits, fColorTable);
 }
+
+void SkSwizzler::swizzleRows(void* dst, size_t dstRowBytes, const uint8_t* SK_RESTRICT src,
+                             size_t srcRowBytes, int count) {
+    SkASSERT(nullptr != dst && nullptr != src);
+    // When fSrcBPP counts bits, a row of fSrcWidth pixels never takes fSrcWidth * fSrcBPP bytes.
+    const bool contiguous = 1 == fSampleX && 0 == fSrcOffsetUnits && 0 == fDstOffsetBytes &&
+                            fSrcWidth == fSwizzleWidth &&
+                            srcRowBytes == (size_t)fSrcWidth * fSrcBPP &&
+                            dstRowBytes == (size_t)fSwizzleWidth * fDstBPP &&
+                            (int64_t)fSwizzleWidth * count <= std::numeric_limits<int>::max();
+    if (contiguous && count > 1) {
+        fActualProc(dst, src, fSwizzleWidth * count, fSrcBPP, fSrcBPP, 0, fColorTable);
+        return;
+    }
+    for (int y = 0; y < count; y++) {
+        this->swizzle(dst, src);
+        dst = SkTAddOffset<void>(dst, dstRowBytes);
+        src = SkTAddOffset<const uint8_t>(src, srcRowBytes);
+    }
+}
@@ -69,6 +69,14 @@ public:
      */
     void swizzle(void* dst, const uint8_t* SK_RESTRICT src);
 
+    /**
+     *  Swizzle count lines at once. When neither the source nor the destination has padding
+     *  between rows, and there is no sampling or subsetting, this converts them in a single
+     *  pass as if they were one long row.
+     */
+    void swizzleRows(void* dst, size_t dstRowBytes, const uint8_t* SK_RESTRICT src,
+                     size_t srcRowBytes, int count);
+
     int fillWidth() const override {
         return fAllocatedWidth;
     }
@@ -100,8 +100,13 @@ bool SkWbmpCodec::onRewind() {
     return read_header(this->stream(), nullptr);
 }
 
-bool SkWbmpCodec::readRow(uint8_t* row) {
-    return this->stream()->read(row, fSrcRowBytes) == fSrcRowBytes;
+const uint8_t* SkWbmpCodec::readRow(uint8_t* buffer) {
+    const uint8_t* row;
+    if (read_in_place(this->stream(), buffer, fSrcRowBytes, &row,
+                      this->bytesCopiedFromStreamCounter()) != fSrcRowBytes) {
+        return nullptr;
+    }
+    return row;
 }
 
 SkWbmpCodec::SkWbmpCodec(SkEncodedInfo&& info, std::unique_ptr<SkStream> stream)
@@ -141,11 +146,12 @@ SkCodec::Result SkWbmpCodec::onGetPixels(const SkImageInfo& info,
     AutoTMalloc<uint8_t> src(fSrcRowBytes);
     void* dstRow = dst;
     for (int y = 0; y < size.height(); ++y) {
-        if (!this->readRow(src.get())) {
+        const uint8_t* srcRow = this->readRow(src.get());
+        if (!srcRow) {
             *rowsDecoded = y;
             return kIncompleteInput;
         }
-        swizzler->swizzle(dstRow, src.get());
+        swizzler->swizzle(dstRow, srcRow);
         dstRow = SkTAddOffset<void>(dstRow, rowBytes);
     }
     return kSuccess;
@@ -179,10 +185,11 @@ std::unique_ptr<SkCodec> SkWbmpCodec::MakeFromStream(std::unique_ptr<SkStream> s
 int SkWbmpCodec::onGetScanlines(void* dst, int count, size_t dstRowBytes) {
     void* dstRow = dst;
     for (int y = 0; y < count; ++y) {
-        if (!this->readRow(fSrcBuffer.get())) {
+        const uint8_t* srcRow = this->readRow(fSrcBuffer.get());
+        if (!srcRow) {
             return y;
         }
-        fSwizzler->swizzle(dstRow, fSrcBuffer.get());
+        fSwizzler->swizzle(dstRow, srcRow);
         dstRow = SkTAddOffset<void>(dstRow, dstRowBytes);
     }
     return count;
@@ -50,9 +50,10 @@ private:
     }
 
     /*
-     * Read a src row from the encoded stream
+     * Read a src row from the encoded stream, in place if it is in memory or into buffer if not.
+     * Returns nullptr if the stream ends first.
      */
-    bool readRow(uint8_t* row);
+    const uint8_t* readRow(uint8_t* buffer);
 
     SkWbmpCodec(SkEncodedInfo&&, std::unique_ptr<SkStream>);
 
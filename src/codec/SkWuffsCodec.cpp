@@ -81,10 +81,15 @@
 #define SK_WUFFS_INITIALIZE_FLAGS WUFFS_INITIALIZE__DEFAULT_OPTIONS
 #endif
 
-static bool fill_buffer(wuffs_base__io_buffer* b, SkStream* s) {
+// Wuffs reads from its own buffer, so this copies even a stream in memory. Those copies are added
+// to *bytes_copied, if it is not null.
+static bool fill_buffer(wuffs_base__io_buffer* b, SkStream* s, size_t* bytes_copied) {
     b->compact();
     size_t num_read = s->read(b->data.ptr + b->meta.wi, b->data.len - b->meta.wi);
     b->meta.wi += num_read;
+    if (bytes_copied) {
+        *bytes_copied += num_read;
+    }
     b->meta.closed = s->isAtEnd();
     return num_read > 0;
 }
@@ -185,7 +190,7 @@ static SkCodec::Result reset_and_decode_image_config(wuffs_gif__decoder*       d
         } else if (!wuffs_status_means_incomplete_input(status.repr)) {
             SkCodecPrintf("decode_image_config: %s", status.message());
             return SkCodec::kErrorInInput;
-        } else if (!fill_buffer(b, s)) {
+        } else if (!fill_buffer(b, s, nullptr)) {
             return SkCodec::kIncompleteInput;
         }
     }
@@ -933,7 +938,7 @@ const char* SkWuffsCodec::decodeFrameConfig() {
         wuffs_base__status status =
             fDecoder->decode_frame_config(&fFrameConfig, &fIOBuffer);
         if ((status.repr == wuffs_base__suspension__short_read) &&
-            fill_buffer(&fIOBuffer, fStream.get())) {
+            fill_buffer(&fIOBuffer, fStream.get(), this->bytesCopiedFromStreamCounter())) {
             continue;
         }
         fDecoderIsSuspended = !status.is_complete();
@@ -948,7 +953,7 @@ const char* SkWuffsCodec::decodeFrame() {
             &fPixelBuffer, &fIOBuffer, fIncrDecPixelBlend,
             wuffs_base__make_slice_u8(fWorkbufPtr.get(), fWorkbufLen), nullptr);
         if ((status.repr == wuffs_base__suspension__short_read) &&
-            fill_buffer(&fIOBuffer, fStream.get())) {
+            fill_buffer(&fIOBuffer, fStream.get(), this->bytesCopiedFromStreamCounter())) {
             continue;
         }
         fDecoderIsSuspended = !status.is_complete();
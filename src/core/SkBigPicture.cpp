@@ -9,12 +9,24 @@
 
 #include "include/core/SkBBHFactory.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkImage.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkTextBlob.h"
 #include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTPin.h"
+#include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkRecord.h"
 #include "src/core/SkRecordDraw.h"
 #include "src/core/SkRecords.h"
+#include "src/core/SkRectPriv.h"
+#include "src/core/SkStrikeSpec.h"
+#include "src/core/SkTextBlobPriv.h"
 
+#include <cmath>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 SkBigPicture::SkBigPicture(const SkRect& cull,
                            sk_sp<SkRecord> record,
@@ -54,6 +66,288 @@ struct NestedApproxOpCounter {
     }
 };
 
+// Decides whether each op draws the same pixels through one tile's clip as it would through the
+// clip of the whole canvas.  An op passes if either
+//   - it's one we know scan converts independently of the clip (rects, images and glyph masks
+//     under a scale+translate matrix, non-AA rect clips, ...), or
+//   - everything it could touch, including anti-aliased edges, lies inside a single tile, so the
+//     one tile that draws it sees the same clip as playback() would.
+// Ops that read from the destination outside of what they draw (image filters, backdrops) or
+// that escape the tile's clip (resetClip(), drawBehind()) always fail.
+class SkBigPicture::TiledPlaybackChecker {
+public:
+    TiledPlaybackChecker(const SkIRect& deviceBounds, SkISize tileSize)
+        : fDeviceBounds(deviceBounds)
+        , fTileSize(tileSize)
+        , fXTiles((deviceBounds.width()  + tileSize.width()  - 1) / tileSize.width())
+        , fYTiles((deviceBounds.height() + tileSize.height() - 1) / tileSize.height()) {}
+
+    // Checks every op of picture drawn with matrix.  If drawBounds is set, it's also given the
+    // bounds in picture's space of everything picture draws.
+    bool check(const SkBigPicture& picture, const SkMatrix& matrix, SkRect* drawBounds = nullptr) {
+        const SkRecord& record = *picture.fRecord;
+        std::vector<SkRect> bounds(record.count());
+        std::vector<SkBBoxHierarchy::Metadata> meta(record.count());
+        SkRecordFillBounds(SkRectPriv::MakeLargeS32(), record, bounds.data(), meta.data());
+
+        Visitor visitor{this, &picture, matrix};
+        SkRect drawn = SkRect::MakeEmpty();
+        for (int i = 0; i < record.count(); i++) {
+            visitor.fOpBounds = bounds[i];
+            if (!record.visit(i, visitor)) {
+                return false;
+            }
+            if (meta[i].isDraw) {
+                drawn.join(bounds[i]);
+            }
+        }
+        if (drawBounds) {
+            *drawBounds = drawn;
+        }
+        return true;
+    }
+
+private:
+    // Tiles along the edges of the device bounds extend out past them, the same way that
+    // playback() sees no edge there but the canvas's clip.
+    int column(double x) const {
+        const double c = std::floor((x - fDeviceBounds.fLeft) / fTileSize.width());
+        return static_cast<int>(SkTPin<double>(c, 0, fXTiles - 1));
+    }
+    int row(double y) const {
+        const double r = std::floor((y - fDeviceBounds.fTop) / fTileSize.height());
+        return static_cast<int>(SkTPin<double>(r, 0, fYTiles - 1));
+    }
+
+    bool fitsOneTile(const SkRect& deviceRect) const {
+        if (!deviceRect.isFinite()) {
+            return false;
+        }
+        // Anti-aliasing may touch the pixels just outside the rounded out bounds.
+        const double l = std::floor(deviceRect.fLeft)  - 1,
+                     t = std::floor(deviceRect.fTop)   - 1,
+                     r = std::ceil (deviceRect.fRight),
+                     b = std::ceil (deviceRect.fBottom);
+        return this->column(l) == this->column(r) && this->row(t) == this->row(b);
+    }
+
+    struct Visitor {
+        TiledPlaybackChecker* fChecker;
+        const SkBigPicture*   fPicture;
+        SkMatrix              fMatrix;        // Maps the picture's space to the device.
+        SkMatrix              fLocal;         // The picture's own CTM at the current op.
+        SkRect                fOpBounds;      // From SkRecordFillBounds(), in the picture's space.
+
+        template <typename T> bool operator()(const T& op) {
+            this->updateCTM(op);
+            return !ReadsOutside(op) && this->safe(op);
+        }
+
+    private:
+        SkMatrix ctm() const { return SkMatrix::Concat(fMatrix, fLocal); }
+
+        bool fits(const SkRect& localRect) const {
+            return fChecker->fitsOneTile(this->ctm().mapRect(localRect));
+        }
+        bool fitsOp() const { return fChecker->fitsOneTile(fMatrix.mapRect(fOpBounds)); }
+
+        // Rects under a scale+translate draw through SkScan::FillRect() or AntiFillRect(), which
+        // only intersect the rect with the clip.  Past fixed point, they're drawn as paths.
+        bool isExactRect(const SkRect& localRect) const {
+            const SkMatrix ctm = this->ctm();
+            return ctm.rectStaysRect() && SkRectPriv::FitsInFixed(ctm.mapRect(localRect));
+        }
+
+        static bool HasGeometryEffects(const SkPaint* paint) {
+            return paint && (paint->getMaskFilter() || paint->getPathEffect());
+        }
+
+        template <typename T>
+        static std::enable_if_t<(T::kTags & SkRecords::kHasPaint_Tag) != 0, bool>
+        ReadsOutside(const T& op) {
+            const SkPaint* paint = AsPtr(op.paint);
+            return paint && paint->getImageFilter();
+        }
+        template <typename T>
+        static std::enable_if_t<(T::kTags & SkRecords::kHasPaint_Tag) == 0, bool>
+        ReadsOutside(const T&) {
+            return false;
+        }
+        template <typename T> static const T* AsPtr(const SkRecords::Optional<T>& x) { return x; }
+        template <typename T> static const T* AsPtr(const T& x) { return &x; }
+
+        template <typename T> void updateCTM(const T&) {}
+        void updateCTM(const SkRecords::Restore& op)   { fLocal = op.matrix; }
+        void updateCTM(const SkRecords::SetMatrix& op) { fLocal = op.matrix; }
+        void updateCTM(const SkRecords::SetM44& op)    { fLocal = op.matrix.asM33(); }
+        void updateCTM(const SkRecords::Concat44& op)  { fLocal.preConcat(op.matrix.asM33()); }
+        void updateCTM(const SkRecords::Concat& op)    { fLocal.preConcat(op.matrix); }
+        void updateCTM(const SkRecords::Scale& op)     { fLocal.preScale(op.sx, op.sy); }
+        void updateCTM(const SkRecords::Translate& op) { fLocal.preTranslate(op.dx, op.dy); }
+
+        // Anything we don't know better draws through an arbitrary scan converter.
+        template <typename T> bool safe(const T&) { return this->fitsOp(); }
+
+        bool safe(const SkRecords::NoOp&)           { return true; }
+        bool safe(const SkRecords::Save&)           { return true; }
+        bool safe(const SkRecords::Restore&)        { return true; }
+        bool safe(const SkRecords::SetMatrix&)      { return true; }
+        bool safe(const SkRecords::SetM44&)         { return true; }
+        bool safe(const SkRecords::Translate&)      { return true; }
+        bool safe(const SkRecords::Scale&)          { return true; }
+        bool safe(const SkRecords::Concat&)         { return true; }
+        bool safe(const SkRecords::Concat44&)       { return true; }
+        bool safe(const SkRecords::ClipRegion&)     { return true; }
+        bool safe(const SkRecords::ClipShader&)     { return true; }
+        bool safe(const SkRecords::DrawAnnotation&) { return true; }
+
+        // These reset to, or draw through, more than the tile's clip.
+        bool safe(const SkRecords::ResetClip&)  { return false; }
+        bool safe(const SkRecords::SaveBehind&) { return false; }
+        bool safe(const SkRecords::DrawBehind&) { return false; }
+
+        bool safe(const SkRecords::SaveLayer& op) {
+            // A layer's device is sized to its bounds inside the clip.  Only when that's the same
+            // for the tile as for the whole canvas is what's drawn into it the same.
+            return !op.backdrop && op.bounds && this->fits(*op.bounds);
+        }
+
+        bool safe(const SkRecords::ClipRect& op) {
+            return this->isExactClipRect(op.rect, op.opAA.aa()) || this->fits(op.rect);
+        }
+        bool safe(const SkRecords::ClipRRect& op) {
+            return (op.rrect.isRect() && this->isExactClipRect(op.rrect.rect(), op.opAA.aa())) ||
+                   this->fits(op.rrect.rect());
+        }
+        bool safe(const SkRecords::ClipPath& op) {
+            return !op.path.isInverseFillType() && this->fits(op.path.getBounds());
+        }
+        bool isExactClipRect(const SkRect& rect, bool aa) const {
+            // Only rects that land on pixel boundaries keep a non-AA clip.
+            const SkMatrix ctm = this->ctm();
+            if (!ctm.rectStaysRect()) {
+                return false;
+            }
+            const SkRect devRect = ctm.mapRect(rect);
+            return !aa || (devRect.isFinite() && SkRect::Make(devRect.round()) == devRect);
+        }
+
+        bool safe(const SkRecords::DrawPaint& op) {
+            return !op.paint.getMaskFilter() || this->fitsOp();
+        }
+        bool safe(const SkRecords::DrawRect& op) {
+            return (op.paint.getStyle() == SkPaint::kFill_Style &&
+                    !HasGeometryEffects(&op.paint) && this->isExactRect(op.rect)) ||
+                   this->fitsOp();
+        }
+        bool safe(const SkRecords::DrawImage& op) {
+            const SkRect dst = SkRect::MakeXYWH(op.left, op.top,
+                                                op.image->width(), op.image->height());
+            return this->isExactImage(op.image.get(), op.paint, dst) || this->fitsOp();
+        }
+        bool safe(const SkRecords::DrawImageRect& op) {
+            return this->isExactImage(op.image.get(), op.paint, op.dst) || this->fitsOp();
+        }
+        bool safe(const SkRecords::DrawImageLattice& op) {
+            // Each patch is drawn as its own image rect.
+            return this->isExactImage(op.image.get(), op.paint, op.dst) || this->fitsOp();
+        }
+        bool isExactImage(const SkImage* image, const SkPaint* paint, const SkRect& dst) const {
+            // Alpha-only images may be drawn as masks, rasterized inside the clip.
+            return !SkColorTypeIsAlphaOnly(image->colorType()) &&
+                   !HasGeometryEffects(paint) && this->isExactRect(dst);
+        }
+
+        bool safe(const SkRecords::DrawTextBlob& op) {
+            if (HasGeometryEffects(&op.paint)) {
+                return this->fitsOp();
+            }
+            // Glyph masks are rasterized independently of the clip and then blit through it,
+            // but glyphs drawn as paths are scan converted like any other path.
+            SkMatrix positionMatrix = this->ctm();
+            positionMatrix.preTranslate(op.x, op.y);
+            for (SkTextBlobRunIterator it(op.blob.get()); !it.done(); it.next()) {
+                if (it.positioning() == SkTextBlobRunIterator::kRSXform_Positioning ||
+                    SkStrikeSpec::ShouldDrawAsPath(op.paint, it.font(), positionMatrix)) {
+                    return this->fitsOp();
+                }
+            }
+            return true;
+        }
+
+        bool safe(const SkRecords::DrawPicture& op) {
+            if (op.paint) {
+                // The picture is drawn into a layer bounded by its cull rect.
+                return fChecker->fitsOneTile(
+                        SkMatrix::Concat(this->ctm(), op.matrix).mapRect(op.picture->cullRect()));
+            }
+            return this->safePicture(op.picture.get(), op.matrix);
+        }
+        bool safe(const SkRecords::DrawDrawable& op) {
+            // Without a snapshot, the drawable could draw anything.
+            if (!fPicture->drawablePicts() || op.index >= fPicture->drawableCount()) {
+                return false;
+            }
+            return this->safePicture(fPicture->drawablePicts()[op.index],
+                                     op.matrix ? *op.matrix : SkMatrix::I());
+        }
+        bool safePicture(const SkPicture* picture, const SkMatrix& matrix) {
+            const SkBigPicture* big = picture->asSkBigPicture();
+            if (!big) {
+                return false;
+            }
+            // A tile skips the nested picture when its cull rect misses the tile, so the picture
+            // can't draw anything outside of its cull rect.
+            SkRect drawn;
+            const SkMatrix nestedMatrix = SkMatrix::Concat(this->ctm(), matrix);
+            return fChecker->check(*big, nestedMatrix, &drawn) &&
+                   big->cullRect().contains(drawn);
+        }
+    };
+
+    const SkIRect fDeviceBounds;
+    const SkISize fTileSize;
+    const int     fXTiles,
+                  fYTiles;
+};
+
+void SkBigPicture::playbackTile(SkCanvas* canvas, const SkRect& canvasClip) const {
+    SkASSERT(canvas);
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+
+    // The BBH only knows ops' bounds inside the cull rect, but ops may draw outside it.  A tile
+    // inside the cull rect can search for the ops that touch it; any other tile draws what
+    // playback() would draw through the whole canvas, and lets its clip drop the rest.
+    const SkRect tileClip = canvas->getLocalClipBounds();
+    const SkRect* query = nullptr;
+    if (fBBH && fCullRect.contains(tileClip)) {
+        query = &tileClip;
+    } else if (fBBH && !canvasClip.contains(fCullRect)) {
+        query = &canvasClip;
+    }
+
+    SkRecords::Draw draw(canvas, this->drawablePicts(), nullptr, this->drawableCount());
+    if (query) {
+        std::vector<int> ops;
+        fBBH->search(*query, &ops);
+        for (int op : ops) {
+            fRecord->visit(op, draw);
+        }
+    } else {
+        for (int i = 0; i < fRecord->count(); i++) {
+            fRecord->visit(i, draw);
+        }
+    }
+}
+
+bool SkBigPicture::canPlaybackTiled(const SkMatrix& matrix, const SkIRect& deviceBounds,
+                                    SkISize tileSize) const {
+    if (matrix.hasPerspective() || deviceBounds.isEmpty() || tileSize.isEmpty()) {
+        return false;
+    }
+    return TiledPlaybackChecker(deviceBounds, tileSize).check(*this, matrix);
+}
+
 SkRect SkBigPicture::cullRect()            const { return fCullRect; }
 int SkBigPicture::approximateOpCount(bool nested) const {
     if (nested) {
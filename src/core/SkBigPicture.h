@@ -12,6 +12,7 @@
 #include "include/core/SkPicture.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/core/SkRecord.h"
@@ -20,6 +21,7 @@
 #include <memory>
 
 class SkCanvas;
+class SkMatrix;
 
 // An implementation of SkPicture supporting an arbitrary number of drawing commands.
 // This is called "big" because there used to be a "mini" that only supported a subset of the
@@ -53,11 +55,23 @@ public:
     size_t approximateBytesUsed() const override;
     const SkBigPicture* asSkBigPicture() const override { return this; }
 
+    // Returns true if drawing this picture with matrix through each tileSize tile of deviceBounds
+    // draws exactly the pixels that playback() would draw through all of deviceBounds, so the
+    // tiles can be drawn concurrently into the same pixels.
+    bool canPlaybackTiled(const SkMatrix& matrix, const SkIRect& deviceBounds,
+                          SkISize tileSize) const;
+
+    // Draws the ops that playback() would draw through a canvas whose local clip bounds are
+    // canvasClip, into canvas, which is clipped to one tile of that canvas.
+    void playbackTile(SkCanvas* canvas, const SkRect& canvasClip) const;
+
 // Used by GrRecordReplaceDraw
     const SkBBoxHierarchy* bbh() const { return fBBH.get(); }
     const SkRecord*     record() const { return fRecord.get(); }
 
 private:
+    class TiledPlaybackChecker;
+
     int drawableCount() const;
     SkPicture const* const* drawablePicts() const;
 
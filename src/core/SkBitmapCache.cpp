@@ -184,8 +184,16 @@ private:
 
 void SkBitmapCache::PrivateDeleteRec(Rec* rec) { delete rec; }
 
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+static SkResourceCache::DiscardableFactory get_fact(SkResourceCache* localCache) {
+    return localCache ? localCache->discardableFactory()
+                      : SkResourceCache::GetDiscardableFactory();
+}
+
 SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const SkImageInfo& info,
-                                           SkPixmap* pmap) {
+                                           SkPixmap* pmap, SkResourceCache* localCache) {
     // Ensure that the info matches the subset (i.e. the subset is the entire image)
     SkASSERT(info.width() == desc.fSubset.width());
     SkASSERT(info.height() == desc.fSubset.height());
@@ -199,7 +207,7 @@ SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const
     std::unique_ptr<SkDiscardableMemory> dm;
     void* block = nullptr;
 
-    auto factory = SkResourceCache::GetDiscardableFactory();
+    auto factory = get_fact(localCache);
     if (factory) {
         dm.reset(factory(size));
     } else {
@@ -212,21 +220,20 @@ SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const
     return RecPtr(new Rec(desc, info, rb, std::move(dm), block));
 }
 
-void SkBitmapCache::Add(RecPtr rec, SkBitmap* bitmap) {
-    SkResourceCache::Add(rec.release(), bitmap);
+void SkBitmapCache::Add(RecPtr rec, SkBitmap* bitmap, SkResourceCache* localCache) {
+    CHECK_LOCAL(localCache, add, Add, rec.release(), bitmap);
 }
 
-bool SkBitmapCache::Find(const SkBitmapCacheDesc& desc, SkBitmap* result) {
+bool SkBitmapCache::Find(const SkBitmapCacheDesc& desc, SkBitmap* result,
+                         SkResourceCache* localCache) {
     desc.validate();
-    return SkResourceCache::Find(BitmapKey(desc), SkBitmapCache::Rec::Finder, result);
+    return CHECK_LOCAL(localCache, find, Find, BitmapKey(desc), SkBitmapCache::Rec::Finder,
+                       result);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////
 
-#define CHECK_LOCAL(localCache, localName, globalName, ...) \
-    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
-
 namespace {
 static unsigned gMipMapKeyNamespaceLabel;
 
@@ -290,11 +297,6 @@ const SkMipmap* SkMipmapCache::FindAndRef(const SkBitmapCacheDesc& desc,
     return result;
 }
 
-static SkResourceCache::DiscardableFactory get_fact(SkResourceCache* localCache) {
-    return localCache ? localCache->discardableFactory()
-                      : SkResourceCache::GetDiscardableFactory();
-}
-
 const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCache* localCache) {
     SkBitmap src;
     if (!image->getROPixels(nullptr, &src)) {
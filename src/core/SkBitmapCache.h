@@ -46,14 +46,16 @@ public:
      *  Search based on the desc. If found, returns true and
      *  result will be set to the matching bitmap with its pixels already locked.
      */
-    static bool Find(const SkBitmapCacheDesc&, SkBitmap* result);
+    static bool Find(const SkBitmapCacheDesc&, SkBitmap* result,
+                     SkResourceCache* localCache = nullptr);
 
     class Rec;
     struct RecDeleter { void operator()(Rec* r) { PrivateDeleteRec(r); } };
     typedef std::unique_ptr<Rec, RecDeleter> RecPtr;
 
-    static RecPtr Alloc(const SkBitmapCacheDesc&, const SkImageInfo&, SkPixmap*);
-    static void Add(RecPtr, SkBitmap*);
+    static RecPtr Alloc(const SkBitmapCacheDesc&, const SkImageInfo&, SkPixmap*,
+                        SkResourceCache* localCache = nullptr);
+    static void Add(RecPtr, SkBitmap*, SkResourceCache* localCache = nullptr);
 
 private:
     static void PrivateDeleteRec(Rec*);
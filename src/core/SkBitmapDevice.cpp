@@ -37,6 +37,8 @@
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/image/SkImage_Base.h"
+#include "src/image/SkImage_Lazy.h"
+#include "src/shaders/SkImageShader.h"
 #include "src/text/GlyphRun.h"
 
 #include <utility>
@@ -136,6 +138,7 @@ public:
         }
 
         fDraw.fProps = &fDevice->surfaceProps();
+        fDraw.fPathFillExecutor = fDevice->fPathFillExecutor;
     }
 
     bool needsTiling() const { return fNeedsTiling; }
@@ -417,6 +420,32 @@ void SkBitmapDevice::drawImageRect(const SkImage* image, const SkRect* src, cons
     SkASSERT(dst.isFinite());
     SkASSERT(dst.isSorted());
 
+    // Images that draw from YUVA planes are sampled by an image shader over the whole image, so
+    // they are never decoded to RGBA. Filtering within a strict src needs an RGBA subset though.
+    if (as_IB(image)->type() == SkImage_Base::Type::kLazy &&
+        static_cast<const SkImage_Lazy*>(image)->drawsRasterFromPlanes()) {
+        const SkRect imageBounds = SkRect::Make(image->bounds());
+        if (!src || src->contains(imageBounds) ||
+            SkCanvas::kFast_SrcRectConstraint == constraint ||
+            sampling == SkSamplingOptions()) {
+            SkRect srcRect = src ? *src : imageBounds;
+            const SkMatrix matrix = SkMatrix::RectToRect(srcRect, dst);
+            if (!srcRect.intersect(imageBounds)) {
+                return; // nothing to draw
+            }
+            SkRect dstRect = matrix.mapRect(srcRect);
+            if (!dstRect.isFinite()) {
+                return;
+            }
+            SkPaint paintWithShader(paint);
+            paintWithShader.setStyle(SkPaint::kFill_Style);
+            paintWithShader.setShader(SkImageShader::Make(sk_ref_sp(image), SkTileMode::kClamp,
+                                                          SkTileMode::kClamp, sampling, &matrix));
+            this->drawRect(dstRect, paintWithShader);
+            return;
+        }
+    }
+
     SkBitmap bitmap;
     // TODO: Elevate direct context requirement to public API and remove cheat.
     auto dContext = as_IB(image)->directContext();
@@ -21,6 +21,7 @@
 #include <cstddef>
 
 class SkBlender;
+class SkExecutor;
 class SkImage;
 class SkImageFilterCache;
 class SkMatrix;
@@ -116,6 +117,10 @@ public:
 
     void* getRasterHandle() const override { return fRasterHandle; }
 
+    // Big path fills draw in horizontal bands, in parallel on this executor, when one is set.
+    // They draw the same pixels as in one pass. See SkSurfaces::SetPathFillExecutor().
+    void setPathFillExecutor(SkExecutor* executor) { fPathFillExecutor = executor; }
+
 private:
     // friend class SkCanvas;
     friend class SkDraw;
@@ -148,6 +153,7 @@ private:
 
     SkBitmap    fBitmap;
     void*       fRasterHandle = nullptr;
+    SkExecutor* fPathFillExecutor = nullptr;
     SkRasterClipStack  fRCStack;
     SkGlyphRunListPainterCPU fGlyphPainter;
 };
@@ -66,6 +66,12 @@ public:
         return canvas->topDevice();
     }
 
+    // Lets the canvas's surface (if any) prepare for pixels to be written outside of the canvas,
+    // e.g. by copying on write.  Returns false if drawing should not happen.
+    static bool PredrawNotify(SkCanvas* canvas) {
+        return canvas->predrawNotify();
+    }
+
 #if defined(GRAPHITE_TEST_UTILS)
     static skgpu::graphite::TextureProxy* TopDeviceGraphiteTargetProxy(SkCanvas*);
 #endif
@@ -136,16 +136,39 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Pass useCache = false when paint's shader changes state between blits (e.g. SkTriColorShader) or
+// lives in an arena, so it must not outlive the draw in the blitter cache.
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap&,
                                          const SkPaint&,
                                          const SkMatrix& ctm,
                                          SkArenaAlloc*,
                                          sk_sp<SkShader> clipShader,
-                                         const SkSurfaceProps& props);
+                                         const SkSurfaceProps& props,
+                                         bool useCache = true);
 // Use this if you've pre-baked a shader pipeline, including modulating with paint alpha.
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap&, const SkPaint&,
                                          const SkRasterPipeline& shaderPipeline,
                                          bool shader_is_opaque,
                                          SkArenaAlloc*, sk_sp<SkShader> clipShader);
 
+// The first SkCreateRasterPipelineBlitter() keeps a small process-wide cache of already compiled
+// blitters, keyed on the paint's shader, color filter and blender, the CTM and the kind of pixmap,
+// so that drawing the same kind of paint into the same kind of pixmap again skips building and
+// compiling its pipelines. Solid-color paints only need to patch in the new color. These back the
+// SkGraphics raster pipeline cache calls.
+class SkRasterPipelineBlitterCache {
+public:
+    static size_t GetHits();
+    static size_t GetMisses();
+
+    static int GetCountLimit();
+    static int SetCountLimit(int count);  // Returns the old limit. Zero disables the cache.
+
+    static void PurgeAll();
+
+    // Counts only the calling thread's hits, so tests can check their own draws hit while other
+    // threads draw too.
+    static size_t GetThreadHitsForTesting();
+};
+
 #endif
@@ -79,8 +79,13 @@
 #endif
 
 uint32_t SkCpu::gCachedFeatures = 0;
+uint32_t SkCpu::gDisabledFeatures = 0;
 
 void SkCpu::CacheRuntimeFeatures() {
     static SkOnce once;
-    once([] { gCachedFeatures = read_cpu_features(); });
+    once([] { gCachedFeatures = read_cpu_features() & ~gDisabledFeatures; });
+}
+
+void SkCpu::DisableRuntimeFeaturesForTesting(uint32_t features) {
+    gDisabledFeatures |= features;
 }
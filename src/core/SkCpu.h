@@ -44,8 +44,13 @@ struct SkCpu {
 
     static void CacheRuntimeFeatures();
     static bool Supports(uint32_t);
+
+    // Pretend the CPU lacks these runtime features, e.g. to bench the HSW opts on an SKX machine.
+    // Must be called before CacheRuntimeFeatures() (i.e. before SkGraphics::Init()).
+    static void DisableRuntimeFeaturesForTesting(uint32_t);
 private:
     static uint32_t gCachedFeatures;
+    static uint32_t gDisabledFeatures;
 };
 
 inline bool SkCpu::Supports(uint32_t mask) {
@@ -11,6 +11,7 @@
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkOnce.h"
+#include "src/core/SkDataPriv.h"
 #include "src/core/SkOSFile.h"
 #include "src/core/SkStreamPriv.h"
 
@@ -135,6 +136,10 @@ static void sk_mmap_releaseproc(const void* addr, void* ctx) {
     sk_fmunmap(addr, length);
 }
 
+bool SkDataPriv::IsFileMapped(const SkData& data) {
+    return data.fReleaseProc == sk_mmap_releaseproc;
+}
+
 sk_sp<SkData> SkData::MakeFromFILE(FILE* f) {
     size_t size;
     void* addr = sk_fmmap(f, &size);
@@ -0,0 +1,20 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkDataPriv_DEFINED
+#define SkDataPriv_DEFINED
+
+class SkData;
+
+class SkDataPriv {
+public:
+    // Returns true if data is a file mapped into memory by SkData::MakeFromFILE(), MakeFromFD()
+    // or MakeFromFileName(). Its pages are read from the file as they are first touched.
+    static bool IsFileMapped(const SkData& data);
+};
+
+#endif  // SkDataPriv_DEFINED
@@ -5,6 +5,7 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkExecutor.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
@@ -36,6 +37,7 @@
 #include "src/core/SkRasterClip.h"
 #include "src/core/SkRectPriv.h"
 #include "src/core/SkScan.h"
+#include "src/core/SkTaskGroup.h"
 #include <algorithm>
 #include <cstddef>
 #include <optional>
@@ -326,6 +328,10 @@ void SkDrawBase::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool d
     if (SkPathPriv::TooBigForMath(devPath)) {
         return;
     }
+    if (doFill && !customBlitter && !paint.getMaskFilter() &&
+        this->fillDevPathInBands(devPath, paint, drawCoverage)) {
+        return;
+    }
     SkBlitter* blitter = nullptr;
     SkAutoBlitterChoose blitterStorage;
     if (nullptr == customBlitter) {
@@ -380,6 +386,40 @@ void SkDrawBase::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool d
     proc(devPath, *fRC, blitter);
 }
 
+// Fills need at least this many verbs, covering at least this many pixels, before we split them
+// into bands. Below that, setting up the bands costs more than we'd save.
+static constexpr int kMinBandedFillVerbs  = 10000;
+static constexpr int kMinBandedFillPixels = 256 * 256;
+
+// Bands are fixed rows of the device, not a share of the path per thread, so how the work is
+// split up doesn't depend on the executor.
+static constexpr int kBandHeight = 64;
+
+bool SkDrawBase::fillDevPathInBands(const SkPath& devPath, const SkPaint& paint,
+                                    bool drawCoverage) const {
+    if (!fPathFillExecutor || devPath.countVerbs() < kMinBandedFillVerbs) {
+        return false;
+    }
+    SkIRect bounds = fRC->getBounds();
+    if (!bounds.intersect(devPath.getBounds().roundOut()) ||
+        (int64_t)bounds.width() * bounds.height() < kMinBandedFillPixels) {
+        return false;
+    }
+
+    SkBandedFill fill;
+    if (!fill.init(devPath, *fRC, paint.isAntiAlias(), kBandHeight) || fill.bandCount() < 2) {
+        return false;
+    }
+    // Each band draws with its own blitter: blitters keep per-draw scratch, so can't be shared.
+    SkParallelFor(*fPathFillExecutor, fill.bandCount(), 1, [&](int start, int end) {
+        for (int band = start; band < end; band++) {
+            SkAutoBlitterChoose blitter(*this, nullptr, paint, drawCoverage);
+            fill.fillBand(band, blitter.get());
+        }
+    });
+    return true;
+}
+
 void SkDrawBase::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
                       const SkMatrix* prePathMatrix, bool pathIsMutable,
                       bool drawCoverage, SkBlitter* customBlitter) const {
@@ -23,6 +23,7 @@ class SkArenaAlloc;
 class SkBitmap;
 class SkBlitter;
 class SkDevice;
+class SkExecutor;
 class SkGlyph;
 class SkMaskFilter;
 class SkMatrix;
@@ -137,6 +138,11 @@ private:
                      bool drawCoverage,
                      SkBlitter* customBlitter,
                      bool doFill) const;
+
+    // Fills a big enough devPath in horizontal bands, in parallel on fPathFillExecutor, drawing
+    // exactly what one pass would (see SkBandedFill). Returns false, having drawn nothing, if
+    // there is no executor or the path can't or isn't worth splitting up.
+    bool fillDevPathInBands(const SkPath& devPath, const SkPaint& paint, bool drawCoverage) const;
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -153,6 +159,7 @@ public:
     const SkMatrix*         fCTM{nullptr};             // required
     const SkRasterClip*     fRC{nullptr};              // required
     const SkSurfaceProps*   fProps{nullptr};           // optional
+    SkExecutor*             fPathFillExecutor{nullptr};  // optional, see fillDevPathInBands()
 
 #ifdef SK_DEBUG
     void validate() const;
@@ -288,7 +288,8 @@ void SkDraw::drawFixedVertices(const SkVertices* vertices,
                                                  *ctm,
                                                  outerAlloc,
                                                  fRC->clipShader(),
-                                                 props);
+                                                 props,
+                                                 /*useCache=*/false);
     if (!blitter) {
         return;
     }
@@ -11,6 +11,9 @@
 #include "include/private/base/SkTArray.h"
 #include "src/base/SkNoDestructor.h"
 #include "src/base/SkSpinlock.h"
+#include "src/core/SkTaskGroup.h"
+#include <atomic>
+#include <cstdint>
 #include <deque>
 #include <thread>
 
@@ -37,6 +40,8 @@ class SkTrivialExecutor final : public SkExecutor {
     void add(std::function<void(void)> work) override {
         work();
     }
+
+    int concurrency() const override { return 1; }
 };
 
 static SkExecutor& trivial_executor() {
@@ -69,6 +74,15 @@ static inline std::function<void(void)> pop(TArray<std::function<void(void)>>* l
     return fn;
 }
 
+// Which thread pool is this thread part of (if any)?  For an SkWorkStealingThreadPool, which of
+// its threads is this?
+static thread_local const SkExecutor* sCurrentPool   = nullptr;
+static thread_local int               sCurrentWorker = -1;
+
+bool SkIsExecutorThread() {
+    return sCurrentPool != nullptr;
+}
+
 // An SkThreadPool is an executor that runs work on a fixed pool of OS threads.
 template <typename WorkList>
 class SkThreadPool final : public SkExecutor {
@@ -107,6 +121,8 @@ public:
         }
     }
 
+    int concurrency() const override { return fThreads.size(); }
+
 private:
     // This method should be called only when fWorkAvailable indicates there's work to do.
     bool do_work() {
@@ -127,9 +143,11 @@ private:
 
     static void Loop(void* ctx) {
         auto pool = (SkThreadPool*)ctx;
+        sCurrentPool = pool;
         do {
             pool->fWorkAvailable.wait();
         } while (pool->do_work());
+        sCurrentPool = nullptr;
     }
 
     // Both SkMutex and SkSpinlock can work here.
@@ -142,6 +160,232 @@ private:
     bool                  fAllowBorrowing;
 };
 
+// A fixed-capacity Chase-Lev work-stealing deque of heap-allocated work.
+// Only the owning thread may push() and pop(), which work at the bottom; any thread may steal()
+// from the top.  This follows Lê, Pop, Cohen, and Zappa Nardelli, "Correct and Efficient
+// Work-Stealing for Weak Memory Models" (PPoPP '13), but uses sequentially consistent operations
+// in place of their standalone fences, which keeps the synchronization visible to TSAN.
+class SkWorkStealingDeque {
+public:
+    using Work = std::function<void(void)>;
+
+    static constexpr int64_t kCapacity = 1024;  // Must be a power of two.
+
+    ~SkWorkStealingDeque() {
+        while (Work* work = this->pop()) {
+            delete work;
+        }
+    }
+
+    // Returns false if the deque is full; the caller keeps ownership of work in that case.
+    bool push(Work* work) {
+        int64_t b = fBottom.load(std::memory_order_relaxed),
+                t = fTop   .load(std::memory_order_acquire);
+        if (b - t >= kCapacity) {
+            return false;
+        }
+        fSlots[b & (kCapacity - 1)].store(work, std::memory_order_relaxed);
+        fBottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Takes the most recently pushed work, or returns nullptr if the deque is empty.
+    Work* pop() {
+        int64_t b = fBottom.load(std::memory_order_relaxed) - 1;
+        fBottom.store(b, std::memory_order_seq_cst);
+        int64_t t = fTop.load(std::memory_order_seq_cst);
+
+        Work* work = nullptr;
+        if (t <= b) {
+            work = fSlots[b & (kCapacity - 1)].load(std::memory_order_relaxed);
+            if (t == b) {
+                // This is the last item, so we race any thieves for it.
+                if (!fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                            std::memory_order_relaxed)) {
+                    work = nullptr;
+                }
+                fBottom.store(b + 1, std::memory_order_release);
+            }
+        } else {
+            fBottom.store(b + 1, std::memory_order_release);
+        }
+        return work;
+    }
+
+    // Takes the least recently pushed work, or returns nullptr if the deque is empty or we lost
+    // a race with another thief or the owner.
+    Work* steal() {
+        int64_t t = fTop   .load(std::memory_order_seq_cst),
+                b = fBottom.load(std::memory_order_seq_cst);
+
+        if (t < b) {
+            Work* work = fSlots[t & (kCapacity - 1)].load(std::memory_order_relaxed);
+            if (fTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                       std::memory_order_relaxed)) {
+                return work;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    // fTop is written by thieves and fBottom by the owner, so keep them on separate cache lines.
+    alignas(64) std::atomic<int64_t> fTop{0};
+    alignas(64) std::atomic<int64_t> fBottom{0};
+    std::atomic<Work*>               fSlots[kCapacity] = {};
+};
+
+// An SkWorkStealingThreadPool gives each of its threads a private lock-free deque and an inbox.
+//
+// Work added from one of the pool's own threads (e.g. a nested SkTaskGroup) goes onto that
+// thread's deque, where it will be run LIFO by the owner or stolen FIFO by idle threads.  Work
+// added from outside the pool is spread round-robin over the inboxes, so concurrent producers
+// rarely contend on the same lock.
+//
+// As in SkThreadPool, fWorkAvailable counts queued work: every add() signals it once, and any
+// thread must take one count before it goes looking for work, so that search always succeeds.
+class SkWorkStealingThreadPool final : public SkExecutor {
+public:
+    using Work = SkWorkStealingDeque::Work;
+
+    explicit SkWorkStealingThreadPool(int threads, bool allowBorrowing)
+            : fWorkers(new Worker[threads])
+            , fWorkerCount(threads)
+            , fAllowBorrowing(allowBorrowing) {
+        for (int i = 0; i < threads; i++) {
+            fThreads.emplace_back(&Loop, this, i);
+        }
+    }
+
+    ~SkWorkStealingThreadPool() override {
+        // Signal each thread that it's time to shut down.
+        for (int i = 0; i < fThreads.size(); i++) {
+            this->add(nullptr);
+        }
+        // Wait for each thread to shut down.
+        for (int i = 0; i < fThreads.size(); i++) {
+            fThreads[i].join();
+        }
+    }
+
+    void add(std::function<void(void)> work) override {
+        Work* heapWork = new Work(std::move(work));
+
+        // Work added from inside one of our threads goes on that thread's own deque.
+        int index = this->currentWorkerIndex();
+        if (index < 0 || !fWorkers[index].fDeque.push(heapWork)) {
+            // Otherwise it goes in an inbox, by default picked round-robin.
+            if (index < 0) {
+                index = (int)(fNextInbox.fetch_add(1, std::memory_order_relaxed) %
+                              (uint32_t)fWorkerCount);
+            }
+            Worker& worker = fWorkers[index];
+            SkAutoMutexExclusive lock(worker.fInboxLock);
+            worker.fInbox.push_back(heapWork);
+        }
+        // Tell the Loop() threads to pick it up.
+        fWorkAvailable.signal(1);
+    }
+
+    void borrow() override {
+        // If there is work waiting and we're allowed to borrow work, do it.
+        // Our own threads may always borrow: they only call borrow() from inside a task
+        // blocked in SkTaskGroup::wait(), and must make progress on nested work to avoid deadlock.
+        if ((fAllowBorrowing || this->currentWorkerIndex() >= 0) && fWorkAvailable.try_wait()) {
+            if (!this->do_work()) {
+                // During shutdown we may have taken one of the destructor's nullptr signals.
+                // It belongs to a Loop() thread, so put it back.
+                this->add(nullptr);
+            }
+        }
+    }
+
+    int concurrency() const override { return fThreads.size(); }
+
+private:
+    struct Worker {
+        SkWorkStealingDeque fDeque;
+        SkMutex             fInboxLock;
+        std::deque<Work*>   fInbox;
+
+        ~Worker() {
+            for (Work* work : fInbox) {
+                delete work;
+            }
+        }
+
+        Work* popInbox() {
+            SkAutoMutexExclusive lock(fInboxLock);
+            if (fInbox.empty()) {
+                return nullptr;
+            }
+            Work* work = fInbox.front();
+            fInbox.pop_front();
+            return work;
+        }
+    };
+
+    int currentWorkerIndex() const {
+        return sCurrentPool == this ? sCurrentWorker : -1;
+    }
+
+    // Find some work to do.  Only call this after taking a count from fWorkAvailable:
+    // that guarantees there is some work queued somewhere that no other thread has claimed.
+    Work* find_work() {
+        const int n = fWorkerCount;
+        int self = this->currentWorkerIndex();
+        if (self >= 0) {
+            if (Work* work = fWorkers[self].fDeque.pop()) {
+                return work;
+            }
+        }
+        int start = self >= 0 ? self
+                              : (int)(fNextVictim.fetch_add(1, std::memory_order_relaxed) %
+                                      (uint32_t)n);
+        // steal() may fail spuriously when racing other threads, so keep looking until we win.
+        for (;;) {
+            for (int i = 0; i < n; i++) {
+                Worker& victim = fWorkers[(start + i) % n];
+                if (Work* work = victim.popInbox()) {
+                    return work;
+                }
+                if (Work* work = victim.fDeque.steal()) {
+                    return work;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // This method should be called only when fWorkAvailable indicates there's work to do.
+    bool do_work() {
+        std::unique_ptr<Work> work(this->find_work());
+        if (!*work) {
+            return false;  // This is Loop()'s signal to shut down.
+        }
+
+        (*work)();
+        return true;
+    }
+
+    static void Loop(SkWorkStealingThreadPool* pool, int index) {
+        sCurrentPool   = pool;
+        sCurrentWorker = index;
+        do {
+            pool->fWorkAvailable.wait();
+        } while (pool->do_work());
+        sCurrentPool = nullptr;
+    }
+
+    std::unique_ptr<Worker[]> fWorkers;
+    int                       fWorkerCount;
+    TArray<std::thread>       fThreads;
+    std::atomic<uint32_t>     fNextInbox{0};
+    std::atomic<uint32_t>     fNextVictim{0};
+    SkSemaphore               fWorkAvailable;
+    bool                      fAllowBorrowing;
+};
+
 std::unique_ptr<SkExecutor> SkExecutor::MakeFIFOThreadPool(int threads, bool allowBorrowing) {
     using WorkList = std::deque<std::function<void(void)>>;
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
@@ -152,3 +396,8 @@ std::unique_ptr<SkExecutor> SkExecutor::MakeLIFOThreadPool(int threads, bool all
     return std::make_unique<SkThreadPool<WorkList>>(threads > 0 ? threads : num_cores(),
                                                     allowBorrowing);
 }
+std::unique_ptr<SkExecutor> SkExecutor::MakeWorkStealingThreadPool(int threads,
+                                                                   bool allowBorrowing) {
+    return std::make_unique<SkWorkStealingThreadPool>(threads > 0 ? threads : num_cores(),
+                                                       allowBorrowing);
+}
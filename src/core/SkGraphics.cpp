@@ -10,10 +10,13 @@
 #include "src/core/SkBitmapProcState.h"
 #include "src/core/SkBlitMask.h"
 #include "src/core/SkBlitRow.h"
+#include "src/core/SkCoreBlitters.h"
 #include "src/core/SkCpu.h"
 #include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkMaskBlurFilter.h"
 #include "src/core/SkMemset.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkPngFilters.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkStrikeCache.h"
 #include "src/core/SkSwizzlePriv.h"
@@ -26,7 +29,9 @@ void SkGraphics::Init() {
     SkOpts::Init_BitmapProcState();
     SkOpts::Init_BlitMask();
     SkOpts::Init_BlitRow();
+    SkOpts::Init_MaskBlurFilter();
     SkOpts::Init_Memset();
+    SkOpts::Init_PngFilters();
     SkOpts::Init_Swizzler();
 }
 
@@ -41,6 +46,7 @@ void SkGraphics::PurgeAllCaches() {
     SkGraphics::PurgeFontCache();
     SkGraphics::PurgeResourceCache();
     SkImageFilter_Base::PurgeCache();
+    SkGraphics::PurgeRasterPipelineCache();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -78,6 +84,26 @@ void SkGraphics::PurgePinnedFontCache() {
     SkStrikeCache::GlobalStrikeCache()->purgePinned();
 }
 
+size_t SkGraphics::GetRasterPipelineCacheHits() {
+    return SkRasterPipelineBlitterCache::GetHits();
+}
+
+size_t SkGraphics::GetRasterPipelineCacheMisses() {
+    return SkRasterPipelineBlitterCache::GetMisses();
+}
+
+int SkGraphics::GetRasterPipelineCacheCountLimit() {
+    return SkRasterPipelineBlitterCache::GetCountLimit();
+}
+
+int SkGraphics::SetRasterPipelineCacheCountLimit(int count) {
+    return SkRasterPipelineBlitterCache::SetCountLimit(count);
+}
+
+void SkGraphics::PurgeRasterPipelineCache() {
+    SkRasterPipelineBlitterCache::PurgeAll();
+}
+
 static SkGraphics::OpenTypeSVGDecoderFactory gSVGDecoderFactory = nullptr;
 
 SkGraphics::OpenTypeSVGDecoderFactory
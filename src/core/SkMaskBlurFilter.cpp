@@ -8,6 +8,7 @@
 #include "src/core/SkMaskBlurFilter.h"
 
 #include "include/core/SkColorPriv.h"
+#include "include/core/SkExecutor.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTPin.h"
 #include "include/private/base/SkTemplates.h"
@@ -15,6 +16,7 @@
 #include "src/base/SkArenaAlloc.h"
 #include "src/base/SkVx.h"
 #include "src/core/SkGaussFilter.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <cmath>
 #include <climits>
@@ -90,6 +92,14 @@ public:
 
     int    border()     const { return fBorder; }
 
+    // SkOpts::mask_blur_box3_transposed() needs a ring buffer for every pass. Only a window of
+    // one leaves the passes empty, and then Scan is used instead.
+    bool canBlurRows() const { return fPass0Size > 0; }
+
+    SkMaskBlurBoxes boxes() const {
+        return {fWeight, fPass0Size, fPass1Size, fPass2Size, fSlidingWindow};
+    }
+
 public:
     class Scan {
     public:
@@ -950,10 +960,51 @@ static SkIPoint small_blur(double sigmaX, double sigmaY, const SkMask& src, SkMa
     return {radiusX, radiusY};
 }
 
+// Converts a row of width mask values to A8, 8 at a time. strideOf8 is the number of bytes
+// holding 8 of them.
+static void row_to_a8(ToA8 toA8, int strideOf8, uint8_t* a8, const uint8_t* from, int width) {
+    for (int x = 0; x < width; x += 8, from += strideOf8) {
+        toA8(a8 + x, from, std::min(8, width - x));
+    }
+}
+
+// Large blurs are split into groups of rows on the executor. Every row is blurred the
+// same way no matter which group it's in, so this doesn't change any pixels.
+static constexpr int64_t kMinParallelBlurPixels = 256 * 256;
+static constexpr int     kParallelBlurRows      = 64;
+
+// Blurs rows of A8 src with plan's box filters, transposing them into dst.
+static void blur_rows_transposed(const PlanGauss& plan,
+                                 const uint8_t* src, size_t srcRB, int srcW, int rows,
+                                 uint8_t* dst, size_t dstRB, int dstW, SkExecutor& executor) {
+    const SkMaskBlurBoxes boxes = plan.boxes();
+    if ((int64_t)rows * dstW < kMinParallelBlurPixels) {
+        SkOpts::mask_blur_box3_transposed(src, srcRB, srcW, rows, dst, dstRB, dstW, boxes);
+        return;
+    }
+    SkParallelFor(executor, rows, kParallelBlurRows, [&](int start, int end) {
+        SkOpts::mask_blur_box3_transposed(src + start * srcRB, srcRB, srcW, end - start,
+                                          dst + start, dstRB, dstW, boxes);
+    });
+}
+
 // TODO: assuming sigmaW = sigmaH. Allow different sigmas. Right now the
 // API forces the sigmas to be the same.
 SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMaskBuilder* dst) const {
+    return this->blur(src, dst, /*blurSeveralRows=*/true, SkExecutor::GetDefault());
+}
+
+SkIPoint SkMaskBlurFilter::blurRowByRowForTesting(const SkMask& src, SkMaskBuilder* dst) const {
+    return this->blur(src, dst, /*blurSeveralRows=*/false, SkExecutor::GetDefault());
+}
 
+SkIPoint SkMaskBlurFilter::blurForTesting(const SkMask& src, SkMaskBuilder* dst,
+                                          SkExecutor& executor) const {
+    return this->blur(src, dst, /*blurSeveralRows=*/true, executor);
+}
+
+SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMaskBuilder* dst,
+                                bool blurSeveralRows, SkExecutor& executor) const {
     if (fSigmaW < 2.0 && fSigmaH < 2.0) {
         return small_blur(fSigmaW, fSigmaH, src, dst);
     }
@@ -997,57 +1048,85 @@ SkIPoint SkMaskBlurFilter::blur(const SkMask& src, SkMaskBuilder* dst) const {
     auto tmp = alloc.makeArrayDefault<uint8_t>(tmpW * tmpH);
 
     // Blur horizontally, and transpose.
-    const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
-    switch (src.fFormat) {
-        case SkMask::kBW_Format: {
-            const uint8_t* bwStart = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
-            auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+    if (blurSeveralRows && planW.canBlurRows() && srcW > 0) {
+        const uint8_t* a8 = src.fImage;
+        size_t a8RB = src.fRowBytes;
+        if (src.fFormat != SkMask::kA8_Format) {
+            ToA8* toA8;
+            int strideOf8;
+            switch (src.fFormat) {
+                case SkMask::kBW_Format:     toA8 = bw_to_a8;     strideOf8 =  1; break;
+                case SkMask::kARGB32_Format: toA8 = argb32_to_a8; strideOf8 = 32; break;
+                case SkMask::kLCD16_Format:  toA8 = lcd_to_a8;    strideOf8 = 16; break;
+                default: SK_ABORT("Unhandled format.");
             }
-        } break;
-        case SkMask::kA8_Format: {
-            const uint8_t* a8Start = src.fImage;
-            auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
-            auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+            auto converted = alloc.makeArrayDefault<uint8_t>((size_t)srcW * srcH);
+            for (int y = 0; y < srcH; y++) {
+                row_to_a8(toA8, strideOf8, converted + (size_t)y * srcW,
+                          src.fImage + y * src.fRowBytes, srcW);
             }
-        } break;
-        case SkMask::kARGB32_Format: {
-            const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
-            auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        case SkMask::kLCD16_Format: {
-            const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(src.fImage);
-            auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
-            auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
-            for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
-                auto tmpStart = &tmp[y];
-                scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
-            }
-        } break;
-        default:
-            SK_ABORT("Unhandled format.");
+            a8 = converted;
+            a8RB = srcW;
+        }
+        blur_rows_transposed(planW, a8, a8RB, srcW, srcH, tmp, tmpW, tmpH, executor);
+    } else {
+        const PlanGauss::Scan& scanW = planW.makeBlurScan(srcW, buffer);
+        switch (src.fFormat) {
+            case SkMask::kBW_Format: {
+                const uint8_t* bwStart = src.fImage;
+                auto start = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart, 0);
+                auto end = SkMask::AlphaIter<SkMask::kBW_Format>(bwStart + (srcW / 8), srcW % 8);
+                for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kA8_Format: {
+                const uint8_t* a8Start = src.fImage;
+                auto start = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start);
+                auto end = SkMask::AlphaIter<SkMask::kA8_Format>(a8Start + srcW);
+                for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kARGB32_Format: {
+                const uint32_t* argbStart = reinterpret_cast<const uint32_t*>(src.fImage);
+                auto start = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart);
+                auto end = SkMask::AlphaIter<SkMask::kARGB32_Format>(argbStart + srcW);
+                for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            case SkMask::kLCD16_Format: {
+                const uint16_t* lcdStart = reinterpret_cast<const uint16_t*>(src.fImage);
+                auto start = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart);
+                auto end = SkMask::AlphaIter<SkMask::kLCD16_Format>(lcdStart + srcW);
+                for (int y = 0; y < srcH; ++y, start >>= src.fRowBytes, end >>= src.fRowBytes) {
+                    auto tmpStart = &tmp[y];
+                    scanW.blur(start, end, tmpStart, tmpW, tmpStart + tmpW * tmpH);
+                }
+            } break;
+            default:
+                SK_ABORT("Unhandled format.");
+        }
     }
 
     // Blur vertically (scan in memory order because of the transposition),
     // and transpose back to the original orientation.
-    const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
-    for (int y = 0; y < tmpH; y++) {
-        auto tmpStart = &tmp[y * tmpW];
-        auto dstStart = &dst->image()[y];
+    if (blurSeveralRows && planH.canBlurRows() && tmpW > 0) {
+        blur_rows_transposed(planH, tmp, tmpW, tmpW, tmpH, dst->image(), dst->fRowBytes, dstH,
+                             executor);
+    } else {
+        const PlanGauss::Scan& scanH = planH.makeBlurScan(tmpW, buffer);
+        for (int y = 0; y < tmpH; y++) {
+            auto tmpStart = &tmp[y * tmpW];
+            auto dstStart = &dst->image()[y];
 
-        scanH.blur(tmpStart, tmpStart + tmpW,
-                   dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
+            scanH.blur(tmpStart, tmpStart + tmpW,
+                       dstStart, dst->fRowBytes, dstStart + dst->fRowBytes * dstH);
+        }
     }
 
     return {SkTo<int32_t>(borderW), SkTo<int32_t>(borderH)};
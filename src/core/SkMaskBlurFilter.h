@@ -9,12 +9,16 @@
 #define SkMaskBlurFilter_DEFINED
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <tuple>
 
 #include "include/core/SkTypes.h"
 #include "src/core/SkMask.h"
 
+class SkExecutor;
+
 // Implement a single channel Gaussian blur. The specifics for implementation are taken from:
 // https://drafts.fxtf.org/filters/#feGaussianBlurElement
 class SkMaskBlurFilter {
@@ -29,9 +33,42 @@ public:
     // Given a src SkMask, generate dst SkMask returning the border width and height.
     SkIPoint blur(const SkMask& src, SkMaskBuilder* dst) const;
 
+    // Like blur(), but always blurs one row at a time with the portable scalar code, rather than
+    // several rows at once with SkOpts. Both must produce exactly the same mask.
+    SkIPoint blurRowByRowForTesting(const SkMask& src, SkMaskBuilder* dst) const;
+
+    // Like blur(), but splits large masks into groups of rows on executor rather than on
+    // SkExecutor::GetDefault().
+    SkIPoint blurForTesting(const SkMask& src, SkMaskBuilder* dst, SkExecutor& executor) const;
+
 private:
+    SkIPoint blur(const SkMask& src, SkMaskBuilder* dst, bool blurSeveralRows,
+                  SkExecutor& executor) const;
+
     const double fSigmaW;
     const double fSigmaH;
 };
 
+// The three box filters that, run one after another, approximate a Gaussian. Each pass keeps a
+// ring buffer of passNSize sums, and weight is the reciprocal of the total divisor in 32.32 fixed
+// point. slidingWindow is the width of the whole stack of filters.
+struct SkMaskBlurBoxes {
+    uint64_t weight;
+    int      pass0Size;
+    int      pass1Size;
+    int      pass2Size;
+    int      slidingWindow;
+};
+
+namespace SkOpts {
+    // Blurs rows of an A8 image with boxes, and transposes the result: pixel x of row y is
+    // written to dst[x * dstRB + y]. Each blurred row is dstW pixels long. Several rows are blurred
+    // at once, one per SIMD lane, so every store writes a run of adjacent bytes.
+    extern void (*mask_blur_box3_transposed)(const uint8_t* src, size_t srcRB, int srcW, int rows,
+                                             uint8_t* dst, size_t dstRB, int dstW,
+                                             const SkMaskBlurBoxes& boxes);
+
+    void Init_MaskBlurFilter();
+}  // namespace SkOpts
+
 #endif  // SkBlurMaskFilter_DEFINED
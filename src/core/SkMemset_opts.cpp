@@ -26,6 +26,7 @@ namespace SkOpts {
     DEFINE_DEFAULT(rect_memset64);
 
     void Init_Memset_avx();
+    void Init_Memset_skx();
     void Init_Memset_erms();
 
     static bool init() {
@@ -36,6 +37,11 @@ namespace SkOpts {
             if (SkCpu::Supports(SkCpu::AVX)) { Init_Memset_avx(); }
         #endif
 
+        #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_SKX
+            if (SkCpu::Supports(SkCpu::SKX)) { Init_Memset_skx(); }
+        #endif
+
+        // ERMS wraps whichever memsets were chosen above for its small-size cases, so it goes last.
         if (SkCpu::Supports(SkCpu::ERMS)) { Init_Memset_erms(); }
     #endif
       return true;
@@ -17,6 +17,7 @@
 #include "src/base/SkVx.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkMipmapBuilder.h"
+#include "src/core/SkTaskGroup.h"
 
 #include <new>
 
@@ -647,14 +648,26 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
 
         const SkPixmap& dstPM = levels[i].fPixmap;
         if (computeContents) {
-            const void* srcBasePtr = srcPM.addr();
-            void* dstBasePtr = dstPM.writable_addr();
-
-            const size_t srcRB = srcPM.rowBytes();
-            for (int y = 0; y < height; y++) {
-                proc(dstBasePtr, srcBasePtr, srcRB, width);
-                srcBasePtr = (char*)srcBasePtr + srcRB * 2; // jump two rows
-                dstBasePtr = (char*)dstBasePtr + dstPM.rowBytes();
+            const char* srcBasePtr = (const char*)srcPM.addr();
+            char* dstBasePtr = (char*)dstPM.writable_addr();
+
+            const size_t srcRB = srcPM.rowBytes(),
+                         dstRB = dstPM.rowBytes();
+            auto buildRows = [&](int startY, int endY) {
+                for (int y = startY; y < endY; y++) {
+                    proc(dstBasePtr + y * dstRB, srcBasePtr + y * srcRB * 2, srcRB, width);
+                }
+            };
+            // Each row of this level only reads its own two or three rows of the level above,
+            // so we can build rows in parallel, in chunks of roughly kPixelsPerChunk pixels.
+            // If we're already running on a pool thread, though, the pool is busy with other
+            // work, and waiting for our rows would pull that unrelated work onto this stack.
+            static constexpr int kPixelsPerChunk = 16 * 1024;
+            if (SkIsExecutorThread()) {
+                buildRows(0, height);
+            } else {
+                SkParallelFor(SkExecutor::GetDefault(), height,
+                              std::max(1, kPixelsPerChunk / width), buildRows);
             }
         }
         srcPM = dstPM;
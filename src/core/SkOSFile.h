@@ -50,6 +50,11 @@ void*   sk_fdmmap(int fd, size_t* length);
  */
 void    sk_fmunmap(const void* addr, size_t length);
 
+/** Hints that the memory at addr, e.g. a file mapped by sk_fmmap, is about to be read through
+ *  from start to end, so the OS may read ahead of the reader. This may do nothing.
+ */
+void    sk_fmadvise_sequential(const void* addr, size_t length);
+
 /** Returns true if the two point at the exact same filesystem object. */
 bool    sk_fidentical(FILE* a, FILE* b);
 
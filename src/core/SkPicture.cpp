@@ -7,13 +7,19 @@
 
 #include "include/core/SkPicture.h"
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkM44.h"
 #include "include/core/SkPictureRecorder.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkSerialProcs.h"
 #include "include/core/SkStream.h"
 #include "include/private/base/SkTFitsIn.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkMathPriv.h"
+#include "src/core/SkBigPicture.h"
 #include "src/core/SkCanvasPriv.h"
 #include "src/core/SkPictureData.h"
 #include "src/core/SkPicturePlayback.h"
@@ -22,6 +28,7 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkStreamPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkWriteBuffer.h"
 
 #include <atomic>
@@ -334,6 +341,64 @@ void SkPicturePriv::Flatten(const sk_sp<const SkPicture> picture, SkWriteBuffer&
     }
 }
 
+void SkPicture::playbackParallel(SkCanvas* canvas, SkExecutor& executor, SkISize tileSize) const {
+    SkASSERT(canvas);
+    if (canvas->isClipEmpty()) {
+        return;
+    }
+
+    const SkBigPicture* big = this->asSkBigPicture();
+    if (!big || tileSize.isEmpty() || !canvas->isClipRect()) {
+        this->playback(canvas);
+        return;
+    }
+
+    // We're about to write to the canvas's pixels behind its back, so give its surface a chance
+    // to copy-on-write before we look at them.
+    SkPixmap pixmap;
+    if (!SkCanvasPriv::PredrawNotify(canvas)) {
+        return;
+    }
+    if (!canvas->peekPixels(&pixmap)) {
+        this->playback(canvas);
+        return;
+    }
+
+    const SkIRect bounds = canvas->getDeviceClipBounds();
+    const int xTiles = (bounds.width()  + tileSize.width()  - 1) / tileSize.width(),
+              yTiles = (bounds.height() + tileSize.height() - 1) / tileSize.height();
+    if (xTiles * yTiles <= 1 ||
+        !big->canPlaybackTiled(canvas->getTotalMatrix(), bounds, tileSize)) {
+        this->playback(canvas);
+        return;
+    }
+
+    // Every tile draws through its own full-size device over the shared pixels, clipped to the
+    // tile.  Keeping the device the same size as the canvas's means device-space coordinates
+    // (dithering, shader gradients, ...) are the same as if we'd drawn without tiling.
+    SkBitmap bitmap;
+    bitmap.installPixels(pixmap);
+    const SkSurfaceProps props = canvas->getTopProps();
+    const SkM44 ctm = canvas->getLocalToDevice();
+    const SkRect localClip = canvas->getLocalClipBounds();
+
+    SkTaskGroup tiles(executor);
+    tiles.batch(xTiles * yTiles, [&](int i) {
+        SkIRect tile = SkIRect::MakeXYWH(bounds.fLeft + (i % xTiles) * tileSize.width(),
+                                         bounds.fTop  + (i / xTiles) * tileSize.height(),
+                                         tileSize.width(),
+                                         tileSize.height());
+        SkAssertResult(tile.intersect(bounds));
+
+        SkCanvas tileCanvas(bitmap, props);
+        tileCanvas.clipIRect(tile);
+        tileCanvas.setMatrix(ctm);
+        // Where it can, this uses the SkBBoxHierarchy to skip ops outside the tile.
+        big->playbackTile(&tileCanvas, localClip);
+    });
+    tiles.wait();
+}
+
 sk_sp<SkPicture> SkPicture::MakePlaceholder(SkRect cull) {
     struct Placeholder : public SkPicture {
           explicit Placeholder(SkRect cull) : fCull(cull) {}
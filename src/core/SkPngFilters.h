@@ -0,0 +1,48 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngFilters_DEFINED
+#define SkPngFilters_DEFINED
+
+#include <cstddef>
+#include <cstdint>
+
+// The PNG filter types, as numbered in the filter type byte at the start of each filtered row.
+enum SkPngFilterType : int {
+    kNone_SkPngFilterType  = 0,
+    kSub_SkPngFilterType   = 1,
+    kUp_SkPngFilterType    = 2,
+    kAvg_SkPngFilterType   = 3,
+    kPaeth_SkPngFilterType = 4,
+
+    kLast_SkPngFilterType  = kPaeth_SkPngFilterType,
+};
+
+namespace SkOpts {
+    // Filters the rowBytes bytes of row with the given filter type into dst. prev is the
+    // unfiltered row above, or zeros for the first row, and bpp is the number of bytes per pixel,
+    // at least 1. Filtering only reads unfiltered bytes, so every byte is filtered independently
+    // of the others, a whole vector of them at a time.
+    extern void (*png_filter_row)(SkPngFilterType type, const uint8_t* row, const uint8_t* prev,
+                                  size_t rowBytes, size_t bpp, uint8_t* dst);
+
+    // Undoes png_filter_row() in place: unfilters the rowBytes bytes of row, which were filtered
+    // with the given filter type. prev and bpp are as for png_filter_row(), and rowBytes is a
+    // multiple of bpp. Each byte needs the unfiltered byte one pixel to its left, so only Up runs
+    // a whole vector of bytes at a time, and the others a pixel at a time.
+    extern void (*png_unfilter_row)(SkPngFilterType type, uint8_t* row, const uint8_t* prev,
+                                    size_t rowBytes, size_t bpp);
+
+    // libpng's heuristic for choosing among filters: the sum of the n filtered bytes as signed
+    // values, in absolute value. Rows with smaller sums tend to compress better. Once the sum
+    // reaches limit, this may stop counting and return any value of at least limit.
+    extern uint64_t (*png_filtered_row_cost)(const uint8_t* filtered, size_t n, uint64_t limit);
+
+    void Init_PngFilters();
+}  // namespace SkOpts
+
+#endif  // SkPngFilters_DEFINED
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/private/base/SkFeatures.h"
+#include "src/core/SkCpu.h"
+#include "src/core/SkOptsTargets.h"
+#include "src/core/SkPngFilters.h"
+
+#define SK_OPTS_TARGET SK_OPTS_TARGET_DEFAULT
+#include "src/opts/SkOpts_SetTarget.h"
+
+#include "src/opts/SkPngFilters_opts.h"  // IWYU pragma: keep
+
+#include "src/opts/SkOpts_RestoreTarget.h"
+
+namespace SkOpts {
+    DEFINE_DEFAULT(png_filter_row);
+    DEFINE_DEFAULT(png_unfilter_row);
+    DEFINE_DEFAULT(png_filtered_row_cost);
+
+    void Init_PngFilters_ssse3();
+    void Init_PngFilters_hsw();
+
+    static bool init() {
+    #if defined(SK_ENABLE_OPTIMIZE_SIZE)
+        // All Init_foo functions are omitted when optimizing for size
+    #elif defined(SK_CPU_X86)
+        #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_SSSE3
+            if (SkCpu::Supports(SkCpu::SSSE3)) { Init_PngFilters_ssse3(); }
+        #endif
+
+        #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
+            if (SkCpu::Supports(SkCpu::HSW)) { Init_PngFilters_hsw(); }
+        #endif
+    #endif
+      return true;
+    }
+
+    void Init_PngFilters() {
+        [[maybe_unused]] static bool gInitialized = init();
+    }
+}  // namespace SkOpts
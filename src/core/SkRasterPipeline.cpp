@@ -10,16 +10,32 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkStream.h"
+#include "include/core/SkString.h"
+#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTemplates.h"
 #include "modules/skcms/skcms.h"
 #include "src/base/SkVx.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkOpts.h"
+#include "src/core/SkTHash.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
 #include <cstring>
+#include <utility>
 #include <vector>
 
+#if defined(SK_CPU_X86)
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+#endif
+
 using namespace skia_private;
 using Op = SkRasterPipelineOp;
 
@@ -130,35 +146,54 @@ void SkRasterPipeline::append_set_rgb(SkArenaAlloc* alloc, const float rgb[3]) {
     this->unchecked_append(op, arg);
 }
 
-void SkRasterPipeline::append_constant_color(SkArenaAlloc* alloc, const float rgba[4]) {
+SkRasterPipelineOp SkRasterPipeline::ConstantColorOp(const float rgba[4]) {
+    if (rgba[0] == 0 && rgba[1] == 0 && rgba[2] == 0 && rgba[3] == 1) {
+        return Op::black_color;
+    }
+    if (rgba[0] == 1 && rgba[1] == 1 && rgba[2] == 1 && rgba[3] == 1) {
+        return Op::white_color;
+    }
+    // uniform_color requires colors in range and can go lowp,
+    // while unbounded_uniform_color supports out-of-range colors too but not lowp.
+    if (0 <= rgba[0] && rgba[0] <= rgba[3] &&
+        0 <= rgba[1] && rgba[1] <= rgba[3] &&
+        0 <= rgba[2] && rgba[2] <= rgba[3]) {
+        return Op::uniform_color;
+    }
+    return Op::unbounded_uniform_color;
+}
+
+void SkRasterPipeline::SetUniformColor(SkRasterPipeline_UniformColorCtx* ctx,
+                                       const float rgba[4]) {
+    skvx::float4 color = skvx::float4::Load(rgba);
+    color.store(&ctx->r);
+
+    // To make loads more direct, we store 8-bit values in 16-bit slots.
+    // These are only meaningful (and only read) for in-range colors, i.e. uniform_color.
+    if (ConstantColorOp(rgba) == Op::uniform_color) {
+        color = color * 255.0f + 0.5f;
+        ctx->rgba[0] = (uint16_t)color[0];
+        ctx->rgba[1] = (uint16_t)color[1];
+        ctx->rgba[2] = (uint16_t)color[2];
+        ctx->rgba[3] = (uint16_t)color[3];
+    }
+}
+
+SkRasterPipeline_UniformColorCtx* SkRasterPipeline::append_constant_color(SkArenaAlloc* alloc,
+                                                                          const float rgba[4]) {
     // r,g,b might be outside [0,1], but alpha should probably always be in [0,1].
     SkASSERT(0 <= rgba[3] && rgba[3] <= 1);
 
-    if (rgba[0] == 0 && rgba[1] == 0 && rgba[2] == 0 && rgba[3] == 1) {
-        this->append(Op::black_color);
-    } else if (rgba[0] == 1 && rgba[1] == 1 && rgba[2] == 1 && rgba[3] == 1) {
-        this->append(Op::white_color);
-    } else {
-        auto ctx = alloc->make<SkRasterPipeline_UniformColorCtx>();
-        skvx::float4 color = skvx::float4::Load(rgba);
-        color.store(&ctx->r);
-
-        // uniform_color requires colors in range and can go lowp,
-        // while unbounded_uniform_color supports out-of-range colors too but not lowp.
-        if (0 <= rgba[0] && rgba[0] <= rgba[3] &&
-            0 <= rgba[1] && rgba[1] <= rgba[3] &&
-            0 <= rgba[2] && rgba[2] <= rgba[3]) {
-            // To make loads more direct, we store 8-bit values in 16-bit slots.
-            color = color * 255.0f + 0.5f;
-            ctx->rgba[0] = (uint16_t)color[0];
-            ctx->rgba[1] = (uint16_t)color[1];
-            ctx->rgba[2] = (uint16_t)color[2];
-            ctx->rgba[3] = (uint16_t)color[3];
-            this->unchecked_append(Op::uniform_color, ctx);
-        } else {
-            this->unchecked_append(Op::unbounded_uniform_color, ctx);
-        }
+    Op op = ConstantColorOp(rgba);
+    if (op == Op::black_color || op == Op::white_color) {
+        this->append(op);
+        return nullptr;
     }
+
+    auto ctx = alloc->make<SkRasterPipeline_UniformColorCtx>();
+    SetUniformColor(ctx, rgba);
+    this->unchecked_append(op, ctx);
+    return ctx;
 }
 
 void SkRasterPipeline::append_matrix(SkArenaAlloc* alloc, const SkMatrix& matrix) {
@@ -414,30 +449,283 @@ static void prepend_to_pipeline(SkRasterPipelineStage*& ip, SkOpts::StageFn stag
     ip->ctx = ctx;
 }
 
-bool SkRasterPipeline::build_lowp_pipeline(SkRasterPipelineStage* ip) const {
+// ~~~~~~ Stage profiling marks ~~~~~~ //
+
+// The cheapest fine-grained clock we can read: the time-stamp counter on x86, the virtual counter
+// on ARM64, and nanoseconds elsewhere.
+static uint64_t read_cycle_counter() {
+#if defined(SK_CPU_X86)
+    return __rdtsc();
+#elif defined(SK_CPU_ARM64) && (defined(__GNUC__) || defined(__clang__))
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+namespace {
+
+struct StageCounts {
+    uint64_t calls  = 0;
+    uint64_t pixels = 0;
+    uint64_t cycles = 0;
+};
+
+struct StageProfileTable {
+    SkMutex     mutex;
+    StageCounts ops[kNumRasterPipelineHighpOps] SK_GUARDED_BY(mutex);
+
+    static StageProfileTable* Get() {
+        static StageProfileTable* gTable = new StageProfileTable;
+        return gTable;
+    }
+};
+
+// The context of a profile stage. Each stage of a profiled program is followed by one of these,
+// which charges the time since the previous mark to that stage.
+struct ProfileMark : SkRasterPipeline_ProfileCtx {
+    uint64_t*   lastTick;
+    int         op;  // The stage we time, or -1 for the mark that starts the program.
+    StageCounts counts;
+};
+
+void profile_mark(SkRasterPipeline_ProfileCtx* self, int activePixels) {
+    auto mark = static_cast<ProfileMark*>(self);
+    if (mark->op >= 0) {
+        mark->counts.calls  += 1;
+        mark->counts.pixels += activePixels;
+        mark->counts.cycles += read_cycle_counter() - *mark->lastTick;
+    }
+    // Read the counter again so this bookkeeping isn't charged to the next stage.
+    *mark->lastTick = read_cycle_counter();
+}
+
+}  // namespace
+
+// The marks of one profiled program, counting locally until flush() adds them to the table.
+struct SkRasterPipeline::ProfileMarks {
+    explicit ProfileMarks(int maxMarks) {
+        // The marks' addresses are baked into the program, so we can't let fMarks reallocate.
+        fMarks.reserve(maxMarks);
+        fBranches.reserve(maxMarks);
+    }
+
+    // Prepends a mark that times `op`, the stage that will be prepended just before it.
+    void prepend(SkRasterPipelineStage*& ip, SkOpts::StageFn profileFn, Op op) {
+        this->prependMark(ip, profileFn, (int)op);
+    }
+    void prependStart(SkRasterPipelineStage*& ip, SkOpts::StageFn profileFn) {
+        this->prependMark(ip, profileFn, -1);
+    }
+
+    // Each stage is followed by its mark, so a branch must jump twice as far. The branch's
+    // context is shared with unprofiled programs, so this returns a copy to use instead.
+    void* branchContext(Op op, void* ctx) {
+        SkASSERT(fBranches.size() < fBranches.capacity());
+        SkRasterPipeline_BranchIfEqualCtx branch = {};
+        if (op == Op::branch_if_no_active_lanes_eq) {
+            branch = *static_cast<const SkRasterPipeline_BranchIfEqualCtx*>(ctx);
+        }
+        branch.offset = 2 * static_cast<const SkRasterPipeline_BranchCtx*>(ctx)->offset;
+        fBranches.push_back(branch);
+        return &fBranches.back();
+    }
+
+    void clear() {
+        fMarks.clear();
+        fBranches.clear();
+    }
+
+    void flush() const {
+        StageProfileTable* table = StageProfileTable::Get();
+        SkAutoMutexExclusive lock(table->mutex);
+        for (const ProfileMark& mark : fMarks) {
+            if (mark.op >= 0) {
+                StageCounts& counts = table->ops[mark.op];
+                counts.calls  += mark.counts.calls;
+                counts.pixels += mark.counts.pixels;
+                counts.cycles += mark.counts.cycles;
+            }
+        }
+    }
+
+private:
+    void prependMark(SkRasterPipelineStage*& ip, SkOpts::StageFn profileFn, int op) {
+        SkASSERT(fMarks.size() < fMarks.capacity());
+        fMarks.push_back(ProfileMark{{profile_mark}, &fLastTick, op, {}});
+        prepend_to_pipeline(ip, profileFn, &fMarks.back());
+    }
+
+    uint64_t                                       fLastTick = 0;
+    std::vector<ProfileMark>                       fMarks;
+    std::vector<SkRasterPipeline_BranchIfEqualCtx> fBranches;
+};
+
+namespace {
+
+// Runs of stages we replace with one fused stage as we build a program. Fusing saves a dispatch
+// and the register shuffling around it for each stage boundary inside the run. A run fuses only
+// if every stage in it that has a context has the same one; the fused stage takes that context.
+//
+// The first comes from coverage-scaled SrcOver blits into 8888, the others from image shaders
+// and gradients mapping device space into their own. To re-derive the set, run nanobench over
+// the SKP corpus with --stageHistogram and look for the heaviest runs.
+struct StageFusion {
+    Op  fused;
+    int count;
+    Op  ops[3];  // In pipeline order.
+};
+
+constexpr StageFusion kFusions[] = {
+    {Op::load_dst_srcover_store_8888, 3, {Op::load_8888_dst, Op::srcover, Op::store_8888}},
+    {Op::seed_shader_scale_translate, 2, {Op::seed_shader, Op::matrix_scale_translate}},
+    {Op::seed_shader_translate,       2, {Op::seed_shader, Op::matrix_translate}},
+};
+
+// The pipeline positions (in pipeline order) from the first branch or branch target to the last.
+// Branches jump by a count of stages, so fusing a run of stages anywhere in between would change
+// how far they need to jump.
+struct BranchSpan {
+    int lo = INT_MAX;
+    int hi = INT_MIN;
+
+    bool overlaps(int first, int last) const { return first <= hi && lo <= last; }
+};
+
+bool is_branch(Op op) {
+    switch (op) {
+        case Op::jump:
+        case Op::branch_if_all_lanes_active:
+        case Op::branch_if_any_lanes_active:
+        case Op::branch_if_no_lanes_active:
+        case Op::branch_if_no_active_lanes_eq:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
+static BranchSpan find_branch_span(const SkRasterPipeline::StageList* st, int numStages) {
+    BranchSpan span;
+    for (int index = numStages - 1; st; st = st->prev, --index) {
+        if (is_branch(st->stage)) {
+            int target = index + static_cast<const SkRasterPipeline_BranchCtx*>(st->ctx)->offset;
+            span.lo = std::min({span.lo, index, target});
+            span.hi = std::max({span.hi, index, target});
+        }
+    }
+    return span;
+}
+
+// Settable for testing, so we can compare fused programs against unfused ones.
+bool gDisableRasterPipelineStageFusion;
+
+// Looks for a fusable run ending with `st`, which sits at pipeline position `index`. (Remember,
+// the stage list runs backwards.) On success, sets *op, *ctx and *count to the fused stage, its
+// context, and how many stages of the list it replaces.
+static bool find_fusion(const SkRasterPipeline::StageList* st, int index, const BranchSpan& branches,
+                        Op* op, void** ctx, int* count) {
+    if (gDisableRasterPipelineStageFusion) {
+        return false;
+    }
+    for (const StageFusion& fusion : kFusions) {
+        if (branches.overlaps(index - fusion.count + 1, index)) {
+            continue;
+        }
+        const SkRasterPipeline::StageList* stage = st;
+        void* sharedCtx = nullptr;
+        int i = fusion.count;
+        for (; i > 0 && stage; --i, stage = stage->prev) {
+            if (stage->stage != fusion.ops[i - 1]) {
+                break;
+            }
+            if (stage->ctx) {
+                if (sharedCtx && sharedCtx != stage->ctx) {
+                    break;
+                }
+                sharedCtx = stage->ctx;
+            }
+        }
+        if (i == 0) {
+            *op    = fusion.fused;
+            *ctx   = sharedCtx;
+            *count = fusion.count;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SkRasterPipeline::build_lowp_pipeline(SkRasterPipelineStage** program,
+                                           ProfileMarks* marks) const {
     if (gForceHighPrecisionRasterPipeline || fRewindCtx) {
         return false;
     }
     // Stages are stored backwards in fStages; to compensate, we assemble the pipeline in reverse
     // here, back to front.
+    SkRasterPipelineStage* ip = *program;
     prepend_to_pipeline(ip, SkOpts::just_return_lowp, /*ctx=*/nullptr);
-    for (const StageList* st = fStages; st; st = st->prev) {
-        int opIndex = (int)st->stage;
+    const BranchSpan branches = find_branch_span(fStages, fNumStages);
+    int index = fNumStages - 1;
+    for (const StageList* st = fStages; st;) {
+        Op op = st->stage;
+        void* ctx = st->ctx;
+        int count = 1;
+        find_fusion(st, index, branches, &op, &ctx, &count);
+
+        int opIndex = (int)op;
         if (opIndex >= kNumRasterPipelineLowpOps || !SkOpts::ops_lowp[opIndex]) {
             // This program contains a stage that doesn't exist in lowp.
             return false;
         }
-        prepend_to_pipeline(ip, SkOpts::ops_lowp[opIndex], st->ctx);
+        if (marks) {
+            marks->prepend(ip, SkOpts::ops_lowp[(int)Op::profile], op);
+            if (is_branch(op)) {
+                ctx = marks->branchContext(op, ctx);
+            }
+        }
+        prepend_to_pipeline(ip, SkOpts::ops_lowp[opIndex], ctx);
+        index -= count;
+        while (count --> 0) {
+            st = st->prev;
+        }
     }
+    if (marks) {
+        marks->prependStart(ip, SkOpts::ops_lowp[(int)Op::profile]);
+    }
+    *program = ip;
     return true;
 }
 
-void SkRasterPipeline::build_highp_pipeline(SkRasterPipelineStage* ip) const {
+void SkRasterPipeline::build_highp_pipeline(SkRasterPipelineStage** program,
+                                            ProfileMarks* marks) const {
     // We assemble the pipeline in reverse, since the stage list is stored backwards.
+    SkRasterPipelineStage* ip = *program;
     prepend_to_pipeline(ip, SkOpts::just_return_highp, /*ctx=*/nullptr);
-    for (const StageList* st = fStages; st; st = st->prev) {
-        int opIndex = (int)st->stage;
-        prepend_to_pipeline(ip, SkOpts::ops_highp[opIndex], st->ctx);
+    const BranchSpan branches = find_branch_span(fStages, fNumStages);
+    int index = fNumStages - 1;
+    for (const StageList* st = fStages; st;) {
+        Op op = st->stage;
+        void* ctx = st->ctx;
+        int count = 1;
+        find_fusion(st, index, branches, &op, &ctx, &count);
+
+        if (marks) {
+            marks->prepend(ip, SkOpts::ops_highp[(int)Op::profile], op);
+            if (is_branch(op)) {
+                ctx = marks->branchContext(op, ctx);
+            }
+        }
+        prepend_to_pipeline(ip, SkOpts::ops_highp[(int)op], ctx);
+        index -= count;
+        while (count --> 0) {
+            st = st->prev;
+        }
     }
 
     // stack_checkpoint and stack_rewind are only implemented in highp. We only need these stages
@@ -446,21 +734,197 @@ void SkRasterPipeline::build_highp_pipeline(SkRasterPipelineStage* ip) const {
     // code without floating point.
     if (fRewindCtx) {
         const int rewindIndex = (int)Op::stack_checkpoint;
+        if (marks) {
+            marks->prepend(ip, SkOpts::ops_highp[(int)Op::profile], Op::stack_checkpoint);
+        }
         prepend_to_pipeline(ip, SkOpts::ops_highp[rewindIndex], fRewindCtx);
     }
+    if (marks) {
+        marks->prependStart(ip, SkOpts::ops_highp[(int)Op::profile]);
+    }
+    *program = ip;
 }
 
 SkRasterPipeline::StartPipelineFn SkRasterPipeline::build_pipeline(
-        SkRasterPipelineStage* ip) const {
+        SkRasterPipelineStage** program, ProfileMarks* marks) const {
     // We try to build a lowp pipeline first; if that fails, we fall back to a highp float pipeline.
-    if (this->build_lowp_pipeline(ip)) {
+    if (this->build_lowp_pipeline(program, marks)) {
         return SkOpts::start_pipeline_lowp;
     }
 
-    this->build_highp_pipeline(ip);
+    if (marks) {
+        marks->clear();
+    }
+    this->build_highp_pipeline(program, marks);
     return SkOpts::start_pipeline_highp;
 }
 
+// ~~~~~~ Stage histogram ~~~~~~ //
+
+// The stage histogram and stage profiling share one flag word, so run() can rule them both out
+// with a single load.
+enum StageObserver : int {
+    kStageHistogram_StageObserver = 1 << 0,
+    kStageProfiling_StageObserver = 1 << 1,
+};
+static std::atomic<int> gStageObservers{0};
+
+static void set_stage_observer(StageObserver observer, bool enabled) {
+    if (enabled) {
+        gStageObservers.fetch_or(observer, std::memory_order_relaxed);
+    } else {
+        gStageObservers.fetch_and(~observer, std::memory_order_relaxed);
+    }
+}
+
+namespace {
+
+struct StageHistogram {
+    struct Counts {
+        uint64_t pixels = 0;
+        uint64_t calls  = 0;
+    };
+
+    SkMutex                                  mutex;
+    skia_private::THashMap<uint64_t, Counts> runs SK_GUARDED_BY(mutex);
+
+    static StageHistogram* Get() {
+        static StageHistogram* gHistogram = new StageHistogram;
+        return gHistogram;
+    }
+};
+
+// A run of up to three stages, packed into 16 bits each. Zero marks an unused slot.
+uint64_t pack_stage_run(const Op* ops, int count) {
+    uint64_t run = 0;
+    for (int i = 0; i < count; i++) {
+        run |= (uint64_t)((int)ops[i] + 1) << (16 * i);
+    }
+    return run;
+}
+
+}  // namespace
+
+// Every run of two and three consecutive stages in the (unfused) stage list.
+static std::vector<uint64_t> stage_runs(const SkRasterPipeline::StageList* stages) {
+    std::vector<Op> ops;
+    for (const SkRasterPipeline::StageList* st = stages; st; st = st->prev) {
+        ops.push_back(st->stage);
+    }
+    std::reverse(ops.begin(), ops.end());
+
+    std::vector<uint64_t> runs;
+    for (int len = 2; len <= 3; len++) {
+        for (int i = 0; i + len <= (int)ops.size(); i++) {
+            runs.push_back(pack_stage_run(ops.data() + i, len));
+        }
+    }
+    return runs;
+}
+
+static void record_stage_runs(const std::vector<uint64_t>& runs, size_t pixels) {
+    StageHistogram* histogram = StageHistogram::Get();
+    SkAutoMutexExclusive lock(histogram->mutex);
+    for (uint64_t run : runs) {
+        StageHistogram::Counts& counts = histogram->runs[run];
+        counts.pixels += pixels;
+        counts.calls  += 1;
+    }
+}
+
+void SkRasterPipeline::SetStageHistogramEnabled(bool enabled) {
+    set_stage_observer(kStageHistogram_StageObserver, enabled);
+}
+
+void SkRasterPipeline::ResetStageHistogram() {
+    StageHistogram* histogram = StageHistogram::Get();
+    SkAutoMutexExclusive lock(histogram->mutex);
+    histogram->runs.reset();
+}
+
+void SkRasterPipeline::DumpStageHistogram(SkWStream* stream) {
+    std::vector<std::pair<uint64_t, StageHistogram::Counts>> sorted;
+    {
+        StageHistogram* histogram = StageHistogram::Get();
+        SkAutoMutexExclusive lock(histogram->mutex);
+        histogram->runs.foreach([&](uint64_t run, StageHistogram::Counts* counts) {
+            sorted.push_back({run, *counts});
+        });
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.pixels != b.second.pixels ? a.second.pixels > b.second.pixels
+                                                  : a.first < b.first;
+    });
+
+    for (const auto& [run, counts] : sorted) {
+        SkString line = SkStringPrintf("%llu\t%llu",
+                                       (unsigned long long)counts.pixels,
+                                       (unsigned long long)counts.calls);
+        for (uint64_t packed = run; packed; packed >>= 16) {
+            line.appendf("\t%s", GetOpName((Op)((packed & 0xffff) - 1)));
+        }
+        line.append("\n");
+        stream->writeText(line.c_str());
+    }
+}
+
+// ~~~~~~ Stage profiling ~~~~~~ //
+
+void SkRasterPipeline::SetStageProfilingEnabled(bool enabled) {
+    set_stage_observer(kStageProfiling_StageObserver, enabled);
+}
+
+void SkRasterPipeline::ResetStageProfile() {
+    StageProfileTable* table = StageProfileTable::Get();
+    SkAutoMutexExclusive lock(table->mutex);
+    for (StageCounts& counts : table->ops) {
+        counts = {};
+    }
+}
+
+std::vector<SkRasterPipeline::StageProfile> SkRasterPipeline::GetStageProfile() {
+    std::vector<StageProfile> profile;
+    {
+        StageProfileTable* table = StageProfileTable::Get();
+        SkAutoMutexExclusive lock(table->mutex);
+        for (int op = 0; op < kNumRasterPipelineHighpOps; op++) {
+            const StageCounts& counts = table->ops[op];
+            if (counts.calls) {
+                profile.push_back({(Op)op, counts.calls, counts.pixels, counts.cycles});
+            }
+        }
+    }
+    std::stable_sort(profile.begin(), profile.end(), [](const auto& a, const auto& b) {
+        return a.cycles > b.cycles;
+    });
+    return profile;
+}
+
+bool SkRasterPipeline::profiling() const {
+    return fProfileStages ||
+           (gStageObservers.load(std::memory_order_relaxed) & kStageProfiling_StageObserver);
+}
+
+void SkRasterPipeline::run_observed(size_t x, size_t y, size_t w, size_t h) const {
+    if (gStageObservers.load(std::memory_order_relaxed) & kStageHistogram_StageObserver) {
+        record_stage_runs(stage_runs(fStages), w*h);
+    }
+    const bool profile = this->profiling();
+
+    // When profiling, every stage gets a mark after it, and one more starts the program.
+    int stagesNeeded = (profile ? 2 : 1) * this->stages_needed();
+
+    AutoSTMalloc<64, SkRasterPipelineStage> storage(stagesNeeded);
+    ProfileMarks marks(profile ? stagesNeeded : 0);
+
+    SkRasterPipelineStage* program = storage.get() + stagesNeeded;
+    auto start_pipeline = this->build_pipeline(&program, profile ? &marks : nullptr);
+    start_pipeline(x,y,x+w,y+h, program);
+    if (profile) {
+        marks.flush();
+    }
+}
+
 int SkRasterPipeline::stages_needed() const {
     // Add 1 to budget for a `just_return` stage at the end.
     int stages = fNumStages + 1;
@@ -477,13 +941,19 @@ void SkRasterPipeline::run(size_t x, size_t y, size_t w, size_t h) const {
         return;
     }
 
+    if (fProfileStages || gStageObservers.load(std::memory_order_relaxed)) {
+        this->run_observed(x,y,w,h);
+        return;
+    }
+
     int stagesNeeded = this->stages_needed();
 
     // Best to not use fAlloc here... we can't bound how often run() will be called.
-    AutoSTMalloc<32, SkRasterPipelineStage> program(stagesNeeded);
+    AutoSTMalloc<32, SkRasterPipelineStage> storage(stagesNeeded);
 
-    auto start_pipeline = this->build_pipeline(program.get() + stagesNeeded);
-    start_pipeline(x,y,x+w,y+h, program.get());
+    SkRasterPipelineStage* program = storage.get() + stagesNeeded;
+    auto start_pipeline = this->build_pipeline(&program);
+    start_pipeline(x,y,x+w,y+h, program);
 }
 
 std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile() const {
@@ -491,11 +961,32 @@ std::function<void(size_t, size_t, size_t, size_t)> SkRasterPipeline::compile()
         return [](size_t, size_t, size_t, size_t) {};
     }
 
+    if (this->profiling()) {
+        // Each profiled run counts into its own marks, so rather than compiling one program that
+        // every caller shares, run() builds a new one for each call. That needs a pipeline that
+        // lives as long as the compiled program does, which fAlloc's lifetime guarantees.
+        auto pipeline = fAlloc->make<SkRasterPipeline>(fAlloc);
+        pipeline->fRewindCtx = fRewindCtx;
+        pipeline->fStages    = fStages;
+        pipeline->fNumStages = fNumStages;
+        pipeline->fProfileStages = true;
+        return [=](size_t x, size_t y, size_t w, size_t h) {
+            pipeline->run(x,y,w,h);
+        };
+    }
+
     int stagesNeeded = this->stages_needed();
 
-    SkRasterPipelineStage* program = fAlloc->makeArray<SkRasterPipelineStage>(stagesNeeded);
+    SkRasterPipelineStage* program = fAlloc->makeArray<SkRasterPipelineStage>(stagesNeeded)
+                                   + stagesNeeded;
 
-    auto start_pipeline = this->build_pipeline(program + stagesNeeded);
+    auto start_pipeline = this->build_pipeline(&program);
+    if (gStageObservers.load(std::memory_order_relaxed) & kStageHistogram_StageObserver) {
+        return [=, runs = stage_runs(fStages)](size_t x, size_t y, size_t w, size_t h) {
+            record_stage_runs(runs, w*h);
+            start_pipeline(x,y,x+w,y+h, program);
+        };
+    }
     return [=](size_t x, size_t y, size_t w, size_t h) {
         start_pipeline(x,y,x+w,y+h, program);
     };
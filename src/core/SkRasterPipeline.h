@@ -18,8 +18,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <vector>
 
 class SkMatrix;
+class SkWStream;
 enum SkColorType : int;
 struct SkImageInfo;
 struct skcms_TransferFunction;
@@ -107,12 +109,19 @@ public:
 
     // Appends a stage for a constant uniform color.
     // Tries to optimize the stage based on the color.
-    void append_constant_color(SkArenaAlloc*, const float rgba[4]);
+    // Returns the stage's context, or nullptr if the chosen stage doesn't need one.
+    SkRasterPipeline_UniformColorCtx* append_constant_color(SkArenaAlloc*, const float rgba[4]);
 
-    void append_constant_color(SkArenaAlloc* alloc, const SkColor4f& color) {
-        this->append_constant_color(alloc, color.vec());
+    SkRasterPipeline_UniformColorCtx* append_constant_color(SkArenaAlloc* alloc,
+                                                            const SkColor4f& color) {
+        return this->append_constant_color(alloc, color.vec());
     }
 
+    // The stage append_constant_color() picks for this color. Any two colors that pick the same
+    // stage can share a pipeline, by rewriting its context with SetUniformColor().
+    static SkRasterPipelineOp ConstantColorOp(const float rgba[4]);
+    static void SetUniformColor(SkRasterPipeline_UniformColorCtx*, const float rgba[4]);
+
     // Like append_constant_color() but only affecting r,g,b, ignoring the alpha channel.
     void append_set_rgb(SkArenaAlloc*, const float rgb[3]);
 
@@ -132,12 +141,51 @@ public:
 
     bool empty() const { return fStages == nullptr; }
 
+    // When building a program, we fuse some common runs of stages into single stages (see
+    // kFusions in SkRasterPipeline.cpp). To find which runs are worth fusing, enable the stage
+    // histogram: every program run then records each of its runs of two and three consecutive
+    // stages (as appended, before fusion), weighted by the number of pixels drawn.
+    static void SetStageHistogramEnabled(bool);
+    static void ResetStageHistogram();
+
+    // Writes one line per run of stages, most pixels first: pixels, calls, then the stage names.
+    static void DumpStageHistogram(SkWStream*);
+
+    // To see which stages dominate, enable stage profiling: every program run then interleaves a
+    // profile stage after each of its stages (as executed, after fusion) that reads the CPU's
+    // cycle counter. That costs a call per stage per stride, inflating the cycles we record, but
+    // their proportions still point at the expensive stages. Programs built with profiling
+    // disabled are unchanged.
+    struct StageProfile {
+        SkRasterPipelineOp op;
+        uint64_t calls;   // Strides run, each of up to a full stride of pixels.
+        uint64_t pixels;
+        uint64_t cycles;  // Cycle counter ticks: the TSC on x86, the virtual counter on ARM64.
+    };
+    static void SetStageProfilingEnabled(bool);
+    static void ResetStageProfile();
+
+    // Profiles this pipeline's runs, and the programs compiled from it, even when stage profiling
+    // is disabled for everything else.
+    void enableStageProfiling() { fProfileStages = true; }
+
+    // Every op that has run since the last reset, most cycles first.
+    static std::vector<StageProfile> GetStageProfile();
+
 private:
-    bool build_lowp_pipeline(SkRasterPipelineStage* ip) const;
-    void build_highp_pipeline(SkRasterPipelineStage* ip) const;
+    // These build the program backwards from *ip, leaving *ip pointing at its first stage.
+    // Fused stages mean that may be past the start of the stages_needed() we budgeted.
+    // With `marks`, they interleave the profile stages used by stage profiling.
+    struct ProfileMarks;
+    bool build_lowp_pipeline(SkRasterPipelineStage** ip, ProfileMarks* marks) const;
+    void build_highp_pipeline(SkRasterPipelineStage** ip, ProfileMarks* marks) const;
 
     using StartPipelineFn = void(*)(size_t,size_t,size_t,size_t, SkRasterPipelineStage* program);
-    StartPipelineFn build_pipeline(SkRasterPipelineStage*) const;
+    StartPipelineFn build_pipeline(SkRasterPipelineStage** ip, ProfileMarks* marks = nullptr) const;
+
+    bool profiling() const;
+    // run() for when the stage histogram or stage profiling may want to see this run.
+    void run_observed(size_t x, size_t y, size_t w, size_t h) const;
 
     void unchecked_append(SkRasterPipelineOp, void*);
     int stages_needed() const;
@@ -146,6 +194,7 @@ private:
     SkRasterPipeline_RewindCtx* fRewindCtx;
     StageList*                  fStages;
     int                         fNumStages;
+    bool                        fProfileStages = false;
 };
 
 template <size_t bytes>
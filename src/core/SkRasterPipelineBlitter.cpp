@@ -5,26 +5,49 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBlender.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkColorSpace.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkShader.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/private/SkColorData.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkTPin.h"
+#include "include/private/base/SkThreadAnnotations.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkArenaAlloc.h"
 #include "src/base/SkUtils.h"
 #include "src/core/SkBlendModePriv.h"
 #include "src/core/SkBlenderBase.h"
 #include "src/core/SkBlitter.h"
+#include "src/core/SkChecksum.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkColorSpaceXformSteps.h"
+#include "src/core/SkCoreBlitters.h"
 #include "src/core/SkEffectPriv.h"
+#include "src/core/SkImageInfoPriv.h"
+#include "src/core/SkLRUCache.h"
 #include "src/core/SkMask.h"
 #include "src/core/SkMemset.h"
 #include "src/core/SkRasterPipeline.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
+#include "src/shaders/SkColorFilterShader.h"
 #include "src/shaders/SkShaderBase.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+extern bool gForceHighPrecisionRasterPipeline;
+
 class SkRasterPipelineBlitter final : public SkBlitter {
 public:
     // This is our common entrypoint for creating the blitter once we've sorted out shaders.
@@ -37,6 +60,25 @@ public:
                              bool is_constant,
                              sk_sp<SkShader> clipShader);
 
+    // Builds the shader pipeline for paint's shader (or color) and then calls Create().
+    static SkBlitter* CreateForPaint(const SkPixmap& dst,
+                                     const SkPaint& paint,
+                                     const SkColor4f& dstPaintColor,
+                                     const SkMatrix& ctm,
+                                     SkArenaAlloc* alloc,
+                                     sk_sp<SkShader> clipShader,
+                                     const SkSurfaceProps& props);
+
+    // Like CreateForPaint() without a clip shader, but reuses a blitter from the process-wide
+    // cache when one was built for the same kind of paint and dst. Returns nullptr if the
+    // cache is disabled or passes on this paint; callers should then use CreateForPaint().
+    static SkBlitter* CreateCached(const SkPixmap& dst,
+                                   const SkPaint& paint,
+                                   const SkColor4f& dstPaintColor,
+                                   const SkMatrix& ctm,
+                                   SkArenaAlloc* alloc,
+                                   const SkSurfaceProps& props);
+
     SkRasterPipelineBlitter(SkPixmap dst,
                             SkArenaAlloc* alloc)
         : fDst(dst)
@@ -55,6 +97,7 @@ public:
 
 private:
     void blitRectWithTrace(int x, int y, int w, int h, bool trace);
+    void updateMemsetColor();
     void append_load_dst      (SkRasterPipeline*) const;
     void append_store         (SkRasterPipeline*) const;
 
@@ -79,6 +122,10 @@ private:
     // We may be able to specialize blitH() or blitRect() into a memset.
     void   (*fMemset2D)(SkPixmap*, int x,int y, int w,int h, uint64_t color) = nullptr;
     uint64_t fMemsetColor = 0;   // Big enough for largest memsettable dst format, F16.
+    std::function<void(size_t, size_t, size_t, size_t)> fStoreMemsetColor;
+
+    // The context of a constant color pipeline's uniform_color stage, if it has one.
+    SkRasterPipeline_UniformColorCtx* fUniformColor = nullptr;
 
     // Built lazily on first use.
     std::function<void(size_t, size_t, size_t, size_t)> fBlitRect,
@@ -102,16 +149,338 @@ static SkColor4f paint_color_to_dst(const SkPaint& paint, const SkPixmap& dst) {
     return paintColor;
 }
 
-SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
-                                         const SkPaint& paint,
-                                         const SkMatrix& ctm,
-                                         SkArenaAlloc* alloc,
-                                         sk_sp<SkShader> clipShader,
-                                         const SkSurfaceProps& props) {
-    SkColorSpace* dstCS = dst.colorSpace();
-    SkColorType dstCT = dst.colorType();
-    SkColor4f dstPaintColor = paint_color_to_dst(paint, dst);
+namespace {
+
+// Everything a cached blitter's compiled pipelines depend on, besides the dst pixels.
+//
+// Solid-color paints (no shader, color filter or runtime blender) factor out the paint color: their
+// pipelines only see it through one uniform_color context, which a hit patches. The dst color
+// space then only matters through that color, and whether there is one at all (which rules out
+// srcover_rgba_8888 in blitRect()).
+//
+// Any other paint is keyed on the identity of its shader, color filter and blender, along with the
+// CTM, paint color, dither and surface props their stages are built from. Shaders, color filters
+// and blenders are immutable, and the cached entry holds a ref to each, so no other effect can
+// reuse their addresses while the entry could match it. Their stages don't describe their contexts,
+// so nothing is patched: a different CTM or color is a different entry.
+struct BlitterKey {
+    uint64_t fShader        = 0;
+    uint64_t fColorFilter   = 0;   // Including one SkPaintPriv::RemoveColorFilter() folded away.
+    uint64_t fBlender       = 0;   // Zero for blend modes; see fBlendMode.
+    uint64_t fColorSpace    = 0;   // SkColorSpace::hash(); hits also check SkColorSpace::Equals().
+    uint32_t fMatrix[9]     = {};
+    uint32_t fColor[4]      = {};
+    uint32_t fShaderAlpha   = 0;
+    uint32_t fPropsFlags    = 0;
+    uint16_t fColorOp       = 0;   // SkRasterPipeline::ConstantColorOp() of a solid color.
+    uint8_t  fColorType     = 0;
+    uint8_t  fAlphaType     = 0;
+    uint8_t  fBlendMode     = 0;   // For solid colors, after strength reduction (SrcOver -> Src).
+    uint8_t  fHasColorSpace = 0;
+    uint8_t  fHighp         = 0;   // gForceHighPrecisionRasterPipeline, read by compile().
+    uint8_t  fDither        = 0;
+    uint8_t  fGeometry      = 0;   // SkPixelGeometry
+    uint8_t  fSolid         = 0;
+    uint8_t  fPad[2]        = {};
+
+    bool operator==(const BlitterKey& that) const {
+        return 0 == memcmp(this, &that, sizeof(BlitterKey));
+    }
+};
+static_assert(std::has_unique_object_representations<BlitterKey>::value);
+
+static uint64_t identity(const void* ptr) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(ptr));
+}
+
+// A cached blitter lives in its own arena, along with every context its pipelines point to. It
+// holds refs on what its key identifies, declared first so they outlive the arena's contexts.
+struct CachedBlitter {
+    sk_sp<SkShader>          fShader;
+    sk_sp<SkColorFilter>     fColorFilter;
+    sk_sp<SkBlender>         fBlender;
+    sk_sp<SkColorSpace>      fColorSpace;
+    SkSTArenaAlloc<2048>     fAlloc;
+    SkRasterPipelineBlitter* fBlitter = nullptr;
+};
+
+// One bounded LRU cache shared by every thread. Blitters are handed out exclusively: a hit removes
+// the blitter from the cache, and the draw returns it when it's done, so two threads (or a nested
+// draw) never run the same pipelines at once; a concurrent draw of the same kind just misses. A
+// slot whose blitter is checked out still counts toward the limit, so we don't build a second one
+// just to evict it again when both come back.
+//
+// Paints with effects are only cached the second time their key is seen recently. Plenty of draws
+// wrap their shader in a new object every time (shaders with color filters folded in), and those
+// should neither pay to build an entry nor evict useful ones. Image shaders aren't cached at all.
+constexpr int kDefaultCountLimit = 32;
+
+thread_local size_t tThreadHits = 0;
+
+class BlitterCache {
+public:
+    static BlitterCache* Get() {
+        static BlitterCache* cache = new BlitterCache;
+        return cache;
+    }
+
+    struct Checkout {
+        std::unique_ptr<CachedBlitter> fCached;   // Set on a hit.
+        bool                           fBuild = false;  // On a miss, build one to check in.
+        uint32_t                       fGeneration = 0;
+    };
+
+    Checkout checkout(const BlitterKey& key, const SkColorSpace* dstCS) {
+        Checkout result;
+        SkAutoMutexExclusive lock(fMutex);
+        if (!fLRU) {
+            return result;
+        }
+        result.fGeneration = fGeneration;
+        std::unique_ptr<CachedBlitter>* slot = fLRU->find(key);
+        if (slot && *slot && (key.fSolid || SkColorSpace::Equals((*slot)->fColorSpace.get(),
+                                                                 dstCS))) {
+            fHits++;
+            tThreadHits++;
+            result.fCached = std::move(*slot);
+            return result;
+        }
+        fMisses++;
+        result.fBuild = key.fSolid || slot || this->seenRecently(key);
+        return result;
+    }
+
+    void checkin(const BlitterKey& key, uint32_t generation,
+                 std::unique_ptr<CachedBlitter> blitter) {
+        SkAutoMutexExclusive lock(fMutex);
+        if (!fLRU || generation != fGeneration) {
+            return;  // The cache was purged or turned off while this blitter was out.
+        }
+        std::unique_ptr<CachedBlitter>* slot = fLRU->find(key);
+        if (!slot) {
+            fLRU->insert(key, std::move(blitter));
+        } else if (!*slot || !SkColorSpace::Equals((*slot)->fColorSpace.get(),
+                                                   blitter->fColorSpace.get())) {
+            *slot = std::move(blitter);
+        }
+        // Otherwise a concurrent or nested draw of the same kind returned its blitter first.
+    }
+
+    size_t hits() const {
+        SkAutoMutexExclusive lock(fMutex);
+        return fHits;
+    }
+    size_t misses() const {
+        SkAutoMutexExclusive lock(fMutex);
+        return fMisses;
+    }
+    int countLimit() const {
+        SkAutoMutexExclusive lock(fMutex);
+        return fCountLimit;
+    }
+
+    int setCountLimit(int count) {
+        SkAutoMutexExclusive lock(fMutex);
+        int prev = fCountLimit;
+        fCountLimit = std::max(count, 0);
+        // SkLRUCache's limit is fixed at construction, so any change starts over empty.
+        fLRU = fCountLimit > 0 ? std::make_unique<LRU>(fCountLimit) : nullptr;
+        fGeneration++;
+        return prev;
+    }
+
+    void purgeAll() {
+        SkAutoMutexExclusive lock(fMutex);
+        if (fLRU) {
+            fLRU->reset();
+        }
+        fGeneration++;
+    }
+
+private:
+    using LRU = SkLRUCache<BlitterKey, std::unique_ptr<CachedBlitter>>;
+
+    static constexpr int kRecentKeys = 16;
+
+    BlitterCache() : fLRU(std::make_unique<LRU>(kDefaultCountLimit)) {}
+
+    bool seenRecently(const BlitterKey& key) SK_REQUIRES(fMutex) {
+        const uint32_t hash = SkGoodHash()(key);
+        for (uint32_t recent : fRecentKeys) {
+            if (recent == hash) {
+                return true;
+            }
+        }
+        fRecentKeys[fNextRecentKey] = hash;
+        fNextRecentKey = (fNextRecentKey + 1) % kRecentKeys;
+        return false;
+    }
+
+    mutable SkMutex      fMutex;
+    std::unique_ptr<LRU> fLRU           SK_GUARDED_BY(fMutex);
+    int                  fCountLimit    SK_GUARDED_BY(fMutex) = kDefaultCountLimit;
+    uint32_t             fGeneration    SK_GUARDED_BY(fMutex) = 0;
+    size_t               fHits          SK_GUARDED_BY(fMutex) = 0;
+    size_t               fMisses        SK_GUARDED_BY(fMutex) = 0;
+    uint32_t             fRecentKeys[kRecentKeys] SK_GUARDED_BY(fMutex) = {};
+    int                  fNextRecentKey SK_GUARDED_BY(fMutex) = 0;
+};
+
+// Allocated in the draw's arena; returns the cached blitter when that arena goes away.
+class CachedBlitterLease {
+public:
+    CachedBlitterLease(const BlitterKey& key, uint32_t generation,
+                       std::unique_ptr<CachedBlitter> blitter)
+        : fKey(key), fGeneration(generation), fBlitter(std::move(blitter)) {}
+
+    ~CachedBlitterLease() {
+        BlitterCache::Get()->checkin(fKey, fGeneration, std::move(fBlitter));
+    }
 
+private:
+    BlitterKey                     fKey;
+    uint32_t                       fGeneration;
+    std::unique_ptr<CachedBlitter> fBlitter;
+};
+
+}  // namespace
+
+size_t SkRasterPipelineBlitterCache::GetHits() {
+    return BlitterCache::Get()->hits();
+}
+size_t SkRasterPipelineBlitterCache::GetMisses() {
+    return BlitterCache::Get()->misses();
+}
+int SkRasterPipelineBlitterCache::GetCountLimit() {
+    return BlitterCache::Get()->countLimit();
+}
+int SkRasterPipelineBlitterCache::SetCountLimit(int count) {
+    return BlitterCache::Get()->setCountLimit(count);
+}
+void SkRasterPipelineBlitterCache::PurgeAll() {
+    BlitterCache::Get()->purgeAll();
+}
+size_t SkRasterPipelineBlitterCache::GetThreadHitsForTesting() {
+    return tThreadHits;
+}
+
+SkBlitter* SkRasterPipelineBlitter::CreateCached(const SkPixmap& dst,
+                                                 const SkPaint& paint,
+                                                 const SkColor4f& dstPaintColor,
+                                                 const SkMatrix& ctm,
+                                                 SkArenaAlloc* alloc,
+                                                 const SkSurfaceProps& props) {
+    if (dst.colorType() == kUnknown_SkColorType) {
+        return nullptr;
+    }
+
+    std::optional<SkBlendMode> blendMode = paint.asBlendMode();
+    const bool solid = blendMode && !paint.getShader() && !paint.getColorFilter();
+
+    BlitterKey key;
+    key.fColorType     = SkToU8(dst.colorType());
+    key.fAlphaType     = SkToU8(dst.alphaType());
+    key.fHasColorSpace = dst.colorSpace() != nullptr;
+    key.fHighp         = gForceHighPrecisionRasterPipeline;
+    key.fSolid         = solid;
+
+    // This is the color a solid paint's blitter ends up with after its constant color pipeline.
+    SkPMColor4f color = dstPaintColor.premul();
+    sk_sp<SkShader> shader = paint.refShader();
+    sk_sp<SkColorFilter> colorFilter = paint.refColorFilter();
+    if (solid) {
+        if (SkColorTypeIsNormalized(dst.colorType())) {
+            for (int i = 0; i < 4; i++) {
+                color[i] = SkTPin(color[i], 0.0f, 1.0f);
+            }
+        }
+        if (color.fA == 1.0f && *blendMode == SkBlendMode::kSrcOver) {
+            blendMode = SkBlendMode::kSrc;
+        }
+        key.fColorOp   = SkToU16((int)SkRasterPipeline::ConstantColorOp(color.vec()));
+        key.fBlendMode = SkToU8(*blendMode);
+    } else {
+        // SkBlitter::Choose() folds color filters into a new SkColorFilterShader for each draw, so
+        // key on what it wraps instead.
+        if (shader && as_SB(shader)->type() == SkShaderBase::ShaderType::kColorFilter &&
+            !colorFilter) {
+            auto cfShader = static_cast<const SkColorFilterShader*>(shader.get());
+            colorFilter = cfShader->filter();
+            key.fShaderAlpha = sk_bit_cast<uint32_t>(cfShader->alpha());
+            shader = cfShader->shader();
+        }
+        // An entry would keep an image shader's image alive, and with it any pixels cached for
+        // the image, long after the caller has let go of it.
+        if (shader && shader->isAImage()) {
+            return nullptr;
+        }
+        key.fShader      = identity(shader.get());
+        key.fColorFilter = identity(colorFilter.get());
+        if (blendMode) {
+            key.fBlendMode = SkToU8(*blendMode);
+        } else {
+            key.fBlender = identity(paint.getBlender());
+        }
+        key.fColorSpace = dst.colorSpace() ? dst.colorSpace()->hash() : 0;
+        for (int i = 0; i < 9; i++) {
+            key.fMatrix[i] = sk_bit_cast<uint32_t>(ctm[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+            key.fColor[i] = sk_bit_cast<uint32_t>(dstPaintColor[i]);
+        }
+        key.fDither     = paint.isDither();
+        key.fPropsFlags = props.flags();
+        key.fGeometry   = SkToU8(props.pixelGeometry());
+    }
+
+    BlitterCache::Checkout checkout = BlitterCache::Get()->checkout(key, dst.colorSpace());
+    std::unique_ptr<CachedBlitter> cached = std::move(checkout.fCached);
+    if (!cached && !checkout.fBuild) {
+        return nullptr;
+    }
+
+    if (!cached) {
+        cached = std::make_unique<CachedBlitter>();
+        cached->fShader      = std::move(shader);
+        cached->fColorFilter = std::move(colorFilter);
+        cached->fBlender     = paint.refBlender();
+        cached->fColorSpace  = dst.refColorSpace();
+        SkBlitter* blitter = CreateForPaint(dst, paint, dstPaintColor, ctm, &cached->fAlloc,
+                                            /*clipShader=*/nullptr, props);
+        if (!blitter) {
+            return nullptr;
+        }
+        cached->fBlitter = static_cast<SkRasterPipelineBlitter*>(blitter);
+    } else {
+        // Patch in this draw's dst, and a solid paint's color; everything else already matches.
+        SkRasterPipelineBlitter* blitter = cached->fBlitter;
+        blitter->fDst = dst;
+        if (solid) {
+            if (blitter->fUniformColor) {
+                SkRasterPipeline::SetUniformColor(blitter->fUniformColor, color.vec());
+            }
+            if (blitter->fMemset2D) {
+                blitter->updateMemsetColor();
+            }
+        }
+        blitter->fDstPtr = SkRasterPipeline_MemoryCtx{
+            blitter->fDst.writable_addr(),
+            blitter->fDst.rowBytesAsPixels(),
+        };
+    }
+
+    SkRasterPipelineBlitter* blitter = cached->fBlitter;
+    alloc->make<CachedBlitterLease>(key, checkout.fGeneration, std::move(cached));
+    return blitter;
+}
+
+SkBlitter* SkRasterPipelineBlitter::CreateForPaint(const SkPixmap& dst,
+                                                   const SkPaint& paint,
+                                                   const SkColor4f& dstPaintColor,
+                                                   const SkMatrix& ctm,
+                                                   SkArenaAlloc* alloc,
+                                                   sk_sp<SkShader> clipShader,
+                                                   const SkSurfaceProps& props) {
     auto shader = as_SB(paint.getShader());
 
     SkRasterPipeline_<256> shaderPipeline;
@@ -120,27 +489,47 @@ SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
         shaderPipeline.append_constant_color(alloc, dstPaintColor.premul().vec());
         bool is_opaque    = dstPaintColor.fA == 1.0f,
              is_constant  = true;
-        return SkRasterPipelineBlitter::Create(dst, paint, dstPaintColor, alloc, shaderPipeline,
-                                               is_opaque, is_constant, std::move(clipShader));
+        return Create(dst, paint, dstPaintColor, alloc, shaderPipeline,
+                      is_opaque, is_constant, std::move(clipShader));
     }
 
     bool is_opaque    = shader->isOpaque() && dstPaintColor.fA == 1.0f;
     bool is_constant  = shader->isConstant();
 
-    if (shader->appendRootStages({&shaderPipeline, alloc, dstCT, dstCS, dstPaintColor, props},
+    if (shader->appendRootStages({&shaderPipeline, alloc, dst.colorType(), dst.colorSpace(),
+                                  dstPaintColor, props},
                                  ctm)) {
         if (dstPaintColor.fA != 1.0f) {
             shaderPipeline.append(SkRasterPipelineOp::scale_1_float,
                                   alloc->make<float>(dstPaintColor.fA));
         }
-        return SkRasterPipelineBlitter::Create(dst, paint, dstPaintColor, alloc, shaderPipeline,
-                                               is_opaque, is_constant, std::move(clipShader));
+        return Create(dst, paint, dstPaintColor, alloc, shaderPipeline,
+                      is_opaque, is_constant, std::move(clipShader));
     }
 
     // The shader can't draw with SkRasterPipeline.
     return nullptr;
 }
 
+SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
+                                         const SkPaint& paint,
+                                         const SkMatrix& ctm,
+                                         SkArenaAlloc* alloc,
+                                         sk_sp<SkShader> clipShader,
+                                         const SkSurfaceProps& props,
+                                         bool useCache) {
+    SkColor4f dstPaintColor = paint_color_to_dst(paint, dst);
+
+    if (useCache && !clipShader) {
+        if (SkBlitter* cached = SkRasterPipelineBlitter::CreateCached(dst, paint, dstPaintColor,
+                                                                      ctm, alloc, props)) {
+            return cached;
+        }
+    }
+    return SkRasterPipelineBlitter::CreateForPaint(dst, paint, dstPaintColor, ctm, alloc,
+                                                   std::move(clipShader), props);
+}
+
 SkBlitter* SkCreateRasterPipelineBlitter(const SkPixmap& dst,
                                          const SkPaint& paint,
                                          const SkRasterPipeline& shaderPipeline,
@@ -265,7 +654,7 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
         colorPipeline->append(SkRasterPipelineOp::store_f32, &constantColorPtr);
         colorPipeline->run(0,0,1,1);
         colorPipeline->reset();
-        colorPipeline->append_constant_color(alloc, constantColor);
+        blitter->fUniformColor = colorPipeline->append_constant_color(alloc, constantColor);
 
         is_opaque = constantColor.fA == 1.0f;
     }
@@ -289,11 +678,7 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
         dst.info().bytesPerPixel() <= static_cast<int>(sizeof(blitter->fMemsetColor))) {
         // Run our color pipeline all the way through to produce what we'd memset when we can.
         // Not all blits can memset, so we need to keep colorPipeline too.
-        SkRasterPipeline_<256> p;
-        p.extend(*colorPipeline);
-        blitter->fDstPtr = SkRasterPipeline_MemoryCtx{&blitter->fMemsetColor, 0};
-        blitter->append_store(&p);
-        p.run(0,0,1,1);
+        blitter->updateMemsetColor();
 
         switch (blitter->fDst.shiftPerPixel()) {
             case 0: blitter->fMemset2D = [](SkPixmap* dst, int x,int y, int w,int h, uint64_t c) {
@@ -338,6 +723,19 @@ SkBlitter* SkRasterPipelineBlitter::Create(const SkPixmap& dst,
     return blitter;
 }
 
+void SkRasterPipelineBlitter::updateMemsetColor() {
+    // This pipeline stores through fDstPtr like any other, so point that at fMemsetColor for now.
+    // Callers must point it back at fDst afterwards.
+    if (!fStoreMemsetColor) {
+        SkRasterPipeline p(fAlloc);
+        p.extend(fColorPipeline);
+        this->append_store(&p);
+        fStoreMemsetColor = p.compile();
+    }
+    fDstPtr = SkRasterPipeline_MemoryCtx{&fMemsetColor, 0};
+    fStoreMemsetColor(0,0,1,1);
+}
+
 void SkRasterPipelineBlitter::append_load_dst(SkRasterPipeline* p) const {
     p->append_load_dst(fDst.info().colorType(), &fDstPtr);
     if (fDst.info().alphaType() == kUnpremul_SkAlphaType) {
@@ -8,16 +8,24 @@
 #ifndef SkRasterPipelineOpContexts_DEFINED
 #define SkRasterPipelineOpContexts_DEFINED
 
+#include "include/private/base/SkFeatures.h"
+
 #include <cstddef>
 
 namespace SkSL { class TraceHook; }
 
 // The largest number of pixels we handle at a time. We have a separate value for the largest number
 // of pixels we handle in the highp pipeline. Many of the context structs in this file are only used
-// by stages that have no lowp implementation. They can therefore use the (smaller) highp value to
-// save memory in the arena.
+// by stages that have no lowp implementation. They can therefore use the highp value to save memory
+// in the arena. Highp runs 16 pixels at a time with SKX, which any x86 build may install, so x86
+// builds pay for 16-wide highp contexts; everything else keeps the smaller 8. This must not depend
+// on SK_CPU_SSE_LEVEL, which SkOpts_SetTarget.h changes from one translation unit to the next.
 inline static constexpr int SkRasterPipeline_kMaxStride = 16;
+#if defined(SK_CPU_X86)
+inline static constexpr int SkRasterPipeline_kMaxStride_highp = 16;
+#else
 inline static constexpr int SkRasterPipeline_kMaxStride_highp = 8;
+#endif
 
 // These structs hold the context data for many of the Raster Pipeline ops.
 struct SkRasterPipeline_MemoryCtx {
@@ -105,6 +113,12 @@ struct SkRasterPipeline_CallbackCtx {
     float* read_from = rgba;
 };
 
+// SkRasterPipeline interleaves a profile stage between every pair of stages when stage profiling
+// is enabled. Unlike callback, fn() sees no pixels, just how many are active.
+struct SkRasterPipeline_ProfileCtx {
+    void (*fn)(SkRasterPipeline_ProfileCtx* self, int active_pixels);
+};
+
 // state shared by stack_checkpoint and stack_rewind
 struct SkRasterPipelineStage;
 
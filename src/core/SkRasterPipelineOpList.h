@@ -37,6 +37,9 @@
     M(darken) M(difference)                                        \
     M(exclusion) M(hardlight) M(lighten) M(overlay)                \
     M(srcover_rgba_8888)                                           \
+    M(load_dst_srcover_store_8888)                                 \
+    M(seed_shader_translate) M(seed_shader_scale_translate)        \
+    M(profile)                                                     \
     M(matrix_translate) M(matrix_scale_translate)                  \
     M(matrix_2x3)                                                  \
     M(matrix_perspective)                                          \
@@ -10,11 +10,14 @@
 #define SkScan_DEFINED
 
 #include "include/core/SkRect.h"
+#include "include/core/SkRegion.h"
 #include "include/private/base/SkFixed.h"
 #include <atomic>
+#include <memory>
 
+class SkAAClip;
+class SkFillPathEdges;
 class SkRasterClip;
-class SkRegion;
 class SkBlitter;
 class SkPath;
 
@@ -25,6 +28,7 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseAnalyticAA;
 extern std::atomic<bool> gSkForceAnalyticAA;
+extern std::atomic<bool> gSkUseSparseStripAA;
 
 class AdditiveBlitter;
 
@@ -76,6 +80,12 @@ public:
     // Needed by SkRegion::setPath
     static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
 
+    // The sparse strip anti-aliased fill that AntiFillPath() uses when gSkUseSparseStripAA is set
+    // (public so tests can compare it with the others directly). It blits 4-row masks and spans
+    // out of scanline order, and only fills non-inverse paths.
+    static void SparseStripFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
+                                    const SkIRect& clipBounds);
+
 private:
     friend class SkAAClip;
     friend class SkRegion;
@@ -98,6 +108,36 @@ private:
                             const SkIRect& clipBounds, bool forceRLE);
 };
 
+/** A path fill split into horizontal bands of device rows. Each band draws exactly what
+    SkScan::FillPath() or AntiFillPath() would draw in its rows, with its own blitter, so the bands
+    can be drawn concurrently and in any order. The path's edges are built once, up front.
+*/
+class SkBandedFill {
+public:
+    SkBandedFill();
+    ~SkBandedFill();
+
+    // Splits the fill into bands of bandHeight rows, aligned to multiples of bandHeight. Returns
+    // false if this fill can't be split up exactly: inverse and convex fills, fills that need
+    // their clip trimmed, and antialiased fills that SkScan wouldn't supersample row by row.
+    bool init(const SkPath&, const SkRasterClip&, bool antiAlias, int bandHeight);
+
+    int bandCount() const;
+
+    // Draws one band. Different bands may be drawn concurrently.
+    void fillBand(int band, SkBlitter*) const;
+
+private:
+    bool initBW(const SkPath&, int bandHeight);
+    bool initAA(const SkPath&, bool forceRLE, int bandHeight);
+
+    std::unique_ptr<SkFillPathEdges> fEdges;
+    SkRegion                         fClip;
+    const SkAAClip*                  fAAClip = nullptr;
+    SkIRect                          fPathIR = SkIRect::MakeEmpty();
+    bool                             fAntiAlias = false;
+};
+
 /** Assign an SkXRect from a SkIRect, by promoting the src rect's coordinates
     from int to SkFixed. Does not check for overflow if the src coordinates
     exceed 32K
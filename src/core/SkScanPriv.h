@@ -9,7 +9,9 @@
 #define SkScanPriv_DEFINED
 
 #include "include/core/SkPath.h"
+#include "include/private/base/SkTArray.h"
 #include "src/core/SkBlitter.h"
+#include "src/core/SkEdgeBuilder.h"
 #include "src/core/SkScan.h"
 
 #if defined(SK_DISABLE_AAA) && defined(SK_FORCE_AAA)
@@ -44,6 +46,48 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
                   bool pathContainedInClip);
 
+// The sorted edges that sk_fill_path() walks, built once so that the horizontal bands of a
+// non-inverse fill can each walk just their own rows (see SkBandedFill). Bands are rows
+// [k * bandHeight, (k + 1) * bandHeight) of the device, clipped to the rows of the fill.
+class SkFillPathEdges {
+public:
+    explicit SkFillPathEdges(int shiftEdgesUp) : fBuilder(shiftEdgesUp), fShift(shiftEdgesUp) {}
+
+    // Takes the same arguments as sk_fill_path(). Returns false if there's nothing to draw.
+    bool init(const SkPath& path, const SkIRect& clipRect, int start_y, int stop_y,
+              bool pathContainedInClip, int bandHeight);
+
+    int bandCount() const { return fBandCount; }
+
+    // Draws one band's rows of what sk_fill_path() would draw, with the same calls to blitter.
+    // This doesn't change the edges, so different bands may be drawn concurrently.
+    void fillBand(int band, SkBlitter* blitter) const;
+
+private:
+    bool startBand(int band, int top, int bottom, SkArenaAlloc*, SkEdge* head, SkEdge* tail) const;
+    void startAtTop(int bottom, SkArenaAlloc*, SkEdge* head, SkEdge* tail) const;
+
+    SkBasicEdgeBuilder fBuilder;
+    const int          fShift;
+    SkEdge**           fEdges = nullptr;  // Sorted by first row, then by x.
+    int                fCount = 0;
+    SkPathFillType     fFillType = SkPathFillType::kWinding;
+    int                fStartY = 0;       // The (shifted) rows walked by the whole fill.
+    int                fStopY = 0;
+    int                fRightClip = 0;
+    int                fBandHeight = 0;   // Not shifted.
+    int                fFirstBand = 0;
+    int                fBandCount = 0;
+    // For each band, the indices of the edges that start above it and reach down into it.
+    skia_private::TArray<skia_private::TArray<int>> fEdgesIntoBand;
+};
+
+// Supersamples one band of edges built with SK_SUPERSAMPLE_SHIFT, as SkScan::SAAFillPath() would.
+void sk_supersample_band(const SkFillPathEdges& edges, int band, SkBlitter* blitter,
+                         const SkIRect& pathIR, const SkIRect& clipBounds);
+// Whether SkScan::SAAFillPath() would supersample this fill row by row, rather than into a mask.
+bool sk_supersamples_rows(const SkIRect& pathIR, bool forceRLE);
+
 // blit the rects above and below avoid, clipped to clip
 void sk_blit_above(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
 void sk_blit_below(SkBlitter*, const SkIRect& avoid, const SkRegion& clip);
@@ -146,7 +146,11 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         sk_blit_above(blitter, ir, *clipRgn);
     }
 
-    if (ShouldUseAAA(path)) {
+    if (gSkUseSparseStripAA && !isInverse && !forceRLE) {
+        // Sparse strips blit four rows at a time, so can't feed blitters that need scanline
+        // order (forceRLE), nor fill outside the path for inverse fills.
+        SkScan::SparseStripFillPath(path, blitter, ir, clipRgn->getBounds());
+    } else if (ShouldUseAAA(path)) {
         // Do not use AAA if path is too complicated:
         // there won't be any speedup or significant visual improvement.
         SkScan::AAAFillPath(path, blitter, ir, clipRgn->getBounds(), forceRLE);
@@ -159,6 +163,28 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
     }
 }
 
+// Follows AntiFillPath(), but gives up wherever that wouldn't supersample row by row, or would
+// trim the clip.
+bool SkBandedFill::initAA(const SkPath& path, bool forceRLE, int bandHeight) {
+    const SkIRect ir = safeRoundOut(path.getBounds());
+    SkIRect clippedIR;
+    if (ir.isEmpty() || !clippedIR.intersect(ir, fClip.getBounds()) ||
+        rect_overflows_short_shift(clippedIR, SK_SUPERSAMPLE_SHIFT)) {
+        return false;
+    }
+    static const int32_t kMaxClipCoord = 32767;
+    if (fClip.getBounds().fRight > kMaxClipCoord || fClip.getBounds().fBottom > kMaxClipCoord) {
+        return false;
+    }
+    if (gSkUseSparseStripAA || ShouldUseAAA(path) || !sk_supersamples_rows(ir, forceRLE)) {
+        return false;
+    }
+    fPathIR = ir;
+    fEdges = std::make_unique<SkFillPathEdges>(SK_SUPERSAMPLE_SHIFT);
+    return fEdges->init(path, fClip.getBounds(), ir.fTop, ir.fBottom,
+                        /*pathContainedInClip=*/fClip.getBounds().contains(ir), bandHeight);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "src/core/SkRasterClip.h"
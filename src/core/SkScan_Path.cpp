@@ -10,7 +10,9 @@
 #include "include/private/base/SkMacros.h"
 #include "include/private/base/SkSafe32.h"
 #include "include/private/base/SkTemplates.h"
+#include "src/base/SkArenaAlloc.h"
 #include "src/base/SkTSort.h"
+#include "src/core/SkAAClip.h"
 #include "src/core/SkBlitter.h"
 #include "src/core/SkEdge.h"
 #include "src/core/SkEdgeBuilder.h"
@@ -20,6 +22,8 @@
 #include "src/core/SkRectPriv.h"
 #include "src/core/SkScanPriv.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <utility>
 
 #define kEDGE_HEAD_Y    SK_MinS32
@@ -471,6 +475,221 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+
+static SkEdge* copy_edge(const SkEdge& edge, SkArenaAlloc* alloc) {
+    switch (edge.fEdgeType) {
+        case SkEdge::kLine_Type:
+            return alloc->make<SkEdge>(edge);
+        case SkEdge::kQuad_Type:
+            return alloc->make<SkQuadraticEdge>(static_cast<const SkQuadraticEdge&>(edge));
+        case SkEdge::kCubic_Type:
+            return alloc->make<SkCubicEdge>(static_cast<const SkCubicEdge&>(edge));
+    }
+    SkUNREACHABLE;
+}
+
+// Moves on to the next segment of a curve, as walk_edges() does after its last row.
+static bool next_segment(SkEdge* edge) {
+    if (edge->fCurveCount > 0) {
+        return ((SkQuadraticEdge*)edge)->updateQuadratic();
+    }
+    if (edge->fCurveCount < 0) {
+        return ((SkCubicEdge*)edge)->updateCubic();
+    }
+    return false;
+}
+
+// Steps an edge that starts above row y into the state walk_edges() leaves it in when it reaches
+// y. Returns false if the edge ends above y.
+static bool advance_edge_to(SkEdge* edge, int y) {
+    while (edge->fLastY < y) {
+        if (!next_segment(edge)) {
+            return false;
+        }
+    }
+    // walk_edges() adds fDX once per row; wrapping adds of the same total give the same bits.
+    edge->fX = (SkFixed)((uint32_t)edge->fX + (uint32_t)(y - edge->fFirstY) * (uint32_t)edge->fDX);
+    edge->fFirstY = y;
+    return true;
+}
+
+// Links edges between head and tail, which are set up as sk_fill_path() sets them up.
+static void link_edges(SkEdge* const edges[], int count, SkEdge* head, SkEdge* tail) {
+    head->fPrev = nullptr;
+    head->fFirstY = kEDGE_HEAD_Y;
+    head->fX = SK_MinS32;
+    tail->fNext = nullptr;
+    tail->fFirstY = kEDGE_TAIL_Y;
+
+    SkEdge* prev = head;
+    for (int i = 0; i < count; i++) {
+        prev->fNext = edges[i];
+        edges[i]->fPrev = prev;
+        prev = edges[i];
+    }
+    prev->fNext = tail;
+    tail->fPrev = prev;
+}
+
+// Passes on only the rows from top down, for bands that have to walk their edges from the top.
+class SkRowsFromBlitter final : public SkBlitter {
+public:
+    SkRowsFromBlitter(SkBlitter* blitter, int top) : fBlitter(blitter), fTop(top) {}
+
+    void blitH(int x, int y, int width) override {
+        if (y >= fTop) {
+            fBlitter->blitH(x, y, width);
+        }
+    }
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        SkDEBUGFAIL("walk_edges() only calls blitH()");
+    }
+
+private:
+    SkBlitter* fBlitter;
+    int        fTop;
+};
+
+bool SkFillPathEdges::init(const SkPath& path, const SkIRect& clipRect, int start_y, int stop_y,
+                           bool pathContainedInClip, int bandHeight) {
+    SkIRect shiftedClip = clipRect;
+    shiftedClip.fLeft = SkLeftShift(shiftedClip.fLeft, fShift);
+    shiftedClip.fRight = SkLeftShift(shiftedClip.fRight, fShift);
+    shiftedClip.fTop = SkLeftShift(shiftedClip.fTop, fShift);
+    shiftedClip.fBottom = SkLeftShift(shiftedClip.fBottom, fShift);
+
+    fCount = fBuilder.buildEdges(path, pathContainedInClip ? nullptr : &shiftedClip);
+    if (fCount == 0) {
+        return false;
+    }
+    fEdges = fBuilder.edgeList();
+    SkEdge* last;
+    sort_edges(fEdges, fCount, &last);
+    fFillType = path.getFillType();
+    fRightClip = shiftedClip.right();
+
+    if (!pathContainedInClip) {
+        start_y = std::max(start_y, clipRect.fTop);
+        stop_y = std::min(stop_y, clipRect.fBottom);
+    }
+    if (start_y >= stop_y) {
+        return false;
+    }
+    SkASSERT(start_y >= 0);
+    fStartY = SkLeftShift(start_y, fShift);
+    fStopY = SkLeftShift(stop_y, fShift);
+
+    fBandHeight = bandHeight;
+    fFirstBand = start_y / bandHeight;
+    fBandCount = (stop_y - 1) / bandHeight - fFirstBand + 1;
+
+    // The first band walks from the top of the fill, so only the later bands need to know which
+    // edges come into them from above.
+    fEdgesIntoBand.reset(fBandCount);
+    fEdgesIntoBand.push_back_n(fBandCount);
+    for (int i = 0; i < fCount; i++) {
+        const SkEdge* edge = fEdges[i];
+        int top = edge->fFirstY,
+            bottom = edge->fLastY;
+        if (edge->fCurveCount != 0) {
+            SkSTArenaAlloc<sizeof(SkCubicEdge)> alloc;
+            SkEdge* curve = copy_edge(*edge, &alloc);
+            while (next_segment(curve)) {
+                bottom = curve->fLastY;
+            }
+        }
+        for (int band = std::max(1, (top >> fShift) / bandHeight - fFirstBand); band < fBandCount;
+             band++) {
+            int bandTop = SkLeftShift((fFirstBand + band) * bandHeight, fShift);
+            if (bandTop <= top) {
+                continue;
+            }
+            if (bandTop > bottom) {
+                break;
+            }
+            fEdgesIntoBand[band].push_back(i);
+        }
+    }
+    return true;
+}
+
+void SkFillPathEdges::startAtTop(int bottom, SkArenaAlloc* alloc, SkEdge* head,
+                                 SkEdge* tail) const {
+    // The edges are sorted by their first row, so the ones we need are a prefix.
+    int count = 0;
+    while (count < fCount && fEdges[count]->fFirstY < bottom) {
+        count++;
+    }
+    SkEdge** edges = alloc->makeArrayDefault<SkEdge*>(count);
+    for (int i = 0; i < count; i++) {
+        edges[i] = copy_edge(*fEdges[i], alloc);
+    }
+    link_edges(edges, count, head, tail);
+}
+
+bool SkFillPathEdges::startBand(int band, int top, int bottom, SkArenaAlloc* alloc, SkEdge* head,
+                                SkEdge* tail) const {
+    // The edges that start in this band, in sorted order, as walk_edges() would find them.
+    auto startsAbove = [](const SkEdge* edge, int y) { return edge->fFirstY < y; };
+    SkEdge* const* sorted = fEdges;
+    SkEdge* const* firstNew = std::lower_bound(sorted, sorted + fCount, top, startsAbove);
+    SkEdge* const* endNew = std::lower_bound(firstNew, sorted + fCount, bottom, startsAbove);
+
+    const skia_private::TArray<int>& into = fEdgesIntoBand[band];
+    int count = 0;
+    SkEdge** edges = alloc->makeArrayDefault<SkEdge*>(into.size() + (endNew - firstNew));
+    for (int i : into) {
+        SkEdge* edge = copy_edge(*fEdges[i], alloc);
+        if (advance_edge_to(edge, top)) {
+            edges[count++] = edge;
+        }
+    }
+    int active = count;
+    for (SkEdge* const* edge = firstNew; edge < endNew; edge++) {
+        edges[count++] = copy_edge(**edge, alloc);
+    }
+
+    // At the band's top row, walk_edges() would have its edges sorted by x. If two are tied, it
+    // keeps whichever order they arrived in, which we can't know without walking from the top.
+    // Ties matter: they can split a span in two, which shaders and supersampling can tell apart.
+    while (active < count && edges[active]->fFirstY == top) {
+        active++;
+    }
+    std::sort(edges, edges + active, [](const SkEdge* a, const SkEdge* b) {
+        return a->fX < b->fX;
+    });
+    for (int i = 1; i < active; i++) {
+        if (edges[i - 1]->fX == edges[i]->fX) {
+            return false;
+        }
+    }
+    link_edges(edges, count, head, tail);
+    return true;
+}
+
+void SkFillPathEdges::fillBand(int band, SkBlitter* blitter) const {
+    SkASSERT(0 <= band && band < fBandCount);
+    const int top    = band == 0 ? fStartY
+                                 : SkLeftShift((fFirstBand + band) * fBandHeight, fShift),
+              bottom = std::min(fStopY,
+                                SkLeftShift((fFirstBand + band + 1) * fBandHeight, fShift));
+
+    SkSTArenaAlloc<4096> alloc;
+    SkEdge head, tail;
+    if (band > 0 && this->startBand(band, top, bottom, &alloc, &head, &tail)) {
+        if (head.fNext != &tail) {
+            walk_edges(&head, fFillType, blitter, top, bottom, nullptr, fRightClip);
+        }
+        return;
+    }
+    this->startAtTop(bottom, &alloc, &head, &tail);
+    if (head.fNext != &tail) {
+        SkRowsFromBlitter rows(blitter, top);
+        walk_edges(&head, fFillType, &rows, fStartY, bottom, nullptr, fRightClip);
+    }
+}
+
 void sk_blit_above(SkBlitter* blitter, const SkIRect& ir, const SkRegion& clip) {
     const SkIRect& cr = clip.getBounds();
     SkIRect tmp;
@@ -666,6 +885,71 @@ void SkScan::FillPath(const SkPath& path, const SkRegion& origClip,
     }
 }
 
+SkBandedFill::SkBandedFill() = default;
+SkBandedFill::~SkBandedFill() = default;
+
+bool SkBandedFill::init(const SkPath& path, const SkRasterClip& clip, bool antiAlias,
+                        int bandHeight) {
+    // Inverse fills blit around the path's bounds, and convex fills walk their edges as pairs;
+    // neither is worth splitting up.
+    if (clip.isEmpty() || !path.isFinite() || path.isInverseFillType() || path.isConvex()) {
+        return false;
+    }
+    // Like FillPath() and AntiFillPath(), we fill an AA clip's bounds, masked by the clip.
+    if (clip.isBW()) {
+        fClip = clip.bwRgn();
+    } else {
+        fClip.setRect(clip.getBounds());
+        fAAClip = &clip.aaRgn();
+    }
+    fAntiAlias = antiAlias;
+    return antiAlias ? this->initAA(path, /*forceRLE=*/fAAClip != nullptr, bandHeight)
+                     : this->initBW(path, bandHeight);
+}
+
+// Follows FillPath(), but gives up wherever that would trim the clip or the path's bounds.
+bool SkBandedFill::initBW(const SkPath& path, int bandHeight) {
+    SkRegion finiteClip;
+    if (clip_to_limit(fClip, &finiteClip)) {
+        return false;
+    }
+    const SkRect& bounds = path.getBounds();
+    if (!SkRectPriv::MakeLargeS32().contains(bounds)) {
+        return false;
+    }
+    fPathIR = conservative_round_to_int(bounds);
+    if (fPathIR.isEmpty() || !SkIRect::Intersects(fClip.getBounds(), fPathIR)) {
+        return false;
+    }
+    // SkScanClipper only leaves rect clips that contain the path unchecked.
+    const bool containedInClip = fClip.isRect() && fClip.getBounds().contains(fPathIR);
+    fEdges = std::make_unique<SkFillPathEdges>(0);
+    return fEdges->init(path, fClip.getBounds(), fPathIR.fTop, fPathIR.fBottom, containedInClip,
+                        bandHeight);
+}
+
+int SkBandedFill::bandCount() const {
+    return fEdges ? fEdges->bandCount() : 0;
+}
+
+void SkBandedFill::fillBand(int band, SkBlitter* blitter) const {
+    SkASSERT(fEdges);
+    SkAAClipBlitter aaBlitter;
+    if (fAAClip) {
+        aaBlitter.init(blitter, fAAClip);
+        blitter = &aaBlitter;
+    }
+    SkScanClipper clipper(blitter, &fClip, fPathIR);
+    if (!clipper.getBlitter()) {
+        return;
+    }
+    if (fAntiAlias) {
+        sk_supersample_band(*fEdges, band, clipper.getBlitter(), fPathIR, fClip.getBounds());
+    } else {
+        fEdges->fillBand(band, clipper.getBlitter());
+    }
+}
+
 void SkScan::FillPath(const SkPath& path, const SkIRect& ir,
                       SkBlitter* blitter) {
     SkRegion rgn(ir);
@@ -21,6 +21,15 @@ void SkScan::SAAFillPath(const SkPath&, SkBlitter*, const SkIRect&, const SkIRec
     SkDEBUGFAIL("SAA Disabled");
 }
 
+void sk_supersample_band(const SkFillPathEdges&, int, SkBlitter*,
+                         const SkIRect&, const SkIRect&) {
+    SkDEBUGFAIL("SAA Disabled");
+}
+
+bool sk_supersamples_rows(const SkIRect&, bool) {
+    return false;
+}
+
 #else
 
 #define SHIFT   SK_SUPERSAMPLE_SHIFT
@@ -605,4 +614,14 @@ void SkScan::SAAFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect&
     }
 }
 
+void sk_supersample_band(const SkFillPathEdges& edges, int band, SkBlitter* blitter,
+                         const SkIRect& pathIR, const SkIRect& clipBounds) {
+    SuperBlitter superBlit(blitter, pathIR, clipBounds, /*isInverse=*/false);
+    edges.fillBand(band, &superBlit);
+}
+
+bool sk_supersamples_rows(const SkIRect& pathIR, bool forceRLE) {
+    return forceRLE || !MaskSuperBlitter::CanHandleRect(pathIR);
+}
+
 #endif  // defined(SK_FORCE_AAA)
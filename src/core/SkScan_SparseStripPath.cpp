@@ -0,0 +1,384 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkScanPriv.h"
+
+#include "include/core/SkPath.h"
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTPin.h"
+#include "include/private/base/SkTo.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkGeometry.h"
+#include "src/core/SkLineClipper.h"
+#include "src/core/SkMask.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+using namespace skia_private;
+
+/** @file
+    The sparse strip scan converter. Rather than walking edges a scanline at a time like AAA and
+    SAA, we flatten the path into lines and bin them into 4x4 pixel tiles. Each row of tiles then
+    splits into strips, runs of adjacent tiles that some line touches, and the gaps between them.
+
+    For a strip we accumulate each line's exact signed area into its pixels, then sweep left to
+    right summing those into winding numbers, all four rows of the tile row at once. The strip goes
+    to the blitter as one A8 mask. A gap contains no edges, so every pixel in a row of it has the
+    winding number the strip to its left ended with: it's a solid span, or nothing at all.
+
+    Where a path has many small features (glyph runs, map tiles) that turns a flood of short
+    blitAntiH() runs into a handful of masks and long spans.
+*/
+
+namespace {
+
+constexpr int kTileWidth  = 4;
+constexpr int kTileHeight = 4;  // One lane of skvx::float4 per row of a tile.
+
+// How far (in pixels) we let the lines we flatten curves into stray from the curves.
+constexpr float kFlattenTolerance = 0.0625f;
+constexpr int   kMaxCurveLines    = 256;
+
+// A line, in pixels relative to the top left of the area we're filling, always pointing down.
+struct Line {
+    float x0, y0, x1, y1;
+    float dxdy;
+    float dir;  // +1 if the path ran down this line, -1 if up.
+
+    float xAt(float y) const {
+        return y <= y0 ? x0 : y >= y1 ? x1 : x0 + (y - y0) * dxdy;
+    }
+};
+
+// The tiles one line touches in one row of tiles.
+struct TileSpan {
+    int left, right;  // Inclusive tile columns.
+    int line;
+};
+
+class LineBuilder {
+public:
+    LineBuilder(const SkIRect& bounds)
+        : fClip(SkRect::Make(bounds))
+        , fOrigin(SkPoint::Make(bounds.fLeft, bounds.fTop)) {}
+
+    void addPath(const SkPath& path) {
+        SkPath::Iter iter(path, /*forceClose=*/true);
+        SkPoint pts[4];
+        for (SkPath::Verb verb; (verb = iter.next(pts)) != SkPath::kDone_Verb;) {
+            switch (verb) {
+                case SkPath::kLine_Verb:  this->addLine(pts[0], pts[1]);          break;
+                case SkPath::kQuad_Verb:  this->addQuad(pts);                     break;
+                case SkPath::kConic_Verb: this->addConic(pts, iter.conicWeight()); break;
+                case SkPath::kCubic_Verb: this->addCubic(pts);                    break;
+                default:                                                          break;
+            }
+        }
+    }
+
+    const TArray<Line>& lines() const { return fLines; }
+
+private:
+    static int LinesFor(float error) {
+        // Splitting a curve into n lines divides its error by n^2.
+        return SkTPin((int)std::ceil(std::sqrt(error / kFlattenTolerance)), 1, kMaxCurveLines);
+    }
+
+    void addQuad(const SkPoint pts[3]) {
+        // A quad strays at most |p0 - 2p1 + p2| / 4 from its chord.
+        int n = LinesFor((pts[0] - pts[1] - pts[1] + pts[2]).length() * 0.25f);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; i++) {
+            SkPoint next = SkEvalQuadAt(pts, (float)i / n);
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[2]);
+    }
+
+    void addConic(const SkPoint pts[3], float weight) {
+        SkAutoConicToQuads converter;
+        const SkPoint* quads = converter.computeQuads(pts, weight, kFlattenTolerance);
+        for (int i = 0; i < converter.countQuads(); i++) {
+            this->addQuad(quads + 2 * i);
+        }
+    }
+
+    void addCubic(const SkPoint pts[4]) {
+        // A cubic strays at most 3/4 of its larger second difference from its chord.
+        float dd = std::max((pts[0] - pts[1] - pts[1] + pts[2]).length(),
+                            (pts[1] - pts[2] - pts[2] + pts[3]).length());
+        int n = LinesFor(dd * 0.75f);
+        SkPoint prev = pts[0];
+        for (int i = 1; i < n; i++) {
+            SkPoint next;
+            SkEvalCubicAt(pts, (float)i / n, &next, nullptr, nullptr);
+            this->addLine(prev, next);
+            prev = next;
+        }
+        this->addLine(prev, pts[3]);
+    }
+
+    void addLine(SkPoint p0, SkPoint p1) {
+        // Lines left of the clip become vertical lines along its left edge, so they still add
+        // their winding to everything we fill. Lines right of it can't affect anything we fill.
+        const SkPoint pts[2] = {p0, p1};
+        SkPoint clipped[SkLineClipper::kMaxPoints];
+        int count = SkLineClipper::ClipLine(pts, fClip, clipped, /*canCullToTheRight=*/true);
+        for (int i = 0; i < count; i++) {
+            this->addClippedLine(clipped[i] - fOrigin, clipped[i + 1] - fOrigin);
+        }
+    }
+
+    void addClippedLine(SkPoint p0, SkPoint p1) {
+        if (p0.fY == p1.fY) {
+            return;  // Horizontal lines don't change the winding number.
+        }
+        float dir = 1;
+        if (p0.fY > p1.fY) {
+            std::swap(p0, p1);
+            dir = -1;
+        }
+        fLines.push_back({p0.fX, p0.fY, p1.fX, p1.fY, (p1.fX - p0.fX) / (p1.fY - p0.fY), dir});
+    }
+
+    const SkRect  fClip;
+    const SkPoint fOrigin;
+    TArray<Line>  fLines;
+};
+
+// Adds the signed area `line` covers in each pixel (and the rest of its winding to the pixels
+// right of it) to `cells`, a strip `width` pixels wide starting at (x,y), kept column by column.
+// Summing the cells of a row left to right gives each pixel's winding number.
+void accumulate_line(const Line& line, float x, float y, int width, float* cells) {
+    const float top    = std::max(line.y0, y),
+                bottom = std::min(line.y1, y + kTileHeight);
+    for (int row = (int)(top - y); row < kTileHeight && y + row < bottom; row++) {
+        const float y0 = std::max(top,    y + row),
+                    y1 = std::min(bottom, y + row + 1);
+        if (y0 >= y1) {
+            continue;
+        }
+        // Lines were binned by where they cross this strip, so these are inside [0, width] but
+        // for rounding.
+        const float x0 = SkTPin(line.xAt(y0) - x, 0.0f, (float)width),
+                    x1 = SkTPin(line.xAt(y1) - x, 0.0f, (float)width);
+        const float d  = (y1 - y0) * line.dir;
+        auto cell = [&](int i) -> float& { return cells[i * kTileHeight + row]; };
+
+        const float xl = std::min(x0, x1),
+                    xr = std::max(x0, x1);
+        const int il = (int)xl,             // The cell the line starts in...
+                  ir = (int)std::ceil(xr);  // ...and the first cell entirely to its right.
+        if (ir <= il + 1) {
+            // The line stays within one cell; what's right of its midpoint is covered.
+            const float xm = 0.5f * (x0 + x1) - il;
+            cell(il)     += d * (1 - xm);
+            cell(il + 1) += d * xm;
+        } else {
+            // The line crosses several cells. Its coverage ramps up linearly across them.
+            const float s   = 1 / (xr - xl),
+                        xlf = xl - il,
+                        xrf = xr - ir + 1,
+                        a0  = 0.5f * s * (1 - xlf) * (1 - xlf),
+                        am  = 0.5f * s * xrf * xrf;
+            cell(il) += d * a0;
+            if (ir == il + 2) {
+                cell(il + 1) += d * (1 - a0 - am);
+            } else {
+                const float a1 = s * (1.5f - xlf);
+                cell(il + 1) += d * (a1 - a0);
+                for (int i = il + 2; i < ir - 1; i++) {
+                    cell(i) += d * s;
+                }
+                const float a2 = a1 + (ir - il - 3) * s;
+                cell(ir - 1) += d * (1 - a2 - am);
+            }
+            cell(ir) += d * am;
+        }
+    }
+}
+
+// Converts a winding number (one per row of a tile) into alpha.
+SK_ALWAYS_INLINE skvx::byte4 winding_to_alpha(skvx::float4 winding, bool evenOdd) {
+    skvx::float4 coverage = abs(winding);
+    if (evenOdd) {
+        coverage = coverage - 2 * floor(coverage * 0.5f);
+        coverage = min(coverage, 2 - coverage);
+    } else {
+        coverage = min(coverage, 1);
+    }
+    return skvx::cast<uint8_t>(coverage * 255 + 0.5f);
+}
+
+class StripBlitter {
+public:
+    StripBlitter(SkBlitter* blitter, const SkIRect& bounds)
+        : fBlitter(blitter)
+        , fBounds(bounds)
+        , fRuns(bounds.width() + 1)
+        , fAlpha(bounds.width() + 1) {}
+
+    // Fills columns [left, right) of a row of tiles that no line touches. Each row of pixels
+    // has the same winding number all the way across.
+    void blitGap(int row, int left, int right, skvx::float4 winding, bool evenOdd) {
+        right = std::min(right, fBounds.width());
+        if (left >= right) {
+            return;
+        }
+        const int x      = fBounds.fLeft + left,
+                  y      = fBounds.fTop + row * kTileHeight,
+                  width  = right - left,
+                  height = std::min(kTileHeight, fBounds.bottom() - y);
+        const skvx::byte4 alpha = winding_to_alpha(winding, evenOdd);
+        if (all(alpha == 0xFF) && height == kTileHeight) {
+            fBlitter->blitRect(x, y, width, height);
+            return;
+        }
+        for (int i = 0; i < height; i++) {
+            if (alpha[i] == 0xFF) {
+                fBlitter->blitH(x, y + i, width);
+            } else if (alpha[i]) {
+                fRuns[0]     = SkToS16(width);
+                fRuns[width] = 0;
+                fAlpha[0]    = alpha[i];
+                fBlitter->blitAntiH(x, y + i, fAlpha.get(), fRuns.get());
+            }
+        }
+    }
+
+    // Blits the alpha of a strip whose first pixel is column `left` of a row of tiles.
+    void blitStrip(int row, int left, int width, const uint8_t* alpha) {
+        const SkIRect stripBounds = SkIRect::MakeXYWH(fBounds.fLeft + left,
+                                                      fBounds.fTop + row * kTileHeight,
+                                                      width, kTileHeight);
+        SkIRect clip;
+        if (clip.intersect(stripBounds, fBounds)) {
+            fBlitter->blitMask(SkMask(alpha, stripBounds, width, SkMask::kA8_Format), clip);
+        }
+    }
+
+private:
+    SkBlitter*                 fBlitter;
+    const SkIRect              fBounds;
+    AutoTMalloc<int16_t>       fRuns;
+    AutoTMalloc<SkAlpha>       fAlpha;
+};
+
+}  // namespace
+
+void SkScan::SparseStripFillPath(const SkPath& path, SkBlitter* blitter, const SkIRect& pathIR,
+                                 const SkIRect& clipBounds) {
+    SkASSERT(!path.isInverseFillType());
+
+    SkIRect bounds;
+    if (!bounds.intersect(pathIR, clipBounds)) {
+        return;
+    }
+
+    LineBuilder builder(bounds);
+    builder.addPath(path);
+    const TArray<Line>& lines = builder.lines();
+    if (lines.empty()) {
+        return;
+    }
+
+    const int tileRows = (bounds.height() + kTileHeight - 1) / kTileHeight,
+              tileCols = (bounds.width()  + kTileWidth  - 1) / kTileWidth;
+
+    // Bin the lines by row of tiles, noting which columns of tiles they touch in each.
+    auto for_each_row = [&](const Line& line, auto&& fn) {
+        const int first = (int)(line.y0 / kTileHeight),
+                  last  = std::min((int)std::ceil(line.y1 / kTileHeight), tileRows) - 1;
+        for (int row = first; row <= last; row++) {
+            const float xa = line.xAt(std::max(line.y0, (float)( row      * kTileHeight))),
+                        xb = line.xAt(std::min(line.y1, (float)((row + 1) * kTileHeight)));
+            fn(row,
+               SkTPin((int)(std::min(xa, xb) / kTileWidth), 0, tileCols - 1),
+               SkTPin((int)(std::max(xa, xb) / kTileWidth), 0, tileCols - 1));
+        }
+    };
+
+    // A counting sort by row, then a sort of each row by column, leaves spans in scan order.
+    TArray<int> rowStart;
+    rowStart.push_back_n(tileRows + 1, 0);
+    for (const Line& line : lines) {
+        for_each_row(line, [&](int row, int, int) { rowStart[row + 1]++; });
+    }
+    for (int row = 0; row < tileRows; row++) {
+        rowStart[row + 1] += rowStart[row];
+    }
+    AutoTMalloc<TileSpan> spans(rowStart[tileRows]);
+    {
+        TArray<int> next(rowStart);
+        for (int i = 0; i < lines.size(); i++) {
+            for_each_row(lines[i], [&](int row, int left, int right) {
+                spans[next[row]++] = {left, right, i};
+            });
+        }
+    }
+
+    const bool evenOdd = path.getFillType() == SkPathFillType::kEvenOdd;
+    StripBlitter stripBlitter(blitter, bounds);
+
+    // Scratch for one strip at a time: its cells (with two more columns for the winding that
+    // spills out its right side) and its alpha.
+    AutoSTMalloc<64, skvx::float4> cells(tileCols * kTileWidth + 2);
+    AutoSTMalloc<256, uint8_t>     alpha(tileCols * kTileWidth * kTileHeight);
+
+    for (int row = 0; row < tileRows; row++) {
+        TileSpan* span = spans.get() + rowStart[row];
+        TileSpan* end  = spans.get() + rowStart[row + 1];
+        if (span == end) {
+            continue;
+        }
+        std::sort(span, end, [](const TileSpan& a, const TileSpan& b) { return a.left < b.left; });
+
+        skvx::float4 winding = 0;
+        int done = 0;  // Columns of pixels we've filled in this row of tiles.
+        while (span != end) {
+            // Extend the strip over every span that touches or overlaps it.
+            const int left = span->left;
+            int right = span->right;
+            TileSpan* stripEnd = span + 1;
+            for (; stripEnd != end && stripEnd->left <= right + 1; stripEnd++) {
+                right = std::max(right, stripEnd->right);
+            }
+
+            stripBlitter.blitGap(row, done, left * kTileWidth, winding, evenOdd);
+
+            const int x     = left * kTileWidth,
+                      width = (right - left + 1) * kTileWidth;
+            memset(cells.get(), 0, (width + 2) * sizeof(skvx::float4));
+            for (; span != stripEnd; span++) {
+                accumulate_line(lines[span->line], x, row * kTileHeight, width,
+                                reinterpret_cast<float*>(cells.get()));
+            }
+            for (int i = 0; i < width; i++) {
+                winding += cells[i];
+                skvx::byte4 a = winding_to_alpha(winding, evenOdd);
+                for (int r = 0; r < kTileHeight; r++) {
+                    alpha[r * width + i] = a[r];
+                }
+            }
+            winding += cells[width] + cells[width + 1];
+            stripBlitter.blitStrip(row, x, width, alpha.get());
+
+            done = x + width;
+        }
+        // Lines right of the clip were culled, so what's past the last strip may be filled too.
+        stripBlitter.blitGap(row, done, bounds.width(), winding, evenOdd);
+    }
+}
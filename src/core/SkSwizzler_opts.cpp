@@ -31,6 +31,7 @@ namespace SkOpts {
 
     void Init_Swizzler_ssse3();
     void Init_Swizzler_hsw();
+    void Init_Swizzler_skx();
 
     static bool init() {
     #if defined(SK_ENABLE_OPTIMIZE_SIZE)
@@ -43,6 +44,10 @@ namespace SkOpts {
         #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_AVX2
             if (SkCpu::Supports(SkCpu::HSW)) { Init_Swizzler_hsw(); }
         #endif
+
+        #if SK_CPU_SSE_LEVEL < SK_CPU_SSE_LEVEL_SKX
+            if (SkCpu::Supports(SkCpu::SKX)) { Init_Swizzler_skx(); }
+        #endif
     #endif
       return true;
     }
@@ -11,8 +11,12 @@
 #include "include/core/SkExecutor.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkNoncopyable.h"
+#include <algorithm>
 #include <atomic>
 #include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
 
 class SkTaskGroup : SkNoncopyable {
 public:
@@ -45,4 +49,84 @@ private:
     SkExecutor&          fExecutor;
 };
 
+// Returns true if the calling thread is one of the threads of an SkExecutor thread pool, e.g. it
+// is running a task for SkExecutor::GetDefault().
+bool SkIsExecutorThread();
+
+// Calls fn(start, end) for consecutive chunks [start, end) of at most grain indices covering
+// [0, count), running the chunks concurrently on executor, and blocks until they're all done.
+// The calling thread works on chunks too.  Only a handful of tasks are added to the executor no
+// matter how large count is: each task keeps claiming chunks until there are none left.
+// If the executor can't run work concurrently, the chunks all run in order on this thread.
+template <typename Fn>
+void SkParallelFor(SkExecutor& executor, int count, int grain, Fn&& fn) {
+    SkASSERT(count >= 0 && grain > 0);
+    const int chunks = count / grain + (count % grain != 0);
+
+    auto runChunk = [&](int chunk) {
+        int start = chunk * grain;
+        fn(start, start + std::min(grain, count - start));
+    };
+
+    const int concurrency = executor.concurrency();
+    if (chunks <= 1 || concurrency == 1) {
+        for (int chunk = 0; chunk < chunks; chunk++) {
+            runChunk(chunk);
+        }
+        return;
+    }
+
+    // When the executor doesn't know its concurrency, this is a reasonable guess.
+    static constexpr int kUnknownConcurrency = 8;
+    const int helpers = std::min(chunks, concurrency > 0 ? concurrency : kUnknownConcurrency) - 1;
+
+    std::atomic<int> nextChunk{0};
+    auto work = [&] {
+        for (int chunk; (chunk = nextChunk.fetch_add(1, std::memory_order_relaxed)) < chunks;) {
+            runChunk(chunk);
+        }
+    };
+
+    SkTaskGroup group(executor);
+    for (int i = 0; i < helpers; i++) {
+        // Capturing only a reference keeps this small enough to not allocate in std::function.
+        group.add([&work] { work(); });
+    }
+    work();
+    group.wait();
+}
+
+// Maps each chunk [start, end) of at most grain indices covering [0, count) to a T with
+// map(start, end), and folds those in order with combine(T, T), starting from identity.
+// The chunks are mapped concurrently on executor, but always combined in the same order,
+// so the result doesn't depend on how the work was scheduled.
+template <typename T, typename MapFn, typename CombineFn>
+T SkParallelReduce(SkExecutor& executor, int count, int grain, T identity,
+                   MapFn&& map, CombineFn&& combine) {
+    SkASSERT(count >= 0 && grain > 0);
+    const int chunks = count / grain + (count % grain != 0);
+    if (chunks <= 1 || executor.concurrency() == 1) {
+        T result = std::move(identity);
+        for (int start = 0; start < count; start += grain) {
+            result = combine(std::move(result), map(start, start + std::min(grain, count - start)));
+        }
+        return result;
+    }
+
+    // std::optional keeps each partial result its own object, so chunks never share storage.
+    std::vector<std::optional<T>> partials(chunks);
+    SkParallelFor(executor, chunks, 1, [&](int firstChunk, int endChunk) {
+        for (int chunk = firstChunk; chunk < endChunk; chunk++) {
+            int start = chunk * grain;
+            partials[chunk] = map(start, start + std::min(grain, count - start));
+        }
+    });
+
+    T result = std::move(identity);
+    for (std::optional<T>& partial : partials) {
+        result = combine(std::move(result), std::move(*partial));
+    }
+    return result;
+}
+
 #endif//SkTaskGroup_DEFINED
@@ -11,9 +11,12 @@
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkYUVAInfo.h"
 #include "include/core/SkYUVAPixmaps.h"
@@ -22,19 +25,25 @@
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "src/base/SkMSAN.h"
 #include "src/codec/SkJpegConstants.h"
 #include "src/codec/SkJpegPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 #include "src/encode/SkJPEGWriteUtility.h"
 #include "src/image/SkImage_Base.h"
 
+#include <algorithm>
+#include <atomic>
 #include <csetjmp>
 #include <cstdint>
 #include <cstring>
 #include <memory>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 class GrDirectContext;
 class SkColorSpace;
@@ -257,44 +266,50 @@ bool SkJpegEncoderMgr::setParams(const SkYUVAPixmapInfo& srcInfo,
     return true;
 }
 
-static std::unique_ptr<SkEncoder> Make(SkWStream* dst,
-                                       const SkPixmap* src,
-                                       const SkYUVAPixmaps* srcYUVA,
-                                       const SkColorSpace* srcYUVAColorSpace,
-                                       const SkJpegEncoder::Options& options) {
-    // Exactly one of |src| or |srcYUVA| should be specified.
-    if (srcYUVA) {
-        SkASSERT(!src);
-        if (!srcYUVA->isValid()) {
-            return nullptr;
-        }
-    } else {
-        SkASSERT(src);
-        if (!src || !SkPixmapIsValid(*src)) {
-            return nullptr;
-        }
-    }
+// How one strip of a striped encode (see encode_in_strips()) differs from a serial encode.
+struct JpegStrip {
+    unsigned fRestartInterval;  // The number of MCUs in a whole strip.
+    bool     fFirst;            // Only the first strip's header is kept, with the metadata.
+};
 
-    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
+static bool set_params(SkJpegEncoderMgr* encoderMgr,
+                       const SkPixmap* src,
+                       const SkYUVAPixmaps* srcYUVA,
+                       const SkJpegEncoder::Options& options) {
+    return srcYUVA ? encoderMgr->setParams(srcYUVA->pixmapsInfo(), options)
+                   : encoderMgr->setParams(src->info(), options);
+}
 
+// Sets up encoderMgr to encode src or srcYUVA, starts compressing, and writes the metadata. When
+// strip is set, this is one strip of a striped encode instead.
+static bool start_compress(SkJpegEncoderMgr* encoderMgr,
+                           const SkPixmap* src,
+                           const SkYUVAPixmaps* srcYUVA,
+                           const SkColorSpace* srcYUVAColorSpace,
+                           const SkJpegEncoder::Options& options,
+                           const JpegStrip* strip) {
     skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
     if (setjmp(jmp)) {
-        return nullptr;
+        return false;
     }
 
-    if (srcYUVA) {
-        if (!encoderMgr->setParams(srcYUVA->pixmapsInfo(), options)) {
-            return nullptr;
-        }
-    } else {
-        if (!encoderMgr->setParams(src->info(), options)) {
-            return nullptr;
-        }
+    if (!set_params(encoderMgr, src, srcYUVA, options)) {
+        return false;
+    }
+    if (strip) {
+        // Each strip is one restart interval. The strips can't share tables computed for the
+        // whole image, so they all use the standard ones.
+        encoderMgr->cinfo()->restart_interval = strip->fRestartInterval;
+        encoderMgr->cinfo()->optimize_coding = FALSE;
     }
 
     jpeg_set_quality(encoderMgr->cinfo(), options.fQuality, TRUE);
     jpeg_start_compress(encoderMgr->cinfo(), TRUE);
 
+    if (strip && !strip->fFirst) {
+        return true;
+    }
+
     // Write XMP metadata. This will only write the standard XMP segment.
     // TODO(ccameron): Split this into a standard and extended XMP segment if needed.
     if (options.xmpMetadata) {
@@ -323,6 +338,32 @@ static std::unique_ptr<SkEncoder> Make(SkWStream* dst,
 
         jpeg_write_marker(encoderMgr->cinfo(), kICCMarker, markerData->bytes(), markerData->size());
     }
+    return true;
+}
+
+static bool is_valid_src(const SkPixmap* src, const SkYUVAPixmaps* srcYUVA) {
+    // Exactly one of |src| or |srcYUVA| should be specified.
+    if (srcYUVA) {
+        SkASSERT(!src);
+        return srcYUVA->isValid();
+    }
+    SkASSERT(src);
+    return src && SkPixmapIsValid(*src);
+}
+
+static std::unique_ptr<SkEncoder> Make(SkWStream* dst,
+                                       const SkPixmap* src,
+                                       const SkYUVAPixmaps* srcYUVA,
+                                       const SkColorSpace* srcYUVAColorSpace,
+                                       const SkJpegEncoder::Options& options) {
+    if (!is_valid_src(src, srcYUVA)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
+    if (!start_compress(encoderMgr.get(), src, srcYUVA, srcYUVAColorSpace, options, nullptr)) {
+        return nullptr;
+    }
 
     if (srcYUVA) {
         return std::make_unique<SkJpegEncoderImpl>(std::move(encoderMgr), srcYUVA);
@@ -392,9 +433,214 @@ bool SkJpegEncoderImpl::onEncodeRows(int numRows) {
     return true;
 }
 
+// A striped encode splits the image into strips of whole MCU rows, with at least this many pixels
+// in each.
+static constexpr int kMinStripPixels = 1 << 18;
+
+// The largest restart interval a DRI marker can hold, in MCUs.
+static constexpr int kMaxRestartInterval = 0xFFFF;
+
+// How encode_in_strips() splits an image: every strip but the last has fRows rows.
+struct JpegStripLayout {
+    int      fRows;
+    int      fCount;
+    unsigned fRestartInterval;
+};
+
+// Returns whether src or srcYUVA is large enough to encode in strips on executor, and if so how.
+static bool choose_strips(const SkPixmap* src,
+                          const SkYUVAPixmaps* srcYUVA,
+                          const SkJpegEncoder::Options& options,
+                          const SkExecutor& executor,
+                          JpegStripLayout* layout) {
+    if (executor.concurrency() == 1 || !is_valid_src(src, srcYUVA)) {
+        return false;
+    }
+
+    // The MCU size depends on the parameters, so set them up as an encode would.
+    SkNullWStream nullStream;
+    std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(&nullStream);
+    {
+        skjpeg_error_mgr::AutoPushJmpBuf jmp(encoderMgr->errorMgr());
+        if (setjmp(jmp) || !set_params(encoderMgr.get(), src, srcYUVA, options)) {
+            return false;
+        }
+    }
+    const jpeg_compress_struct* cinfo = encoderMgr->cinfo();
+    int maxHSamp = 1, maxVSamp = 1;
+    if (cinfo->num_components > 1) {
+        for (int i = 0; i < cinfo->num_components; ++i) {
+            maxHSamp = std::max(maxHSamp, cinfo->comp_info[i].h_samp_factor);
+            maxVSamp = std::max(maxVSamp, cinfo->comp_info[i].v_samp_factor);
+        }
+    }
+    const int width = SkToInt(cinfo->image_width),
+              height = SkToInt(cinfo->image_height);
+    const int mcuWidth = DCTSIZE * maxHSamp,
+              mcuHeight = DCTSIZE * maxVSamp;
+    const int mcusPerRow = (width + mcuWidth - 1) / mcuWidth,
+              mcuRows = (height + mcuHeight - 1) / mcuHeight;
+
+    const int64_t mcuRowPixels = (int64_t)width * mcuHeight;
+    const int stripMcuRows = SkToInt(std::min<int64_t>(
+            (kMinStripPixels + mcuRowPixels - 1) / mcuRowPixels,
+            kMaxRestartInterval / mcusPerRow));
+    if (stripMcuRows < 1 || mcuRows < 2 * stripMcuRows) {
+        return false;
+    }
+    layout->fRows = stripMcuRows * mcuHeight;
+    layout->fCount = (mcuRows + stripMcuRows - 1) / stripMcuRows;
+    layout->fRestartInterval = SkToUInt(stripMcuRows * mcusPerRow);
+    return true;
+}
+
+// Returns the rows [startRow, endRow) of src as an image of their own.
+static SkYUVAPixmaps yuva_strip(const SkYUVAPixmaps& src, int startRow, int endRow) {
+    const SkYUVAInfo& info = src.yuvaInfo();
+    const SkYUVAInfo stripInfo({info.width(), endRow - startRow},
+                               info.planeConfig(),
+                               info.subsampling(),
+                               info.yuvColorSpace());
+    SkISize stripDims[SkYUVAInfo::kMaxPlanes];
+    const int numPlanes = stripInfo.planeDimensions(stripDims);
+    SkPixmap planes[SkYUVAInfo::kMaxPlanes];
+    for (int i = 0; i < numPlanes; ++i) {
+        // Strips start on MCU boundaries, which are on subsampled rows.
+        const int planeStartRow = startRow / std::get<1>(info.planeSubsamplingFactors(i));
+        if (!src.plane(i).extractSubset(&planes[i],
+                                        SkIRect::MakeXYWH(0, planeStartRow,
+                                                          stripDims[i].width(),
+                                                          stripDims[i].height()))) {
+            return {};
+        }
+    }
+    return SkYUVAPixmaps::FromExternalPixmaps(stripInfo, planes);
+}
+
+// Finds the SOF segment, and the start of the entropy-coded data after the SOS segment, of a
+// JPEG written by libjpeg. The data runs up to the EOI marker at the end.
+static bool find_frame_and_scan(const SkData& jpeg, size_t* sofOffset, size_t* scanOffset) {
+    const uint8_t* bytes = jpeg.bytes();
+    const size_t size = jpeg.size();
+    if (size < 4 || bytes[0] != 0xFF || bytes[1] != kJpegMarkerStartOfImage ||
+        bytes[size - 2] != 0xFF || bytes[size - 1] != kJpegMarkerEndOfImage) {
+        return false;
+    }
+    bool foundFrame = false;
+    for (size_t offset = 2; offset + 4 <= size;) {
+        const uint8_t marker = bytes[offset + 1];
+        const size_t segmentSize = 2 + (bytes[offset + 2] << 8 | bytes[offset + 3]);
+        if (bytes[offset] != 0xFF || offset + segmentSize > size) {
+            return false;
+        }
+        if (marker == kJpegMarkerStartOfFrameBaseline ||
+            marker == kJpegMarkerStartOfFrameExtended) {
+            *sofOffset = offset;
+            foundFrame = true;
+        } else if (marker == kJpegMarkerStartOfScan) {
+            *scanOffset = offset + segmentSize;
+            return foundFrame;
+        }
+        offset += segmentSize;
+    }
+    return false;
+}
+
+// Encodes src or srcYUVA in strips laid out by choose_strips(), each compressed on its own
+// concurrently on executor. The first strip's header is written with the height of the whole
+// image, and then each strip's entropy-coded data, with restart markers between them.
+static bool encode_in_strips(SkWStream* dst,
+                             const SkPixmap* src,
+                             const SkYUVAPixmaps* srcYUVA,
+                             const SkColorSpace* srcYUVAColorSpace,
+                             const SkJpegEncoder::Options& options,
+                             SkExecutor& executor,
+                             const JpegStripLayout& layout) {
+    const int width = src ? src->width() : srcYUVA->yuvaInfo().width();
+    const int height = src ? src->height() : srcYUVA->yuvaInfo().height();
+
+    std::vector<sk_sp<SkData>> strips(layout.fCount);
+    auto encodeStrip = [&](int i) {
+        const int startRow = i * layout.fRows,
+                  endRow = std::min(startRow + layout.fRows, height);
+        SkPixmap stripSrc;
+        SkYUVAPixmaps stripYUVA;
+        if (srcYUVA) {
+            stripYUVA = yuva_strip(*srcYUVA, startRow, endRow);
+            if (!stripYUVA.isValid()) {
+                return false;
+            }
+        } else if (!src->extractSubset(&stripSrc, SkIRect::MakeLTRB(0, startRow, width, endRow))) {
+            return false;
+        }
+
+        SkDynamicMemoryWStream stream;
+        std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(&stream);
+        const JpegStrip strip = {layout.fRestartInterval, i == 0};
+        if (!start_compress(encoderMgr.get(), srcYUVA ? nullptr : &stripSrc,
+                            srcYUVA ? &stripYUVA : nullptr, srcYUVAColorSpace, options, &strip)) {
+            return false;
+        }
+        std::unique_ptr<SkEncoder> encoder =
+                srcYUVA ? std::make_unique<SkJpegEncoderImpl>(std::move(encoderMgr), &stripYUVA)
+                        : std::make_unique<SkJpegEncoderImpl>(std::move(encoderMgr), stripSrc);
+        if (!encoder->encodeRows(endRow - startRow)) {
+            return false;
+        }
+        strips[i] = stream.detachAsData();
+        return true;
+    };
+
+    std::atomic<bool> succeeded{true};
+    SkParallelFor(executor, layout.fCount, 1, [&](int firstStrip, int endStrip) {
+        for (int i = firstStrip; i < endStrip && succeeded; ++i) {
+            if (!encodeStrip(i)) {
+                succeeded = false;
+            }
+        }
+    });
+    if (!succeeded) {
+        return false;
+    }
+
+    size_t sofOffset, scanOffset;
+    if (!find_frame_and_scan(*strips[0], &sofOffset, &scanOffset)) {
+        return false;
+    }
+    // The frame header's height follows the marker, its length, and the sample precision.
+    std::vector<uint8_t> header(strips[0]->bytes(), strips[0]->bytes() + scanOffset);
+    header[sofOffset + 5] = height >> 8;
+    header[sofOffset + 6] = height & 0xFF;
+    if (!dst->write(header.data(), header.size())) {
+        return false;
+    }
+    for (int i = 0; i < layout.fCount; ++i) {
+        size_t unused;
+        if (i > 0 && !find_frame_and_scan(*strips[i], &unused, &scanOffset)) {
+            return false;
+        }
+        const size_t endOffset = strips[i]->size() - 2;
+        if (!dst->write(strips[i]->bytes() + scanOffset, endOffset - scanOffset)) {
+            return false;
+        }
+        const uint8_t marker[2] = {0xFF, i + 1 < layout.fCount
+                                                 ? SkToU8(kJpegMarkerRST0 + i % 8)
+                                                 : kJpegMarkerEndOfImage};
+        if (!dst->write(marker, sizeof(marker))) {
+            return false;
+        }
+    }
+    dst->flush();
+    return true;
+}
+
 namespace SkJpegEncoder {
 
 bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    JpegStripLayout layout;
+    if (options.fExecutor && choose_strips(&src, nullptr, options, *options.fExecutor, &layout)) {
+        return encode_in_strips(dst, &src, nullptr, nullptr, options, *options.fExecutor, layout);
+    }
     auto encoder = Make(dst, src, options);
     return encoder.get() && encoder->encodeRows(src.height());
 }
@@ -403,6 +649,11 @@ bool Encode(SkWStream* dst,
             const SkYUVAPixmaps& src,
             const SkColorSpace* srcColorSpace,
             const Options& options) {
+    JpegStripLayout layout;
+    if (options.fExecutor && choose_strips(nullptr, &src, options, *options.fExecutor, &layout)) {
+        return encode_in_strips(dst, nullptr, &src, srcColorSpace, options, *options.fExecutor,
+                                layout);
+    }
     auto encoder = Make(dst, src, srcColorSpace, options);
     return encoder.get() && encoder->encodeRows(src.yuvaInfo().height());
 }
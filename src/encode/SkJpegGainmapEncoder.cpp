@@ -237,8 +237,7 @@ static sk_sp<SkData> encode_to_data(const SkPixmap& pm,
     SkJpegEncoder::Options optionsWithXmp = options;
     optionsWithXmp.xmpMetadata = xmpMetadata;
     SkDynamicMemoryWStream encodeStream;
-    auto encoder = SkJpegEncoder::Make(&encodeStream, pm, optionsWithXmp);
-    if (!encoder || !encoder->encodeRows(pm.height())) {
+    if (!SkJpegEncoder::Encode(&encodeStream, pm, optionsWithXmp)) {
         return nullptr;
     }
     return encodeStream.detachAsData();
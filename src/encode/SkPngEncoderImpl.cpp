@@ -13,6 +13,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
@@ -24,14 +25,19 @@
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkNoncopyable.h"
 #include "include/private/base/SkTemplates.h"
+#include "include/private/base/SkTo.h"
 #include "modules/skcms/skcms.h"
 #include "src/base/SkMSAN.h"
+#include "src/base/SkScopeExit.h"
 #include "src/codec/SkPngPriv.h"
+#include "src/core/SkPngFilters.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
 #include "src/image/SkImage_Base.h"
 
 #include <algorithm>
+#include <atomic>
 #include <csetjmp>
 #include <cstdint>
 #include <cstring>
@@ -42,6 +48,8 @@
 #include <png.h>
 #include <pngconf.h>
 
+#include "zlib.h"
+
 class GrDirectContext;
 class SkImage;
 
@@ -86,6 +94,8 @@ public:
     png_infop infoPtr() { return fInfoPtr; }
     int pngBytesPerPixel() const { return fPngBytesPerPixel; }
     transform_scanline_proc proc() const { return fProc; }
+    int filterFlags() const { return fFilterFlags; }
+    int zlibLevel() const { return fZLibLevel; }
 
     ~SkPngEncoderMgr() { png_destroy_write_struct(&fPngPtr, &fInfoPtr); }
 
@@ -96,6 +106,8 @@ private:
     png_infop fInfoPtr;
     int fPngBytesPerPixel;
     transform_scanline_proc fProc;
+    int fFilterFlags;
+    int fZLibLevel;
 };
 
 std::unique_ptr<SkPngEncoderMgr> SkPngEncoderMgr::Make(SkWStream* stream) {
@@ -220,10 +232,12 @@ bool SkPngEncoderMgr::setHeader(const SkImageInfo& srcInfo, const SkPngEncoder::
     int filters = (int)options.fFilterFlags & (int)SkPngEncoder::FilterFlag::kAll;
     SkASSERT(filters == (int)options.fFilterFlags);
     png_set_filter(fPngPtr, PNG_FILTER_TYPE_BASE, filters);
+    fFilterFlags = filters;
 
     int zlibLevel = std::min(std::max(0, options.fZLibLevel), 9);
     SkASSERT(zlibLevel == options.fZLibLevel);
     png_set_compression_level(fPngPtr, zlibLevel);
+    fZLibLevel = zlibLevel;
 
     // Set comments in tEXt chunk
     const sk_sp<SkDataTable>& comments = options.fComments;
@@ -466,6 +480,247 @@ bool SkPngEncoderImpl::onEncodeRows(int numRows) {
     return true;
 }
 
+// encodeInBands() splits the image into bands of at least this many bytes of filtered rows.
+static constexpr size_t kMinBandBytes = 1 << 20;
+
+// The size of deflate's window, the most data that a band can refer back to.
+static constexpr size_t kDeflateWindowBytes = 32 * 1024;
+
+// Rows are filtered and compressed this many bytes at a time.
+static constexpr size_t kDeflateChunkBytes = 64 * 1024;
+
+// Without an executor, compressed data is written out in IDAT chunks of about this size.
+static constexpr size_t kIdatBytes = 64 * 1024;
+
+static_assert(PNG_FILTER_VALUE_NONE  == kNone_SkPngFilterType,  "Skia libpng filter err.");
+static_assert(PNG_FILTER_VALUE_PAETH == kLast_SkPngFilterType,  "Skia libpng filter err.");
+
+// Writes the filter type to out[0], followed by the rowBytes of row filtered with the cheapest of
+// the filters in filterFlags, trying the others in scratch. Both hold rowBytes + 1 bytes.
+static void filter_row_with_best(int filterFlags, const uint8_t* row, const uint8_t* prev,
+                                 size_t rowBytes, size_t bpp, uint8_t* out, uint8_t* scratch) {
+    // As in libpng, no filters means no filtering at all.
+    if (!filterFlags) {
+        filterFlags = PNG_FILTER_NONE;
+    }
+    uint8_t* best = out;
+    uint8_t* trial = scratch;
+    uint64_t bestCost = UINT64_MAX;
+    for (int i = kNone_SkPngFilterType; i <= kLast_SkPngFilterType; i++) {
+        const auto type = static_cast<SkPngFilterType>(i);
+        if (!(filterFlags & (PNG_FILTER_NONE << type))) {
+            continue;
+        }
+        if (filterFlags == (PNG_FILTER_NONE << type)) {
+            out[0] = type;
+            SkOpts::png_filter_row(type, row, prev, rowBytes, bpp, out + 1);
+            return;
+        }
+        trial[0] = type;
+        SkOpts::png_filter_row(type, row, prev, rowBytes, bpp, trial + 1);
+        uint64_t cost = SkOpts::png_filtered_row_cost(trial + 1, rowBytes, bestCost);
+        if (cost < bestCost) {
+            bestCost = cost;
+            std::swap(best, trial);
+        }
+    }
+    if (best != out) {
+        memcpy(out, best, rowBytes + 1);
+    }
+}
+
+// The output of compressing one band of rows.
+struct DeflatedBand {
+    std::vector<uint8_t> fData;
+    uLong fAdler = 0;
+    uLong fLength = 0;
+};
+
+static bool write_png_chunk(SkWStream* stream, const char type[4], const uint8_t* data,
+                            size_t length) {
+    auto bigEndian = [](uint32_t v, uint8_t bytes[4]) {
+        bytes[0] = v >> 24;
+        bytes[1] = v >> 16;
+        bytes[2] = v >> 8;
+        bytes[3] = v;
+    };
+    uint8_t lengthBytes[4], crcBytes[4];
+    bigEndian(SkToU32(length), lengthBytes);
+    uLong crc = crc32(0, reinterpret_cast<const Bytef*>(type), 4);
+    if (length > 0) {
+        crc = crc32(crc, data, SkToUInt(length));
+    }
+    bigEndian(crc, crcBytes);
+    return stream->write(lengthBytes, 4) && stream->write(type, 4) &&
+           (length == 0 || stream->write(data, length)) && stream->write(crcBytes, 4);
+}
+
+bool SkPngEncoderImpl::canEncodeInBands(const SkExecutor* executor) const {
+    const size_t rowBytes = fEncoderMgr->pngBytesPerPixel() * fSrc.width();
+    // libpng's own transforms, like stripping a filler channel, are not applied to bands.
+    if (fCurrRow != 0 || !fEncoderMgr->proc() || rowBytes >= kMinBandBytes ||
+        png_get_rowbytes(fEncoderMgr->pngPtr(), fEncoderMgr->infoPtr()) != rowBytes) {
+        return false;
+    }
+    if (!executor) {
+        return true;
+    }
+    return executor->concurrency() != 1 && (rowBytes + 1) * fSrc.height() / kMinBandBytes >= 2;
+}
+
+bool SkPngEncoderImpl::encodeInBands(SkExecutor* executor) {
+    SkASSERT(this->canEncodeInBands(executor));
+    const int height = fSrc.height();
+    const size_t rowBytes = fEncoderMgr->pngBytesPerPixel() * fSrc.width();
+    const size_t filteredRowBytes = rowBytes + 1;
+    const size_t bpp = std::max(rowBytes / fSrc.width(), (size_t)1);
+    const int bandCount = executor ? SkToInt(filteredRowBytes * height / kMinBandBytes) : 1;
+    const int chunkRows = SkToInt(std::max(kDeflateChunkBytes / filteredRowBytes, (size_t)1));
+
+    const transform_scanline_proc proc = fEncoderMgr->proc();
+    const int filterFlags = fEncoderMgr->filterFlags();
+    const int zlibLevel = fEncoderMgr->zlibLevel();
+    // The same strategy libpng picks by default.
+    const int strategy = filterFlags & ~PNG_FILTER_NONE ? Z_FILTERED : Z_DEFAULT_STRATEGY;
+    SkWStream* stream = static_cast<SkWStream*>(png_get_io_ptr(fEncoderMgr->pngPtr()));
+
+    auto deflateBand = [&](int startRow, int endRow, bool last, DeflatedBand* band) {
+        // Compress the band as if it followed the rows above it in one stream: prime the window
+        // with them, so it can refer back to them just as a serial encode would.
+        const int windowRows = SkToInt(std::min<size_t>(
+                startRow, (kDeflateWindowBytes + filteredRowBytes - 1) / filteredRowBytes));
+        const int firstRow = startRow - windowRows;
+
+        skia_private::AutoTMalloc<uint8_t> rows(2 * rowBytes);
+        skia_private::AutoTMalloc<uint8_t> filtered(std::max(windowRows, chunkRows) *
+                                                    filteredRowBytes);
+        skia_private::AutoTMalloc<uint8_t> scratch(filteredRowBytes);
+        uint8_t* prev = rows.get();
+        uint8_t* curr = prev + rowBytes;
+        if (firstRow > 0) {
+            proc((char*)prev, (const char*)fSrc.addr(0, firstRow - 1), fSrc.width(),
+                 SkColorTypeBytesPerPixel(fSrc.colorType()));
+        } else {
+            memset(prev, 0, rowBytes);
+        }
+        // Filters rows [y, endY) into filtered, and returns how many bytes that is.
+        auto filterRows = [&](int y, int endY) {
+            for (int i = y; i < endY; i++) {
+                const void* srcRow = fSrc.addr(0, i);
+                sk_msan_assert_initialized(
+                        srcRow, (const uint8_t*)srcRow + (fSrc.width() << fSrc.shiftPerPixel()));
+                proc((char*)curr, (const char*)srcRow, fSrc.width(),
+                     SkColorTypeBytesPerPixel(fSrc.colorType()));
+                filter_row_with_best(filterFlags, curr, prev, rowBytes, bpp,
+                                     filtered.get() + (i - y) * filteredRowBytes, scratch.get());
+                std::swap(prev, curr);
+            }
+            return (endY - y) * filteredRowBytes;
+        };
+
+        z_stream zstream = {};
+        if (Z_OK != deflateInit2(&zstream, zlibLevel, Z_DEFLATED, -MAX_WBITS, 8, strategy)) {
+            return false;
+        }
+        SK_AT_SCOPE_EXIT(deflateEnd(&zstream));
+        if (windowRows > 0) {
+            const size_t windowBytes = std::min(kDeflateWindowBytes,
+                                                filterRows(firstRow, startRow));
+            if (Z_OK != deflateSetDictionary(&zstream,
+                                             filtered.get() + windowRows * filteredRowBytes -
+                                                     windowBytes,
+                                             SkToUInt(windowBytes))) {
+                return false;
+            }
+        }
+
+        band->fLength = (endRow - startRow) * filteredRowBytes;
+        band->fAdler = adler32(0, nullptr, 0);
+        std::vector<uint8_t>& out = band->fData;
+        size_t outSize = out.size();
+        for (int y = startRow; y < endRow; y += chunkRows) {
+            const int endY = std::min(y + chunkRows, endRow);
+            const size_t length = filterRows(y, endY);
+            band->fAdler = adler32(band->fAdler, filtered.get(), SkToUInt(length));
+
+            // Every band but the last ends with a sync flush, which ends the data on a byte
+            // boundary without ending the stream, so the next band's data can simply follow it.
+            const int flush = endY < endRow ? Z_NO_FLUSH : last ? Z_FINISH : Z_SYNC_FLUSH;
+            zstream.next_in = filtered.get();
+            zstream.avail_in = SkToUInt(length);
+            int result;
+            do {
+                if (out.size() - outSize < kDeflateChunkBytes / 4) {
+                    out.resize(std::max(2 * out.size(), outSize + kDeflateChunkBytes));
+                }
+                zstream.next_out = out.data() + outSize;
+                zstream.avail_out = SkToUInt(out.size() - outSize);
+                result = deflate(&zstream, flush);
+                outSize = out.size() - zstream.avail_out;
+                if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+                    return false;
+                }
+            } while (flush == Z_FINISH ? result != Z_STREAM_END
+                                       : zstream.avail_in != 0 || zstream.avail_out == 0);
+
+            // A single band is written out as it goes, rather than held until the end.
+            if (!executor && outSize >= kIdatBytes && endY < endRow) {
+                if (!write_png_chunk(stream, "IDAT", out.data(), outSize)) {
+                    return false;
+                }
+                outSize = 0;
+            }
+        }
+        out.resize(outSize);
+        return true;
+    };
+
+    std::vector<DeflatedBand> bands(bandCount);
+    // The zlib header goes in front of the first band: a 32K window, and the level as a hint.
+    const uint8_t cmf = 0x78;
+    const uint8_t flevel = zlibLevel < 2 ? 0 : zlibLevel < 6 ? 1 : zlibLevel == 6 ? 2 : 3;
+    const uint8_t flg = (flevel << 6) + (31 - ((cmf << 8) + (flevel << 6)) % 31) % 31;
+    bands[0].fData = {cmf, flg};
+
+    if (executor) {
+        std::atomic<bool> succeeded{true};
+        SkParallelFor(*executor, bandCount, 1, [&](int firstBand, int endBand) {
+            for (int i = firstBand; i < endBand && succeeded; i++) {
+                const int startRow = SkToInt((int64_t)i * height / bandCount),
+                          endRow = SkToInt((int64_t)(i + 1) * height / bandCount);
+                if (!deflateBand(startRow, endRow, i == bandCount - 1, &bands[i])) {
+                    succeeded = false;
+                }
+            }
+        });
+        if (!succeeded) {
+            return false;
+        }
+    } else if (!deflateBand(0, height, true, &bands[0])) {
+        return false;
+    }
+
+    // The zlib trailer: the Adler-32 checksum of all the data.
+    uLong adler = bands[0].fAdler;
+    for (int i = 1; i < bandCount; i++) {
+        adler = adler32_combine(adler, bands[i].fAdler, bands[i].fLength);
+    }
+    for (int shift : {24, 16, 8, 0}) {
+        bands.back().fData.push_back(adler >> shift);
+    }
+
+    for (const DeflatedBand& band : bands) {
+        if (!write_png_chunk(stream, "IDAT", band.fData.data(), band.fData.size())) {
+            return false;
+        }
+    }
+    if (!write_png_chunk(stream, "IEND", nullptr, 0)) {
+        return false;
+    }
+    fCurrRow = height;
+    return true;
+}
+
 namespace SkPngEncoder {
 std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
     if (!SkPixmapIsValid(src)) {
@@ -496,7 +751,17 @@ std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Optio
 
 bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
     auto encoder = Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    if (!encoder) {
+        return false;
+    }
+    auto impl = static_cast<SkPngEncoderImpl*>(encoder.get());
+    if (options.fExecutor && impl->canEncodeInBands(options.fExecutor)) {
+        return impl->encodeInBands(options.fExecutor);
+    }
+    if (options.fUseSkiaFilters && impl->canEncodeInBands(nullptr)) {
+        return impl->encodeInBands(nullptr);
+    }
+    return encoder->encodeRows(src.height());
 }
 
 sk_sp<SkData> Encode(GrDirectContext* ctx, const SkImage* img, const Options& options) {
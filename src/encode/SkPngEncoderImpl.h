@@ -12,6 +12,7 @@
 
 #include <memory>
 
+class SkExecutor;
 class SkPixmap;
 class SkPngEncoderMgr;
 
@@ -22,6 +23,15 @@ public:
     SkPngEncoderImpl(std::unique_ptr<SkPngEncoderMgr>, const SkPixmap& src);
     ~SkPngEncoderImpl() override;
 
+    // Returns true if encodeInBands() can encode this image, which needs no rows encoded yet.
+    // With an executor, it also needs enough rows to split into bands.
+    bool canEncodeInBands(const SkExecutor*) const;
+
+    // Encodes every row, filtering them with SkOpts' PNG filters instead of libpng's. With an
+    // executor, the rows are split into bands that are filtered and compressed concurrently.
+    // Without one, they are encoded as a single band on this thread.
+    bool encodeInBands(SkExecutor*);
+
 protected:
     bool onEncodeRows(int numRows) override;
     std::unique_ptr<SkPngEncoderMgr> fEncoderMgr;
@@ -7,8 +7,10 @@
 
 #include "src/image/SkImage_Lazy.h"
 
+#include "include/codec/SkEncodedOrigin.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkPixmap.h"
@@ -19,6 +21,7 @@
 #include "src/core/SkNextID.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkYUVPlanesCache.h"
+#include "src/image/SkImageGeneratorPriv.h"
 
 #include <utility>
 
@@ -100,6 +103,7 @@ private:
 SkImage_Lazy::SkImage_Lazy(Validator* validator)
     : SkImage_Base(validator->fInfo, validator->fUniqueID)
     , fSharedGenerator(std::move(validator->fSharedGenerator))
+    , fDrawRasterFromPlanes(validator->fDrawRasterFromPlanes)
 {
     SkASSERT(fSharedGenerator);
 }
@@ -113,14 +117,15 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
     };
 
     auto desc = SkBitmapCacheDesc::Make(this);
-    if (SkBitmapCache::Find(desc, bitmap)) {
+    if (SkBitmapCache::Find(desc, bitmap, fLocalCache)) {
         check_output_bitmap();
         return true;
     }
 
     if (SkImage::kAllow_CachingHint == chint) {
         SkPixmap pmap;
-        SkBitmapCache::RecPtr cacheRec = SkBitmapCache::Alloc(desc, this->imageInfo(), &pmap);
+        SkBitmapCache::RecPtr cacheRec = SkBitmapCache::Alloc(desc, this->imageInfo(), &pmap,
+                                                              fLocalCache);
         if (!cacheRec) {
             return false;
         }
@@ -131,7 +136,7 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
         if (!success && !this->readPixelsProxy(ctx, pmap)) {
             return false;
         }
-        SkBitmapCache::Add(std::move(cacheRec), bitmap);
+        SkBitmapCache::Add(std::move(cacheRec), bitmap, fLocalCache);
         this->notifyAddedToRasterCache();
     } else {
         if (!bitmap->tryAllocPixels(this->imageInfo())) {
@@ -247,7 +252,8 @@ sk_sp<SkCachedData> SkImage_Lazy::getPlanes(
         SkYUVAPixmaps* yuvaPixmaps) const {
     ScopedGenerator generator(fSharedGenerator);
 
-    sk_sp<SkCachedData> data(SkYUVPlanesCache::FindAndRef(generator->uniqueID(), yuvaPixmaps));
+    sk_sp<SkCachedData> data(SkYUVPlanesCache::FindAndRef(generator->uniqueID(), yuvaPixmaps,
+                                                          fLocalCache));
 
     if (data) {
         SkASSERT(yuvaPixmaps->isValid());
@@ -259,7 +265,9 @@ sk_sp<SkCachedData> SkImage_Lazy::getPlanes(
         yuvaPixmapInfo.yuvaInfo().dimensions() != this->dimensions()) {
         return nullptr;
     }
-    data.reset(SkResourceCache::NewCachedData(yuvaPixmapInfo.computeTotalBytes()));
+    const size_t totalBytes = yuvaPixmapInfo.computeTotalBytes();
+    data.reset(fLocalCache ? fLocalCache->newCachedData(totalBytes)
+                           : SkResourceCache::NewCachedData(totalBytes));
     SkYUVAPixmaps tempPixmaps = SkYUVAPixmaps::FromExternalMemory(yuvaPixmapInfo,
                                                                   data->writable_data());
     SkASSERT(tempPixmaps.isValid());
@@ -268,7 +276,49 @@ sk_sp<SkCachedData> SkImage_Lazy::getPlanes(
     }
     // Decoding is done, cache the resulting YUV planes
     *yuvaPixmaps = tempPixmaps;
-    SkYUVPlanesCache::Add(this->uniqueID(), data.get(), *yuvaPixmaps);
+    SkYUVPlanesCache::Add(this->uniqueID(), data.get(), *yuvaPixmaps, fLocalCache);
+    this->notifyAddedToRasterCache();
+    return data;
+}
+
+sk_sp<SkCachedData> SkImage_Lazy::getRasterPlanes(SkYUVAPixmaps* yuvaPixmaps) const {
+    if (!this->drawsRasterFromPlanes()) {
+        return nullptr;
+    }
+
+    SkYUVAPixmapInfo::SupportedDataTypes supportedDataTypes;
+    supportedDataTypes.enableDataType(SkYUVAPixmapInfo::DataType::kUnorm8, 1);
+    supportedDataTypes.enableDataType(SkYUVAPixmapInfo::DataType::kUnorm8, 2);
+    sk_sp<SkCachedData> data = this->getPlanes(supportedDataTypes, yuvaPixmaps);
+
+    // Planes cached by a GPU draw may be of other types. Rotated images and offset chroma are
+    // left to the RGBA decode.
+    auto samplable = [](const SkYUVAPixmaps& pixmaps) {
+        const SkYUVAInfo& info = pixmaps.yuvaInfo();
+        if (info.origin() != kTopLeft_SkEncodedOrigin ||
+            info.sitingX() != SkYUVAInfo::Siting::kCentered ||
+            info.sitingY() != SkYUVAInfo::Siting::kCentered) {
+            return false;
+        }
+        for (int i = 0; i < pixmaps.numPlanes(); ++i) {
+            switch (pixmaps.plane(i).colorType()) {
+                case kAlpha_8_SkColorType:
+                case kGray_8_SkColorType:
+                case kR8_unorm_SkColorType:
+                case kR8G8_unorm_SkColorType:
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return true;
+    };
+    if (data && !samplable(*yuvaPixmaps)) {
+        data.reset();
+    }
+    if (!data) {
+        fRasterPlanesUnavailable.store(true, std::memory_order_relaxed);
+    }
     return data;
 }
 
@@ -286,4 +336,16 @@ sk_sp<SkImage> DeferredFromGenerator(std::unique_ptr<SkImageGenerator> generator
     return validator ? sk_make_sp<SkImage_Lazy>(&validator) : nullptr;
 }
 
+sk_sp<SkImage> DeferredYUVAFromEncodedData(sk_sp<SkData> encoded) {
+    if (nullptr == encoded || 0 == encoded->size()) {
+        return nullptr;
+    }
+    SkImage_Lazy::Validator validator(
+            SharedGenerator::Make(SkImageGenerators::MakeFromEncoded(std::move(encoded))),
+            nullptr, nullptr);
+    validator.fDrawRasterFromPlanes = true;
+
+    return validator ? sk_make_sp<SkImage_Lazy>(&validator) : nullptr;
+}
+
 }  // namespace SkImages
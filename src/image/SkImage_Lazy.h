@@ -19,6 +19,7 @@
 #include "include/private/base/SkMutex.h"
 #include "src/image/SkImage_Base.h"
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
@@ -30,6 +31,7 @@ class SkBitmap;
 class SkCachedData;
 class SkData;
 class SkPixmap;
+class SkResourceCache;
 enum SkColorType : int;
 struct SkIRect;
 
@@ -46,6 +48,9 @@ public:
         SkImageInfo            fInfo;
         sk_sp<SkColorSpace>    fColorSpace;
         uint32_t               fUniqueID;
+        // Whether raster draws should sample the generator's YUVA planes instead of decoding to
+        // RGBA (see SkImages::DeferredYUVAFromEncodedData).
+        bool                   fDrawRasterFromPlanes = false;
     };
 
     SkImage_Lazy(Validator* validator);
@@ -79,6 +84,23 @@ public:
     sk_sp<SkCachedData> getPlanes(const SkYUVAPixmapInfo::SupportedDataTypes& supportedDataTypes,
                                   SkYUVAPixmaps* pixmaps) const;
 
+    // Whether raster draws should sample this image's YUVA planes, as far as is known yet.
+    bool drawsRasterFromPlanes() const {
+        return fDrawRasterFromPlanes && !fRasterPlanesUnavailable.load(std::memory_order_relaxed);
+    }
+
+    /**
+     *  If this image draws on the raster backend from its YUVA planes, returns them in a form
+     *  SkImageShader can sample: 8-bit planes of one or two channels, in the image's orientation
+     *  and with centered chroma. Otherwise, or if the generator can't make such planes, returns
+     *  null and the image should be drawn from its RGBA pixels.
+     */
+    sk_sp<SkCachedData> getRasterPlanes(SkYUVAPixmaps* pixmaps) const;
+
+    // Keeps this image's raster pixels and planes in cache rather than the global resource cache.
+    // Must be called before the image is drawn or decoded.
+    void setLocalCacheForTesting(SkResourceCache* cache) { fLocalCache = cache; }
+
 
     // Be careful with this. You need to acquire the mutex, as the generator might be shared
     // among several images.
@@ -95,6 +117,11 @@ private:
     // onMakeColorTypeAndColorSpace.
     sk_sp<SharedGenerator> fSharedGenerator;
 
+    const bool                fDrawRasterFromPlanes;
+    // Set once the generator has failed to make planes that getRasterPlanes() can return.
+    mutable std::atomic<bool> fRasterPlanesUnavailable{false};
+    SkResourceCache*          fLocalCache = nullptr;
+
     // Repeated calls to onMakeColorTypeAndColorSpace will result in a proliferation of unique IDs
     // and SkImage_Lazy instances. Cache the result of the last successful call.
     mutable SkMutex        fOnMakeColorTypeAndSpaceMutex;
@@ -155,6 +155,12 @@ sk_sp<const SkCapabilities> SkSurface_Raster::onCapabilities() {
     return SkCapabilities::RasterBackend();
 }
 
+void SkSurface_Raster::setPathFillExecutor(SkExecutor* executor) {
+    // Our canvas is cached, and its root device always draws into fBitmap.
+    auto device = static_cast<SkBitmapDevice*>(this->getCachedCanvas()->rootDevice());
+    device->setPathFillExecutor(executor);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 namespace SkSurfaces {
 sk_sp<SkSurface> WrapPixels(const SkImageInfo& info,
@@ -183,6 +189,14 @@ sk_sp<SkSurface> WrapPixels(const SkImageInfo& info,
     return WrapPixels(info, pixels, rowBytes, nullptr, nullptr, props);
 }
 
+bool SetPathFillExecutor(SkSurface* surface, SkExecutor* executor) {
+    if (!surface || !asSB(surface)->isRasterBacked()) {
+        return false;
+    }
+    static_cast<SkSurface_Raster*>(surface)->setPathFillExecutor(executor);
+    return true;
+}
+
 sk_sp<SkSurface> Raster(const SkImageInfo& info, size_t rowBytes, const SkSurfaceProps* props) {
     if (!SkSurfaceValidateRasterInfo(info)) {
         return nullptr;
@@ -19,6 +19,7 @@
 
 class SkCanvas;
 class SkCapabilities;
+class SkExecutor;
 class SkImage;
 class SkPaint;
 class SkPixelRef;
@@ -49,6 +50,9 @@ public:
     void onRestoreBackingMutability() override;
     sk_sp<const SkCapabilities> onCapabilities() override;
 
+    // See SkSurfaces::SetPathFillExecutor().
+    void setPathFillExecutor(SkExecutor*);
+
 private:
     SkBitmap    fBitmap;
     bool        fWeOwnThePixels;
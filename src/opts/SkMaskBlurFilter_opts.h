@@ -0,0 +1,188 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkMaskBlurFilter_opts_DEFINED
+#define SkMaskBlurFilter_opts_DEFINED
+
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkMaskBlurFilter.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <emmintrin.h>
+#endif
+
+namespace SK_OPTS_NS {
+
+// How many rows mask_blur_box3_transposed() blurs together: one row per 32-bit lane, so with
+// AVX-512 each of the running sums fills a whole register.
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    static constexpr int kMaskBlurRows = 16;
+#else
+    static constexpr int kMaskBlurRows = 8;
+#endif
+
+// Transposes up to N rows of width bytes: pixel x of row i is copied to columns[x*N + i].
+template <int N>
+static void transpose_rows(const uint8_t* src, size_t srcRB, int width, int rows,
+                           uint8_t* columns) {
+    int x = 0;
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    // Transpose 8x8 blocks by interleaving pairs of rows, then pairs of those, and so on, until
+    // each register holds two whole columns of the block.
+    if (rows == N) {
+        for (; x + 8 <= width; x += 8) {
+            for (int i = 0; i < N; i += 8) {
+                const uint8_t* block = src + i * srcRB + x;
+                auto row = [&](int r) {
+                    return _mm_loadl_epi64((const __m128i*)(block + r * srcRB));
+                };
+                __m128i r01 = _mm_unpacklo_epi8(row(0), row(1)),
+                        r23 = _mm_unpacklo_epi8(row(2), row(3)),
+                        r45 = _mm_unpacklo_epi8(row(4), row(5)),
+                        r67 = _mm_unpacklo_epi8(row(6), row(7));
+                __m128i r0123lo = _mm_unpacklo_epi16(r01, r23),
+                        r0123hi = _mm_unpackhi_epi16(r01, r23),
+                        r4567lo = _mm_unpacklo_epi16(r45, r67),
+                        r4567hi = _mm_unpackhi_epi16(r45, r67);
+                const __m128i pairs[] = {
+                    _mm_unpacklo_epi32(r0123lo, r4567lo),  // Columns 0 and 1
+                    _mm_unpackhi_epi32(r0123lo, r4567lo),  // Columns 2 and 3
+                    _mm_unpacklo_epi32(r0123hi, r4567hi),  // Columns 4 and 5
+                    _mm_unpackhi_epi32(r0123hi, r4567hi),  // Columns 6 and 7
+                };
+                uint8_t* out = columns + x * N + i;
+                for (const __m128i& pair : pairs) {
+                    _mm_storel_epi64((__m128i*)out, pair);
+                    _mm_storel_epi64((__m128i*)(out + N), _mm_unpackhi_epi64(pair, pair));
+                    out += 2 * N;
+                }
+            }
+        }
+    }
+#endif
+    for (int i = 0; i < rows; i++) {
+        const uint8_t* row = src + i * srcRB;
+        for (int col = x; col < width; col++) {
+            columns[col * N + i] = row[col];
+        }
+    }
+}
+
+// This is PlanGauss::Scan::blur() from SkMaskBlurFilter.cpp, run on kMaskBlurRows rows at once,
+// and produces exactly the same pixels. The rows are transposed into columns up front, so each
+// step loads the next pixel of every row with one load, and stores the results of every row with
+// one store into the (already transposed) destination.
+static void mask_blur_box3_transposed(const uint8_t* src, size_t srcRB, int srcW, int rows,
+                                      uint8_t* dst, size_t dstRB, int dstW,
+                                      const SkMaskBlurBoxes& boxes) {
+    constexpr int N = kMaskBlurRows;
+    using U8  = skvx::Vec<N, uint8_t>;
+    using U32 = skvx::Vec<N, uint32_t>;
+
+    const int pass0Size = boxes.pass0Size,
+              pass1Size = boxes.pass1Size,
+              pass2Size = boxes.pass2Size;
+    SkASSERT(pass0Size > 0 && pass1Size > 0 && pass2Size > 0);
+    SkASSERT(srcW > 0 && dstW >= srcW);
+
+    // Each ring buffer entry and each column is N lanes wide. Column x of the current rows is the
+    // N bytes at columns[x * N].
+    const int ringSize = pass0Size + pass1Size + pass2Size;
+    skia_private::AutoTMalloc<uint32_t> ring(ringSize * N);
+    skia_private::AutoTMalloc<uint8_t>  columns(srcW * N);
+    uint32_t* const buffer0 = ring.get();
+    uint32_t* const buffer1 = buffer0 + pass0Size * N;
+    uint32_t* const buffer2 = buffer1 + pass1Size * N;
+
+    const int noChangeCount = std::max(boxes.slidingWindow - srcW, 0);
+    // Every window here is at least 2, so the weight fits in 32 bits, and each product is just a
+    // 32x32->64-bit multiply.
+    SkASSERT(boxes.weight <= 0xFFFFFFFF);
+    const uint64_t weight = static_cast<uint32_t>(boxes.weight);
+    static constexpr uint64_t kHalf = static_cast<uint64_t>(1) << 31;
+
+    U32 sum0, sum1, sum2;
+    int cursor0, cursor1, cursor2;
+    auto reset = [&] {
+        std::memset(ring.get(), 0, ringSize * N * sizeof(uint32_t));
+        sum0 = sum1 = sum2 = 0;
+        cursor0 = cursor1 = cursor2 = 0;
+    };
+    auto step = [&](U32 leadingEdge) {
+        sum0 += leadingEdge;
+        sum1 += sum0;
+        sum2 += sum1;
+
+        U8 result = skvx::cast<uint8_t>(
+                (skvx::cast<uint64_t>(sum2) * weight + kHalf) >> 32);
+
+        uint32_t* entry2 = buffer2 + cursor2 * N;
+        sum2 -= U32::Load(entry2);
+        sum1.store(entry2);
+        cursor2 = cursor2 + 1 < pass2Size ? cursor2 + 1 : 0;
+
+        uint32_t* entry1 = buffer1 + cursor1 * N;
+        sum1 -= U32::Load(entry1);
+        sum0.store(entry1);
+        cursor1 = cursor1 + 1 < pass1Size ? cursor1 + 1 : 0;
+
+        uint32_t* entry0 = buffer0 + cursor0 * N;
+        sum0 -= U32::Load(entry0);
+        leadingEdge.store(entry0);
+        cursor0 = cursor0 + 1 < pass0Size ? cursor0 + 1 : 0;
+
+        return result;
+    };
+    auto column = [&](int x) {
+        return skvx::cast<uint32_t>(U8::Load(columns.get() + x * N));
+    };
+
+    for (int y = 0; y < rows; y += N) {
+        const int n = std::min(N, rows - y);
+        if (n < N) {
+            std::memset(columns.get(), 0, srcW * N);
+        }
+        transpose_rows<N>(src + y * srcRB, srcRB, srcW, n, columns.get());
+
+        auto store = [&](int x, const U8& result) {
+            uint8_t* out = dst + x * dstRB + y;
+            if (n == N) {
+                result.store(out);
+            } else {
+                std::memcpy(out, &result, n);
+            }
+        };
+
+        // Consume the source generating pixels.
+        reset();
+        int x = 0;
+        for (; x < srcW; x++) {
+            store(x, step(column(x)));
+        }
+
+        // The leading edge is off the right side of the mask.
+        for (int i = 0; i < noChangeCount; i++, x++) {
+            store(x, step(U32(0)));
+        }
+
+        // Starting from the right, fill in the rest of the row.
+        reset();
+        for (int dstX = dstW, srcX = srcW; dstX > x;) {
+            store(--dstX, step(column(--srcX)));
+        }
+    }
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif  // SkMaskBlurFilter_opts_DEFINED
@@ -9,13 +9,20 @@
 #define SkUtils_opts_DEFINED
 
 #include <stdint.h>
+#include "src/base/SkUtils.h"
 #include "src/base/SkVx.h"
 
+#if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    #include <immintrin.h>
+#endif
+
 namespace SK_OPTS_NS {
 
     template <typename T>
     static void memsetT(T buffer[], T value, int count) {
-    #if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
+    #if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+        static constexpr int VecSize = 64 / sizeof(T);
+    #elif defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
         static constexpr int VecSize = 32 / sizeof(T);
     #else
         static constexpr int VecSize = 16 / sizeof(T);
@@ -30,6 +37,14 @@ namespace SK_OPTS_NS {
             count  -= VecSize;
         }
         // If count was not an even multiple of VecSize, take care of the last few.
+    #if defined(SK_CPU_SSE_LEVEL) && SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+        // With AVX-512 that's a single byte-masked store.
+        if (count > 0) {
+            __mmask64 mask = (__mmask64)((uint64_t(1) << (count * sizeof(T))) - 1);
+            _mm512_mask_storeu_epi8(buffer, mask, sk_bit_cast<__m512i>(wideValue));
+        }
+        return;
+    #endif
         while (count-- > 0) {
             *buffer++ = value;
         }
@@ -0,0 +1,344 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPngFilters_opts_DEFINED
+#define SkPngFilters_opts_DEFINED
+
+#include "include/private/base/SkAssert.h"
+#include "src/base/SkVx.h"
+#include "src/core/SkPngFilters.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    #include <immintrin.h>
+#endif
+
+namespace SK_OPTS_NS {
+
+// How many bytes of a row png_filter_row() filters at once.
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+    static constexpr int kPngFilterLanes = 32;
+#else
+    static constexpr int kPngFilterLanes = 16;
+#endif
+
+static inline uint8_t png_paeth_predictor(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a),
+        pb = std::abs(p - b),
+        pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// The same predictor for vectors of bytes. With p = a + b - c, |p - a| = |b - c| and
+// |p - b| = |a - c|, while |p - c| is the sum of those two when a - c and b - c have the same
+// sign, and otherwise their difference. That all fits in bytes, without widening to 16 bits:
+// |p - c| is only compared with the other two, so it may as well saturate at 255.
+template <int N>
+static inline skvx::Vec<N, uint8_t> png_paeth_predictor(skvx::Vec<N, uint8_t> a,
+                                                        skvx::Vec<N, uint8_t> b,
+                                                        skvx::Vec<N, uint8_t> c) {
+    auto pa = skvx::max(b, c) - skvx::min(b, c),
+         pb = skvx::max(a, c) - skvx::min(a, c);
+    auto pc = skvx::if_then_else((a >= c) == (b >= c), skvx::saturated_add(pa, pb),
+                                 skvx::max(pa, pb) - skvx::min(pa, pb));
+    return skvx::if_then_else((pa <= pb) & (pa <= pc), a, skvx::if_then_else(pb <= pc, b, c));
+}
+
+// The average of a and b rounded down, without widening to 16 bits.
+template <int N>
+static inline skvx::Vec<N, uint8_t> png_average(skvx::Vec<N, uint8_t> a,
+                                                skvx::Vec<N, uint8_t> b) {
+    return (a & b) + ((a ^ b) >> 1);
+}
+
+static void png_filter_row(SkPngFilterType type, const uint8_t* row, const uint8_t* prev,
+                           size_t rowBytes, size_t bpp, uint8_t* dst) {
+    constexpr int N = kPngFilterLanes;
+    using U8 = skvx::Vec<N, uint8_t>;
+    SkASSERT(bpp > 0);
+
+    // The first pixel has no pixel to its left, so it is filtered as if that were zero. That
+    // leaves it as is for Sub, and makes Paeth predict the byte above.
+    const size_t first = std::min(bpp, rowBytes);
+    size_t i = 0;
+    switch (type) {
+        case kNone_SkPngFilterType:
+            memcpy(dst, row, rowBytes);
+            return;
+        case kSub_SkPngFilterType:
+            memcpy(dst, row, first);
+            for (i = first; i + N <= rowBytes; i += N) {
+                (U8::Load(row + i) - U8::Load(row + i - bpp)).store(dst + i);
+            }
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - row[i - bpp];
+            }
+            return;
+        case kUp_SkPngFilterType:
+            for (; i + N <= rowBytes; i += N) {
+                (U8::Load(row + i) - U8::Load(prev + i)).store(dst + i);
+            }
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - prev[i];
+            }
+            return;
+        case kAvg_SkPngFilterType:
+            for (; i < first; i++) {
+                dst[i] = row[i] - (prev[i] >> 1);
+            }
+            for (; i + N <= rowBytes; i += N) {
+                (U8::Load(row + i) - png_average(U8::Load(row + i - bpp),
+                                                 U8::Load(prev + i))).store(dst + i);
+            }
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - ((row[i - bpp] + prev[i]) >> 1);
+            }
+            return;
+        case kPaeth_SkPngFilterType:
+            for (; i < first; i++) {
+                dst[i] = row[i] - prev[i];
+            }
+            for (; i + N <= rowBytes; i += N) {
+                (U8::Load(row + i) - png_paeth_predictor(U8::Load(row + i - bpp),
+                                                         U8::Load(prev + i),
+                                                         U8::Load(prev + i - bpp))).store(dst + i);
+            }
+            for (; i < rowBytes; i++) {
+                dst[i] = row[i] - png_paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]);
+            }
+            return;
+    }
+    SkUNREACHABLE;
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+// png_paeth_predictor() for the bytes of SSE registers.
+static inline __m128i png_paeth_predictor_sse2(__m128i a, __m128i b, __m128i c) {
+    auto absdiff = [](__m128i x, __m128i y) {
+        return _mm_sub_epi8(_mm_max_epu8(x, y), _mm_min_epu8(x, y));
+    };
+    auto le = [](__m128i x, __m128i y) { return _mm_cmpeq_epi8(_mm_min_epu8(x, y), x); };
+    auto select = [](__m128i mask, __m128i t, __m128i e) {
+        return _mm_or_si128(_mm_and_si128(mask, t), _mm_andnot_si128(mask, e));
+    };
+    __m128i pa = absdiff(b, c),
+            pb = absdiff(a, c);
+    __m128i pc = select(_mm_cmpeq_epi8(le(c, a), le(c, b)), _mm_adds_epu8(pa, pb),
+                        absdiff(pa, pb));
+    return select(_mm_and_si128(le(pa, pb), le(pa, pc)), a, select(le(pb, pc), b, c));
+}
+#endif
+
+// Unfiltering a byte needs the unfiltered byte one pixel to its left, so Sub, Avg and Paeth go
+// a pixel at a time, with all of a pixel's bytes in one vector. BPP is at most 8.
+template <int BPP>
+static void png_unfilter_pixels(SkPngFilterType type, uint8_t* row, const uint8_t* prev,
+                                size_t rowBytes) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+    // skvx's small vectors are slow to move in and out of registers here, so this works on the
+    // low bytes of SSE registers directly.
+    using V = __m128i;
+    // Loading 3 bytes a byte at a time is slow, so 3-byte pixels load a 4th byte, except for the
+    // last one in the row. Only the low BPP bytes of a pixel are ever stored.
+    auto load = [](const uint8_t* p, bool last) {
+        if (BPP == 3 && !last) {
+            int32_t bytes;
+            memcpy(&bytes, p, 4);
+            return _mm_cvtsi32_si128(bytes);
+        }
+        uint8_t bytes[8] = {};
+        memcpy(bytes, p, BPP);
+        return _mm_loadl_epi64((const __m128i*)bytes);
+    };
+    auto store = [](uint8_t* p, V v) {
+        if (BPP == 4) {
+            int32_t bytes = _mm_cvtsi128_si32(v);
+            memcpy(p, &bytes, 4);
+            return;
+        }
+        uint8_t bytes[8];
+        _mm_storel_epi64((__m128i*)bytes, v);
+        memcpy(p, bytes, BPP);
+    };
+    auto add = [](V x, V y) { return _mm_add_epi8(x, y); };
+    // _mm_avg_epu8() rounds up, so this takes off the bit it rounded up by.
+    auto average = [](V x, V y) {
+        return _mm_sub_epi8(_mm_avg_epu8(x, y),
+                            _mm_and_si128(_mm_xor_si128(x, y), _mm_set1_epi8(1)));
+    };
+    auto paeth = png_paeth_predictor_sse2;
+    V a = _mm_setzero_si128(),
+      c = _mm_setzero_si128();
+#else
+    using V = skvx::Vec<BPP <= 4 ? 4 : 8, uint8_t>;
+    auto load = [](const uint8_t* p, bool /*last*/) {
+        V v = 0;
+        memcpy(&v, p, BPP);
+        return v;
+    };
+    auto store = [](uint8_t* p, const V& v) { memcpy(p, &v, BPP); };
+    auto add = [](const V& x, const V& y) { return x + y; };
+    auto average = [](const V& x, const V& y) { return png_average(x, y); };
+    auto paeth = [](const V& x, const V& y, const V& z) { return png_paeth_predictor(x, y, z); };
+    V a = 0,
+      c = 0;
+#endif
+
+    switch (type) {
+        case kSub_SkPngFilterType:
+            for (size_t i = 0; i < rowBytes; i += BPP) {
+                a = add(load(row + i, i + BPP == rowBytes), a);
+                store(row + i, a);
+            }
+            return;
+        case kAvg_SkPngFilterType:
+            for (size_t i = 0; i < rowBytes; i += BPP) {
+                const bool last = i + BPP == rowBytes;
+                a = add(load(row + i, last), average(a, load(prev + i, last)));
+                store(row + i, a);
+            }
+            return;
+        case kPaeth_SkPngFilterType:
+            for (size_t i = 0; i < rowBytes; i += BPP) {
+                const bool last = i + BPP == rowBytes;
+                V b = load(prev + i, last);
+                a = add(load(row + i, last), paeth(a, b, c));
+                c = b;
+                store(row + i, a);
+            }
+            return;
+        default:
+            break;
+    }
+    SkUNREACHABLE;
+}
+
+static void png_unfilter_row(SkPngFilterType type, uint8_t* row, const uint8_t* prev,
+                             size_t rowBytes, size_t bpp) {
+    constexpr int N = kPngFilterLanes;
+    using U8 = skvx::Vec<N, uint8_t>;
+    SkASSERT(bpp > 0 && rowBytes % bpp == 0);
+
+    size_t i = 0;
+    switch (type) {
+        case kNone_SkPngFilterType:
+            return;
+        case kUp_SkPngFilterType:
+            // Up only needs the row above, so it goes a whole vector at a time.
+            for (; i + N <= rowBytes; i += N) {
+                (U8::Load(row + i) + U8::Load(prev + i)).store(row + i);
+            }
+            for (; i < rowBytes; i++) {
+                row[i] += prev[i];
+            }
+            return;
+        case kSub_SkPngFilterType:
+        case kAvg_SkPngFilterType:
+        case kPaeth_SkPngFilterType:
+            break;
+    }
+
+    switch (bpp) {
+        case 3: png_unfilter_pixels<3>(type, row, prev, rowBytes); return;
+        case 4: png_unfilter_pixels<4>(type, row, prev, rowBytes); return;
+        case 6: png_unfilter_pixels<6>(type, row, prev, rowBytes); return;
+        case 8: png_unfilter_pixels<8>(type, row, prev, rowBytes); return;
+        default: break;
+    }
+
+    // Pixels of one or two bytes gain little from vectors, and other sizes are rare.
+    const size_t first = std::min(bpp, rowBytes);
+    switch (type) {
+        case kSub_SkPngFilterType:
+            for (i = first; i < rowBytes; i++) {
+                row[i] += row[i - bpp];
+            }
+            return;
+        case kAvg_SkPngFilterType:
+            for (; i < first; i++) {
+                row[i] += prev[i] >> 1;
+            }
+            for (; i < rowBytes; i++) {
+                row[i] += (row[i - bpp] + prev[i]) >> 1;
+            }
+            return;
+        case kPaeth_SkPngFilterType:
+            for (; i < first; i++) {
+                row[i] += prev[i];
+            }
+            for (; i < rowBytes; i++) {
+                row[i] += png_paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]);
+            }
+            return;
+        default:
+            break;
+    }
+    SkUNREACHABLE;
+}
+
+static uint64_t png_filtered_row_cost(const uint8_t* filtered, size_t n, uint64_t limit) {
+    // The limit is checked once per block rather than after every byte as in libpng. Stopping a
+    // block late only makes the sum larger, and every sum past the limit is treated the same.
+    constexpr size_t kBlockBytes = 256;
+
+    uint64_t sum = 0;
+    size_t i = 0;
+    while (i < n && sum < limit) {
+        const size_t end = std::min(n, i + kBlockBytes);
+        // A byte's absolute value as a signed byte is the smaller of it and its negation.
+    #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 32 <= end; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(filtered + i));
+            v = _mm256_min_epu8(v, _mm256_sub_epi8(_mm256_setzero_si256(), v));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, _mm256_setzero_si256()));
+        }
+        __m128i acc128 = _mm_add_epi64(_mm256_castsi256_si128(acc),
+                                       _mm256_extracti128_si256(acc, 1));
+        uint64_t lanes[2];
+        _mm_storeu_si128((__m128i*)lanes, acc128);
+        sum += lanes[0] + lanes[1];
+    #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSE2
+        __m128i acc = _mm_setzero_si128();
+        for (; i + 16 <= end; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(filtered + i));
+            v = _mm_min_epu8(v, _mm_sub_epi8(_mm_setzero_si128(), v));
+            acc = _mm_add_epi64(acc, _mm_sad_epu8(v, _mm_setzero_si128()));
+        }
+        uint64_t lanes[2];
+        _mm_storeu_si128((__m128i*)lanes, acc);
+        sum += lanes[0] + lanes[1];
+    #else
+        // Each 16-bit lane sums at most 16 bytes of a block, so it cannot overflow.
+        using U8 = skvx::Vec<16, uint8_t>;
+        skvx::Vec<16, uint16_t> acc = 0;
+        for (; i + 16 <= end; i += 16) {
+            U8 v = U8::Load(filtered + i);
+            acc += skvx::cast<uint16_t>(skvx::min(v, U8(0) - v));
+        }
+        for (int lane = 0; lane < 16; lane++) {
+            sum += acc[lane];
+        }
+    #endif
+        for (; i < end; i++) {
+            sum += filtered[i] < 128 ? filtered[i] : 256 - filtered[i];
+        }
+    }
+    return sum;
+}
+
+}  // namespace SK_OPTS_NS
+
+#endif  // SkPngFilters_opts_DEFINED
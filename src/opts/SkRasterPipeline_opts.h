@@ -58,6 +58,8 @@ using NoCtx = const void*;
     #define JUMPER_IS_SCALAR
 #elif defined(SK_ARM_HAS_NEON)
     #define JUMPER_IS_NEON
+#elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    #define JUMPER_IS_SKX
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX2
     #define JUMPER_IS_HSW
 #elif SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_AVX
@@ -734,6 +736,296 @@ namespace SK_OPTS_NS {
         }
     }
 
+#elif defined(JUMPER_IS_SKX)
+    // These are __m512 and __m512i, but friendlier and strongly-typed.
+    template <typename T> using V = T __attribute__((ext_vector_type(16)));
+    using F   = V<float   >;
+    using I32 = V< int32_t>;
+    using U64 = V<uint64_t>;
+    using U32 = V<uint32_t>;
+    using U16 = V<uint16_t>;
+    using U8  = V<uint8_t >;
+
+    SI F   mad(F f, F m, F a) { return _mm512_fmadd_ps(f, m, a); }
+
+    SI F   min(F a, F b)     { return _mm512_min_ps(a,b); }
+    SI I32 min(I32 a, I32 b) { return (I32)_mm512_min_epi32((__m512i)a, (__m512i)b); }
+    SI U32 min(U32 a, U32 b) { return (U32)_mm512_min_epu32((__m512i)a, (__m512i)b); }
+    SI F   max(F a, F b)     { return _mm512_max_ps(a,b); }
+    SI I32 max(I32 a, I32 b) { return (I32)_mm512_max_epi32((__m512i)a, (__m512i)b); }
+    SI U32 max(U32 a, U32 b) { return (U32)_mm512_max_epu32((__m512i)a, (__m512i)b); }
+
+    SI F   abs_  (F v)   { return _mm512_abs_ps(v); }
+    SI I32 abs_  (I32 v) { return (I32)_mm512_abs_epi32((__m512i)v); }
+    SI F   floor_(F v)   { return _mm512_floor_ps(v); }
+    SI F   ceil_(F v)    { return _mm512_ceil_ps(v);  }
+    SI F   rcp_fast(F v) { return _mm512_rcp14_ps  (v); }
+    SI F   rsqrt (F v)   { return _mm512_rsqrt14_ps(v); }
+    SI F   sqrt_ (F v)   { return _mm512_sqrt_ps   (v); }
+    SI F rcp_precise (F v) {
+        F e = rcp_fast(v);
+        return _mm512_fnmadd_ps(v, e, _mm512_set1_ps(2.0f)) * e;
+    }
+
+    SI U32 round(F v)          { return (U32)_mm512_cvtps_epi32(v); }
+    SI U32 round(F v, F scale) { return (U32)_mm512_cvtps_epi32(v*scale); }
+    SI U16 pack(U32 v) { return (U16)_mm512_cvtepi32_epi16((__m512i)v); }
+    SI U8  pack(U16 v) { return  (U8)_mm256_cvtepi16_epi8 ((__m256i)v); }
+
+    // Like the HSW versions, these only work with mask values (true == all bits set).
+    SI __mmask16 to_mask(I32 c) { return _mm512_movepi32_mask((__m512i)c); }
+    SI F if_then_else(I32 c, F t, F e) { return _mm512_mask_blend_ps(to_mask(c), e, t); }
+    SI bool any(I32 c) { return to_mask(c) != 0;      }
+    SI bool all(I32 c) { return to_mask(c) == 0xffff; }
+
+    template <typename T>
+    SI V<T> gather(const T* p, U32 ix) {
+        return { p[ix[ 0]], p[ix[ 1]], p[ix[ 2]], p[ix[ 3]],
+                 p[ix[ 4]], p[ix[ 5]], p[ix[ 6]], p[ix[ 7]],
+                 p[ix[ 8]], p[ix[ 9]], p[ix[10]], p[ix[11]],
+                 p[ix[12]], p[ix[13]], p[ix[14]], p[ix[15]], };
+    }
+    SI F   gather(const float*    p, U32 ix) { return _mm512_i32gather_ps((__m512i)ix, p, 4); }
+    SI U32 gather(const uint32_t* p, U32 ix) {
+        return (U32)_mm512_i32gather_epi32((__m512i)ix, p, 4);
+    }
+    SI U64 gather(const uint64_t* p, U32 ix) {
+        __m512i parts[] = {
+            _mm512_i32gather_epi64(_mm512_castsi512_si256    ((__m512i)ix   ), p, 8),
+            _mm512_i32gather_epi64(_mm512_extracti64x4_epi64((__m512i)ix, 1), p, 8),
+        };
+        return sk_bit_cast<U64>(parts);
+    }
+    template <typename V, typename S>
+    SI void scatter_masked(V src, S* dst, U32 ix, I32 mask) {
+        V before = gather(dst, ix);
+        V after = if_then_else(mask, src, before);
+        SK_UNROLL for (int i = 0; i < 16; ++i) {
+            dst[ix[i]] = after[i];
+        }
+    }
+
+    // A tail of n < 16 pixels is handled by masking off the inactive lanes of loads and stores,
+    // so unlike the narrower targets, there's no need to move the last few pixels one at a time.
+    SI __mmask16 tail_mask(size_t tail) { return (__mmask16)((1u << tail) - 1); }
+
+    template <typename T>
+    SI V<T> load_masked(const T* ptr, __mmask16 m) {
+        if constexpr (sizeof(T) == 1) {
+            return sk_bit_cast<V<T>>(_mm_maskz_loadu_epi8(m, ptr));
+        } else if constexpr (sizeof(T) == 2) {
+            return sk_bit_cast<V<T>>(_mm256_maskz_loadu_epi16(m, ptr));
+        } else if constexpr (sizeof(T) == 4) {
+            return sk_bit_cast<V<T>>(_mm512_maskz_loadu_epi32(m, ptr));
+        } else {
+            static_assert(sizeof(T) == 8);
+            __m512i parts[] = {
+                _mm512_maskz_loadu_epi64((__mmask8)(m >> 0), ptr + 0),
+                _mm512_maskz_loadu_epi64((__mmask8)(m >> 8), ptr + 8),
+            };
+            return sk_bit_cast<V<T>>(parts);
+        }
+    }
+    template <typename T, typename Vec>
+    SI void store_masked(T* ptr, __mmask16 m, Vec v) {
+        static_assert(sizeof(Vec) == 16*sizeof(T));
+        if constexpr (sizeof(T) == 1) {
+            _mm_mask_storeu_epi8(ptr, m, sk_bit_cast<__m128i>(v));
+        } else if constexpr (sizeof(T) == 2) {
+            _mm256_mask_storeu_epi16(ptr, m, sk_bit_cast<__m256i>(v));
+        } else if constexpr (sizeof(T) == 4) {
+            _mm512_mask_storeu_epi32(ptr, m, sk_bit_cast<__m512i>(v));
+        } else {
+            static_assert(sizeof(T) == 8);
+            __m512i parts[2];
+            memcpy(parts, &v, sizeof(parts));
+            _mm512_mask_storeu_epi64(ptr + 0, (__mmask8)(m >> 0), parts[0]);
+            _mm512_mask_storeu_epi64(ptr + 8, (__mmask8)(m >> 8), parts[1]);
+        }
+    }
+
+    SI void load2(const uint16_t* ptr, size_t tail, U16* r, U16* g) {
+        // Each rg pair is one 32-bit lane.
+        __m512i rg = __builtin_expect(tail,0) ? _mm512_maskz_loadu_epi32(tail_mask(tail), ptr)
+                                              : _mm512_loadu_si512(ptr);
+        *r = (U16)_mm512_cvtepi32_epi16(rg);
+        *g = (U16)_mm512_cvtepi32_epi16(_mm512_srli_epi32(rg, 16));
+    }
+    SI void store2(uint16_t* ptr, size_t tail, U16 r, U16 g) {
+        __m512i rg = _mm512_or_si512(                 _mm512_cvtepu16_epi32((__m256i)r),
+                                     _mm512_slli_epi32(_mm512_cvtepu16_epi32((__m256i)g), 16));
+        if (__builtin_expect(tail,0)) {
+            _mm512_mask_storeu_epi32(ptr, tail_mask(tail), rg);
+        } else {
+            _mm512_storeu_si512(ptr, rg);
+        }
+    }
+
+    SI void load3(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b) {
+        // 16 rgb pixels are 48 uint16_t: 32 in one register and 16 in another.
+        using U16x32 = uint16_t __attribute__((ext_vector_type(32)));
+        U16x32 _0_a;
+        U16    _a_f;
+        if (__builtin_expect(tail,0)) {
+            uint64_t m = (uint64_t(1) << (3*tail)) - 1;
+            _0_a = (U16x32)_mm512_maskz_loadu_epi16((__mmask32)(m >>  0), ptr +  0);
+            _a_f = (U16   )_mm256_maskz_loadu_epi16((__mmask16)(m >> 32), ptr + 32);
+        } else {
+            _0_a = (U16x32)_mm512_loadu_si512(ptr);
+            _a_f = (U16   )_mm256_loadu_si256((const __m256i*)(ptr + 32));
+        }
+        // Widen the upper 16 values so that channel c of pixel p is element 3p+c of (_0_a,hi).
+        U16x32 hi = __builtin_shufflevector(_a_f, _a_f, 0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,
+                                                        0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15);
+        *r = __builtin_shufflevector(_0_a, hi,  0, 3, 6, 9,12,15,18,21,24,27,30,33,36,39,42,45);
+        *g = __builtin_shufflevector(_0_a, hi,  1, 4, 7,10,13,16,19,22,25,28,31,34,37,40,43,46);
+        *b = __builtin_shufflevector(_0_a, hi,  2, 5, 8,11,14,17,20,23,26,29,32,35,38,41,44,47);
+    }
+    SI void load4(const uint16_t* ptr, size_t tail, U16* r, U16* g, U16* b, U16* a) {
+        // Each rgba pixel is one 64-bit lane, 8 to a register.
+        __m512i _01234567, _89abcdef;
+        if (__builtin_expect(tail,0)) {
+            __mmask16 m = tail_mask(tail);
+            _01234567 = _mm512_maskz_loadu_epi64((__mmask8)(m >> 0), ptr +  0);
+            _89abcdef = _mm512_maskz_loadu_epi64((__mmask8)(m >> 8), ptr + 32);
+        } else {
+            _01234567 = _mm512_loadu_si512(ptr +  0);
+            _89abcdef = _mm512_loadu_si512(ptr + 32);
+        }
+        auto channel = [&](int shift) {
+            return (U16)_mm256_setr_m128i(
+                    _mm512_cvtepi64_epi16(_mm512_srl_epi64(_01234567, _mm_cvtsi32_si128(shift))),
+                    _mm512_cvtepi64_epi16(_mm512_srl_epi64(_89abcdef, _mm_cvtsi32_si128(shift))));
+        };
+        *r = channel( 0);
+        *g = channel(16);
+        *b = channel(32);
+        *a = channel(48);
+    }
+    SI void store4(uint16_t* ptr, size_t tail, U16 r, U16 g, U16 b, U16 a) {
+        auto pixels = [](__m128i r, __m128i g, __m128i b, __m128i a) {
+            return _mm512_or_si512(
+                    _mm512_or_si512(                  _mm512_cvtepu16_epi64(r),
+                                    _mm512_slli_epi64(_mm512_cvtepu16_epi64(g), 16)),
+                    _mm512_or_si512(_mm512_slli_epi64(_mm512_cvtepu16_epi64(b), 32),
+                                    _mm512_slli_epi64(_mm512_cvtepu16_epi64(a), 48)));
+        };
+        __m512i _01234567 = pixels(_mm256_castsi256_si128((__m256i)r),
+                                   _mm256_castsi256_si128((__m256i)g),
+                                   _mm256_castsi256_si128((__m256i)b),
+                                   _mm256_castsi256_si128((__m256i)a)),
+                _89abcdef = pixels(_mm256_extracti128_si256((__m256i)r, 1),
+                                   _mm256_extracti128_si256((__m256i)g, 1),
+                                   _mm256_extracti128_si256((__m256i)b, 1),
+                                   _mm256_extracti128_si256((__m256i)a, 1));
+        if (__builtin_expect(tail,0)) {
+            __mmask16 m = tail_mask(tail);
+            _mm512_mask_storeu_epi64(ptr +  0, (__mmask8)(m >> 0), _01234567);
+            _mm512_mask_storeu_epi64(ptr + 32, (__mmask8)(m >> 8), _89abcdef);
+        } else {
+            _mm512_storeu_si512(ptr +  0, _01234567);
+            _mm512_storeu_si512(ptr + 32, _89abcdef);
+        }
+    }
+
+    SI void load2(const float* ptr, size_t tail, F* r, F* g) {
+        // Each rg pair is one 64-bit lane, 8 to a register.
+        F _01234567, _89abcdef;
+        if (__builtin_expect(tail,0)) {
+            __mmask16 m = tail_mask(tail);
+            _01234567 = (F)_mm512_maskz_loadu_epi64((__mmask8)(m >> 0), ptr +  0);
+            _89abcdef = (F)_mm512_maskz_loadu_epi64((__mmask8)(m >> 8), ptr + 16);
+        } else {
+            _01234567 = _mm512_loadu_ps(ptr +  0);
+            _89abcdef = _mm512_loadu_ps(ptr + 16);
+        }
+        *r = __builtin_shufflevector(_01234567, _89abcdef,  0, 2, 4, 6, 8,10,12,14,
+                                                           16,18,20,22,24,26,28,30);
+        *g = __builtin_shufflevector(_01234567, _89abcdef,  1, 3, 5, 7, 9,11,13,15,
+                                                           17,19,21,23,25,27,29,31);
+    }
+    SI void store2(float* ptr, size_t tail, F r, F g) {
+        F _01234567 = __builtin_shufflevector(r, g, 0,16, 1,17, 2,18, 3,19,
+                                                    4,20, 5,21, 6,22, 7,23),
+          _89abcdef = __builtin_shufflevector(r, g, 8,24, 9,25, 10,26, 11,27,
+                                                   12,28, 13,29, 14,30, 15,31);
+        if (__builtin_expect(tail,0)) {
+            __mmask16 m = tail_mask(tail);
+            _mm512_mask_storeu_epi64(ptr +  0, (__mmask8)(m >> 0), (__m512i)_01234567);
+            _mm512_mask_storeu_epi64(ptr + 16, (__mmask8)(m >> 8), (__m512i)_89abcdef);
+        } else {
+            _mm512_storeu_ps(ptr +  0, _01234567);
+            _mm512_storeu_ps(ptr + 16, _89abcdef);
+        }
+    }
+
+    SI void load4(const float* ptr, size_t tail, F* r, F* g, F* b, F* a) {
+        // Each rgba pixel is four 32-bit lanes, 4 to a register.
+        F _0123, _4567, _89ab, _cdef;
+        if (__builtin_expect(tail,0)) {
+            uint64_t m = (uint64_t(1) << (4*tail)) - 1;
+            _0123 = _mm512_maskz_loadu_ps((__mmask16)(m >>  0), ptr +  0);
+            _4567 = _mm512_maskz_loadu_ps((__mmask16)(m >> 16), ptr + 16);
+            _89ab = _mm512_maskz_loadu_ps((__mmask16)(m >> 32), ptr + 32);
+            _cdef = _mm512_maskz_loadu_ps((__mmask16)(m >> 48), ptr + 48);
+        } else {
+            _0123 = _mm512_loadu_ps(ptr +  0);
+            _4567 = _mm512_loadu_ps(ptr + 16);
+            _89ab = _mm512_loadu_ps(ptr + 32);
+            _cdef = _mm512_loadu_ps(ptr + 48);
+        }
+
+        F rg01234567 = __builtin_shufflevector(_0123, _4567,  0, 4, 8,12,16,20,24,28,   // r0..r7
+                                                              1, 5, 9,13,17,21,25,29),  // g0..g7
+          ba01234567 = __builtin_shufflevector(_0123, _4567,  2, 6,10,14,18,22,26,30,   // b0..b7
+                                                              3, 7,11,15,19,23,27,31),  // a0..a7
+          rg89abcdef = __builtin_shufflevector(_89ab, _cdef,  0, 4, 8,12,16,20,24,28,
+                                                              1, 5, 9,13,17,21,25,29),
+          ba89abcdef = __builtin_shufflevector(_89ab, _cdef,  2, 6,10,14,18,22,26,30,
+                                                              3, 7,11,15,19,23,27,31);
+
+        *r = __builtin_shufflevector(rg01234567, rg89abcdef,  0, 1, 2, 3, 4, 5, 6, 7,
+                                                             16,17,18,19,20,21,22,23);
+        *g = __builtin_shufflevector(rg01234567, rg89abcdef,  8, 9,10,11,12,13,14,15,
+                                                             24,25,26,27,28,29,30,31);
+        *b = __builtin_shufflevector(ba01234567, ba89abcdef,  0, 1, 2, 3, 4, 5, 6, 7,
+                                                             16,17,18,19,20,21,22,23);
+        *a = __builtin_shufflevector(ba01234567, ba89abcdef,  8, 9,10,11,12,13,14,15,
+                                                             24,25,26,27,28,29,30,31);
+    }
+    SI void store4(float* ptr, size_t tail, F r, F g, F b, F a) {
+        F rg01234567 = __builtin_shufflevector(r, g, 0,16, 1,17, 2,18, 3,19,   // r0 g0 r1 g1 ...
+                                                     4,20, 5,21, 6,22, 7,23),
+          ba01234567 = __builtin_shufflevector(b, a, 0,16, 1,17, 2,18, 3,19,   // b0 a0 b1 a1 ...
+                                                     4,20, 5,21, 6,22, 7,23),
+          rg89abcdef = __builtin_shufflevector(r, g, 8,24, 9,25, 10,26, 11,27,
+                                                    12,28, 13,29, 14,30, 15,31),
+          ba89abcdef = __builtin_shufflevector(b, a, 8,24, 9,25, 10,26, 11,27,
+                                                    12,28, 13,29, 14,30, 15,31);
+
+        F _0123 = __builtin_shufflevector(rg01234567, ba01234567,  0, 1,16,17,  2, 3,18,19,
+                                                                   4, 5,20,21,  6, 7,22,23),
+          _4567 = __builtin_shufflevector(rg01234567, ba01234567,  8, 9,24,25, 10,11,26,27,
+                                                                  12,13,28,29, 14,15,30,31),
+          _89ab = __builtin_shufflevector(rg89abcdef, ba89abcdef,  0, 1,16,17,  2, 3,18,19,
+                                                                   4, 5,20,21,  6, 7,22,23),
+          _cdef = __builtin_shufflevector(rg89abcdef, ba89abcdef,  8, 9,24,25, 10,11,26,27,
+                                                                  12,13,28,29, 14,15,30,31);
+
+        if (__builtin_expect(tail,0)) {
+            uint64_t m = (uint64_t(1) << (4*tail)) - 1;
+            _mm512_mask_storeu_ps(ptr +  0, (__mmask16)(m >>  0), _0123);
+            _mm512_mask_storeu_ps(ptr + 16, (__mmask16)(m >> 16), _4567);
+            _mm512_mask_storeu_ps(ptr + 32, (__mmask16)(m >> 32), _89ab);
+            _mm512_mask_storeu_ps(ptr + 48, (__mmask16)(m >> 48), _cdef);
+        } else {
+            _mm512_storeu_ps(ptr +  0, _0123);
+            _mm512_storeu_ps(ptr + 16, _4567);
+            _mm512_storeu_ps(ptr + 32, _89ab);
+            _mm512_storeu_ps(ptr + 48, _cdef);
+        }
+    }
+
 #elif defined(JUMPER_IS_SSE2) || defined(JUMPER_IS_SSE41) || defined(JUMPER_IS_AVX)
 template <typename T> using V = T __attribute__((ext_vector_type(4)));
     using F   = V<float   >;
@@ -1097,6 +1389,9 @@ SI F from_half(U16 h) {
     && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f32_f16(h);
 
+#elif defined(JUMPER_IS_SKX)
+    return _mm512_cvtph_ps((__m256i)h);
+
 #elif defined(JUMPER_IS_HSW)
     return _mm256_cvtph_ps(h);
 
@@ -1118,6 +1413,9 @@ SI U16 to_half(F f) {
     && !defined(SK_BUILD_FOR_GOOGLE3)  // Temporary workaround for some Google3 builds.
     return vcvt_f16_f32(f);
 
+#elif defined(JUMPER_IS_SKX)
+    return (U16)_mm512_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
+
 #elif defined(JUMPER_IS_HSW)
     return _mm256_cvtps_ph(f, _MM_FROUND_CUR_DIRECTION);
 
@@ -1136,6 +1434,7 @@ SI U16 to_half(F f) {
 
 // Our fundamental vector depth is our pixel stride.
 static constexpr size_t N = sizeof(F) / sizeof(float);
+static_assert(N <= SkRasterPipeline_kMaxStride_highp);
 
 // We're finally going to get to what a Stage function looks like!
 //    tail == 0 ~~> work on a full N pixels
@@ -1379,7 +1678,12 @@ static void start_pipeline(size_t dx, size_t dy,
 
 template <typename V, typename T>
 SI V load(const T* src, size_t tail) {
-#if !defined(JUMPER_IS_SCALAR)
+#if defined(JUMPER_IS_SKX)
+    __builtin_assume(tail < N);
+    if (__builtin_expect(tail, 0)) {
+        return sk_bit_cast<V>(load_masked(src, tail_mask(tail)));  // Inactive lanes are zeroed.
+    }
+#elif !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         V v{};  // Any inactive lanes are zeroed.
@@ -1400,7 +1704,13 @@ SI V load(const T* src, size_t tail) {
 
 template <typename V, typename T>
 SI void store(T* dst, V v, size_t tail) {
-#if !defined(JUMPER_IS_SCALAR)
+#if defined(JUMPER_IS_SKX)
+    __builtin_assume(tail < N);
+    if (__builtin_expect(tail, 0)) {
+        store_masked(dst, tail_mask(tail), v);
+        return;
+    }
+#elif !defined(JUMPER_IS_SCALAR)
     __builtin_assume(tail < N);
     if (__builtin_expect(tail, 0)) {
         switch (tail) {
@@ -1716,7 +2026,7 @@ STAGE(seed_shader, NoCtx) {
 
 STAGE(dither, const float* rate) {
     // Get [(dx,dy), (dx+1,dy), (dx+2,dy), ...] loaded up in integer vectors.
-    uint32_t iota[] = {0,1,2,3,4,5,6,7};
+    uint32_t iota[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15};
     U32 X = dx + sk_unaligned_load<U32>(iota),
         Y = dy;
 
@@ -3031,10 +3341,48 @@ STAGE(matrix_perspective, const float* m) {
     g = G * rcp_precise(Z);
 }
 
+// ~~~~~~ Fused stages ~~~~~~ //
+// Each of these does exactly what the run of stages named in it would, in one dispatch.
+// SkRasterPipeline substitutes them when it builds a program; see kFusions there.
+
+STAGE(load_dst_srcover_store_8888, const SkRasterPipeline_MemoryCtx* ctx) {
+    load_8888_dst_k(ctx, dx,dy,tail,base, r,g,b,a, dr,dg,db,da);
+    srcover_k      (nullptr, dx,dy,tail,base, r,g,b,a, dr,dg,db,da);
+    store_8888_k   (ctx, dx,dy,tail,base, r,g,b,a, dr,dg,db,da);
+}
+STAGE(seed_shader_translate, const float* m) {
+    seed_shader_k     (nullptr, dx,dy,tail,base, r,g,b,a, dr,dg,db,da);
+    matrix_translate_k(m,       dx,dy,tail,base, r,g,b,a, dr,dg,db,da);
+}
+STAGE(seed_shader_scale_translate, const float* m) {
+    seed_shader_k           (nullptr, dx,dy,tail,base, r,g,b,a, dr,dg,db,da);
+    matrix_scale_translate_k(m,       dx,dy,tail,base, r,g,b,a, dr,dg,db,da);
+}
+
+STAGE(profile, SkRasterPipeline_ProfileCtx* c) {
+    c->fn(c, tail ? tail : N);
+}
+
 SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         F* r, F* g, F* b, F* a) {
     F fr, br, fg, bg, fb, bb, fa, ba;
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_SKX)
+    if (c->stopCount <= 16) {
+        // Stop arrays may be shorter than 16 floats, so only load the ones that exist.
+        auto lookup = [&](const float* v) {
+            __mmask16 m = (__mmask16)((1u << c->stopCount) - 1);
+            return _mm512_permutexvar_ps((__m512i)idx, _mm512_maskz_loadu_ps(m, v));
+        };
+        fr = lookup(c->fs[0]);
+        br = lookup(c->bs[0]);
+        fg = lookup(c->fs[1]);
+        bg = lookup(c->bs[1]);
+        fb = lookup(c->fs[2]);
+        bb = lookup(c->bs[2]);
+        fa = lookup(c->fs[3]);
+        ba = lookup(c->bs[3]);
+    } else
+#elif defined(JUMPER_IS_HSW)
     if (c->stopCount <=8) {
         fr = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->fs[0]), idx);
         br = _mm256_permutevar8x32_ps(_mm256_loadu_ps(c->bs[0]), idx);
@@ -3353,7 +3701,7 @@ STAGE_TAIL(set_base_pointer, std::byte* p) {
                                                    sk_bit_cast<I32>(b))
 
 STAGE_TAIL(init_lane_masks, NoCtx) {
-    uint32_t iota[] = {0,1,2,3,4,5,6,7};
+    uint32_t iota[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15};
     I32 mask = tail ? cond_to_mask(sk_unaligned_load<U32>(iota) < tail) : I32(~0);
     r = g = b = a = sk_bit_cast<F>(mask);
 }
@@ -3477,7 +3825,7 @@ STAGE_TAIL(mask_off_return_mask, NoCtx) {
 
 STAGE_BRANCH(branch_if_all_lanes_active, SkRasterPipeline_BranchCtx* ctx) {
     if (tail) {
-        uint32_t iota[] = {0,1,2,3,4,5,6,7};
+        uint32_t iota[] = {0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15};
         I32 tailLanes = cond_to_mask(tail <= sk_unaligned_load<U32>(iota));
         return all(execution_mask() | tailLanes) ? ctx->offset : 1;
     } else {
@@ -4572,7 +4920,7 @@ namespace lowp {
 
 #else  // We are compiling vector code with Clang... let's make some lowp stages!
 
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     using U8  = uint8_t  __attribute__((ext_vector_type(16)));
     using U16 = uint16_t __attribute__((ext_vector_type(16)));
     using I16 =  int16_t __attribute__((ext_vector_type(16)));
@@ -4845,7 +5193,9 @@ SI U32 trunc_(F x) { return (U32)cast<I32>(x); }
 
 // Use approximate instructions and one Newton-Raphson step to calculate 1/x.
 SI F rcp_precise(F x) {
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_SKX)
+    return SK_OPTS_NS::rcp_precise(x);
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(SK_OPTS_NS::rcp_precise(lo), SK_OPTS_NS::rcp_precise(hi));
@@ -4862,7 +5212,9 @@ SI F rcp_precise(F x) {
 #endif
 }
 SI F sqrt_(F x) {
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_SKX)
+    return _mm512_sqrt_ps(x);
+#elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
     return join<F>(_mm256_sqrt_ps(lo), _mm256_sqrt_ps(hi));
@@ -4897,6 +5249,8 @@ SI F floor_(F x) {
     float32x4_t lo,hi;
     split(x, &lo,&hi);
     return join<F>(vrndmq_f32(lo), vrndmq_f32(hi));
+#elif defined(JUMPER_IS_SKX)
+    return _mm512_floor_ps(x);
 #elif defined(JUMPER_IS_HSW)
     __m256 lo,hi;
     split(x, &lo,&hi);
@@ -4917,7 +5271,7 @@ SI F floor_(F x) {
 // The result is a number on [-1, 1).
 // Note: on neon this is a saturating multiply while the others are not.
 SI I16 scaled_mult(I16 a, I16 b) {
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     return _mm256_mulhrs_epi16(a, b);
 #elif defined(JUMPER_IS_SSE41) || defined(JUMPER_IS_AVX)
     return _mm_mulhrs_epi16(a, b);
@@ -5182,10 +5536,15 @@ SI U32 ix_and_ptr(T** ptr, const SkRasterPipeline_GatherCtx* ctx, I32 x, I32 y)
 
 template <typename V, typename T>
 SI V load(const T* ptr, size_t tail) {
+#if defined(JUMPER_IS_SKX)
+    if (tail & (N-1)) {
+        return sk_bit_cast<V>(SK_OPTS_NS::load_masked(ptr, SK_OPTS_NS::tail_mask(tail & (N-1))));
+    }
+#endif
     V v = 0;
     switch (tail & (N-1)) {
         case  0: memcpy(&v, ptr, sizeof(v)); break;
-    #if defined(JUMPER_IS_HSW)
+    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
         case 15: v[14] = ptr[14]; [[fallthrough]];
         case 14: v[13] = ptr[13]; [[fallthrough]];
         case 13: v[12] = ptr[12]; [[fallthrough]];
@@ -5207,9 +5566,15 @@ SI V load(const T* ptr, size_t tail) {
 }
 template <typename V, typename T>
 SI void store(T* ptr, size_t tail, V v) {
+#if defined(JUMPER_IS_SKX)
+    if (tail & (N-1)) {
+        SK_OPTS_NS::store_masked(ptr, SK_OPTS_NS::tail_mask(tail & (N-1)), v);
+        return;
+    }
+#endif
     switch (tail & (N-1)) {
         case  0: memcpy(ptr, &v, sizeof(v)); break;
-    #if defined(JUMPER_IS_HSW)
+    #if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
         case 15: ptr[14] = v[14]; [[fallthrough]];
         case 14: ptr[13] = v[13]; [[fallthrough]];
         case 13: ptr[12] = v[12]; [[fallthrough]];
@@ -5229,7 +5594,7 @@ SI void store(T* ptr, size_t tail, V v) {
     }
 }
 
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     template <typename V, typename T>
     SI V gather(const T* ptr, U32 ix) {
         return V{ ptr[ix[ 0]], ptr[ix[ 1]], ptr[ix[ 2]], ptr[ix[ 3]],
@@ -5267,7 +5632,7 @@ SI void store(T* ptr, size_t tail, V v) {
 // ~~~~~~ 32-bit memory loads and stores ~~~~~~ //
 
 SI void from_8888(U32 rgba, U16* r, U16* g, U16* b, U16* a) {
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     // Swap the middle 128-bit lanes to make _mm256_packus_epi32() in cast_U16() work out nicely.
     __m256i _01,_23;
     split(rgba, &_01, &_23);
@@ -5748,7 +6113,7 @@ SI void gradient_lookup(const SkRasterPipeline_GradientCtx* c, U32 idx, F t,
                         U16* r, U16* g, U16* b, U16* a) {
 
     F fr, fg, fb, fa, br, bg, bb, ba;
-#if defined(JUMPER_IS_HSW)
+#if defined(JUMPER_IS_HSW) || defined(JUMPER_IS_SKX)
     if (c->stopCount <=8) {
         __m256i lo, hi;
         split(idx, &lo, &hi);
@@ -5951,6 +6316,27 @@ STAGE_PP(srcover_rgba_8888, const SkRasterPipeline_MemoryCtx* ctx) {
     store_8888_(ptr, tail, r,g,b,a);
 }
 
+// ~~~~~~ Fused stages ~~~~~~ //
+// Unlike srcover_rgba_8888 above, these match their unfused stages bit for bit.
+
+STAGE_PP(load_dst_srcover_store_8888, const SkRasterPipeline_MemoryCtx* ctx) {
+    load_8888_dst_k(ctx,     dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    srcover_k      (nullptr, dx,dy,tail, r,g,b,a, dr,dg,db,da);
+    store_8888_k   (ctx,     dx,dy,tail, r,g,b,a, dr,dg,db,da);
+}
+STAGE_GG(seed_shader_translate, const float* m) {
+    seed_shader_k     (nullptr, dx,dy,tail, x,y);
+    matrix_translate_k(m,       dx,dy,tail, x,y);
+}
+STAGE_GG(seed_shader_scale_translate, const float* m) {
+    seed_shader_k           (nullptr, dx,dy,tail, x,y);
+    matrix_scale_translate_k(m,       dx,dy,tail, x,y);
+}
+
+STAGE_PP(profile, SkRasterPipeline_ProfileCtx* c) {
+    c->fn(c, tail ? tail : N);
+}
+
 // ~~~~~~ skgpu::Swizzle stage ~~~~~~ //
 
 STAGE_PP(swizzle, void* ctx) {
@@ -10,6 +10,7 @@
 
 #include "include/private/SkColorData.h"
 #include "src/base/SkVx.h"
+#include <algorithm>
 #include <utility>
 
 #if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
@@ -401,6 +402,21 @@ static void premul_should_swapRB(bool kSwapRB, uint32_t* dst, const uint32_t* sr
         count -= 16;
     }
 
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    // AVX-512VL lets us run the tail of [0,16) pixels through premul8() using masked loads and
+    // stores, rather than dropping down to portable code.
+    if (count > 0) {
+        __mmask8 loMask = (__mmask8)((1u << std::min(count, 8)) - 1),
+                 hiMask = (__mmask8)((1u << std::max(count - 8, 0)) - 1);
+        __m256i lo = _mm256_maskz_loadu_epi32(loMask, src + 0),
+                hi = _mm256_maskz_loadu_epi32(hiMask, src + 8);
+
+        premul8(&lo, &hi);
+
+        _mm256_mask_storeu_epi32(dst + 0, loMask, lo);
+        _mm256_mask_storeu_epi32(dst + 8, hiMask, hi);
+    }
+#else
     if (count >= 8) {
         __m256i lo = _mm256_loadu_si256((const __m256i*) src),
                 hi = _mm256_setzero_si256();
@@ -417,6 +433,7 @@ static void premul_should_swapRB(bool kSwapRB, uint32_t* dst, const uint32_t* sr
     // Call portable code to finish up the tail of [0,8) pixels.
     auto proc = kSwapRB ? RGBA_to_bgrA_portable : RGBA_to_rgbA_portable;
     proc(dst, src, count);
+#endif
 }
 
 /*not static*/ inline void RGBA_to_rgbA(uint32_t* dst, const uint32_t* src, int count) {
@@ -428,6 +445,26 @@ static void premul_should_swapRB(bool kSwapRB, uint32_t* dst, const uint32_t* sr
 }
 
 /*not static*/ inline void RGBA_to_BGRA(uint32_t* dst, const uint32_t* src, int count) {
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SKX
+    const __m512i swapRB_x4 = _mm512_broadcast_i32x4(
+            _mm_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15));
+
+    while (count >= 16) {
+        __m512i rgba = _mm512_loadu_si512(src);
+        _mm512_storeu_si512(dst, _mm512_shuffle_epi8(rgba, swapRB_x4));
+
+        src += 16;
+        dst += 16;
+        count -= 16;
+    }
+
+    if (count > 0) {
+        __mmask16 mask = (__mmask16)((1u << count) - 1);
+        __m512i rgba = _mm512_maskz_loadu_epi32(mask, src);
+        _mm512_mask_storeu_epi32(dst, mask, _mm512_shuffle_epi8(rgba, swapRB_x4));
+    }
+    return;
+#endif
     const __m256i swapRB = _mm256_setr_epi8(2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15,
                                             2,1,0,3, 6,5,4,7, 10,9,8,11, 14,13,12,15);
 
@@ -10,11 +10,13 @@
 #include "include/core/SkData.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTo.h"
+#include "src/base/SkAutoMalloc.h"
 #include "src/core/SkTraceEvent.h"
 
 #include "zlib.h"
 
 #include <algorithm>
+#include <climits>
 
 namespace {
 
@@ -26,6 +28,16 @@ template <typename T> void* skia_alloc_func(void*, T items, T size) {
 
 void skia_free_func(void*, void* address) { sk_free(address); }
 
+int zlib_strategy(SkDeflateStrategy strategy) {
+    switch (strategy) {
+        case SkDeflateStrategy::kDefault:     return Z_DEFAULT_STRATEGY;
+        case SkDeflateStrategy::kFiltered:    return Z_FILTERED;
+        case SkDeflateStrategy::kRLE:         return Z_RLE;
+        case SkDeflateStrategy::kHuffmanOnly: return Z_HUFFMAN_ONLY;
+    }
+    SkUNREACHABLE;
+}
+
 }  // namespace
 
 #define SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE 4096
@@ -66,7 +78,8 @@ struct SkDeflateWStream::Impl {
 
 SkDeflateWStream::SkDeflateWStream(SkWStream* out,
                                    int compressionLevel,
-                                   bool gzip)
+                                   bool gzip,
+                                   SkDeflateStrategy strategy)
     : fImpl(std::make_unique<SkDeflateWStream::Impl>()) {
 
     // There has existed at some point at least one zlib implementation which thought it was being
@@ -87,7 +100,7 @@ SkDeflateWStream::SkDeflateWStream(SkWStream* out,
     SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
     SkDEBUGCODE(int r =) deflateInit2(&fImpl->fZStream, compressionLevel,
                                       Z_DEFLATED, gzip ? 0x1F : 0x0F,
-                                      8, Z_DEFAULT_STRATEGY);
+                                      8, zlib_strategy(strategy));
     SkASSERT(Z_OK == r);
 }
 
@@ -132,3 +145,92 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 size_t SkDeflateWStream::bytesWritten() const {
     return fImpl->fZStream.total_in + fImpl->fInBufferIndex;
 }
+
+namespace {
+
+class ZlibCompressor final : public SkPDF::Compressor {
+public:
+    bool compress(const void* data, size_t size, int compressionLevel,
+                  SkDeflateStrategy strategy, SkWStream* dst) const override {
+        TRACE_EVENT0("skia", TRACE_FUNC);
+        SkASSERT(compressionLevel != 0);
+        SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
+        if (size > UINT_MAX / 2) {
+            // Too big for one call into zlib, which counts in uInt.
+            SkDeflateWStream deflateWStream(dst, compressionLevel, false, strategy);
+            return deflateWStream.write(data, size);
+        }
+
+        // A window covering the whole input (plus zlib's 262 byte lookahead) finds every match
+        // the full 32K window would, and the hash table need not be much larger than the window.
+        // So for the many small streams in a PDF, zlib allocates and clears a few kilobytes
+        // instead of a few hundred. Large inputs get zlib's defaults, as SkDeflateWStream does.
+        static constexpr size_t kLookahead = 262;
+        int windowBits = 9;  // The smallest deflate() accepts.
+        while (windowBits < 15 && (size_t(1) << windowBits) < size + kLookahead) {
+            ++windowBits;
+        }
+        int memLevel = std::min(8, windowBits - 6);
+
+        z_stream zStream;
+        zStream.zalloc = &skia_alloc_func;
+        zStream.zfree = &skia_free_func;
+        zStream.opaque = nullptr;
+        if (Z_OK != deflateInit2(&zStream, compressionLevel, Z_DEFLATED, windowBits, memLevel,
+                                 zlib_strategy(strategy))) {
+            return false;
+        }
+        // The bound leaves room for incompressible data, so one deflate() call always finishes.
+        size_t bound = deflateBound(&zStream, static_cast<uLong>(size));
+        SkAutoMalloc compressed(bound);
+        zStream.next_in = static_cast<Bytef*>(const_cast<void*>(data));
+        zStream.avail_in = SkToUInt(size);
+        zStream.next_out = static_cast<Bytef*>(compressed.get());
+        zStream.avail_out = SkToUInt(bound);
+        int result = deflate(&zStream, Z_FINISH);
+        size_t compressedSize = bound - zStream.avail_out;
+        (void)deflateEnd(&zStream);
+        SkASSERT(result == Z_STREAM_END);
+        return result == Z_STREAM_END && dst->write(compressed.get(), compressedSize);
+    }
+};
+
+}  // namespace
+
+const SkPDF::Compressor* SkDeflateZlibCompressor() {
+    static const ZlibCompressor gCompressor;
+    return &gCompressor;
+}
+
+std::unique_ptr<SkStreamAsset> SkDeflateCompressStream(const SkPDF::Compressor* compressor,
+                                                       SkStreamAsset* src,
+                                                       int compressionLevel,
+                                                       SkDeflateStrategy strategy) {
+    SkASSERT(compressor && src && src->hasLength());
+    // Streams written by SkDynamicMemoryWStream are in blocks, so they are copied into one buffer
+    // for the compressor. Past this size, the copy costs more memory than it saves time.
+    static constexpr size_t kMaxCopySize = 1 << 20;
+    sk_sp<SkData> copy;
+    const void* data = src->getMemoryBase();
+    size_t size = src->getLength();
+    SkDynamicMemoryWStream compressed;
+    if (!data && size > kMaxCopySize) {
+        SkDeflateWStream deflateWStream(&compressed, compressionLevel, false, strategy);
+        if (!deflateWStream.writeStream(src, size)) {
+            return nullptr;
+        }
+        deflateWStream.finalize();
+        return compressed.detachAsStream();
+    }
+    if (!data) {
+        copy = SkData::MakeFromStream(src, size);
+        if (!copy) {
+            return nullptr;
+        }
+        data = copy->data();
+    }
+    if (!compressor->compress(data, size, compressionLevel, strategy, &compressed)) {
+        return nullptr;
+    }
+    return compressed.detachAsStream();
+}
@@ -10,6 +10,12 @@
 #define SkFlate_DEFINED
 
 #include "include/core/SkStream.h"
+#include "include/docs/SkPDFDocument.h"
+
+#include <cstddef>
+#include <memory>
+
+using SkDeflateStrategy = SkPDF::DeflateStrategy;
 
 /**
   * Wrap a stream in this class to compress the information written to
@@ -32,7 +38,8 @@ public:
      */
     SkDeflateWStream(SkWStream*,
                      int compressionLevel,
-                     bool gzip = false);
+                     bool gzip = false,
+                     SkDeflateStrategy strategy = SkDeflateStrategy::kDefault);
 
     /** The destructor calls finalize(). */
     ~SkDeflateWStream() override;
@@ -50,4 +57,17 @@ private:
     std::unique_ptr<Impl> fImpl;
 };
 
+/** An SkPDF::Compressor on top of zlib's deflate(), which is always available. It compresses the
+    whole input in one pass, with buffers and tables sized to the input. */
+const SkPDF::Compressor* SkDeflateZlibCompressor();
+
+/** Compresses all of |src| with |compressor|, reading |src| in place if it is in memory and
+    copying it into one buffer if it is not too large. Larger streams are compressed a piece at a
+    time with SkDeflateWStream, so that they are never held in memory twice. Returns nullptr on
+    failure. */
+std::unique_ptr<SkStreamAsset> SkDeflateCompressStream(const SkPDF::Compressor* compressor,
+                                                       SkStreamAsset* src,
+                                                       int compressionLevel,
+                                                       SkDeflateStrategy strategy);
+
 #endif  // SkFlate_DEFINED
@@ -9,20 +9,27 @@
 
 #include "include/codec/SkEncodedImageFormat.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
 #include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkStream.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/private/SkColorData.h"
+#include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
+#include "src/core/SkChecksum.h"
 #include "src/core/SkImageInfoPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkJpegInfo.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFTypes.h"
 #include "src/pdf/SkPDFUtils.h"
 
+#include <algorithm>
+#include <cstring>
+
 ////////////////////////////////////////////////////////////////////////////////
 
 // write a single byte to a stream n times.
@@ -122,7 +129,9 @@ static void do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndir
     SkWStream* stream = &buffer;
     std::optional<SkDeflateWStream> deflateWStream;
     if (format == SkPDFStreamFormat::Flate) {
-        deflateWStream.emplace(&buffer, SkToInt(compressionLevel));
+        // Masks are mostly runs of one value; run-length matching compresses them as well as the
+        // default strategy, or better, in a fraction of the time.
+        deflateWStream.emplace(&buffer, SkToInt(compressionLevel), false, SkDeflateStrategy::kRLE);
         stream = &*deflateWStream;
     }
     if (kAlpha_8_SkColorType == pm.colorType()) {
@@ -176,7 +185,12 @@ static void do_deflated_image(const SkPixmap& pm,
     SkWStream* stream = &buffer;
     std::optional<SkDeflateWStream> deflateWStream;
     if (format == SkPDFStreamFormat::Flate) {
-        deflateWStream.emplace(&buffer, SkToInt(compressionLevel));
+        // An alpha-only image is written as a run of zeros, which run-length matching finds as
+        // well as the default strategy does. Gray and RGB pixels keep the default strategy.
+        SkDeflateStrategy strategy = pm.colorType() == kAlpha_8_SkColorType
+                                   ? SkDeflateStrategy::kRLE
+                                   : SkDeflateStrategy::kDefault;
+        deflateWStream.emplace(&buffer, SkToInt(compressionLevel), false, strategy);
         stream = &*deflateWStream;
     }
     const char* colorSpace = "DeviceGray";
@@ -331,3 +345,93 @@ SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
     serialize_image(img, encodingQuality, doc, ref);
     return ref;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+static uint64_t combine_hashes(uint64_t a, uint64_t b) {
+    const uint64_t hashes[2] = {a, b};
+    return SkChecksum::Hash64(hashes, sizeof(hashes));
+}
+
+// Hash |rows| rows of |rowSize| bytes each, |rowBytes| apart.  The rows are split into chunks of
+// at least 64K, and the chunk hashes are combined in order, so that the result does not depend on
+// whether or how the chunks were run in parallel.
+static uint64_t hash_rows(const void* addr, size_t rowBytes, size_t rowSize, int rows,
+                          SkExecutor* executor) {
+    constexpr size_t kMinChunkSize = 1 << 16;
+    const int grain = SkToInt(std::max<size_t>(1, kMinChunkSize / std::max<size_t>(1, rowSize)));
+    auto hashChunk = [&](int start, int end) {
+        uint64_t hash = 0;
+        for (int y = start; y < end; ++y) {
+            hash = SkChecksum::Hash64(SkTAddOffset<const void>(addr, y * rowBytes), rowSize, hash);
+        }
+        return hash;
+    };
+    if (executor && rows > grain) {
+        return SkParallelReduce(*executor, rows, grain, uint64_t(0), hashChunk, combine_hashes);
+    }
+    uint64_t hash = 0;
+    for (int start = 0; start < rows; start += grain) {
+        hash = combine_hashes(hash, hashChunk(start, std::min(rows, start + grain)));
+    }
+    return hash;
+}
+
+bool SkPDFHashImage(const SkImage* img, SkExecutor* executor, uint64_t* hash) {
+    SkASSERT(img);
+    SkASSERT(hash);
+    // serialize_image() prefers the encoded data, so images are the same if that is the same.
+    // Tag the two kinds of contents so that encoded data can't collide with pixels.
+    uint64_t contents;
+    uint64_t kind;
+    if (sk_sp<SkData> data = img->refEncodedData()) {
+        constexpr size_t kRowSize = 4096;
+        const int rows = SkToInt(data->size() / kRowSize);
+        const size_t tail = data->size() % kRowSize;
+        contents = hash_rows(data->data(), kRowSize, kRowSize, rows, executor);
+        contents = SkChecksum::Hash64(data->bytes() + rows * kRowSize, tail, contents);
+        kind = 1;
+    } else if (SkPixmap pm; img->peekPixels(&pm)) {
+        contents = hash_rows(pm.addr(), pm.rowBytes(), pm.info().minRowBytes(), pm.height(),
+                             executor);
+        kind = 2;
+    } else {
+        return false;
+    }
+    const uint64_t header[] = {
+        kind,
+        (uint64_t)img->width() << 32 | (uint32_t)img->height(),
+        (uint64_t)img->colorType() << 32 | (uint32_t)img->alphaType(),
+        img->colorSpace() ? img->colorSpace()->hash() : 0,
+    };
+    *hash = combine_hashes(SkChecksum::Hash64(header, sizeof(header)), contents);
+    return true;
+}
+
+bool SkPDFImagesHaveSameContents(const SkImage* a, const SkImage* b) {
+    SkASSERT(a && b);
+    if (a == b) {
+        return true;
+    }
+    if (a->dimensions() != b->dimensions() || a->colorType() != b->colorType() ||
+        a->alphaType() != b->alphaType() ||
+        !SkColorSpace::Equals(a->colorSpace(), b->colorSpace())) {
+        return false;
+    }
+    sk_sp<SkData> aData = a->refEncodedData(),
+                  bData = b->refEncodedData();
+    if (aData || bData) {
+        return aData && bData && aData->equals(bData.get());
+    }
+    SkPixmap aPixmap, bPixmap;
+    if (!a->peekPixels(&aPixmap) || !b->peekPixels(&bPixmap)) {
+        return false;
+    }
+    const size_t rowSize = aPixmap.info().minRowBytes();
+    for (int y = 0; y < aPixmap.height(); ++y) {
+        if (memcmp(aPixmap.addr(0, y), bPixmap.addr(0, y), rowSize) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -7,6 +7,9 @@
 #ifndef SkPDFBitmap_DEFINED
 #define SkPDFBitmap_DEFINED
 
+#include <cstdint>
+
+class SkExecutor;
 class SkImage;
 class SkPDFDocument;
 struct SkPDFIndirectReference;
@@ -19,4 +22,19 @@ SkPDFIndirectReference SkPDFSerializeImage(const SkImage* img,
                                            SkPDFDocument* doc,
                                            int encodingQuality = 101);
 
+/**
+ * Hash the contents of an image: its encoded data if it has any, otherwise its pixels.
+ * Two images with the same hash are written to the PDF the same way by SkPDFSerializeImage.
+ * If executor is not null, parts of the image are hashed concurrently; the result is the
+ * same either way.  Returns false if the contents can not be read without decoding or
+ * drawing the image.
+ */
+bool SkPDFHashImage(const SkImage* img, SkExecutor* executor, uint64_t* hash);
+
+/**
+ * Returns whether a and b, two images for which SkPDFHashImage succeeded, have the same contents,
+ * i.e. whether a hash match between them is a real one.
+ */
+bool SkPDFImagesHaveSameContents(const SkImage* a, const SkImage* b);
+
 #endif  // SkPDFBitmap_DEFINED
@@ -20,6 +20,7 @@
 #include "include/docs/SkPDFDocument.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/pathops/SkPathOps.h"
+#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkScopeExit.h"
@@ -143,9 +144,8 @@ sk_sp<SkImage> alpha_image_to_greyscale_image(const SkImage* mask) {
     return greyBitmap.asImage();
 }
 
-static int add_resource(THashSet<SkPDFIndirectReference>& resources, SkPDFIndirectReference ref) {
-    resources.add(ref);
-    return ref.fValue;
+static int add_resource(SkPDFResourceList& resources, SkPDFIndirectReference ref) {
+    return resources.add(ref);
 }
 
 static void draw_points(SkCanvas::PointMode mode,
@@ -354,8 +354,9 @@ void SkPDFDevice::drawAnnotation(const SkRect& rect, const char key[], SkData* v
         if (!strcmp(SkAnnotationKeys::Define_Named_Dest_Key(), key)) {
             SkPoint p = this->localToDevice().mapXY(rect.x(), rect.y());
             pageXform.mapPoints(&p, 1);
-            auto pg = fDocument->currentPage();
-            fDocument->fNamedDestinations.push_back(SkPDFNamedDestination{sk_ref_sp(value), p, pg});
+            SkPDFPageState* page = fDocument->currentPageState();
+            page->fNamedDestinations.push_back(
+                    SkPDFNamedDestination{sk_ref_sp(value), p, page->fRef});
         }
         return;
     }
@@ -380,7 +381,7 @@ void SkPDFDevice::drawAnnotation(const SkRect& rect, const char key[], SkData* v
     if (linkType != SkPDFLink::Type::kNone) {
         std::unique_ptr<SkPDFLink> link = std::make_unique<SkPDFLink>(
             linkType, value, transformedRect, fNodeId);
-        fDocument->fCurrentPageLinks.push_back(std::move(link));
+        fDocument->currentPageState()->fLinks.push_back(std::move(link));
     }
 }
 
@@ -554,11 +555,15 @@ void SkPDFDevice::setGraphicState(SkPDFIndirectReference gs, SkDynamicMemoryWStr
 
 void SkPDFDevice::clearMaskOnGraphicState(SkDynamicMemoryWStream* contentStream) {
     // The no-softmask graphic state is used to "turn off" the mask for later draw calls.
-    SkPDFIndirectReference& noSMaskGS = fDocument->fNoSmaskGraphicState;
-    if (!noSMaskGS) {
-        SkPDFDict tmp("ExtGState");
-        tmp.insertName("SMask", "None");
-        noSMaskGS = fDocument->emit(tmp);
+    SkPDFIndirectReference noSMaskGS;
+    {
+        SkAutoMutexExclusive lock(fDocument->fGraphicStateMutex);
+        if (!fDocument->fNoSmaskGraphicState) {
+            SkPDFDict tmp("ExtGState");
+            tmp.insertName("SMask", "None");
+            fDocument->fNoSmaskGraphicState = fDocument->emit(tmp);
+        }
+        noSMaskGS = fDocument->fNoSmaskGraphicState;
     }
     this->setGraphicState(noSMaskGS, contentStream);
 }
@@ -884,6 +889,19 @@ void SkPDFDevice::internalDrawGlyphRun(
     SK_AT_SCOPE_EXIT(if (clusterator.reversedChars()) { out->writeText("EMC\n"); } );
     GlyphPositioner glyphPositioner(out, glyphRunFont.getSkewX(), offset);
     SkPDFFont* font = nullptr;
+    // Fonts are shared by pages drawn concurrently, so note the glyphs used from each font
+    // together, under the document's font lock.
+    std::vector<SkGlyphID> usedGlyphs;
+    auto noteGlyphUsage = [&font, &usedGlyphs, this]() {
+        if (font && !usedGlyphs.empty()) {
+            SkAutoMutexExclusive lock(fDocument->fFontMutex);
+            for (SkGlyphID gid : usedGlyphs) {
+                font->noteGlyphUsage(gid);
+            }
+        }
+        usedGlyphs.clear();
+    };
+    SK_AT_SCOPE_EXIT(noteGlyphUsage());
 
     SkBulkGlyphMetricsAndPaths paths{strikeSpec};
     auto glyphs = paths.glyphs(glyphRun.glyphsIDs());
@@ -938,6 +956,7 @@ void SkPDFDevice::internalDrawGlyphRun(
             }
             if (needs_new_font(font, glyphs[index], fontType)) {
                 // Not yet specified font or need to switch font.
+                noteGlyphUsage();
                 font = SkPDFFont::GetFontResource(fDocument, glyphs[index], typeface);
                 SkASSERT(font);  // All preconditions for SkPDFFont::GetFontResource are met.
                 glyphPositioner.setFont(font);
@@ -948,7 +967,7 @@ void SkPDFDevice::internalDrawGlyphRun(
                 out->writeText(" Tf\n");
 
             }
-            font->noteGlyphUsage(gid);
+            usedGlyphs.push_back(gid);
             SkGlyphID encodedGlyph = font->glyphToPDFFontEncoding(gid);
             SkScalar advance = advanceScale * glyphs[index]->advanceX();
             glyphPositioner.writeGlyph(encodedGlyph, advance, xy);
@@ -993,22 +1012,11 @@ sk_sp<SkSurface> SkPDFDevice::makeSurface(const SkImageInfo& info, const SkSurfa
     return SkSurfaces::Raster(info, &props);
 }
 
-static std::vector<SkPDFIndirectReference> sort(const THashSet<SkPDFIndirectReference>& src) {
-    std::vector<SkPDFIndirectReference> dst;
-    dst.reserve(src.count());
-    for (SkPDFIndirectReference ref : src) {
-        dst.push_back(ref);
-    }
-    std::sort(dst.begin(), dst.end(),
-            [](SkPDFIndirectReference a, SkPDFIndirectReference b) { return a.fValue < b.fValue; });
-    return dst;
-}
-
 std::unique_ptr<SkPDFDict> SkPDFDevice::makeResourceDict() {
-    return SkPDFMakeResourceDict(sort(fGraphicStateResources),
-                                 sort(fShaderResources),
-                                 sort(fXObjectResources),
-                                 sort(fFontResources));
+    return SkPDFMakeResourceDict(fGraphicStateResources.refs(),
+                                 fShaderResources.refs(),
+                                 fXObjectResources.refs(),
+                                 fFontResources.refs());
 }
 
 std::unique_ptr<SkStreamAsset> SkPDFDevice::content() {
@@ -1155,8 +1163,8 @@ static void populate_graphic_state_entry_from_paint(
         const SkMatrix& initialTransform,
         SkScalar textScale,
         SkPDFGraphicStackState::Entry* entry,
-        THashSet<SkPDFIndirectReference>* shaderResources,
-        THashSet<SkPDFIndirectReference>* graphicStateResources) {
+        SkPDFResourceList* shaderResources,
+        SkPDFResourceList* graphicStateResources) {
     NOT_IMPLEMENTED(paint.getPathEffect() != nullptr, false);
     NOT_IMPLEMENTED(paint.getMaskFilter() != nullptr, false);
     NOT_IMPLEMENTED(paint.getColorFilter() != nullptr, false);
@@ -1666,15 +1674,31 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
         // (maybe in the resource cache?)
     }
 
-    SkBitmapKey key = imageSubset.key();
-    SkPDFIndirectReference* pdfimagePtr = fDocument->fPDFBitmapMap.find(key);
-    SkPDFIndirectReference pdfimage = pdfimagePtr ? *pdfimagePtr : SkPDFIndirectReference();
-    if (!pdfimagePtr) {
+    SkBitmapKey key = fDocument->canonicalImageKey(imageSubset.image().get(), imageSubset.key());
+    SkPDFIndirectReference pdfimage;
+    {
+        SkAutoMutexExclusive lock(fDocument->fPDFBitmapMutex);
+        if (SkPDFIndirectReference* pdfimagePtr = fDocument->fPDFBitmapMap.find(key)) {
+            pdfimage = *pdfimagePtr;
+        }
+    }
+    if (pdfimage && key != imageSubset.key()) {
+        fDocument->countDeduplication(&SkPDF::DeduplicationStats::fImageHits);
+    }
+    if (!pdfimage) {
+        // Serialize the image without holding the lock, so other pages can be drawn meanwhile.
+        // If another page serialized the same image first, use that one; this one is never
+        // referenced, and so never written.
         SkASSERT(imageSubset);
         pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
                                        fDocument->metadata().fEncodingQuality);
         SkASSERT((key != SkBitmapKey{{0, 0, 0, 0}, 0}));
-        fDocument->fPDFBitmapMap.set(key, pdfimage);
+        SkAutoMutexExclusive lock(fDocument->fPDFBitmapMutex);
+        if (SkPDFIndirectReference* first = fDocument->fPDFBitmapMap.find(key)) {
+            pdfimage = *first;
+        } else {
+            fDocument->fPDFBitmapMap.set(key, pdfimage);
+        }
     }
     SkASSERT(pdfimage != SkPDFIndirectReference());
     this->drawFormXObject(pdfimage, content.stream());
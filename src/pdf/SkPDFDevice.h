@@ -21,6 +21,7 @@
 #include "src/core/SkTextBlobPriv.h"
 #include "src/pdf/SkKeyedImage.h"
 #include "src/pdf/SkPDFGraphicStackState.h"
+#include "src/pdf/SkPDFResourceDict.h"
 #include "src/pdf/SkPDFTypes.h"
 
 #include <vector>
@@ -125,10 +126,10 @@ private:
 
     SkMatrix fInitialTransform;
 
-    skia_private::THashSet<SkPDFIndirectReference> fGraphicStateResources;
-    skia_private::THashSet<SkPDFIndirectReference> fXObjectResources;
-    skia_private::THashSet<SkPDFIndirectReference> fShaderResources;
-    skia_private::THashSet<SkPDFIndirectReference> fFontResources;
+    SkPDFResourceList fGraphicStateResources;
+    SkPDFResourceList fXObjectResources;
+    SkPDFResourceList fShaderResources;
+    SkPDFResourceList fFontResources;
     int fNodeId;
 
     SkDynamicMemoryWStream fContent;
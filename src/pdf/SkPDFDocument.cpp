@@ -8,10 +8,18 @@
 #include "include/docs/SkPDFDocument.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 
+#include "include/core/SkImage.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
+#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkUTF.h"
+#include "src/core/SkStreamPriv.h"
+#include "src/core/SkTaskGroup.h"
+#include "src/pdf/SkBitmapKey.h"
+#include "src/pdf/SkDeflate.h"
+#include "src/pdf/SkPDFBitmap.h"
 #include "src/pdf/SkPDFDevice.h"
 #include "src/pdf/SkPDFFont.h"
 #include "src/pdf/SkPDFGradientShader.h"
@@ -20,6 +28,9 @@
 #include "src/pdf/SkPDFTag.h"
 #include "src/pdf/SkPDFUtils.h"
 
+#include <algorithm>
+#include <climits>
+#include <cstring>
 #include <utility>
 
 // For use in SkCanvas::drawAnnotation
@@ -61,14 +72,25 @@ static size_t difference(size_t minuend, size_t subtrahend) {
 void SkPDFOffsetMap::markStartOfObject(int referenceNumber, const SkWStream* s) {
     SkASSERT(referenceNumber > 0);
     size_t index = SkToSizeT(referenceNumber - 1);
-    if (index >= fOffsets.size()) {
-        fOffsets.resize(index + 1);
+    if (index >= fLocations.size()) {
+        fLocations.resize(index + 1);
     }
-    fOffsets[index] = SkToInt(difference(s->bytesWritten(), fBaseOffset));
+    fLocations[index].fOffset = SkToInt(difference(s->bytesWritten(), fBaseOffset));
+}
+
+void SkPDFOffsetMap::markObjectInStream(int referenceNumber, int objectStreamNumber, int index) {
+    SkASSERT(referenceNumber > 0);
+    SkASSERT(objectStreamNumber > 0);
+    size_t location = SkToSizeT(referenceNumber - 1);
+    if (location >= fLocations.size()) {
+        fLocations.resize(location + 1);
+    }
+    fLocations[location].fObjectStream = objectStreamNumber;
+    fLocations[location].fIndex = index;
 }
 
 int SkPDFOffsetMap::objectCount() const {
-    return SkToInt(fOffsets.size() + 1); // Include the special zeroth object in the count.
+    return SkToInt(fLocations.size() + 1); // Include the special zeroth object in the count.
 }
 
 int SkPDFOffsetMap::emitCrossReferenceTable(SkWStream* s) const {
@@ -76,13 +98,65 @@ int SkPDFOffsetMap::emitCrossReferenceTable(SkWStream* s) const {
     s->writeText("xref\n0 ");
     s->writeDecAsText(this->objectCount());
     s->writeText("\n0000000000 65535 f \n");
-    for (int offset : fOffsets) {
-        SkASSERT(offset > 0);  // Offset was set.
-        s->writeBigDecAsText(offset, 10);
+    for (const Location& location : fLocations) {
+        SkASSERT(location.fOffset > 0);  // Offset was set.
+        s->writeBigDecAsText(location.fOffset, 10);
         s->writeText(" 00000 n \n");
     }
     return xRefFileOffset;
 }
+
+int SkPDFOffsetMap::emitCrossReferenceStream(SkWStream* s,
+                                             SkPDFIndirectReference ref,
+                                             SkPDFDict* dict,
+                                             const SkPDF::Compressor* compressor,
+                                             int compressionLevel) {
+    int xRefFileOffset = SkToInt(difference(s->bytesWritten(), fBaseOffset));
+    this->markStartOfObject(ref.fValue, s);
+    SkASSERT(ref.fValue + 1 == this->objectCount());
+
+    // Each entry is a type, then either an offset and a generation number, or an object stream
+    // and an index in it, as big-endian fields of 1, 4 and 2 bytes.
+    SkDynamicMemoryWStream entries;
+    auto writeEntry = [&entries](uint8_t type, uint32_t field2, uint16_t field3) {
+        const uint8_t entry[7] = {type,
+                                  (uint8_t)(field2 >> 24), (uint8_t)(field2 >> 16),
+                                  (uint8_t)(field2 >>  8), (uint8_t)(field2),
+                                  (uint8_t)(field3 >>  8), (uint8_t)(field3)};
+        entries.write(entry, sizeof(entry));
+    };
+    writeEntry(0, 0, 0xFFFF);
+    for (const Location& location : fLocations) {
+        if (location.fObjectStream > 0) {
+            writeEntry(2, location.fObjectStream, SkToU16(location.fIndex));
+        } else {
+            SkASSERT(location.fOffset > 0);  // Offset was set.
+            writeEntry(1, location.fOffset, 0);
+        }
+    }
+    std::unique_ptr<SkStreamAsset> data = entries.detachAsStream();
+
+    dict->insertInt("Size", this->objectCount());
+    dict->insertObject("W", SkPDFMakeArray(1, 4, 2));
+    if (compressionLevel != 0) {
+        if (auto compressed = SkDeflateCompressStream(compressor, data.get(), compressionLevel,
+                                                      SkDeflateStrategy::kDefault)) {
+            data = std::move(compressed);
+            dict->insertName("Filter", "FlateDecode");
+        } else {
+            SkAssertResult(data->rewind());
+        }
+    }
+    dict->insertInt("Length", data->getLength());
+
+    s->writeDecAsText(ref.fValue);
+    s->writeText(" 0 obj\n");
+    dict->emitObject(s);
+    s->writeText(" stream\n");
+    s->writeStream(data.get(), data->getLength());
+    s->writeText("\nendstream\nendobj\n");
+    return xRefFileOffset;
+}
 //
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -93,9 +167,11 @@ static_assert((SKPDF_MAGIC[1] & 0x7F) == "Skia"[1], "");
 static_assert((SKPDF_MAGIC[2] & 0x7F) == "Skia"[2], "");
 static_assert((SKPDF_MAGIC[3] & 0x7F) == "Skia"[3], "");
 #endif
-static void serializeHeader(SkPDFOffsetMap* offsetMap, SkWStream* wStream) {
+static void serializeHeader(SkPDFOffsetMap* offsetMap, SkWStream* wStream, bool objectStreams) {
     offsetMap->markStartOfDocument(wStream);
-    wStream->writeText("%PDF-1.4\n%" SKPDF_MAGIC "\n");
+    // Object streams and cross-reference streams are new in PDF 1.5.
+    wStream->writeText(objectStreams ? "%PDF-1.5\n%" SKPDF_MAGIC "\n"
+                                     : "%PDF-1.4\n%" SKPDF_MAGIC "\n");
     // The PDF spec recommends including a comment with four
     // bytes, all with their high bits set.  "\xD3\xEB\xE9\xE1" is
     // "Skia" with the high bits set.
@@ -112,6 +188,25 @@ static void begin_indirect_object(SkPDFOffsetMap* offsetMap,
 
 static void end_indirect_object(SkWStream* s) { s->writeText("\nendobj\n"); }
 
+static void insert_trailer_entries(SkPDFDict* trailerDict,
+                                   SkPDFIndirectReference infoDict,
+                                   SkPDFIndirectReference docCatalog,
+                                   SkUUID uuid) {
+    SkASSERT(docCatalog != SkPDFIndirectReference());
+    trailerDict->insertRef("Root", docCatalog);
+    SkASSERT(infoDict != SkPDFIndirectReference());
+    trailerDict->insertRef("Info", infoDict);
+    if (SkUUID() != uuid) {
+        trailerDict->insertObject("ID", SkPDFMetadata::MakePdfId(uuid, uuid));
+    }
+}
+
+static void serialize_startxref(int xRefFileOffset, SkWStream* wStream) {
+    wStream->writeText("startxref\n");
+    wStream->writeBigDecAsText(xRefFileOffset);
+    wStream->writeText("\n%%EOF\n");
+}
+
 // Xref table and footer
 static void serialize_footer(const SkPDFOffsetMap& offsetMap,
                              SkWStream* wStream,
@@ -121,18 +216,27 @@ static void serialize_footer(const SkPDFOffsetMap& offsetMap,
     int xRefFileOffset = offsetMap.emitCrossReferenceTable(wStream);
     SkPDFDict trailerDict;
     trailerDict.insertInt("Size", offsetMap.objectCount());
-    SkASSERT(docCatalog != SkPDFIndirectReference());
-    trailerDict.insertRef("Root", docCatalog);
-    SkASSERT(infoDict != SkPDFIndirectReference());
-    trailerDict.insertRef("Info", infoDict);
-    if (SkUUID() != uuid) {
-        trailerDict.insertObject("ID", SkPDFMetadata::MakePdfId(uuid, uuid));
-    }
+    insert_trailer_entries(&trailerDict, infoDict, docCatalog, uuid);
     wStream->writeText("trailer\n");
     trailerDict.emitObject(wStream);
-    wStream->writeText("\nstartxref\n");
-    wStream->writeBigDecAsText(xRefFileOffset);
-    wStream->writeText("\n%%EOF\n");
+    wStream->writeText("\n");
+    serialize_startxref(xRefFileOffset, wStream);
+}
+
+// Xref stream, which also holds the trailer, and footer
+static void serialize_xref_stream_footer(SkPDFOffsetMap* offsetMap,
+                                         SkWStream* wStream,
+                                         SkPDFIndirectReference xrefStream,
+                                         SkPDFIndirectReference infoDict,
+                                         SkPDFIndirectReference docCatalog,
+                                         SkUUID uuid,
+                                         const SkPDF::Compressor* compressor,
+                                         int compressionLevel) {
+    SkPDFDict trailerDict("XRef");
+    insert_trailer_entries(&trailerDict, infoDict, docCatalog, uuid);
+    int xRefFileOffset = offsetMap->emitCrossReferenceStream(wStream, xrefStream, &trailerDict,
+                                                             compressor, compressionLevel);
+    serialize_startxref(xRefFileOffset, wStream);
 }
 
 static SkPDFIndirectReference generate_page_tree(
@@ -220,6 +324,12 @@ SkPDFDocument::SkPDFDocument(SkWStream* stream,
         fTagTree.init(fMetadata.fStructureElementTreeRoot);
     }
     fExecutor = fMetadata.fExecutor;
+    fCompressor = fMetadata.fCompressor ? fMetadata.fCompressor : SkDeflateZlibCompressor();
+    // PDF/A-1 forbids object and cross-reference streams, and PDF/A validators commonly reject
+    // them, so archival documents always get a classic xref table.
+    if (fMetadata.fPDFA) {
+        fMetadata.fUseObjectStreams = false;
+    }
 }
 
 SkPDFDocument::~SkPDFDocument() {
@@ -227,11 +337,166 @@ SkPDFDocument::~SkPDFDocument() {
     this->close();
 }
 
+// Small enough that each object stream is quick to compress and to parse, big enough to share the
+// compression dictionary across many similar objects.
+static constexpr size_t kObjectsPerStream = 100;
+
 SkPDFIndirectReference SkPDFDocument::emit(const SkPDFObject& object, SkPDFIndirectReference ref){
+    if (fRenumbering) {
+        SkDynamicMemoryWStream buffer;
+        object.emitObject(&buffer);
+        this->emitRenumbered(ref, buffer.detachAsData(), nullptr);
+        return ref;
+    }
+    std::unique_ptr<SkPDFPendingObjects> fullStream;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        if (!fMetadata.fUseObjectStreams) {
+            object.emitObject(this->beginObject(ref));
+            this->endObject();
+            return ref;
+        }
+        if (!fPendingObjects) {
+            fPendingObjects = std::make_unique<SkPDFPendingObjects>();
+        }
+        fPendingObjects->fNumbers.push_back(ref.fValue);
+        fPendingObjects->fOffsets.push_back(fPendingObjects->fData.bytesWritten());
+        object.emitObject(&fPendingObjects->fData);
+        fPendingObjects->fData.writeText("\n");
+        if (fPendingObjects->fNumbers.size() >= kObjectsPerStream) {
+            fullStream = std::move(fPendingObjects);
+        }
+    }
+    // Emitting the object stream takes the lock, and may hand the compression to the executor.
+    if (fullStream) {
+        this->emitObjectStream(std::move(fullStream));
+    }
+    return ref;
+}
+
+void SkPDFDocument::emitObjectStream(std::unique_ptr<SkPDFPendingObjects> objects) {
+    SkASSERT(objects && !objects->fNumbers.empty());
+    // The stream starts with pairs of object numbers and offsets relative to the first object.
+    SkDynamicMemoryWStream header;
+    for (size_t i = 0; i < objects->fNumbers.size(); ++i) {
+        header.writeDecAsText(objects->fNumbers[i]);
+        header.writeText(" ");
+        header.writeBigDecAsText(objects->fOffsets[i]);
+        header.writeText(i + 1 < objects->fNumbers.size() ? " " : "\n");
+    }
+    auto dict = SkPDFMakeDict("ObjStm");
+    dict->insertInt("N", objects->fNumbers.size());
+    dict->insertInt("First", header.bytesWritten());
+    header.prependToAndReset(&objects->fData);
+    SkPDFIndirectReference ref = SkPDFStreamOut(std::move(dict),
+                                                objects->fData.detachAsStream(), this);
+
+    SkAutoMutexExclusive lock(fMutex);
+    for (size_t i = 0; i < objects->fNumbers.size(); ++i) {
+        fOffsetMap.markObjectInStream(objects->fNumbers[i], ref.fValue, SkToInt(i));
+    }
+}
+
+void SkPDFDocument::emitRenumbered(SkPDFIndirectReference ref,
+                                   sk_sp<SkData> object,
+                                   std::unique_ptr<SkStreamAsset> streamData) {
+    std::vector<std::unique_ptr<SkPDFPendingObjects>> fullStreams;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        if (fDeferring) {
+            fDeferredObjects.set(ref.fValue, {std::move(object), std::move(streamData)});
+            return;
+        }
+        this->writeRenumbered(this->numberObject(ref.fValue), *object, streamData.get(),
+                              &fullStreams);
+        this->writeNumberedObjects(&fullStreams);
+    }
+    for (std::unique_ptr<SkPDFPendingObjects>& objects : fullStreams) {
+        this->emitObjectStream(std::move(objects));
+    }
+}
+
+int SkPDFDocument::numberObject(int reference) SK_REQUIRES(fMutex) {
+    if (reference < kSkPDFFirstProvisionalReference) {
+        return reference;
+    }
+    size_t index = SkToSizeT(reference - kSkPDFFirstProvisionalReference);
+    if (index >= fObjectNumbers.size()) {
+        fObjectNumbers.resize(index + 1, 0);
+    }
+    if (fObjectNumbers[index] == 0) {
+        fObjectNumbers[index] = fNextObjectNumber++;
+        fNumbered.push_back(reference);
+    }
+    return fObjectNumbers[index];
+}
+
+int SkPDFDocument::objectNumber(SkPDFIndirectReference ref) {
+    if (ref.fValue < kSkPDFFirstProvisionalReference) {
+        return ref.fValue;
+    }
     SkAutoMutexExclusive lock(fMutex);
-    object.emitObject(this->beginObject(ref));
+    size_t index = SkToSizeT(ref.fValue - kSkPDFFirstProvisionalReference);
+    return index < fObjectNumbers.size() && fObjectNumbers[index] != 0 ? fObjectNumbers[index]
+                                                                       : INT_MAX;
+}
+
+void SkPDFDocument::renumber(const SkData& object, SkWStream* dst) SK_REQUIRES(fMutex) {
+    const char* ptr = static_cast<const char*>(object.data());
+    const char* end = ptr + object.size();
+    while (const char* marker = static_cast<const char*>(
+                   memchr(ptr, kSkPDFProvisionalReferenceMarker, SkToSizeT(end - ptr)))) {
+        dst->write(ptr, SkToSizeT(marker - ptr));
+        int reference = 0;
+        for (ptr = marker + 1; ptr < end && '0' <= *ptr && *ptr <= '9'; ++ptr) {
+            reference = 10 * reference + (*ptr - '0');
+        }
+        dst->writeDecAsText(this->numberObject(reference));
+    }
+    dst->write(ptr, SkToSizeT(end - ptr));
+}
+
+void SkPDFDocument::writeRenumbered(int number,
+                                    const SkData& object,
+                                    SkStreamAsset* streamData,
+                                    std::vector<std::unique_ptr<SkPDFPendingObjects>>* fullStreams)
+        SK_REQUIRES(fMutex) {
+    if (!streamData && fMetadata.fUseObjectStreams) {
+        if (!fPendingObjects) {
+            fPendingObjects = std::make_unique<SkPDFPendingObjects>();
+        }
+        fPendingObjects->fNumbers.push_back(number);
+        fPendingObjects->fOffsets.push_back(fPendingObjects->fData.bytesWritten());
+        this->renumber(object, &fPendingObjects->fData);
+        fPendingObjects->fData.writeText("\n");
+        if (fPendingObjects->fNumbers.size() >= kObjectsPerStream) {
+            fullStreams->push_back(std::move(fPendingObjects));
+        }
+        return;
+    }
+    SkWStream* stream = this->beginObject(SkPDFIndirectReference{number});
+    this->renumber(object, stream);
+    if (streamData) {
+        stream->writeText(" stream\n");
+        stream->writeStream(streamData, streamData->getLength());
+        stream->writeText("\nendstream");
+    }
     this->endObject();
-    return ref;
+}
+
+void SkPDFDocument::writeNumberedObjects(
+        std::vector<std::unique_ptr<SkPDFPendingObjects>>* fullStreams) SK_REQUIRES(fMutex) {
+    // Writing an object can number more, which are written in turn.  Objects that have not been
+    // emitted yet, e.g. fonts, are written with their numbers when they are.
+    while (fNextToWrite < fNumbered.size()) {
+        int reference = fNumbered[fNextToWrite++];
+        if (SkPDFDeferredObject* deferred = fDeferredObjects.find(reference)) {
+            SkPDFDeferredObject object = std::move(*deferred);
+            fDeferredObjects.remove(reference);
+            this->writeRenumbered(this->numberObject(reference), *object.fObject,
+                                  object.fStreamData.get(), fullStreams);
+        }
+    }
 }
 
 SkWStream* SkPDFDocument::beginObject(SkPDFIndirectReference ref) SK_REQUIRES(fMutex) {
@@ -246,41 +511,56 @@ void SkPDFDocument::endObject() SK_REQUIRES(fMutex) {
 static SkSize operator*(SkISize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.height() * s}; }
 
+void SkPDFDocument::beginDocument() {
+    {
+        SkAutoMutexExclusive autoMutexAcquire(fMutex);
+        serializeHeader(&fOffsetMap, this->getStream(), fMetadata.fUseObjectStreams);
+
+    }
+
+    fInfoDict = this->emit(*SkPDFMetadata::MakeDocumentInformationDict(fMetadata));
+    if (fMetadata.fPDFA) {
+        fUUID = SkPDFMetadata::CreateUUID(fMetadata);
+        // We use the same UUID for Document ID and Instance ID since this
+        // is the first revision of this document (and Skia does not
+        // support revising existing PDF documents).
+        // If we are not in PDF/A mode, don't use a UUID since testing
+        // works best with reproducible outputs.
+        fXMP = SkPDFMetadata::MakeXMPObject(fMetadata, fUUID, fUUID, this);
+    }
+}
+
+// By scaling the page at the device level, we will create bitmap layer
+// devices at the rasterized scale, not the 72dpi scale.  Bitmap layer
+// devices are created when saveLayer is called with an ImageFilter;  see
+// SkPDFDevice::onCreateDevice().
+static SkISize page_device_size(SkScalar width, SkScalar height, SkScalar rasterScale) {
+    return (SkSize{width, height} * rasterScale).toRound();
+}
+
+// Skia uses the top left as the origin but PDF natively has the origin at the
+// bottom left. This matrix corrects for that, as well as the raster scale.
+static SkMatrix page_transform(SkISize pageSize, SkScalar inverseRasterScale) {
+    SkMatrix initialTransform;
+    initialTransform.setScaleTranslate(inverseRasterScale, -inverseRasterScale,
+                                       0, inverseRasterScale * pageSize.height());
+    return initialTransform;
+}
+
 SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
     if (fPages.empty()) {
         // if this is the first page if the document.
-        {
-            SkAutoMutexExclusive autoMutexAcquire(fMutex);
-            serializeHeader(&fOffsetMap, this->getStream());
-
-        }
-
-        fInfoDict = this->emit(*SkPDFMetadata::MakeDocumentInformationDict(fMetadata));
-        if (fMetadata.fPDFA) {
-            fUUID = SkPDFMetadata::CreateUUID(fMetadata);
-            // We use the same UUID for Document ID and Instance ID since this
-            // is the first revision of this document (and Skia does not
-            // support revising existing PDF documents).
-            // If we are not in PDF/A mode, don't use a UUID since testing
-            // works best with reproducible outputs.
-            fXMP = SkPDFMetadata::MakeXMPObject(fMetadata, fUUID, fUUID, this);
-        }
+        this->beginDocument();
     }
-    // By scaling the page at the device level, we will create bitmap layer
-    // devices at the rasterized scale, not the 72dpi scale.  Bitmap layer
-    // devices are created when saveLayer is called with an ImageFilter;  see
-    // SkPDFDevice::onCreateDevice().
-    SkISize pageSize = (SkSize{width, height} * fRasterScale).toRound();
-    SkMatrix initialTransform;
-    // Skia uses the top left as the origin but PDF natively has the origin at the
-    // bottom left. This matrix corrects for that, as well as the raster scale.
-    initialTransform.setScaleTranslate(fInverseRasterScale, -fInverseRasterScale,
-                                       0, fInverseRasterScale * pageSize.height());
-    fPageDevice = sk_make_sp<SkPDFDevice>(pageSize, this, initialTransform);
+    SkISize pageSize = page_device_size(width, height, fRasterScale);
+    fPageState.fIndex = fPages.size();
+    fPageState.fRef = this->reserveRef();
+    fPageState.fTransform = page_transform(pageSize, fInverseRasterScale);
+    fPageDevice = sk_make_sp<SkPDFDevice>(pageSize, this, fPageState.fTransform);
     reset_object(&fCanvas, fPageDevice);
     fCanvas.scale(fRasterScale, fRasterScale);
-    fPageRefs.push_back(this->reserveRef());
+    fPageRefs.push_back(fPageState.fRef);
     return &fCanvas;
 }
 
@@ -312,15 +592,15 @@ static SkPDFIndirectReference append_destinations(
     return doc->emit(destinations);
 }
 
-std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
+std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations(const SkPDFPageState& page) {
     std::unique_ptr<SkPDFArray> array;
-    size_t count = fCurrentPageLinks.size();
+    size_t count = page.fLinks.size();
     if (0 == count) {
         return array;  // is nullptr
     }
     array = SkPDFMakeArray();
     array->reserve(count);
-    for (const auto& link : fCurrentPageLinks) {
+    for (const auto& link : page.fLinks) {
         SkPDFDict annotation("Annot");
         populate_link_annotation(&annotation, link->fRect);
         if (link->fType == SkPDFLink::Type::kUrl) {
@@ -336,7 +616,9 @@ std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
         }
 
         if (link->fNodeId) {
-            int structParentKey = createStructParentKeyForNodeId(link->fNodeId);
+            SkAutoMutexExclusive lock(fTagTreeMutex);
+            int structParentKey =
+                    fTagTree.createStructParentKeyForNodeId(link->fNodeId, SkToUInt(page.fIndex));
             if (structParentKey != -1) {
                 annotation.insertInt("StructParent", structParentKey);
             }
@@ -345,38 +627,171 @@ std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
         SkPDFIndirectReference annotationRef = emit(annotation);
         array->appendRef(annotationRef);
         if (link->fNodeId) {
-            fTagTree.addNodeAnnotation(link->fNodeId, annotationRef, SkToUInt(this->currentPageIndex()));
+            SkAutoMutexExclusive lock(fTagTreeMutex);
+            fTagTree.addNodeAnnotation(link->fNodeId, annotationRef, SkToUInt(page.fIndex));
         }
     }
     return array;
 }
 
+std::unique_ptr<SkPDFDict> SkPDFDocument::makePage(SkPDFDevice* device,
+                                                   const SkPDFPageState& pageState) {
+    auto page = SkPDFMakeDict("Page");
+
+    SkSize mediaSize = device->imageInfo().dimensions() * fInverseRasterScale;
+    std::unique_ptr<SkStreamAsset> pageContent = device->content();
+    page->insertObject("Resources", device->makeResourceDict());
+    page->insertObject("MediaBox", SkPDFUtils::RectToArray(SkRect::MakeSize(mediaSize)));
+    page->insertRef("Contents", SkPDFStreamOut(nullptr, std::move(pageContent), this));
+    // The StructParents unique identifier for each page is just its
+    // 0-based page index.
+    page->insertInt("StructParents", SkToInt(pageState.fIndex));
+    return page;
+}
+
+// Pages are committed in order, so annotations and named destinations are too.
+void SkPDFDocument::commitPage(SkPDFPageState* pageState, std::unique_ptr<SkPDFDict> page) {
+    if (std::unique_ptr<SkPDFArray> annotations = this->getAnnotations(*pageState)) {
+        page->insertObject("Annots", std::move(annotations));
+    }
+    pageState->fLinks.clear();
+    for (SkPDFNamedDestination& dest : pageState->fNamedDestinations) {
+        fNamedDestinations.push_back(std::move(dest));
+    }
+    pageState->fNamedDestinations.clear();
+    fPages.emplace_back(std::move(page));
+}
+
 void SkPDFDocument::onEndPage() {
     SkASSERT(!fCanvas.imageInfo().dimensions().isZero());
     reset_object(&fCanvas);
     SkASSERT(fPageDevice);
-
-    auto page = SkPDFMakeDict("Page");
-
-    SkSize mediaSize = fPageDevice->imageInfo().dimensions() * fInverseRasterScale;
-    std::unique_ptr<SkStreamAsset> pageContent = fPageDevice->content();
-    auto resourceDict = fPageDevice->makeResourceDict();
     SkASSERT(fPageRefs.size() > 0);
+    std::unique_ptr<SkPDFDict> page = this->makePage(fPageDevice.get(), fPageState);
     fPageDevice = nullptr;
+    this->commitPage(&fPageState, std::move(page));
+}
 
-    page->insertObject("Resources", std::move(resourceDict));
-    page->insertObject("MediaBox", SkPDFUtils::RectToArray(SkRect::MakeSize(mediaSize)));
+namespace {
+// The page that SkPDF::DrawPages() is drawing on this thread, if any.
+struct DrawingPage {
+    const SkPDFDocument* fDocument;
+    SkPDFPageState* fPage;
+};
+thread_local DrawingPage gDrawingPage = {nullptr, nullptr};
+
+class AutoDrawingPage {
+public:
+    AutoDrawingPage(const SkPDFDocument* document, SkPDFPageState* page) : fPrevious(gDrawingPage) {
+        gDrawingPage = {document, page};
+    }
+    ~AutoDrawingPage() { gDrawingPage = fPrevious; }
 
-    if (std::unique_ptr<SkPDFArray> annotations = getAnnotations()) {
-        page->insertObject("Annots", std::move(annotations));
-        fCurrentPageLinks.clear();
+private:
+    DrawingPage fPrevious;
+};
+}  // namespace
+
+SkPDFPageState* SkPDFDocument::currentPageState() {
+    return gDrawingPage.fDocument == this ? gDrawingPage.fPage : &fPageState;
+}
+
+void SkPDFDocument::drawPages(SkSpan<const sk_sp<SkPicture>> pictures) {
+    if (this->getState() == kClosed_State) {
+        return;
+    }
+    SkASSERT(this->getState() == kBetweenPages_State);
+    std::vector<const SkPicture*> pagePictures;
+    for (const sk_sp<SkPicture>& picture : pictures) {
+        // Like beginPage(), skip empty pages.
+        if (picture && !picture->cullRect().isEmpty()) {
+            pagePictures.push_back(picture.get());
+        }
+    }
+    if (pagePictures.empty()) {
+        return;
     }
+    if (fPages.empty()) {
+        this->beginDocument();
+    }
+    // Objects written from now on are numbered in the order they are written.  Until the pages
+    // have been drawn, references are provisional and objects are held back.
+    this->waitForJobs();
+    fRenumbering = true;
+    fDeferring = true;
+
+    std::vector<SkPDFPageState> pageStates(pagePictures.size());
+    std::vector<std::unique_ptr<SkPDFDict>> pages(pagePictures.size());
+    for (size_t i = 0; i < pagePictures.size(); ++i) {
+        pageStates[i].fIndex = fPages.size() + i;
+        pageStates[i].fRef = this->reserveRef();
+        fPageRefs.push_back(pageStates[i].fRef);
+    }
+    auto drawPage = [&](size_t i) {
+        SkPDFPageState* pageState = &pageStates[i];
+        AutoDrawingPage autoDrawingPage(this, pageState);
+        SkRect cullRect = pagePictures[i]->cullRect();
+        SkISize pageSize = page_device_size(cullRect.width(), cullRect.height(), fRasterScale);
+        pageState->fTransform = page_transform(pageSize, fInverseRasterScale);
+        auto device = sk_make_sp<SkPDFDevice>(pageSize, this, pageState->fTransform);
+        {
+            SkCanvas canvas(device);
+            canvas.scale(fRasterScale, fRasterScale);
+            canvas.translate(-cullRect.left(), -cullRect.top());
+            canvas.drawPicture(pagePictures[i]);
+        }
+        pages[i] = this->makePage(device.get(), *pageState);
+    };
+    if (fExecutor) {
+        SkTaskGroup taskGroup(*fExecutor);
+        for (size_t i = 0; i < pagePictures.size(); ++i) {
+            taskGroup.add([&drawPage, i] { drawPage(i); });
+        }
+        taskGroup.wait();
+    } else {
+        for (size_t i = 0; i < pagePictures.size(); ++i) {
+            drawPage(i);
+        }
+    }
+    this->waitForJobs();
+    fDeferring = false;
 
-    page->insertRef("Contents", SkPDFStreamOut(nullptr, std::move(pageContent), this));
-    // The StructParents unique identifier for each page is just its
-    // 0-based page index.
-    page->insertInt("StructParents", SkToInt(this->currentPageIndex()));
-    fPages.emplace_back(std::move(page));
+    // Write the objects of each page in page order, numbering them as they are reached from the
+    // page, so that neither the numbers nor the order depend on which thread did what first.
+    std::vector<std::unique_ptr<SkPDFPendingObjects>> fullStreams;
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        // Objects whose references were reserved before the pages were drawn come first.
+        std::vector<int> numbered;
+        fDeferredObjects.foreach([&numbered](int reference, const SkPDFDeferredObject&) {
+            if (reference < kSkPDFFirstProvisionalReference) {
+                numbered.push_back(reference);
+            }
+        });
+        std::sort(numbered.begin(), numbered.end());
+        for (int reference : numbered) {
+            SkPDFDeferredObject object = std::move(*fDeferredObjects.find(reference));
+            fDeferredObjects.remove(reference);
+            this->writeRenumbered(reference, *object.fObject, object.fStreamData.get(),
+                                  &fullStreams);
+        }
+    }
+    for (size_t i = 0; i < pages.size(); ++i) {
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            this->numberObject(pageStates[i].fRef.fValue);
+            SkDynamicMemoryWStream pageBytes;
+            pages[i]->emitObject(&pageBytes);
+            SkNullWStream discard;
+            this->renumber(*pageBytes.detachAsData(), &discard);
+            this->writeNumberedObjects(&fullStreams);
+        }
+        this->commitPage(&pageStates[i], std::move(pages[i]));
+    }
+    for (std::unique_ptr<SkPDFPendingObjects>& objects : fullStreams) {
+        this->emitObjectStream(std::move(objects));
+    }
+    this->tagDeferredSubsetFonts();
 }
 
 void SkPDFDocument::onAbort() {
@@ -523,29 +938,32 @@ SkPDFIndirectReference SkPDFDocument::getPage(size_t pageIndex) const {
     return fPageRefs[pageIndex];
 }
 
-const SkMatrix& SkPDFDocument::currentPageTransform() const {
-    return fPageDevice->initialTransform();
-}
-
 int SkPDFDocument::createMarkIdForNodeId(int nodeId) {
+    SkAutoMutexExclusive lock(fTagTreeMutex);
     return fTagTree.createMarkIdForNodeId(nodeId, SkToUInt(this->currentPageIndex()));
 }
 
 int SkPDFDocument::createStructParentKeyForNodeId(int nodeId) {
+    SkAutoMutexExclusive lock(fTagTreeMutex);
     return fTagTree.createStructParentKeyForNodeId(nodeId, SkToUInt(this->currentPageIndex()));
 }
 
-static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
-    std::vector<const SkPDFFont*> fonts;
-    fonts.reserve(canon.fFontMap.count());
+static std::vector<const SkPDFFont*> get_fonts(SkPDFDocument* canon) {
+    SkAutoMutexExclusive lock(canon->fFontMutex);
+    std::vector<std::pair<int, const SkPDFFont*>> fonts;
+    fonts.reserve(canon->fFontMap.count());
     // Sort so the output PDF is reproducible.
-    for (const auto& [unused, font] : canon.fFontMap) {
-        fonts.push_back(&font);
+    for (const auto& [unused, font] : canon->fFontMap) {
+        fonts.push_back({canon->objectNumber(font->indirectReference()), font.get()});
     }
-    std::sort(fonts.begin(), fonts.end(), [](const SkPDFFont* u, const SkPDFFont* v) {
-        return u->indirectReference().fValue < v->indirectReference().fValue;
-    });
-    return fonts;
+    std::sort(fonts.begin(), fonts.end(),
+              [](const auto& u, const auto& v) { return u.first < v.first; });
+    std::vector<const SkPDFFont*> sorted;
+    sorted.reserve(fonts.size());
+    for (const auto& [unused, font] : fonts) {
+        sorted.push_back(font);
+    }
+    return sorted;
 }
 
 SkString SkPDFDocument::nextFontSubsetTag() {
@@ -565,6 +983,67 @@ SkString SkPDFDocument::nextFontSubsetTag() {
     return subsetTag;
 }
 
+void SkPDFDocument::tagSubsetFont(uint32_t typefaceID, SkString* postScriptName) {
+    if (fDeferring) {
+        fUntaggedSubsetFonts.push_back(typefaceID);
+    } else {
+        postScriptName->prepend(this->nextFontSubsetTag());
+    }
+}
+
+void SkPDFDocument::tagDeferredSubsetFonts() {
+    SkAutoMutexExclusive lock(fFontMutex);
+    // Tag the fonts in the order of their object numbers, rather than the order in which the
+    // threads drawing the pages first used them.
+    std::vector<std::pair<int, SkAdvancedTypefaceMetrics*>> fonts;
+    for (uint32_t typefaceID : fUntaggedSubsetFonts) {
+        int firstNumber = INT_MAX;
+        for (const auto& [key, font] : fFontMap) {
+            if ((key >> 16) == typefaceID) {
+                firstNumber = std::min(firstNumber, this->objectNumber(font->indirectReference()));
+            }
+        }
+        fonts.push_back({firstNumber, fTypefaceMetrics.find(typefaceID)->get()});
+    }
+    std::sort(fonts.begin(), fonts.end(), [](const auto& u, const auto& v) {
+        return u.first != v.first ? u.first < v.first
+                                  : strcmp(u.second->fPostScriptName.c_str(),
+                                           v.second->fPostScriptName.c_str()) < 0;
+    });
+    for (const auto& [unused, metrics] : fonts) {
+        metrics->fPostScriptName.prepend(this->nextFontSubsetTag());
+    }
+    fUntaggedSubsetFonts.clear();
+}
+
+SkBitmapKey SkPDFDocument::canonicalImageKey(const SkImage* img, const SkBitmapKey& imgKey) {
+    if (!fMetadata.fDeduplicateByContent) {
+        return imgKey;
+    }
+    SkAutoMutexExclusive lock(fImageContentMutex);
+    if (const SkBitmapKey* key = fCanonicalImageKeys.find(imgKey)) {
+        return *key;
+    }
+    // Each image is hashed at most once; later draws of it only cost the lookup above.
+    SkBitmapKey key = imgKey;
+    uint64_t hash;
+    // Pages drawn concurrently hash their images serially: waiting for the executor could run
+    // another page on this thread while it holds fImageContentMutex.
+    if (SkPDFHashImage(img, fDeferring ? nullptr : this->executor(), &hash)) {
+        this->countDeduplication(&SkPDF::DeduplicationStats::fImagesHashed);
+        if (const ImageContent* first = fImageContentMap.find(hash)) {
+            // A hash collision leaves img with its own key, and the first image in the map.
+            if (SkPDFImagesHaveSameContents(first->fImage.get(), img)) {
+                key = first->fKey;
+            }
+        } else {
+            fImageContentMap.set(hash, {sk_ref_sp(img), imgKey});
+        }
+    }
+    fCanonicalImageKeys.set(imgKey, key);
+    return key;
+}
+
 void SkPDFDocument::onClose(SkWStream* stream) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
     if (fPages.empty()) {
@@ -588,25 +1067,53 @@ void SkPDFDocument::onClose(SkWStream* stream) {
     }
 
     // Handle tagged PDFs.
-    if (SkPDFIndirectReference root = fTagTree.makeStructTreeRoot(this)) {
+    SkPDFIndirectReference structTreeRoot;
+    {
+        SkAutoMutexExclusive lock(fTagTreeMutex);
+        structTreeRoot = fTagTree.makeStructTreeRoot(this);
+    }
+    if (structTreeRoot) {
         // In the document catalog, indicate that this PDF is tagged.
         auto markInfo = SkPDFMakeDict("MarkInfo");
         markInfo->insertBool("Marked", true);
         docCatalog->insertObject("MarkInfo", std::move(markInfo));
-        docCatalog->insertRef("StructTreeRoot", root);
+        docCatalog->insertRef("StructTreeRoot", structTreeRoot);
     }
 
     auto docCatalogRef = this->emit(*docCatalog);
 
-    for (const SkPDFFont* f : get_fonts(*this)) {
+    for (const SkPDFFont* f : get_fonts(this)) {
         f->emitSubset(this);
     }
 
     this->waitForJobs();
     {
+        // Objects held back while pages were drawn, but never referenced.
+        SkAutoMutexExclusive autoMutexAcquire(fMutex);
+        fDeferredObjects.reset();
+    }
+    if (fMetadata.fUseObjectStreams) {
+        std::unique_ptr<SkPDFPendingObjects> lastStream;
+        {
+            SkAutoMutexExclusive autoMutexAcquire(fMutex);
+            lastStream = std::move(fPendingObjects);
+        }
+        if (lastStream) {
+            this->emitObjectStream(std::move(lastStream));
+            this->waitForJobs();
+        }
+        SkAutoMutexExclusive autoMutexAcquire(fMutex);
+        serialize_xref_stream_footer(&fOffsetMap, this->getStream(), this->reserveRef(),
+                                     fInfoDict, docCatalogRef, fUUID, fCompressor,
+                                     SkToInt(fMetadata.fCompressionLevel));
+    } else {
         SkAutoMutexExclusive autoMutexAcquire(fMutex);
         serialize_footer(fOffsetMap, this->getStream(), fInfoDict, docCatalogRef, fUUID);
     }
+    if (fMetadata.fDeduplicateByContent && fMetadata.fDeduplicationStats) {
+        SkAutoMutexExclusive lock(fStatsMutex);
+        *fMetadata.fDeduplicationStats = fDeduplicationStats;
+    }
 }
 
 void SkPDFDocument::incrementJobCount() { fJobCount++; }
@@ -629,6 +1136,12 @@ void SkPDF::SetNodeId(SkCanvas* canvas, int nodeID) {
     canvas->drawAnnotation({0, 0, 0, 0}, key, payload.get());
 }
 
+void SkPDF::DrawPages(SkDocument* document, SkSpan<const sk_sp<SkPicture>> pages) {
+    SkASSERT(document);
+    document->endPage();
+    static_cast<SkPDFDocument*>(document)->drawPages(pages);
+}
+
 sk_sp<SkDocument> SkPDF::MakeDocument(SkWStream* stream, const SkPDF::Metadata& metadata) {
     SkPDF::Metadata meta = metadata;
     if (meta.fRasterDPI <= 0) {
@@ -8,10 +8,13 @@
 #define SkPDFDocumentPriv_DEFINED
 
 #include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkStream.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/base/SkMutex.h"
 #include "src/core/SkTHash.h"
+#include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFGraphicState.h"
 #include "src/pdf/SkPDFMetadata.h"
 #include "src/pdf/SkPDFShader.h"
@@ -22,7 +25,9 @@
 #include <memory>
 
 class SkExecutor;
+class SkImage;
 class SkPDFDevice;
+class SkPicture;
 class SkPDFFont;
 struct SkAdvancedTypefaceMetrics;
 struct SkBitmapKey;
@@ -39,13 +44,30 @@ class SkPDFOffsetMap {
 public:
     void markStartOfDocument(const SkWStream*);
     void markStartOfObject(int referenceNumber, const SkWStream*);
+    void markObjectInStream(int referenceNumber, int objectStreamNumber, int index);
     int objectCount() const;
     int emitCrossReferenceTable(SkWStream* s) const;
+    // Writes a PDF 1.5 cross-reference stream as object |ref|, which must be the last object.
+    // |dict| is the stream's dictionary, holding the trailer entries.
+    int emitCrossReferenceStream(SkWStream* s, SkPDFIndirectReference ref, SkPDFDict* dict,
+                                 const SkPDF::Compressor* compressor, int compressionLevel);
 private:
-    std::vector<int> fOffsets;
+    struct Location {
+        int fOffset = 0;        // Objects written directly have an offset in the file,
+        int fObjectStream = 0;  // others an object stream
+        int fIndex = 0;         // and their index within it.
+    };
+    std::vector<Location> fLocations;
     size_t fBaseOffset = SIZE_MAX;
 };
 
+// Objects waiting to be packed into the next object stream.
+struct SkPDFPendingObjects {
+    std::vector<int> fNumbers;
+    std::vector<size_t> fOffsets;
+    SkDynamicMemoryWStream fData;
+};
+
 
 struct SkPDFNamedDestination {
     sk_sp<SkData> fName;
@@ -73,6 +95,22 @@ struct SkPDFLink {
     const int fNodeId;
 };
 
+// The page being drawn.  Pages drawn by SkPDF::DrawPages() each have their own, used by the
+// thread drawing the page.
+struct SkPDFPageState {
+    size_t fIndex = 0;
+    SkPDFIndirectReference fRef;
+    SkMatrix fTransform;
+    std::vector<std::unique_ptr<SkPDFLink>> fLinks;
+    std::vector<SkPDFNamedDestination> fNamedDestinations;
+};
+
+// An object emitted while pages are drawn concurrently, waiting for its object number.
+struct SkPDFDeferredObject {
+    sk_sp<SkData> fObject;                        // The object, or the dictionary of a stream,
+    std::unique_ptr<SkStreamAsset> fStreamData;   // and the data of the stream.
+};
+
 
 /** Concrete implementation of SkDocument that creates PDF files. This
     class does not produced linearized or optimized PDFs; instead it
@@ -100,6 +138,14 @@ public:
 
     template <typename T>
     void emitStream(const SkPDFDict& dict, T writeStream, SkPDFIndirectReference ref) {
+        if (fRenumbering) {
+            SkDynamicMemoryWStream dictBytes;
+            dict.emitObject(&dictBytes);
+            SkDynamicMemoryWStream data;
+            writeStream(&data);
+            this->emitRenumbered(ref, dictBytes.detachAsData(), data.detachAsStream());
+            return;
+        }
         SkAutoMutexExclusive lock(fMutex);
         SkWStream* stream = this->beginObject(ref);
         dict.emitObject(stream);
@@ -111,10 +157,15 @@ public:
 
     const SkPDF::Metadata& metadata() const { return fMetadata; }
 
+    // Compresses the document's streams once they are fully buffered.
+    const SkPDF::Compressor* compressor() const { return fCompressor; }
+
+    // Draws each picture as a page, concurrently on the executor if there is one.
+    void drawPages(SkSpan<const sk_sp<SkPicture>> pictures);
+
     SkPDFIndirectReference getPage(size_t pageIndex) const;
-    SkPDFIndirectReference currentPage() const {
-        return SkASSERT(!fPageRefs.empty()), fPageRefs.back();
-    }
+    // The page being drawn on this thread.
+    SkPDFPageState* currentPageState();
     // Used to allow marked content to refer to its corresponding structure
     // tree node, via a page entry in the parent tree. Returns -1 if no
     // mark ID.
@@ -124,56 +175,120 @@ public:
     // key.
     int createStructParentKeyForNodeId(int nodeId);
 
-    std::unique_ptr<SkPDFArray> getAnnotations();
+    std::unique_ptr<SkPDFArray> getAnnotations(const SkPDFPageState&);
 
-    SkPDFIndirectReference reserveRef() { return SkPDFIndirectReference{fNextObjectNumber++}; }
+    SkPDFIndirectReference reserveRef() {
+        return fDeferring ? SkPDFIndirectReference{fNextProvisionalReference++}
+                          : SkPDFIndirectReference{fNextObjectNumber++};
+    }
+    // Returns the number of the object, or INT_MAX if it is provisional and not yet numbered.
+    int objectNumber(SkPDFIndirectReference);
 
     // Returns a tag to prepend to a PostScript name of a subset font. Includes the '+'.
-    SkString nextFontSubsetTag();
+    SkString nextFontSubsetTag() SK_REQUIRES(fFontMutex);
+    // Prepends the subset tag to the font's PostScript name, now or, while pages are drawn
+    // concurrently, once they have been drawn.
+    void tagSubsetFont(uint32_t typefaceID, SkString* postScriptName) SK_REQUIRES(fFontMutex);
 
-    SkExecutor* executor() const { return fExecutor; }
+    // Once pages have been drawn with SkPDF::DrawPages(), the executor is only used while
+    // DrawPages() runs, so that the order of the other objects does not depend on thread timing.
+    // Objects written later would be numbered as their jobs finish.
+    SkExecutor* executor() const { return fRenumbering && !fDeferring ? nullptr : fExecutor; }
     void incrementJobCount();
     void signalJobComplete();
-    size_t currentPageIndex() { return fPages.size(); }
+    size_t currentPageIndex() { return this->currentPageState()->fIndex; }
     size_t pageCount() { return fPageRefs.size(); }
 
-    const SkMatrix& currentPageTransform() const;
+    const SkMatrix& currentPageTransform() { return this->currentPageState()->fTransform; }
+
+    // If metadata().fDeduplicateByContent is set, returns the key of the first image seen with
+    // the same contents as img, whose key is imgKey.  Otherwise returns imgKey.
+    SkBitmapKey canonicalImageKey(const SkImage* img, const SkBitmapKey& imgKey);
+
+    // Counts one deduplicated object, or one hashed, in fDeduplicationStats.
+    void countDeduplication(int SkPDF::DeduplicationStats::*count) {
+        SkAutoMutexExclusive lock(fStatsMutex);
+        ++(fDeduplicationStats.*count);
+    }
 
-    // Canonicalized objects
+    // Canonicalized objects, shared by pages drawn concurrently.  Each kind has its own lock,
+    // which is not held while the objects are made if making one can look up another of the
+    // same kind: an image pattern draws its image, and an alpha gradient is made of two others.
+    // If two pages then make the same object, the first one added to the map is used, and the
+    // other is never referenced, and so never written.
+    SkMutex fImageShaderMutex;
     skia_private::THashMap<SkPDFImageShaderKey,
                            SkPDFIndirectReference,
-                           SkPDFImageShaderKey::Hash> fImageShaderMap;
+                           SkPDFImageShaderKey::Hash> fImageShaderMap
+            SK_GUARDED_BY(fImageShaderMutex);
+    SkMutex fGradientPatternMutex;
     skia_private::THashMap<SkPDFGradientShader::Key,
                            SkPDFIndirectReference,
-                           SkPDFGradientShader::KeyHash> fGradientPatternMap;
-    skia_private::THashMap<SkBitmapKey, SkPDFIndirectReference> fPDFBitmapMap;
-    skia_private::THashMap<uint32_t, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics;
-    skia_private::THashMap<uint32_t, std::vector<SkString>> fType1GlyphNames;
-    skia_private::THashMap<uint32_t, std::vector<SkUnichar>> fToUnicodeMap;
-    skia_private::THashMap<uint32_t, SkPDFIndirectReference> fFontDescriptors;
-    skia_private::THashMap<uint32_t, SkPDFIndirectReference> fType3FontDescriptors;
-    skia_private::THashMap<uint64_t, SkPDFFont> fFontMap;
+                           SkPDFGradientShader::KeyHash> fGradientPatternMap
+            SK_GUARDED_BY(fGradientPatternMutex);
+    SkMutex fPDFBitmapMutex;
+    skia_private::THashMap<SkBitmapKey, SkPDFIndirectReference> fPDFBitmapMap
+            SK_GUARDED_BY(fPDFBitmapMutex);
+    // Content hashes map to the first object seen with them, and to what is needed to check that
+    // a later object with the same hash really has the same contents.
+    struct ImageContent {
+        sk_sp<const SkImage> fImage;
+        SkBitmapKey fKey;
+    };
+    struct FormXObjectContent {
+        sk_sp<SkData> fDict;
+        sk_sp<SkData> fContent;
+        SkPDFIndirectReference fRef;
+    };
+    SkMutex fImageContentMutex;
+    skia_private::THashMap<SkBitmapKey, SkBitmapKey> fCanonicalImageKeys
+            SK_GUARDED_BY(fImageContentMutex);
+    skia_private::THashMap<uint64_t, ImageContent> fImageContentMap
+            SK_GUARDED_BY(fImageContentMutex);
+    SkMutex fFormXObjectContentMutex;
+    skia_private::THashMap<uint64_t, FormXObjectContent> fFormXObjectContentMap
+            SK_GUARDED_BY(fFormXObjectContentMutex);
+    // Also guards the glyph usage of the fonts, and the subset tags.
+    SkMutex fFontMutex;
+    skia_private::THashMap<uint32_t, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics
+            SK_GUARDED_BY(fFontMutex);
+    skia_private::THashMap<uint32_t, std::vector<SkString>> fType1GlyphNames
+            SK_GUARDED_BY(fFontMutex);
+    skia_private::THashMap<uint32_t, std::unique_ptr<std::vector<SkUnichar>>> fToUnicodeMap
+            SK_GUARDED_BY(fFontMutex);
+    skia_private::THashMap<uint32_t, SkPDFIndirectReference> fFontDescriptors
+            SK_GUARDED_BY(fFontMutex);
+    skia_private::THashMap<uint32_t, SkPDFIndirectReference> fType3FontDescriptors
+            SK_GUARDED_BY(fFontMutex);
+    skia_private::THashMap<uint64_t, std::unique_ptr<SkPDFFont>> fFontMap
+            SK_GUARDED_BY(fFontMutex);
+    SkMutex fGraphicStateMutex;
     skia_private::THashMap<SkPDFStrokeGraphicState,
                            SkPDFIndirectReference,
-                           SkPDFStrokeGraphicState::Hash> fStrokeGSMap;
+                           SkPDFStrokeGraphicState::Hash> fStrokeGSMap
+            SK_GUARDED_BY(fGraphicStateMutex);
     skia_private::THashMap<SkPDFFillGraphicState,
                            SkPDFIndirectReference,
-                           SkPDFFillGraphicState::Hash> fFillGSMap;
-    SkPDFIndirectReference fInvertFunction;
-    SkPDFIndirectReference fNoSmaskGraphicState;
-    std::vector<std::unique_ptr<SkPDFLink>> fCurrentPageLinks;
-    std::vector<SkPDFNamedDestination> fNamedDestinations;
+                           SkPDFFillGraphicState::Hash> fFillGSMap
+            SK_GUARDED_BY(fGraphicStateMutex);
+    SkPDFIndirectReference fInvertFunction SK_GUARDED_BY(fGraphicStateMutex);
+    SkPDFIndirectReference fNoSmaskGraphicState SK_GUARDED_BY(fGraphicStateMutex);
 
 private:
     SkPDFOffsetMap fOffsetMap;
     SkCanvas fCanvas;
     std::vector<std::unique_ptr<SkPDFDict>> fPages;
     std::vector<SkPDFIndirectReference> fPageRefs;
+    std::vector<SkPDFNamedDestination> fNamedDestinations;
 
     sk_sp<SkPDFDevice> fPageDevice;
+    SkPDFPageState fPageState;  // Of the page begun with beginPage().
     std::atomic<int> fNextObjectNumber = {1};
+    std::atomic<int> fNextProvisionalReference = {kSkPDFFirstProvisionalReference};
     std::atomic<int> fJobCount = {0};
-    uint32_t fNextFontSubsetTag = {0};
+    uint32_t fNextFontSubsetTag SK_GUARDED_BY(fFontMutex) = {0};
+    // Typeface IDs, see tagSubsetFont().
+    std::vector<uint32_t> fUntaggedSubsetFonts SK_GUARDED_BY(fFontMutex);
     SkUUID fUUID;
     SkPDFIndirectReference fInfoDict;
     SkPDFIndirectReference fXMP;
@@ -181,16 +296,49 @@ private:
     SkScalar fRasterScale = 1;
     SkScalar fInverseRasterScale = 1;
     SkExecutor* fExecutor = nullptr;
+    const SkPDF::Compressor* fCompressor = nullptr;
 
     // For tagged PDFs.
-    SkPDFTagTree fTagTree;
+    SkMutex fTagTreeMutex;
+    SkPDFTagTree fTagTree SK_GUARDED_BY(fTagTreeMutex);
+
+    // Counts of content deduplication, reported to metadata().fDeduplicationStats on close.
+    SkMutex fStatsMutex;
+    SkPDF::DeduplicationStats fDeduplicationStats SK_GUARDED_BY(fStatsMutex);
 
     SkMutex fMutex;
+    std::unique_ptr<SkPDFPendingObjects> fPendingObjects SK_GUARDED_BY(fMutex);
     SkSemaphore fSemaphore;
 
+    // While pages are drawn concurrently, references are provisional and objects are deferred.
+    // Once any have been, all objects are renumbered as they are written.
+    bool fDeferring = false;
+    bool fRenumbering = false;
+    skia_private::THashMap<int, SkPDFDeferredObject> fDeferredObjects SK_GUARDED_BY(fMutex);
+    // Object numbers of the provisional references, or 0, and the references in the order they
+    // were numbered; those from fNextToWrite on may still have deferred objects to write.
+    std::vector<int> fObjectNumbers SK_GUARDED_BY(fMutex);
+    std::vector<int> fNumbered SK_GUARDED_BY(fMutex);
+    size_t fNextToWrite SK_GUARDED_BY(fMutex) = 0;
+
+    void beginDocument();
     void waitForJobs();
+    void emitObjectStream(std::unique_ptr<SkPDFPendingObjects>);
     SkWStream* beginObject(SkPDFIndirectReference);
     void endObject();
+
+    void emitRenumbered(SkPDFIndirectReference, sk_sp<SkData> object,
+                        std::unique_ptr<SkStreamAsset> streamData);
+    int numberObject(int reference) SK_REQUIRES(fMutex);
+    void renumber(const SkData& object, SkWStream* dst) SK_REQUIRES(fMutex);
+    void writeRenumbered(int number, const SkData& object, SkStreamAsset* streamData,
+                         std::vector<std::unique_ptr<SkPDFPendingObjects>>* fullStreams)
+            SK_REQUIRES(fMutex);
+    void writeNumberedObjects(std::vector<std::unique_ptr<SkPDFPendingObjects>>* fullStreams)
+            SK_REQUIRES(fMutex);
+    void commitPage(SkPDFPageState*, std::unique_ptr<SkPDFDict> page);
+    std::unique_ptr<SkPDFDict> makePage(SkPDFDevice*, const SkPDFPageState&);
+    void tagDeferredSubsetFonts();
 };
 
 #endif  // SkPDFDocumentPriv_DEFINED
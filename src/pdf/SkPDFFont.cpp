@@ -24,6 +24,7 @@
 #include "include/core/SkSurfaceProps.h"
 #include "include/core/SkTypes.h"
 #include "include/docs/SkPDFDocument.h"
+#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkBitmaskEnum.h"
 #include "src/base/SkUTF.h"
@@ -38,6 +39,7 @@
 #include "src/pdf/SkPDFDevice.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFFont.h"
+#include "src/pdf/SkPDFFontCache.h"
 #include "src/pdf/SkPDFFormXObject.h"
 #include "src/pdf/SkPDFMakeCIDGlyphWidthsArray.h"
 #include "src/pdf/SkPDFMakeToUnicodeCmap.h"
@@ -105,20 +107,9 @@ static bool can_embed(const SkAdvancedTypefaceMetrics& metrics) {
     return !SkToBool(metrics.fFlags & SkAdvancedTypefaceMetrics::kNotEmbeddable_FontFlag);
 }
 
-const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface* typeface,
-                                                       SkPDFDocument* canon) {
-    SkASSERT(typeface);
-    SkTypefaceID id = typeface->uniqueID();
-    if (std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id)) {
-        return ptr->get();  // canon retains ownership.
-    }
-    int count = typeface->countGlyphs();
-    if (count <= 0 || count > 1 + SkTo<int>(UINT16_MAX)) {
-        // Cache nullptr to skip this check.  Use SkSafeUnref().
-        canon->fTypefaceMetrics.set(id, nullptr);
-        return nullptr;
-    }
-    std::unique_ptr<SkAdvancedTypefaceMetrics> metrics = typeface->getAdvancedMetrics();
+// Fills in what the typeface's own metrics are missing.
+static std::unique_ptr<SkAdvancedTypefaceMetrics> complete_metrics(
+        std::unique_ptr<SkAdvancedTypefaceMetrics> metrics, const SkTypeface* typeface) {
     if (!metrics) {
         metrics = std::make_unique<SkAdvancedTypefaceMetrics>();
     }
@@ -152,8 +143,31 @@ const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface* typefac
             metrics->fCapHeight = SkToS16(SkScalarRoundToInt(capHeight / 2));
         }
     }
+    return metrics;
+}
+
+const SkAdvancedTypefaceMetrics* SkPDFFont::GetMetrics(const SkTypeface* typeface,
+                                                       SkPDFDocument* canon) {
+    SkASSERT(typeface);
+    SkAutoMutexExclusive lock(canon->fFontMutex);
+    SkTypefaceID id = typeface->uniqueID();
+    if (std::unique_ptr<SkAdvancedTypefaceMetrics>* ptr = canon->fTypefaceMetrics.find(id)) {
+        return ptr->get();  // canon retains ownership.
+    }
+    int count = typeface->countGlyphs();
+    if (count <= 0 || count > 1 + SkTo<int>(UINT16_MAX)) {
+        // Cache nullptr to skip this check.  Use SkSafeUnref().
+        canon->fTypefaceMetrics.set(id, nullptr);
+        return nullptr;
+    }
+    // Other documents may have already made them.
+    auto metrics = std::make_unique<SkAdvancedTypefaceMetrics>();
+    if (!SkPDFFontCache::FindMetrics(id, metrics.get())) {
+        metrics = complete_metrics(typeface->getAdvancedMetrics(), typeface);
+        SkPDFFontCache::AddMetrics(id, *metrics);
+    }
     // Fonts are always subset, so always prepend the subset tag.
-    metrics->fPostScriptName.prepend(canon->nextFontSubsetTag());
+    canon->tagSubsetFont(id, &metrics->fPostScriptName);
     return canon->fTypefaceMetrics.set(id, std::move(metrics))->get();
 }
 
@@ -161,13 +175,39 @@ const std::vector<SkUnichar>& SkPDFFont::GetUnicodeMap(const SkTypeface* typefac
                                                        SkPDFDocument* canon) {
     SkASSERT(typeface);
     SkASSERT(canon);
+    SkAutoMutexExclusive lock(canon->fFontMutex);
     SkTypefaceID id = typeface->uniqueID();
-    if (std::vector<SkUnichar>* ptr = canon->fToUnicodeMap.find(id)) {
-        return *ptr;
+    if (std::unique_ptr<std::vector<SkUnichar>>* ptr = canon->fToUnicodeMap.find(id)) {
+        return **ptr;
     }
-    std::vector<SkUnichar> buffer(typeface->countGlyphs());
-    typeface->getGlyphToUnicodeMap(buffer.data());
-    return *canon->fToUnicodeMap.set(id, std::move(buffer));
+    auto buffer = std::make_unique<std::vector<SkUnichar>>();
+    if (!SkPDFFontCache::FindUnicodeMap(id, buffer.get())) {
+        buffer->resize(typeface->countGlyphs());
+        typeface->getGlyphToUnicodeMap(buffer->data());
+        SkPDFFontCache::AddUnicodeMap(id, *buffer);
+    }
+    return **canon->fToUnicodeMap.set(id, std::move(buffer));
+}
+
+// SkPDFMakeToUnicodeCmap() for the font's glyphs up to lastGlyphID, shared between documents.
+static std::unique_ptr<SkStreamAsset> make_to_unicode_cmap(const SkPDFFont& font,
+                                                           bool multiByte,
+                                                           SkGlyphID lastGlyphID,
+                                                           SkPDFDocument* doc) {
+    SkTypefaceID id = font.typeface()->uniqueID();
+    const SkPDFGlyphUse& subset = font.glyphUsage();
+    if (sk_sp<SkData> cmap = SkPDFFontCache::FindToUnicodeCmap(id, subset, multiByte,
+                                                               lastGlyphID)) {
+        return SkMemoryStream::Make(std::move(cmap));
+    }
+    const std::vector<SkUnichar>& glyphToUnicode = SkPDFFont::GetUnicodeMap(font.typeface(), doc);
+    SkASSERT(SkToSizeT(font.typeface()->countGlyphs()) == glyphToUnicode.size());
+    std::unique_ptr<SkStreamAsset> cmap = SkPDFMakeToUnicodeCmap(glyphToUnicode.data(), &subset,
+                                                                 multiByte, font.firstGlyphID(),
+                                                                 lastGlyphID);
+    sk_sp<SkData> data = SkData::MakeFromStream(cmap.get(), cmap->getLength());
+    SkPDFFontCache::AddToUnicodeCmap(id, subset, multiByte, lastGlyphID, data);
+    return SkMemoryStream::Make(std::move(data));
 }
 
 SkAdvancedTypefaceMetrics::FontType SkPDFFont::FontType(const SkTypeface& typeface,
@@ -213,9 +253,10 @@ SkPDFFont* SkPDFFont::GetFontResource(SkPDFDocument* doc,
             multibyte ? 0 : first_nonzero_glyph_for_single_byte_encoding(glyph->getGlyphID());
     uint64_t typefaceID = (static_cast<uint64_t>(SkTypeface::UniqueID(face)) << 16) | subsetCode;
 
-    if (SkPDFFont* found = doc->fFontMap.find(typefaceID)) {
-        SkASSERT(multibyte == found->multiByteGlyphs());
-        return found;
+    SkAutoMutexExclusive lock(doc->fFontMutex);
+    if (std::unique_ptr<SkPDFFont>* found = doc->fFontMap.find(typefaceID)) {
+        SkASSERT(multibyte == (*found)->multiByteGlyphs());
+        return found->get();
     }
 
     sk_sp<SkTypeface> typeface(sk_ref_sp(face));
@@ -234,8 +275,8 @@ SkPDFFont* SkPDFFont::GetFontResource(SkPDFDocument* doc,
         lastGlyph = SkToU16(std::min<int>((int)lastGlyph, 254 + (int)subsetCode));
     }
     auto ref = doc->reserveRef();
-    return doc->fFontMap.set(
-            typefaceID, SkPDFFont(std::move(typeface), firstNonZeroGlyph, lastGlyph, type, ref));
+    return doc->fFontMap.set(typefaceID, std::unique_ptr<SkPDFFont>(new SkPDFFont(
+            std::move(typeface), firstNonZeroGlyph, lastGlyph, type, ref)))->get();
 }
 
 SkPDFFont::SkPDFFont(sk_sp<SkTypeface> typeface,
@@ -324,10 +365,18 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
                 if (!SkToBool(metrics.fFlags &
                               SkAdvancedTypefaceMetrics::kNotSubsettable_FontFlag)) {
                     SkASSERT(font.firstGlyphID() == 1);
-                    sk_sp<SkData> subsetFontData = SkPDFSubsetFont(
-                            stream_to_data(std::move(fontAsset)), font.glyphUsage(),
-                            doc->metadata().fSubsetter,
-                            metrics.fFontName.c_str(), ttcIndex);
+                    SkPDF::Metadata::Subsetter subsetter = doc->metadata().fSubsetter;
+                    sk_sp<SkData> subsetFontData = SkPDFFontCache::FindSubsetFont(
+                            face->uniqueID(), subsetter, font.glyphUsage());
+                    if (!subsetFontData) {
+                        subsetFontData = SkPDFSubsetFont(
+                                stream_to_data(std::move(fontAsset)), font.glyphUsage(),
+                                subsetter, metrics.fFontName.c_str(), ttcIndex);
+                        if (subsetFontData) {
+                            SkPDFFontCache::AddSubsetFont(face->uniqueID(), subsetter,
+                                                          font.glyphUsage(), subsetFontData);
+                        }
+                    }
                     if (subsetFontData) {
                         std::unique_ptr<SkPDFDict> tmp = SkPDFMakeDict();
                         tmp->insertInt("Length1", SkToInt(subsetFontData->size()));
@@ -407,15 +456,8 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     descendantFonts->appendRef(doc->emit(*newCIDFont));
     fontDict.insertObject("DescendantFonts", std::move(descendantFonts));
 
-    const std::vector<SkUnichar>& glyphToUnicode =
-        SkPDFFont::GetUnicodeMap(font.typeface(), doc);
-    SkASSERT(SkToSizeT(font.typeface()->countGlyphs()) == glyphToUnicode.size());
-    std::unique_ptr<SkStreamAsset> toUnicode =
-            SkPDFMakeToUnicodeCmap(glyphToUnicode.data(),
-                                   &font.glyphUsage(),
-                                   font.multiByteGlyphs(),
-                                   font.firstGlyphID(),
-                                   font.lastGlyphID());
+    std::unique_ptr<SkStreamAsset> toUnicode = make_to_unicode_cmap(font, font.multiByteGlyphs(),
+                                                                  font.lastGlyphID(), doc);
     fontDict.insertRef("ToUnicode", SkPDFStreamOut(nullptr, std::move(toUnicode), doc));
 
     doc->emit(fontDict, font.indirectReference());
@@ -504,8 +546,11 @@ static ImageAndOffset to_image(SkGlyphID gid, SkBulkGlyphMetricsAndImages* small
 static SkPDFIndirectReference type3_descriptor(SkPDFDocument* doc,
                                                const SkTypeface* typeface,
                                                SkScalar xHeight) {
-    if (SkPDFIndirectReference* ptr = doc->fType3FontDescriptors.find(typeface->uniqueID())) {
-        return *ptr;
+    {
+        SkAutoMutexExclusive lock(doc->fFontMutex);
+        if (SkPDFIndirectReference* ptr = doc->fType3FontDescriptors.find(typeface->uniqueID())) {
+            return *ptr;
+        }
     }
 
     SkPDFDict descriptor("FontDescriptor");
@@ -525,6 +570,7 @@ static SkPDFIndirectReference type3_descriptor(SkPDFDocument* doc,
     }
     descriptor.insertInt("Flags", fontDescriptorFlags);
     SkPDFIndirectReference ref = doc->emit(descriptor);
+    SkAutoMutexExclusive lock(doc->fFontMutex);
     doc->fType3FontDescriptors.set(typeface->uniqueID(), ref);
     return ref;
 }
@@ -688,13 +734,7 @@ static void emit_subset_type3(const SkPDFFont& pdfFont, SkPDFDocument* doc) {
 
     font.insertName("CIDToGIDMap", "Identity");
 
-    const std::vector<SkUnichar>& glyphToUnicode = SkPDFFont::GetUnicodeMap(typeface, doc);
-    SkASSERT(glyphToUnicode.size() == SkToSizeT(typeface->countGlyphs()));
-    auto toUnicodeCmap = SkPDFMakeToUnicodeCmap(glyphToUnicode.data(),
-                                                &subset,
-                                                false,
-                                                firstGlyphID,
-                                                lastGlyphID);
+    auto toUnicodeCmap = make_to_unicode_cmap(pdfFont, false, lastGlyphID, doc);
     font.insertRef("ToUnicode", SkPDFStreamOut(nullptr, std::move(toUnicodeCmap), doc));
     font.insertRef("FontDescriptor", type3_descriptor(doc, typeface, xHeight));
     font.insertObject("Widths", std::move(widthArray));
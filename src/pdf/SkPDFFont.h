@@ -72,6 +72,7 @@ public:
         return gid - this->firstGlyphID() + 1;
     }
 
+    // Requires the document's fFontMutex, since pages drawn concurrently share fonts.
     void noteGlyphUsage(SkGlyphID glyph) {
         SkASSERT(this->hasGlyph(glyph));
         fGlyphUsage.set(glyph);
@@ -0,0 +1,217 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/pdf/SkPDFFontCache.h"
+
+#include "include/private/base/SkTo.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkResourceCache.h"
+#include "src/pdf/SkPDFGlyphUse.h"
+
+#include <utility>
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+namespace {
+static unsigned gPDFFontKeyNamespaceLabel;
+
+enum class Kind : uint32_t {
+    kMetrics,
+    kUnicodeMap,
+    kType1GlyphNames,
+    kSubsetFont,
+    kToUnicodeCmap,
+    kGlyphAdvances,
+};
+
+// The glyphs used, led by the range they were allocated from.  Results that depend on the
+// glyphs are keyed by a hash of this, and the rec keeps it to rule out collisions.
+std::vector<SkGlyphID> glyph_list(const SkPDFGlyphUse* glyphUsage) {
+    std::vector<SkGlyphID> glyphs;
+    if (glyphUsage) {
+        glyphs.push_back(glyphUsage->firstNonZero());
+        glyphs.push_back(glyphUsage->lastGlyph());
+        glyphUsage->getSetValues([&glyphs](unsigned gid) { glyphs.push_back(SkToU16(gid)); });
+    }
+    return glyphs;
+}
+
+struct PDFFontKey : public SkResourceCache::Key {
+    PDFFontKey(SkTypefaceID typefaceID, Kind kind, uint32_t param,
+               const std::vector<SkGlyphID>& glyphs)
+        : fTypefaceID(typefaceID)
+        , fKind(static_cast<uint32_t>(kind))
+        , fParam(param) {
+        uint64_t hash = glyphs.empty()
+                      ? 0 : SkChecksum::Hash64(glyphs.data(), glyphs.size() * sizeof(SkGlyphID));
+        fGlyphsHashLo = static_cast<uint32_t>(hash);
+        fGlyphsHashHi = static_cast<uint32_t>(hash >> 32);
+        this->init(&gPDFFontKeyNamespaceLabel, 0,
+                   sizeof(fTypefaceID) + sizeof(fKind) + sizeof(fParam) +
+                   sizeof(fGlyphsHashLo) + sizeof(fGlyphsHashHi));
+    }
+
+    SkTypefaceID fTypefaceID;
+    uint32_t fKind;
+    uint32_t fParam;
+    uint32_t fGlyphsHashLo;
+    uint32_t fGlyphsHashHi;
+};
+
+size_t value_bytes(const SkAdvancedTypefaceMetrics& metrics) {
+    return metrics.fPostScriptName.size() + metrics.fFontName.size();
+}
+size_t value_bytes(const std::vector<SkUnichar>& v) { return v.size() * sizeof(SkUnichar); }
+size_t value_bytes(const std::vector<SkScalar>& v) { return v.size() * sizeof(SkScalar); }
+size_t value_bytes(const std::vector<SkString>& v) {
+    size_t bytes = v.size() * sizeof(SkString);
+    for (const SkString& s : v) {
+        bytes += s.size();
+    }
+    return bytes;
+}
+size_t value_bytes(const sk_sp<SkData>& data) { return data->size(); }
+
+template <typename T>
+struct PDFFontRec : public SkResourceCache::Rec {
+    PDFFontRec(const PDFFontKey& key, std::vector<SkGlyphID> glyphs, T value)
+        : fKey(key)
+        , fGlyphs(std::move(glyphs))
+        , fValue(std::move(value)) {}
+
+    PDFFontKey fKey;
+    std::vector<SkGlyphID> fGlyphs;
+    T fValue;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fGlyphs.size() * sizeof(SkGlyphID) + value_bytes(fValue);
+    }
+    const char* getCategory() const override { return "pdf-font"; }
+
+    struct Context {
+        const std::vector<SkGlyphID>* fGlyphs;
+        T* fValue;
+    };
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const PDFFontRec& rec = static_cast<const PDFFontRec&>(baseRec);
+        Context* context = static_cast<Context*>(contextData);
+        if (rec.fGlyphs != *context->fGlyphs) {
+            return false;  // A hash collision; let the cache replace it.
+        }
+        *context->fValue = rec.fValue;
+        return true;
+    }
+};
+
+template <typename T>
+bool find(SkTypefaceID typefaceID, Kind kind, uint32_t param, const SkPDFGlyphUse* glyphUsage,
+          T* value, SkResourceCache* localCache) {
+    std::vector<SkGlyphID> glyphs = glyph_list(glyphUsage);
+    typename PDFFontRec<T>::Context context{&glyphs, value};
+    return CHECK_LOCAL(localCache, find, Find, PDFFontKey(typefaceID, kind, param, glyphs),
+                       PDFFontRec<T>::Visitor, &context);
+}
+
+template <typename T>
+void add(SkTypefaceID typefaceID, Kind kind, uint32_t param, const SkPDFGlyphUse* glyphUsage,
+         T value, SkResourceCache* localCache) {
+    // Like scaled images, skip anything too large to cache without flushing most of the cache.
+    size_t limit = CHECK_LOCAL(localCache, getEffectiveSingleAllocationByteLimit,
+                               GetEffectiveSingleAllocationByteLimit);
+    if (limit && value_bytes(value) > limit) {
+        return;
+    }
+    std::vector<SkGlyphID> glyphs = glyph_list(glyphUsage);
+    PDFFontKey key(typefaceID, kind, param, glyphs);
+    CHECK_LOCAL(localCache, add, Add, new PDFFontRec<T>(key, std::move(glyphs), std::move(value)));
+}
+
+uint32_t cmap_param(bool multiByteGlyphs, SkGlyphID lastGlyphID) {
+    return (static_cast<uint32_t>(lastGlyphID) << 1) | (multiByteGlyphs ? 1 : 0);
+}
+}  // namespace
+
+bool SkPDFFontCache::FindMetrics(SkTypefaceID id, SkAdvancedTypefaceMetrics* metrics,
+                                 SkResourceCache* localCache) {
+    return find(id, Kind::kMetrics, 0, nullptr, metrics, localCache);
+}
+
+void SkPDFFontCache::AddMetrics(SkTypefaceID id, const SkAdvancedTypefaceMetrics& metrics,
+                                SkResourceCache* localCache) {
+    add(id, Kind::kMetrics, 0, nullptr, metrics, localCache);
+}
+
+bool SkPDFFontCache::FindUnicodeMap(SkTypefaceID id, std::vector<SkUnichar>* map,
+                                    SkResourceCache* localCache) {
+    return find(id, Kind::kUnicodeMap, 0, nullptr, map, localCache);
+}
+
+void SkPDFFontCache::AddUnicodeMap(SkTypefaceID id, const std::vector<SkUnichar>& map,
+                                   SkResourceCache* localCache) {
+    add(id, Kind::kUnicodeMap, 0, nullptr, map, localCache);
+}
+
+bool SkPDFFontCache::FindType1GlyphNames(SkTypefaceID id, std::vector<SkString>* names,
+                                         SkResourceCache* localCache) {
+    return find(id, Kind::kType1GlyphNames, 0, nullptr, names, localCache);
+}
+
+void SkPDFFontCache::AddType1GlyphNames(SkTypefaceID id, const std::vector<SkString>& names,
+                                        SkResourceCache* localCache) {
+    add(id, Kind::kType1GlyphNames, 0, nullptr, names, localCache);
+}
+
+sk_sp<SkData> SkPDFFontCache::FindSubsetFont(SkTypefaceID id,
+                                             SkPDF::Metadata::Subsetter subsetter,
+                                             const SkPDFGlyphUse& glyphUsage,
+                                             SkResourceCache* localCache) {
+    sk_sp<SkData> data;
+    find(id, Kind::kSubsetFont, static_cast<uint32_t>(subsetter), &glyphUsage, &data, localCache);
+    return data;
+}
+
+void SkPDFFontCache::AddSubsetFont(SkTypefaceID id, SkPDF::Metadata::Subsetter subsetter,
+                                   const SkPDFGlyphUse& glyphUsage, sk_sp<SkData> data,
+                                   SkResourceCache* localCache) {
+    SkASSERT(data);
+    add(id, Kind::kSubsetFont, static_cast<uint32_t>(subsetter), &glyphUsage, std::move(data),
+        localCache);
+}
+
+sk_sp<SkData> SkPDFFontCache::FindToUnicodeCmap(SkTypefaceID id,
+                                                const SkPDFGlyphUse& glyphUsage,
+                                                bool multiByteGlyphs,
+                                                SkGlyphID lastGlyphID,
+                                                SkResourceCache* localCache) {
+    sk_sp<SkData> data;
+    find(id, Kind::kToUnicodeCmap, cmap_param(multiByteGlyphs, lastGlyphID), &glyphUsage, &data,
+         localCache);
+    return data;
+}
+
+void SkPDFFontCache::AddToUnicodeCmap(SkTypefaceID id, const SkPDFGlyphUse& glyphUsage,
+                                      bool multiByteGlyphs, SkGlyphID lastGlyphID,
+                                      sk_sp<SkData> data, SkResourceCache* localCache) {
+    SkASSERT(data);
+    add(id, Kind::kToUnicodeCmap, cmap_param(multiByteGlyphs, lastGlyphID), &glyphUsage,
+        std::move(data), localCache);
+}
+
+bool SkPDFFontCache::FindGlyphAdvances(SkTypefaceID id, const SkPDFGlyphUse& glyphUsage,
+                                       std::vector<SkScalar>* advances,
+                                       SkResourceCache* localCache) {
+    return find(id, Kind::kGlyphAdvances, 0, &glyphUsage, advances, localCache);
+}
+
+void SkPDFFontCache::AddGlyphAdvances(SkTypefaceID id, const SkPDFGlyphUse& glyphUsage,
+                                      const std::vector<SkScalar>& advances,
+                                      SkResourceCache* localCache) {
+    add(id, Kind::kGlyphAdvances, 0, &glyphUsage, advances, localCache);
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPDFFontCache_DEFINED
+#define SkPDFFontCache_DEFINED
+
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkScalar.h"
+#include "include/core/SkString.h"
+#include "include/core/SkTypeface.h"
+#include "include/core/SkTypes.h"
+#include "include/docs/SkPDFDocument.h"
+#include "src/core/SkAdvancedTypefaceMetrics.h"
+
+#include <vector>
+
+class SkPDFGlyphUse;
+class SkResourceCache;
+
+/**
+ *  Shares what SkPDF derives from a typeface between documents, so that a process writing many
+ *  PDFs with the same fonts queries and subsets each font once. Entries are keyed by typeface ID
+ *  and, for results that depend on it, the set of glyphs used.
+ *
+ *  The entries live in the global SkResourceCache, under the "pdf-font" category. They count
+ *  against SkGraphics::GetResourceCacheTotalByteLimit(), are included in
+ *  SkGraphics::GetResourceCacheTotalBytesUsed() and SkGraphics::DumpMemoryStatistics(), and are
+ *  freed by SkGraphics::PurgeResourceCache().
+ *
+ *  Find functions return false (or nullptr) if the entry is not in the cache. Each function
+ *  takes an optional localCache, to use instead of the global one.
+ */
+class SkPDFFontCache {
+public:
+    /** Metrics as SkPDFFont::GetMetrics() computes them, before the document's subset tag. */
+    static bool FindMetrics(SkTypefaceID, SkAdvancedTypefaceMetrics*,
+                            SkResourceCache* localCache = nullptr);
+    static void AddMetrics(SkTypefaceID, const SkAdvancedTypefaceMetrics&,
+                           SkResourceCache* localCache = nullptr);
+
+    /** The typeface's glyph to unicode map. */
+    static bool FindUnicodeMap(SkTypefaceID, std::vector<SkUnichar>*,
+                               SkResourceCache* localCache = nullptr);
+    static void AddUnicodeMap(SkTypefaceID, const std::vector<SkUnichar>&,
+                              SkResourceCache* localCache = nullptr);
+
+    /** The typeface's PostScript glyph names, for Type1 fonts. */
+    static bool FindType1GlyphNames(SkTypefaceID, std::vector<SkString>*,
+                                    SkResourceCache* localCache = nullptr);
+    static void AddType1GlyphNames(SkTypefaceID, const std::vector<SkString>&,
+                                   SkResourceCache* localCache = nullptr);
+
+    /** The font program subset to the glyphs used, as SkPDFSubsetFont() returns it. */
+    static sk_sp<SkData> FindSubsetFont(SkTypefaceID, SkPDF::Metadata::Subsetter,
+                                        const SkPDFGlyphUse&, SkResourceCache* localCache = nullptr);
+    static void AddSubsetFont(SkTypefaceID, SkPDF::Metadata::Subsetter, const SkPDFGlyphUse&,
+                              sk_sp<SkData>, SkResourceCache* localCache = nullptr);
+
+    /** The ToUnicode CMap stream for the glyphs used, as SkPDFMakeToUnicodeCmap() writes it for
+        glyphs from glyphUsage.firstNonZero() to lastGlyphID. */
+    static sk_sp<SkData> FindToUnicodeCmap(SkTypefaceID, const SkPDFGlyphUse&,
+                                           bool multiByteGlyphs, SkGlyphID lastGlyphID,
+                                           SkResourceCache* localCache = nullptr);
+    static void AddToUnicodeCmap(SkTypefaceID, const SkPDFGlyphUse&, bool multiByteGlyphs,
+                                 SkGlyphID lastGlyphID, sk_sp<SkData>,
+                                 SkResourceCache* localCache = nullptr);
+
+    /** The advances of the glyphs used, in order, in PDF's 1000 units per em. */
+    static bool FindGlyphAdvances(SkTypefaceID, const SkPDFGlyphUse&, std::vector<SkScalar>*,
+                                  SkResourceCache* localCache = nullptr);
+    static void AddGlyphAdvances(SkTypefaceID, const SkPDFGlyphUse&,
+                                 const std::vector<SkScalar>&,
+                                 SkResourceCache* localCache = nullptr);
+};
+
+#endif  // SkPDFFontCache_DEFINED
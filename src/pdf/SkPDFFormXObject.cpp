@@ -7,6 +7,13 @@
 
 
 #include "src/pdf/SkPDFFormXObject.h"
+
+#include "include/core/SkData.h"
+#include "include/core/SkStream.h"
+#include "include/private/base/SkMutex.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkStreamPriv.h"
+#include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFUtils.h"
 
 SkPDFIndirectReference SkPDFMakeFormXObject(SkPDFDocument* doc,
@@ -35,5 +42,32 @@ SkPDFIndirectReference SkPDFMakeFormXObject(SkPDFDocument* doc,
     }
     group->insertBool("I", true);  // Isolated.
     dict->insertObject("Group", std::move(group));
-    return SkPDFStreamOut(std::move(dict), std::move(content), doc);
+
+    if (!doc->metadata().fDeduplicateByContent) {
+        return SkPDFStreamOut(std::move(dict), std::move(content), doc);
+    }
+    // The resources refer to canonicalized objects, so identical drawings give identical bytes.
+    // The dictionary and content stream are everything that is written for a form XObject; they
+    // are kept, so that a hash match is only trusted when the bytes match too.
+    SkDynamicMemoryWStream dictBytes;
+    dict->emitObject(&dictBytes);
+    sk_sp<SkData> dictData = dictBytes.detachAsData();
+    sk_sp<SkData> contentData = SkCopyStreamToData(content.get());
+    uint64_t hash = SkChecksum::Hash64(dictData->data(), dictData->size());
+    hash = SkChecksum::Hash64(contentData->data(), contentData->size(), hash);
+
+    doc->countDeduplication(&SkPDF::DeduplicationStats::fFormXObjectsHashed);
+    SkAutoMutexExclusive lock(doc->fFormXObjectContentMutex);
+    if (const auto* first = doc->fFormXObjectContentMap.find(hash)) {
+        if (first->fDict->equals(dictData.get()) && first->fContent->equals(contentData.get())) {
+            doc->countDeduplication(&SkPDF::DeduplicationStats::fFormXObjectHits);
+            return first->fRef;
+        }
+        // A hash collision is written out on its own, and the first form XObject stays mapped.
+        return SkPDFStreamOut(std::move(dict), SkMemoryStream::Make(std::move(contentData)), doc);
+    }
+    SkPDFIndirectReference ref = SkPDFStreamOut(std::move(dict), SkMemoryStream::Make(contentData),
+                                                doc);
+    doc->fFormXObjectContentMap.set(hash, {std::move(dictData), std::move(contentData), ref});
+    return ref;
 }
@@ -9,6 +9,7 @@
 
 #include "include/core/SkTileMode.h"
 #include "include/docs/SkPDFDocument.h"
+#include "include/private/base/SkMutex.h"
 #include "src/core/SkChecksum.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFFormXObject.h"
@@ -844,6 +845,7 @@ static SkPDFIndirectReference find_pdf_shader(SkPDFDocument* doc,
                                               SkPDFGradientShader::Key key,
                                               bool keyHasAlpha);
 
+// The resources of the pattern fill content below, each named with key 0.
 static std::unique_ptr<SkPDFDict> get_gradient_resource_dict(SkPDFIndirectReference functionShader,
                                                    SkPDFIndirectReference gState) {
     std::vector<SkPDFIndirectReference> patternShaders;
@@ -922,7 +924,7 @@ static SkPDFIndirectReference create_smask_graphic_state(SkPDFDocument* doc,
     SkRect bbox = SkRect::Make(state.fBBox);
     SkPDFIndirectReference alphaMask =
             SkPDFMakeFormXObject(doc,
-                                 create_pattern_fill_content(-1, luminosityShader.fValue, bbox),
+                                 create_pattern_fill_content(-1, 0, bbox),
                                  SkPDFUtils::RectToArray(bbox),
                                  std::move(resources),
                                  SkMatrix::I(),
@@ -953,7 +955,7 @@ static SkPDFIndirectReference make_alpha_function_shader(SkPDFDocument* doc,
     std::unique_ptr<SkPDFDict> resourceDict = get_gradient_resource_dict(colorShader, alphaGsRef);
 
     std::unique_ptr<SkStreamAsset> colorStream =
-            create_pattern_fill_content(alphaGsRef.fValue, colorShader.fValue, bbox);
+            create_pattern_fill_content(0, 0, bbox);
     std::unique_ptr<SkPDFDict> alphaFunctionShader = SkPDFMakeDict();
     SkPDFUtils::PopulateTilingPatternDict(alphaFunctionShader.get(), bbox,
                                  std::move(resourceDict), SkMatrix::I());
@@ -987,17 +989,24 @@ static SkPDFIndirectReference find_pdf_shader(SkPDFDocument* doc,
                                               SkPDFGradientShader::Key key,
                                               bool keyHasAlpha) {
     SkASSERT(gradient_has_alpha(key) == keyHasAlpha);
-    auto& gradientPatternMap = doc->fGradientPatternMap;
-    if (SkPDFIndirectReference* ptr = gradientPatternMap.find(key)) {
-        return *ptr;
+    {
+        SkAutoMutexExclusive lock(doc->fGradientPatternMutex);
+        if (SkPDFIndirectReference* ptr = doc->fGradientPatternMap.find(key)) {
+            return *ptr;
+        }
     }
+    // Made without holding the lock, since an alpha gradient looks up its opaque parts.
     SkPDFIndirectReference pdfShader;
     if (keyHasAlpha) {
         pdfShader = make_alpha_function_shader(doc, key);
     } else {
         pdfShader = make_function_shader(doc, key);
     }
-    gradientPatternMap.set(std::move(key), pdfShader);
+    SkAutoMutexExclusive lock(doc->fGradientPatternMutex);
+    if (SkPDFIndirectReference* first = doc->fGradientPatternMap.find(key)) {
+        return *first;
+    }
+    doc->fGradientPatternMap.set(std::move(key), pdfShader);
     return pdfShader;
 }
 
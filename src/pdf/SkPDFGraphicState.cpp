@@ -10,6 +10,7 @@
 #include "include/core/SkData.h"
 #include "include/core/SkPaint.h"
 #include "include/docs/SkPDFDocument.h"
+#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTo.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFFormXObject.h"
@@ -57,6 +58,7 @@ SkPDFIndirectReference SkPDFGraphicState::GetGraphicStateForPaint(SkPDFDocument*
                                                                   const SkPaint& p) {
     SkASSERT(doc);
     const SkBlendMode mode = p.getBlendMode_or(SkBlendMode::kSrcOver);
+    SkAutoMutexExclusive lock(doc->fGraphicStateMutex);
 
     if (SkPaint::kFill_Style == p.getStyle()) {
         SkPDFFillGraphicState fillKey = {p.getColor4f().fA, pdf_blend_mode(mode)};
@@ -131,6 +133,7 @@ SkPDFIndirectReference SkPDFGraphicState::GetSMaskGraphicState(SkPDFIndirectRefe
     sMaskDict->insertRef("G", sMask);
     if (invert) {
         // let the doc deduplicate this object.
+        SkAutoMutexExclusive lock(doc->fGraphicStateMutex);
         if (doc->fInvertFunction == SkPDFIndirectReference()) {
             doc->fInvertFunction = make_invert_function(doc);
         }
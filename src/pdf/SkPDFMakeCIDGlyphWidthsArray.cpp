@@ -11,6 +11,7 @@
 #include "include/private/base/SkTo.h"
 #include "src/core/SkStrike.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/pdf/SkPDFFontCache.h"
 #include "src/pdf/SkPDFGlyphUse.h"
 
 #include <algorithm>
@@ -85,41 +86,46 @@ std::unique_ptr<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(const SkTypeface& typef
     //  f. Switching for 3+ repeats wins                      " adv.ances adv.ances adv.ances"
     //     rule: end range for 3+ repeats
 
-    int emSize;
-    SkStrikeSpec strikeSpec = SkStrikeSpec::MakePDFVector(typeface, &emSize);
-    SkBulkGlyphMetricsAndPaths paths{strikeSpec};
-
     auto result = SkPDFMakeArray();
 
     std::vector<SkGlyphID> glyphIDs;
     subset.getSetValues([&](unsigned index) {
         glyphIDs.push_back(SkToU16(index));
     });
-    auto glyphs = paths.glyphs(SkSpan(glyphIDs));
 
-    // C++20 = make_unique_for_overwrite<SkScalar[]>(glyphs.size());
-    auto advances = std::unique_ptr<SkScalar[]>(new SkScalar[glyphs.size()]);
+    // Measuring the glyphs is the expensive part, so the pdf advances are shared between
+    // documents.
+    std::vector<SkScalar> advances;
+    if (!SkPDFFontCache::FindGlyphAdvances(typeface.uniqueID(), subset, &advances)) {
+        int emSize;
+        SkStrikeSpec strikeSpec = SkStrikeSpec::MakePDFVector(typeface, &emSize);
+        SkBulkGlyphMetricsAndPaths paths{strikeSpec};
+        auto glyphs = paths.glyphs(SkSpan(glyphIDs));
+        advances.reserve(glyphs.size());
+        for (const SkGlyph* glyph : glyphs) {
+            advances.push_back(from_font_units(glyph->advanceX(), emSize));
+        }
+        SkPDFFontCache::AddGlyphAdvances(typeface.uniqueID(), subset, advances);
+    }
+    SkASSERT(advances.size() == glyphIDs.size());
+
+    // C++20 = make_unique_for_overwrite<SkScalar[]>(advances.size());
+    auto intAdvances = std::unique_ptr<SkScalar[]>(new SkScalar[advances.size()]);
 
     // Find the pdf integer mode (most common pdf integer advance).
     // Unfortunately, poppler enforces DW (default width) must be an integer,
     // so only consider integer pdf advances when finding the mode.
     size_t numIntAdvances = 0;
-    for (const SkGlyph* glyph : glyphs) {
-        SkScalar currentAdvance = from_font_units(glyph->advanceX(), emSize);
+    for (SkScalar currentAdvance : advances) {
         if ((int32_t)currentAdvance == currentAdvance) {
-            advances[numIntAdvances++] = currentAdvance;
+            intAdvances[numIntAdvances++] = currentAdvance;
         }
     }
-    std::sort(advances.get(), advances.get() + numIntAdvances);
-    int32_t modeAdvance = (int32_t)find_mode_or_0(SkSpan(advances.get(), numIntAdvances));
+    std::sort(intAdvances.get(), intAdvances.get() + numIntAdvances);
+    int32_t modeAdvance = (int32_t)find_mode_or_0(SkSpan(intAdvances.get(), numIntAdvances));
     *defaultAdvance = modeAdvance;
 
-    // Pre-convert to pdf advances.
-    for (size_t i = 0; i < glyphs.size(); ++i) {
-        advances[i] = from_font_units(glyphs[i]->advanceX(), emSize);
-    }
-
-    for (size_t i = 0; i < glyphs.size(); ++i) {
+    for (size_t i = 0; i < glyphIDs.size(); ++i) {
         SkScalar advance = advances[i];
 
         // a. Skipping don't cares or defaults is a win (trivial)
@@ -130,15 +136,15 @@ std::unique_ptr<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(const SkTypeface& typef
         // b. 2+ repeats create run as long as possible, else start range
         {
             size_t j = i + 1; // j is always one past the last known repeat
-            for (; j < glyphs.size(); ++j) {
+            for (; j < glyphIDs.size(); ++j) {
                 SkScalar next_advance = advances[j];
                 if (advance != next_advance) {
                     break;
                 }
             }
             if (j - i >= 2) {
-                result->appendInt(glyphs[i]->getGlyphID());
-                result->appendInt(glyphs[j - 1]->getGlyphID());
+                result->appendInt(glyphIDs[i]);
+                result->appendInt(glyphIDs[j - 1]);
                 result->appendScalar(advance);
                 i = j - 1;
                 continue;
@@ -146,11 +152,11 @@ std::unique_ptr<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(const SkTypeface& typef
         }
 
         {
-            result->appendInt(glyphs[i]->getGlyphID());
+            result->appendInt(glyphIDs[i]);
             auto advanceArray = SkPDFMakeArray();
             advanceArray->appendScalar(advance);
             size_t j = i + 1; // j is always one past the last output
-            for (; j < glyphs.size(); ++j) {
+            for (; j < glyphIDs.size(); ++j) {
                 advance = advances[j];
 
                 // c. end range if default seen
@@ -158,7 +164,7 @@ std::unique_ptr<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(const SkTypeface& typef
                     break;
                 }
 
-                int dontCares = glyphs[j]->getGlyphID() - glyphs[j - 1]->getGlyphID() - 1;
+                int dontCares = glyphIDs[j] - glyphIDs[j - 1] - 1;
                 // d. end range if 4+ don't cares
                 if (dontCares >= 4) {
                     break;
@@ -166,16 +172,16 @@ std::unique_ptr<SkPDFArray> SkPDFMakeCIDGlyphWidthsArray(const SkTypeface& typef
 
                 SkScalar next_advance = 0;
                 // e. end range for 2+ repeats with 4+ don't cares
-                if (j + 1 < glyphs.size()) {
+                if (j + 1 < glyphIDs.size()) {
                     next_advance = advances[j+1];
-                    int next_dontCares = glyphs[j+1]->getGlyphID() - glyphs[j]->getGlyphID() - 1;
+                    int next_dontCares = glyphIDs[j+1] - glyphIDs[j] - 1;
                     if (advance == next_advance && dontCares + next_dontCares >= 4) {
                         break;
                     }
                 }
 
                 // f. end range for 3+ repeats
-                if (j + 2 < glyphs.size() && advance == next_advance) {
+                if (j + 2 < glyphIDs.size() && advance == next_advance) {
                     next_advance = advances[j+2];
                     if (advance == next_advance) {
                         break;
@@ -6,6 +6,7 @@
  */
 
 #include "include/core/SkStream.h"
+#include "include/private/base/SkTo.h"
 #include "src/pdf/SkPDFResourceDict.h"
 #include "src/pdf/SkPDFTypes.h"
 
@@ -42,6 +43,21 @@ void SkPDFWriteResourceName(SkWStream* dst, SkPDFResourceType type, int key) {
     dst->write(buffer, (size_t)(end - buffer));
 }
 
+int SkPDFResourceList::add(SkPDFIndirectReference ref) {
+    if (const int* key = fKeys.find(ref)) {
+        return *key;
+    }
+    int key = SkToInt(fRefs.size());
+    fKeys.set(ref, key);
+    fRefs.push_back(ref);
+    return key;
+}
+
+void SkPDFResourceList::reset() {
+    fKeys.reset();
+    fRefs.clear();
+}
+
 static const char* resource_name(SkPDFResourceType type) {
     static const char* kResourceTypeNames[] = {
         "ExtGState",
@@ -64,8 +80,8 @@ static void add_subdict(const std::vector<SkPDFIndirectReference>& resourceList,
                         SkPDFDict* dst) {
     if (!resourceList.empty()) {
         auto resources = SkPDFMakeDict();
-        for (SkPDFIndirectReference ref : resourceList) {
-            resources->insertRef(resource(type, ref.fValue), ref);
+        for (size_t i = 0; i < resourceList.size(); ++i) {
+            resources->insertRef(resource(type, SkToInt(i)), resourceList[i]);
         }
         dst->insertObject(resource_name(type), std::move(resources));
     }
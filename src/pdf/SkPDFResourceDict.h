@@ -8,6 +8,7 @@
 #ifndef SkPDFResourceDict_DEFINED
 #define SkPDFResourceDict_DEFINED
 
+#include "src/core/SkTHash.h"
 #include "src/pdf/SkPDFFont.h"
 
 #include <vector>
@@ -25,12 +26,28 @@ enum class SkPDFResourceType {
     // currently used by Skia: ColorSpace, Shading, Properties
 };
 
+/** The resources of one type used by a content stream.  Each is named by
+ *  the order in which it was first used, rather than by its object number,
+ *  so that the content does not depend on how objects are numbered.
+ */
+class SkPDFResourceList {
+public:
+    /** Returns the key of the resource's name, adding it if needed. */
+    int add(SkPDFIndirectReference ref);
+    /** The resources, in the order of their keys. */
+    const std::vector<SkPDFIndirectReference>& refs() const { return fRefs; }
+    void reset();
+
+private:
+    skia_private::THashMap<SkPDFIndirectReference, int> fKeys;
+    std::vector<SkPDFIndirectReference> fRefs;
+};
 
 /** Create a PDF resource dictionary.
  *  The full set of ProcSet entries is automatically created for backwards
  *  compatibility, as recommended by the PDF spec.
  *
- *  Any arguments can be nullptr.
+ *  Each resource is named by its index in its list.
  */
 std::unique_ptr<SkPDFDict> SkPDFMakeResourceDict(
         const std::vector<SkPDFIndirectReference>& graphicStateResources,
@@ -43,7 +60,7 @@ std::unique_ptr<SkPDFDict> SkPDFMakeResourceDict(
  * dict.
  *
  *  @param type  The type of resource being entered
- *  @param key   The resource key, should be unique within its type.
+ *  @param key   The resource key, its index in the list of its type.
  */
 void SkPDFWriteResourceName(SkWStream*, SkPDFResourceType type, int key);
 
@@ -14,6 +14,7 @@
 #include "include/core/SkTileMode.h"
 #include "include/docs/SkPDFDocument.h"
 #include "include/private/base/SkMath.h"
+#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTPin.h"
 #include "include/private/base/SkTemplates.h"
 #include "src/pdf/SkPDFDevice.h"
@@ -342,17 +343,28 @@ SkPDFIndirectReference SkPDFMakeShader(SkPDFDocument* doc,
     SkTileMode imageTileModes[2];
     if (SkImage* skimg = shader->isAImage(&shaderTransform, imageTileModes)) {
         SkMatrix finalMatrix = SkMatrix::Concat(canvasTransform, shaderTransform);
+        SkBitmapKey imageKey = SkBitmapKeyFromImage(skimg);
         SkPDFImageShaderKey key = {
             finalMatrix,
             surfaceBBox,
-            SkBitmapKeyFromImage(skimg),
+            doc->canonicalImageKey(skimg, imageKey),
             {imageTileModes[0], imageTileModes[1]},
             paintColor};
-        SkPDFIndirectReference* shaderPtr = doc->fImageShaderMap.find(key);
-        if (shaderPtr) {
-            return *shaderPtr;
+        SkPDFIndirectReference pdfShader;
+        {
+            SkAutoMutexExclusive lock(doc->fImageShaderMutex);
+            if (SkPDFIndirectReference* shaderPtr = doc->fImageShaderMap.find(key)) {
+                pdfShader = *shaderPtr;
+            }
+        }
+        if (pdfShader) {
+            if (key.fBitmapKey != imageKey) {
+                doc->countDeduplication(&SkPDF::DeduplicationStats::fImagePatternHits);
+            }
+            return pdfShader;
         }
-        SkPDFIndirectReference pdfShader =
+        // Made without holding the lock, since making the pattern draws its image.
+        pdfShader =
                 make_image_shader(doc,
                                   finalMatrix,
                                   imageTileModes[0],
@@ -360,6 +372,10 @@ SkPDFIndirectReference SkPDFMakeShader(SkPDFDocument* doc,
                                   SkRect::Make(surfaceBBox),
                                   skimg,
                                   paintColor);
+        SkAutoMutexExclusive lock(doc->fImageShaderMutex);
+        if (SkPDFIndirectReference* first = doc->fImageShaderMap.find(key)) {
+            return *first;
+        }
         doc->fImageShaderMap.set(std::move(key), pdfShader);
         return pdfShader;
     }
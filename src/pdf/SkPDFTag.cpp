@@ -8,6 +8,8 @@
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFTag.h"
 
+#include <algorithm>
+
 using namespace skia_private;
 
 // The struct parent tree consists of one entry per page, followed by
@@ -234,6 +236,13 @@ SkPDFIndirectReference SkPDFTagTree::PrepareTagTreeToEmit(SkPDFIndirectReference
             kids->appendRef(PrepareTagTreeToEmit(ref, child, doc));
         }
     }
+    // Pages drawn concurrently mark content in any order.
+    std::sort(node->fMarkedContent.begin(), node->fMarkedContent.end(),
+              [](const SkPDFTagNode::MarkedContentInfo& u,
+                 const SkPDFTagNode::MarkedContentInfo& v) {
+                  return u.fPageIndex != v.fPageIndex ? u.fPageIndex < v.fPageIndex
+                                                      : u.fMarkId < v.fMarkId;
+              });
     for (const SkPDFTagNode::MarkedContentInfo& info : node->fMarkedContent) {
         std::unique_ptr<SkPDFDict> mcr = SkPDFMakeDict("MCR");
         mcr->insertRef("Pg", doc->getPage(info.fPageIndex));
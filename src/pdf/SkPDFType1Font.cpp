@@ -3,10 +3,12 @@
 
 #include "src/pdf/SkPDFType1Font.h"
 
+#include "include/private/base/SkMutex.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
 #include "src/core/SkStrike.h"
 #include "src/core/SkStrikeSpec.h"
+#include "src/pdf/SkPDFFontCache.h"
 
 #include <ctype.h>
 
@@ -261,10 +263,15 @@ static SkPDFIndirectReference make_type1_font_descriptor(SkPDFDocument* doc,
 static const std::vector<SkString>& type_1_glyphnames(SkPDFDocument* canon,
                                                       const SkTypeface* typeface) {
     SkTypefaceID typefaceID = typeface->uniqueID();
+    SkAutoMutexExclusive lock(canon->fFontMutex);
     const std::vector<SkString>* glyphNames = canon->fType1GlyphNames.find(typefaceID);
     if (!glyphNames) {
-        std::vector<SkString> names(typeface->countGlyphs());
-        SkPDFFont::GetType1GlyphNames(*typeface, names.data());
+        std::vector<SkString> names;
+        if (!SkPDFFontCache::FindType1GlyphNames(typefaceID, &names)) {
+            names.resize(typeface->countGlyphs());
+            SkPDFFont::GetType1GlyphNames(*typeface, names.data());
+            SkPDFFontCache::AddType1GlyphNames(typefaceID, names);
+        }
         glyphNames = canon->fType1GlyphNames.set(typefaceID, std::move(names));
     }
     SkASSERT(glyphNames);
@@ -274,11 +281,15 @@ static const std::vector<SkString>& type_1_glyphnames(SkPDFDocument* canon,
 static SkPDFIndirectReference type1_font_descriptor(SkPDFDocument* doc,
                                                     const SkTypeface* typeface) {
     SkTypefaceID typefaceID = typeface->uniqueID();
-    if (SkPDFIndirectReference* ptr = doc->fFontDescriptors.find(typefaceID)) {
-        return *ptr;
+    {
+        SkAutoMutexExclusive lock(doc->fFontMutex);
+        if (SkPDFIndirectReference* ptr = doc->fFontDescriptors.find(typefaceID)) {
+            return *ptr;
+        }
     }
     const SkAdvancedTypefaceMetrics* info = SkPDFFont::GetMetrics(typeface, doc);
     auto fontDescriptor = make_type1_font_descriptor(doc, typeface, info);
+    SkAutoMutexExclusive lock(doc->fFontMutex);
     doc->fFontDescriptors.set(typefaceID, fontDescriptor);
     return fontDescriptor;
 }
@@ -288,6 +288,9 @@ void SkPDFUnion::emitObject(SkWStream* stream) const {
             return;
         case Type::kRef:
             SkASSERT(fIntValue >= 0);
+            if (fIntValue >= kSkPDFFirstProvisionalReference) {
+                stream->write(&kSkPDFProvisionalReferenceMarker, 1);
+            }
             stream->writeDecAsText(fIntValue);
             stream->writeText(" 0 R");  // Generation number is always 0.
             return;
@@ -547,23 +550,26 @@ static void serialize_stream(SkPDFDict* origDict,
         compress == SkPDFSteamCompressionEnabled::Yes &&
         stream->getLength() > kMinimumSavings)
     {
-        SkDynamicMemoryWStream compressedData;
-        SkDeflateWStream deflateWStream(&compressedData,SkToInt(doc->metadata().fCompressionLevel));
-        SkStreamCopy(&deflateWStream, stream);
-        deflateWStream.finalize();
+        std::unique_ptr<SkStreamAsset> compressedData = SkDeflateCompressStream(
+                doc->compressor(), stream, SkToInt(doc->metadata().fCompressionLevel),
+                SkDeflateStrategy::kDefault);
         #ifdef SK_PDF_BASE85_BINARY
-        {
-            SkPDFUtils::Base85Encode(compressedData.detachAsStream(), &compressedData);
-            tmp = compressedData.detachAsStream();
+        if (compressedData) {
+            SkDynamicMemoryWStream encodedData;
+            SkPDFUtils::Base85Encode(std::move(compressedData), &encodedData);
+            tmp = encodedData.detachAsStream();
             stream = tmp.get();
             auto filters = SkPDFMakeArray();
             filters->appendName("ASCII85Decode");
             filters->appendName("FlateDecode");
             dict.insertObject("Filter", std::move(filters));
+        } else {
+            SkAssertResult(stream->rewind());
         }
         #else
-        if (stream->getLength() > compressedData.bytesWritten() + kMinimumSavings) {
-            tmp = compressedData.detachAsStream();
+        if (compressedData &&
+            stream->getLength() > compressedData->getLength() + kMinimumSavings) {
+            tmp = std::move(compressedData);
             stream = tmp.get();
             dict.insertName("Filter", "FlateDecode");
         } else {
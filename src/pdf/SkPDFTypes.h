@@ -38,6 +38,14 @@ struct SkPDFIndirectReference {
     explicit operator bool() { return fValue != -1; }
 };
 
+// While SkPDF::DrawPages() draws pages concurrently, references are provisional, counting up from
+// here.  They are written prefixed by kSkPDFProvisionalReferenceMarker and the document replaces
+// them with object numbers, assigned in the order in which they are written, so that the numbers
+// do not depend on thread timing.  Literal strings and names escape control characters, so the
+// marker cannot appear in any other part of an object.
+static constexpr int kSkPDFFirstProvisionalReference = 1 << 30;
+static constexpr char kSkPDFProvisionalReferenceMarker = '\x01';
+
 inline static bool operator==(SkPDFIndirectReference u, SkPDFIndirectReference v) {
     return u.fValue == v.fValue;
 }
@@ -11,6 +11,7 @@
 #include "include/private/base/SkTemplates.h"
 #include "src/core/SkOSFile.h"
 
+#include <cstdint>
 #include <dirent.h>
 #include <new>
 #include <stdio.h>
@@ -81,6 +82,17 @@ void sk_fmunmap(const void* addr, size_t length) {
     munmap(const_cast<void*>(addr), length);
 }
 
+void sk_fmadvise_sequential(const void* addr, size_t length) {
+#if defined(MADV_SEQUENTIAL) && defined(MADV_WILLNEED)
+    // madvise() takes whole pages.
+    const uintptr_t pageMask = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE)) - 1;
+    const uintptr_t start = reinterpret_cast<uintptr_t>(addr) & ~pageMask;
+    const size_t pagesLength = reinterpret_cast<uintptr_t>(addr) + length - start;
+    madvise(reinterpret_cast<void*>(start), pagesLength, MADV_SEQUENTIAL);
+    madvise(reinterpret_cast<void*>(start), pagesLength, MADV_WILLNEED);
+#endif
+}
+
 void* sk_fdmmap(int fd, size_t* size) {
     struct stat status = {};
     if (0 != fstat(fd, &status)) {
@@ -17,9 +17,12 @@
 #include "include/core/SkScalar.h"
 #include "include/core/SkShader.h"
 #include "include/core/SkTileMode.h"
+#include "include/core/SkYUVAInfo.h"
+#include "include/core/SkYUVAPixmaps.h"
 #include "include/private/base/SkMath.h"
 #include "modules/skcms/skcms.h"
 #include "src/base/SkArenaAlloc.h"
+#include "src/core/SkCachedData.h"
 #include "src/core/SkColorSpaceXformSteps.h"
 #include "src/core/SkEffectPriv.h"
 #include "src/core/SkImageInfoPriv.h"
@@ -32,13 +35,17 @@
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkSamplingPriv.h"
 #include "src/core/SkWriteBuffer.h"
+#include "src/core/SkYUVAInfoLocation.h"
+#include "src/core/SkYUVMath.h"
 #include "src/image/SkImage_Base.h"
+#include "src/image/SkImage_Lazy.h"
 #include "src/shaders/SkLocalMatrixShader.h"
 
 #ifdef SK_ENABLE_LEGACY_SHADERCONTEXT
 #include "src/shaders/SkBitmapProcShader.h"
 #endif
 
+#include <cstring>
 #include <optional>
 #include <tuple>
 #include <utility>
@@ -216,6 +223,11 @@ static bool legacy_shader_can_handle(const SkMatrix& inv) {
 SkShaderBase::Context* SkImageShader::onMakeContext(const ContextRec& rec,
                                                     SkArenaAlloc* alloc) const {
     SkASSERT(!needs_subset(fImage.get(), fSubset)); // TODO(skbug.com/12784)
+    // Images drawn from YUVA planes are only sampled by raster pipeline stages.
+    if (as_IB(fImage)->type() == SkImage_Base::Type::kLazy &&
+        static_cast<const SkImage_Lazy*>(fImage.get())->drawsRasterFromPlanes()) {
+        return nullptr;
+    }
     if (fImage->alphaType() == kUnpremul_SkAlphaType) {
         return nullptr;
     }
@@ -457,18 +469,214 @@ static SkSamplingOptions tweak_sampling(SkSamplingOptions sampling, const SkMatr
     return SkSamplingOptions(filter, sampling.mipmap);
 }
 
+static void append_tiling_and_gather(SkRasterPipeline* p,
+                                     const MipLevelHelper* level,
+                                     SkTileMode tileModeX,
+                                     SkTileMode tileModeY) {
+    const bool decalBothAxes = tileModeX == SkTileMode::kDecal && tileModeY == SkTileMode::kDecal;
+    if (decalBothAxes) {
+        p->append(SkRasterPipelineOp::decal_x_and_y,  level->decalCtx);
+    } else {
+        switch (tileModeX) {
+            case SkTileMode::kClamp: /* The gather_xxx stage will clamp for us. */
+                break;
+            case SkTileMode::kMirror:
+                p->append(SkRasterPipelineOp::mirror_x, level->limitX);
+                break;
+            case SkTileMode::kRepeat:
+                p->append(SkRasterPipelineOp::repeat_x, level->limitX);
+                break;
+            case SkTileMode::kDecal:
+                p->append(SkRasterPipelineOp::decal_x, level->decalCtx);
+                break;
+        }
+        switch (tileModeY) {
+            case SkTileMode::kClamp: /* The gather_xxx stage will clamp for us. */
+                break;
+            case SkTileMode::kMirror:
+                p->append(SkRasterPipelineOp::mirror_y, level->limitY);
+                break;
+            case SkTileMode::kRepeat:
+                p->append(SkRasterPipelineOp::repeat_y, level->limitY);
+                break;
+            case SkTileMode::kDecal:
+                p->append(SkRasterPipelineOp::decal_y, level->decalCtx);
+                break;
+        }
+    }
+
+    void* ctx = level->gather;
+    switch (level->pm.colorType()) {
+        case kAlpha_8_SkColorType:      p->append(SkRasterPipelineOp::gather_a8,    ctx); break;
+        case kA16_unorm_SkColorType:    p->append(SkRasterPipelineOp::gather_a16,   ctx); break;
+        case kA16_float_SkColorType:    p->append(SkRasterPipelineOp::gather_af16,  ctx); break;
+        case kRGB_565_SkColorType:      p->append(SkRasterPipelineOp::gather_565,   ctx); break;
+        case kARGB_4444_SkColorType:    p->append(SkRasterPipelineOp::gather_4444,  ctx); break;
+        case kR8G8_unorm_SkColorType:   p->append(SkRasterPipelineOp::gather_rg88,  ctx); break;
+        case kR16G16_unorm_SkColorType: p->append(SkRasterPipelineOp::gather_rg1616,ctx); break;
+        case kR16G16_float_SkColorType: p->append(SkRasterPipelineOp::gather_rgf16, ctx); break;
+        case kRGBA_8888_SkColorType:    p->append(SkRasterPipelineOp::gather_8888,  ctx); break;
+
+        case kRGBA_1010102_SkColorType:
+            p->append(SkRasterPipelineOp::gather_1010102, ctx);
+            break;
+
+        case kR16G16B16A16_unorm_SkColorType:
+            p->append(SkRasterPipelineOp::gather_16161616, ctx);
+            break;
+
+        case kRGBA_F16Norm_SkColorType:
+        case kRGBA_F16_SkColorType:     p->append(SkRasterPipelineOp::gather_f16,   ctx); break;
+        case kRGBA_F32_SkColorType:     p->append(SkRasterPipelineOp::gather_f32,   ctx); break;
+        case kRGBA_10x6_SkColorType:    p->append(SkRasterPipelineOp::gather_10x6,  ctx); break;
+
+        case kGray_8_SkColorType:       p->append(SkRasterPipelineOp::gather_a8,    ctx);
+                                        p->append(SkRasterPipelineOp::alpha_to_gray    ); break;
+
+        case kR8_unorm_SkColorType:     p->append(SkRasterPipelineOp::gather_a8,    ctx);
+                                        p->append(SkRasterPipelineOp::alpha_to_red     ); break;
+
+        case kRGB_888x_SkColorType:     p->append(SkRasterPipelineOp::gather_8888,  ctx);
+                                        p->append(SkRasterPipelineOp::force_opaque     ); break;
+
+        case kBGRA_1010102_SkColorType:
+            p->append(SkRasterPipelineOp::gather_1010102, ctx);
+            p->append(SkRasterPipelineOp::swap_rb);
+            break;
+
+        case kRGB_101010x_SkColorType:
+            p->append(SkRasterPipelineOp::gather_1010102, ctx);
+            p->append(SkRasterPipelineOp::force_opaque);
+            break;
+
+        case kBGR_101010x_XR_SkColorType:
+            p->append(SkRasterPipelineOp::gather_1010102_xr, ctx);
+            p->append(SkRasterPipelineOp::force_opaque);
+            p->append(SkRasterPipelineOp::swap_rb);
+            break;
+
+        case kBGR_101010x_SkColorType:
+            p->append(SkRasterPipelineOp::gather_1010102, ctx);
+            p->append(SkRasterPipelineOp::force_opaque);
+            p->append(SkRasterPipelineOp::swap_rb);
+            break;
+
+        case kBGRA_8888_SkColorType:
+            p->append(SkRasterPipelineOp::gather_8888, ctx);
+            p->append(SkRasterPipelineOp::swap_rb);
+            break;
+
+        case kSRGBA_8888_SkColorType:
+            p->append(SkRasterPipelineOp::gather_8888, ctx);
+            p->append_transfer_function(*skcms_sRGB_TransferFunction());
+            break;
+
+        case kUnknown_SkColorType: SkASSERT(false);
+    }
+    if (level->decalCtx) {
+        p->append(SkRasterPipelineOp::check_decal_mask, level->decalCtx);
+    }
+}
+
+// Samples level at the coordinates in r,g, leaving the color in r,g,b,a. The sampler context may
+// be shared by every call for one pipeline.
+static void append_sample(SkRasterPipeline* p,
+                          const MipLevelHelper* level,
+                          const SkSamplingOptions& sampling,
+                          SkTileMode tileModeX,
+                          SkTileMode tileModeY,
+                          SkRasterPipeline_SamplerCtx* sampler) {
+    auto sample = [&](SkRasterPipelineOp setup_x, SkRasterPipelineOp setup_y) {
+        p->append(setup_x, sampler);
+        p->append(setup_y, sampler);
+        append_tiling_and_gather(p, level, tileModeX, tileModeY);
+        p->append(SkRasterPipelineOp::accumulate, sampler);
+    };
+
+    if (sampling.useCubic) {
+        SkImageShader::CubicResamplerMatrix(sampling.cubic.B, sampling.cubic.C)
+                .getColMajor(sampler->weights);
+
+        p->append(SkRasterPipelineOp::bicubic_setup, sampler);
+
+        sample(SkRasterPipelineOp::bicubic_n3x, SkRasterPipelineOp::bicubic_n3y);
+        sample(SkRasterPipelineOp::bicubic_n1x, SkRasterPipelineOp::bicubic_n3y);
+        sample(SkRasterPipelineOp::bicubic_p1x, SkRasterPipelineOp::bicubic_n3y);
+        sample(SkRasterPipelineOp::bicubic_p3x, SkRasterPipelineOp::bicubic_n3y);
+
+        sample(SkRasterPipelineOp::bicubic_n3x, SkRasterPipelineOp::bicubic_n1y);
+        sample(SkRasterPipelineOp::bicubic_n1x, SkRasterPipelineOp::bicubic_n1y);
+        sample(SkRasterPipelineOp::bicubic_p1x, SkRasterPipelineOp::bicubic_n1y);
+        sample(SkRasterPipelineOp::bicubic_p3x, SkRasterPipelineOp::bicubic_n1y);
+
+        sample(SkRasterPipelineOp::bicubic_n3x, SkRasterPipelineOp::bicubic_p1y);
+        sample(SkRasterPipelineOp::bicubic_n1x, SkRasterPipelineOp::bicubic_p1y);
+        sample(SkRasterPipelineOp::bicubic_p1x, SkRasterPipelineOp::bicubic_p1y);
+        sample(SkRasterPipelineOp::bicubic_p3x, SkRasterPipelineOp::bicubic_p1y);
+
+        sample(SkRasterPipelineOp::bicubic_n3x, SkRasterPipelineOp::bicubic_p3y);
+        sample(SkRasterPipelineOp::bicubic_n1x, SkRasterPipelineOp::bicubic_p3y);
+        sample(SkRasterPipelineOp::bicubic_p1x, SkRasterPipelineOp::bicubic_p3y);
+        sample(SkRasterPipelineOp::bicubic_p3x, SkRasterPipelineOp::bicubic_p3y);
+
+        p->append(SkRasterPipelineOp::move_dst_src);
+    } else if (sampling.filter == SkFilterMode::kLinear) {
+        p->append(SkRasterPipelineOp::bilinear_setup, sampler);
+
+        sample(SkRasterPipelineOp::bilinear_nx, SkRasterPipelineOp::bilinear_ny);
+        sample(SkRasterPipelineOp::bilinear_px, SkRasterPipelineOp::bilinear_ny);
+        sample(SkRasterPipelineOp::bilinear_nx, SkRasterPipelineOp::bilinear_py);
+        sample(SkRasterPipelineOp::bilinear_px, SkRasterPipelineOp::bilinear_py);
+
+        p->append(SkRasterPipelineOp::move_dst_src);
+    } else {
+        append_tiling_and_gather(p, level, tileModeX, tileModeY);
+    }
+}
+
+// Repeat and mirror tiling wrap each plane at its own edges, so subsampled chroma would be filtered
+// across the seams, and an odd-sized image's extra chroma pixel would be tiled into the pattern.
+// The codec's RGBA pixels do neither, so those draws sample RGBA pixels.
+static bool planes_tile_like_image(const SkYUVAPixmaps& planes,
+                                   SkTileMode tileModeX,
+                                   SkTileMode tileModeY) {
+    for (int i = 0; i < planes.numPlanes(); ++i) {
+        auto [ssx, ssy] = planes.yuvaInfo().planeSubsamplingFactors(i);
+        if ((ssx > 1 && tileModeX != SkTileMode::kClamp) ||
+            (ssy > 1 && tileModeY != SkTileMode::kClamp)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool SkImageShader::appendStages(const SkStageRec& rec, const SkShaders::MatrixRec& mRec) const {
     SkASSERT(!needs_subset(fImage.get(), fSubset));  // TODO(skbug.com/12784)
 
+    SkRasterPipeline* p = rec.fPipeline;
+    SkArenaAlloc* alloc = rec.fAlloc;
+
+    // Decal tiling masks out each plane's samples separately, which filtering doesn't undo, so
+    // those draws sample RGBA pixels.
+    if (!fRaw && as_IB(fImage)->type() == SkImage_Base::Type::kLazy &&
+        fTileModeX != SkTileMode::kDecal && fTileModeY != SkTileMode::kDecal) {
+        SkYUVAPixmaps planes;
+        if (sk_sp<SkCachedData> data =
+                    static_cast<const SkImage_Lazy*>(fImage.get())->getRasterPlanes(&planes)) {
+            // Keep the planes locked in the cache for as long as the pipeline samples them.
+            alloc->make<sk_sp<SkCachedData>>(std::move(data));
+            if (planes_tile_like_image(planes, fTileModeX, fTileModeY)) {
+                return this->appendYUVAStages(rec, mRec, planes);
+            }
+        }
+    }
+
     // We only support certain sampling options in stages so far
     auto sampling = fSampling;
     if (sampling.isAniso()) {
         sampling = SkSamplingPriv::AnisoFallback(fImage->hasMipmaps());
     }
 
-    SkRasterPipeline* p = rec.fPipeline;
-    SkArenaAlloc* alloc = rec.fAlloc;
-
     SkMatrix baseInv;
     // If the total matrix isn't valid then we will always access the base MIP level.
     if (mRec.totalMatrixIsValid()) {
@@ -515,113 +723,6 @@ bool SkImageShader::appendStages(const SkStageRec& rec, const SkShaders::MatrixR
         p->append(SkRasterPipelineOp::mipmap_linear_init, mipmapCtx);
     }
 
-    const bool decalBothAxes = fTileModeX == SkTileMode::kDecal && fTileModeY == SkTileMode::kDecal;
-
-    auto append_tiling_and_gather = [&](const MipLevelHelper* level) {
-        if (decalBothAxes) {
-            p->append(SkRasterPipelineOp::decal_x_and_y,  level->decalCtx);
-        } else {
-            switch (fTileModeX) {
-                case SkTileMode::kClamp: /* The gather_xxx stage will clamp for us. */
-                    break;
-                case SkTileMode::kMirror:
-                    p->append(SkRasterPipelineOp::mirror_x, level->limitX);
-                    break;
-                case SkTileMode::kRepeat:
-                    p->append(SkRasterPipelineOp::repeat_x, level->limitX);
-                    break;
-                case SkTileMode::kDecal:
-                    p->append(SkRasterPipelineOp::decal_x, level->decalCtx);
-                    break;
-            }
-            switch (fTileModeY) {
-                case SkTileMode::kClamp: /* The gather_xxx stage will clamp for us. */
-                    break;
-                case SkTileMode::kMirror:
-                    p->append(SkRasterPipelineOp::mirror_y, level->limitY);
-                    break;
-                case SkTileMode::kRepeat:
-                    p->append(SkRasterPipelineOp::repeat_y, level->limitY);
-                    break;
-                case SkTileMode::kDecal:
-                    p->append(SkRasterPipelineOp::decal_y, level->decalCtx);
-                    break;
-            }
-        }
-
-        void* ctx = level->gather;
-        switch (level->pm.colorType()) {
-            case kAlpha_8_SkColorType:      p->append(SkRasterPipelineOp::gather_a8,    ctx); break;
-            case kA16_unorm_SkColorType:    p->append(SkRasterPipelineOp::gather_a16,   ctx); break;
-            case kA16_float_SkColorType:    p->append(SkRasterPipelineOp::gather_af16,  ctx); break;
-            case kRGB_565_SkColorType:      p->append(SkRasterPipelineOp::gather_565,   ctx); break;
-            case kARGB_4444_SkColorType:    p->append(SkRasterPipelineOp::gather_4444,  ctx); break;
-            case kR8G8_unorm_SkColorType:   p->append(SkRasterPipelineOp::gather_rg88,  ctx); break;
-            case kR16G16_unorm_SkColorType: p->append(SkRasterPipelineOp::gather_rg1616,ctx); break;
-            case kR16G16_float_SkColorType: p->append(SkRasterPipelineOp::gather_rgf16, ctx); break;
-            case kRGBA_8888_SkColorType:    p->append(SkRasterPipelineOp::gather_8888,  ctx); break;
-
-            case kRGBA_1010102_SkColorType:
-                p->append(SkRasterPipelineOp::gather_1010102, ctx);
-                break;
-
-            case kR16G16B16A16_unorm_SkColorType:
-                p->append(SkRasterPipelineOp::gather_16161616, ctx);
-                break;
-
-            case kRGBA_F16Norm_SkColorType:
-            case kRGBA_F16_SkColorType:     p->append(SkRasterPipelineOp::gather_f16,   ctx); break;
-            case kRGBA_F32_SkColorType:     p->append(SkRasterPipelineOp::gather_f32,   ctx); break;
-            case kRGBA_10x6_SkColorType:    p->append(SkRasterPipelineOp::gather_10x6,  ctx); break;
-
-            case kGray_8_SkColorType:       p->append(SkRasterPipelineOp::gather_a8,    ctx);
-                                            p->append(SkRasterPipelineOp::alpha_to_gray    ); break;
-
-            case kR8_unorm_SkColorType:     p->append(SkRasterPipelineOp::gather_a8,    ctx);
-                                            p->append(SkRasterPipelineOp::alpha_to_red     ); break;
-
-            case kRGB_888x_SkColorType:     p->append(SkRasterPipelineOp::gather_8888,  ctx);
-                                            p->append(SkRasterPipelineOp::force_opaque     ); break;
-
-            case kBGRA_1010102_SkColorType:
-                p->append(SkRasterPipelineOp::gather_1010102, ctx);
-                p->append(SkRasterPipelineOp::swap_rb);
-                break;
-
-            case kRGB_101010x_SkColorType:
-                p->append(SkRasterPipelineOp::gather_1010102, ctx);
-                p->append(SkRasterPipelineOp::force_opaque);
-                break;
-
-            case kBGR_101010x_XR_SkColorType:
-                p->append(SkRasterPipelineOp::gather_1010102_xr, ctx);
-                p->append(SkRasterPipelineOp::force_opaque);
-                p->append(SkRasterPipelineOp::swap_rb);
-                break;
-
-            case kBGR_101010x_SkColorType:
-                p->append(SkRasterPipelineOp::gather_1010102, ctx);
-                p->append(SkRasterPipelineOp::force_opaque);
-                p->append(SkRasterPipelineOp::swap_rb);
-                break;
-
-            case kBGRA_8888_SkColorType:
-                p->append(SkRasterPipelineOp::gather_8888, ctx);
-                p->append(SkRasterPipelineOp::swap_rb);
-                break;
-
-            case kSRGBA_8888_SkColorType:
-                p->append(SkRasterPipelineOp::gather_8888, ctx);
-                p->append_transfer_function(*skcms_sRGB_TransferFunction());
-                break;
-
-            case kUnknown_SkColorType: SkASSERT(false);
-        }
-        if (level->decalCtx) {
-            p->append(SkRasterPipelineOp::check_decal_mask, level->decalCtx);
-        }
-    };
-
     auto append_misc = [&] {
         SkColorSpace* cs = upper.pm.colorSpace();
         SkAlphaType   at = upper.pm.alphaType();
@@ -679,63 +780,112 @@ bool SkImageShader::appendStages(const SkStageRec& rec, const SkShaders::MatrixR
     // This context can be shared by both levels when doing linear mipmap filtering
     SkRasterPipeline_SamplerCtx* sampler = alloc->make<SkRasterPipeline_SamplerCtx>();
 
-    auto sample = [&](SkRasterPipelineOp setup_x,
-                      SkRasterPipelineOp setup_y,
-                      const MipLevelHelper* level) {
-        p->append(setup_x, sampler);
-        p->append(setup_y, sampler);
-        append_tiling_and_gather(level);
-        p->append(SkRasterPipelineOp::accumulate, sampler);
-    };
-
-    auto sample_level = [&](const MipLevelHelper* level) {
-        if (sampling.useCubic) {
-            CubicResamplerMatrix(sampling.cubic.B, sampling.cubic.C).getColMajor(sampler->weights);
-
-            p->append(SkRasterPipelineOp::bicubic_setup, sampler);
-
-            sample(SkRasterPipelineOp::bicubic_n3x, SkRasterPipelineOp::bicubic_n3y, level);
-            sample(SkRasterPipelineOp::bicubic_n1x, SkRasterPipelineOp::bicubic_n3y, level);
-            sample(SkRasterPipelineOp::bicubic_p1x, SkRasterPipelineOp::bicubic_n3y, level);
-            sample(SkRasterPipelineOp::bicubic_p3x, SkRasterPipelineOp::bicubic_n3y, level);
-
-            sample(SkRasterPipelineOp::bicubic_n3x, SkRasterPipelineOp::bicubic_n1y, level);
-            sample(SkRasterPipelineOp::bicubic_n1x, SkRasterPipelineOp::bicubic_n1y, level);
-            sample(SkRasterPipelineOp::bicubic_p1x, SkRasterPipelineOp::bicubic_n1y, level);
-            sample(SkRasterPipelineOp::bicubic_p3x, SkRasterPipelineOp::bicubic_n1y, level);
-
-            sample(SkRasterPipelineOp::bicubic_n3x, SkRasterPipelineOp::bicubic_p1y, level);
-            sample(SkRasterPipelineOp::bicubic_n1x, SkRasterPipelineOp::bicubic_p1y, level);
-            sample(SkRasterPipelineOp::bicubic_p1x, SkRasterPipelineOp::bicubic_p1y, level);
-            sample(SkRasterPipelineOp::bicubic_p3x, SkRasterPipelineOp::bicubic_p1y, level);
-
-            sample(SkRasterPipelineOp::bicubic_n3x, SkRasterPipelineOp::bicubic_p3y, level);
-            sample(SkRasterPipelineOp::bicubic_n1x, SkRasterPipelineOp::bicubic_p3y, level);
-            sample(SkRasterPipelineOp::bicubic_p1x, SkRasterPipelineOp::bicubic_p3y, level);
-            sample(SkRasterPipelineOp::bicubic_p3x, SkRasterPipelineOp::bicubic_p3y, level);
-
-            p->append(SkRasterPipelineOp::move_dst_src);
-        } else if (sampling.filter == SkFilterMode::kLinear) {
-            p->append(SkRasterPipelineOp::bilinear_setup, sampler);
-
-            sample(SkRasterPipelineOp::bilinear_nx, SkRasterPipelineOp::bilinear_ny, level);
-            sample(SkRasterPipelineOp::bilinear_px, SkRasterPipelineOp::bilinear_ny, level);
-            sample(SkRasterPipelineOp::bilinear_nx, SkRasterPipelineOp::bilinear_py, level);
-            sample(SkRasterPipelineOp::bilinear_px, SkRasterPipelineOp::bilinear_py, level);
-
-            p->append(SkRasterPipelineOp::move_dst_src);
-        } else {
-            append_tiling_and_gather(level);
-        }
-    };
-
-    sample_level(&upper);
+    append_sample(p, &upper, sampling, fTileModeX, fTileModeY, sampler);
 
     if (mipmapCtx) {
         p->append(SkRasterPipelineOp::mipmap_linear_update, mipmapCtx);
-        sample_level(&lower);
+        append_sample(p, &lower, sampling, fTileModeX, fTileModeY, sampler);
         p->append(SkRasterPipelineOp::mipmap_linear_finish, mipmapCtx);
     }
 
     return append_misc();
 }
+
+bool SkImageShader::appendYUVAStages(const SkStageRec& rec,
+                                     const SkShaders::MatrixRec& mRec,
+                                     const SkYUVAPixmaps& planes) const {
+    SkRasterPipeline* p = rec.fPipeline;
+    SkArenaAlloc* alloc = rec.fAlloc;
+
+    // The planes have no mipmaps.
+    SkSamplingOptions sampling = fSampling;
+    if (sampling.isAniso()) {
+        sampling = SkSamplingPriv::AnisoFallback(/*imageIsMipped=*/false);
+    }
+    if (!sampling.useCubic) {
+        sampling = SkSamplingOptions(sampling.filter);
+    }
+
+    SkMatrix baseInv;
+    if (mRec.totalMatrixIsValid()) {
+        if (!mRec.totalInverse(&baseInv)) {
+            return false;
+        }
+        baseInv.normalizePerspective();
+    }
+
+    // Each plane is sampled at the image coordinates, scaled down by its subsampling factors when
+    // its chroma is subsampled. The sampled channels are moved to where Y, U, V and A go (r, g, b
+    // and a) and summed over the planes in yuva.
+    if (!mRec.apply(rec)) {
+        return false;
+    }
+    auto* coords = alloc->makeArray<float>(2 * SkRasterPipeline_kMaxStride_highp);
+    auto* yuva = alloc->makeArray<float>(4 * SkRasterPipeline_kMaxStride_highp);
+    auto* sampler = alloc->make<SkRasterPipeline_SamplerCtx>();
+    p->append(SkRasterPipelineOp::store_src_rg, coords);
+
+    const SkYUVAInfo::YUVALocations locations = planes.toYUVALocations();
+    const bool hasAlpha = locations[SkYUVAInfo::kA].fPlane >= 0;
+    const int numPlanes = planes.numPlanes();
+    for (int i = 0; i < numPlanes; ++i) {
+        MipLevelHelper plane;
+        plane.pm = planes.plane(i);
+        // A subsampled plane of an odd-sized image has an extra pixel of chroma past the image's
+        // edge, so its size can't give the scale.
+        auto [ssx, ssy] = planes.yuvaInfo().planeSubsamplingFactors(i);
+        plane.inv = SkMatrix::Scale(1.f / ssx, 1.f / ssy);
+
+        // Subsampled planes are filtered even for nearest neighbor draws, as codecs upsample
+        // chroma when decoding to RGBA.
+        SkSamplingOptions planeSampling = sampling;
+        if (!sampling.useCubic) {
+            if (!plane.inv.isIdentity()) {
+                planeSampling = SkSamplingOptions(SkFilterMode::kLinear);
+            } else if (mRec.totalMatrixIsValid()) {
+                planeSampling = tweak_sampling(sampling, baseInv);
+            }
+        }
+        plane.allocAndInit(alloc, planeSampling, fTileModeX, fTileModeY);
+
+        if (i > 0) {
+            p->append(SkRasterPipelineOp::load_src_rg, coords);
+        }
+        if (!plane.inv.isIdentity()) {
+            p->append_matrix(alloc, plane.inv);
+        }
+        append_sample(p, &plane, planeSampling, fTileModeX, fTileModeY, sampler);
+
+        char swizzle[4];
+        for (int c = 0; c < SkYUVAInfo::kYUVAChannelCount; ++c) {
+            if (locations[c].fPlane == i) {
+                swizzle[c] = "rgba"[static_cast<int>(locations[c].fChannel)];
+            } else if (c == SkYUVAInfo::kA && !hasAlpha && i == 0) {
+                swizzle[c] = '1';
+            } else {
+                swizzle[c] = '0';
+            }
+        }
+        uintptr_t swizzleCtx = 0;
+        memcpy(&swizzleCtx, swizzle, sizeof(swizzle));
+        p->append(SkRasterPipelineOp::swizzle, swizzleCtx);
+
+        if (i > 0) {
+            p->append(SkRasterPipelineOp::load_dst, yuva);
+            p->append(SkRasterPipelineOp::plus_);
+        }
+        if (i + 1 < numPlanes) {
+            p->append(SkRasterPipelineOp::store_src, yuva);
+        }
+    }
+
+    float* yuvToRGB = alloc->makeArray<float>(20);
+    SkColorMatrix_YUV2RGB(planes.yuvaInfo().yuvColorSpace(), yuvToRGB);
+    p->append(SkRasterPipelineOp::matrix_4x5, yuvToRGB);
+    p->append(SkRasterPipelineOp::clamp_01);
+
+    const SkAlphaType at = hasAlpha ? kUnpremul_SkAlphaType : fImage->alphaType();
+    alloc->make<SkColorSpaceXformSteps>(fImage->colorSpace(), at,
+                                        rec.fDstCS, kPremul_SkAlphaType)->apply(p);
+    return true;
+}
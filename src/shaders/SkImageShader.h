@@ -22,6 +22,7 @@ class SkMatrix;
 class SkReadBuffer;
 class SkShader;
 class SkWriteBuffer;
+class SkYUVAPixmaps;
 enum class SkTileMode;
 struct SkStageRec;
 
@@ -81,6 +82,12 @@ private:
 
     bool appendStages(const SkStageRec&, const SkShaders::MatrixRec&) const override;
 
+    // Samples each of an SkImage_Lazy's YUVA planes and converts the result to RGB, rather than
+    // sampling its RGBA pixels.
+    bool appendYUVAStages(const SkStageRec&,
+                          const SkShaders::MatrixRec&,
+                          const SkYUVAPixmaps&) const;
+
     sk_sp<SkImage>          fImage;
     const SkSamplingOptions fSampling;
     const SkTileMode        fTileModeX;
@@ -17,22 +17,150 @@
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSamplingOptions.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
+#include "src/base/SkAutoMalloc.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/core/SkCachedData.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkNextID.h"
+#include "src/core/SkResourceCache.h"
+#include "src/utils/SkAnimCodecPlayerPriv.h"
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <utility>
 #include <vector>
 
-SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(std::move(codec)) {
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+namespace {
+static unsigned gAnimationFrameKeyNamespaceLabel;
+
+struct AnimationFrameKey : public SkResourceCache::Key {
+public:
+    AnimationFrameKey(uint64_t animationID, int frameIndex) : fFrameIndex(frameIndex) {
+        this->init(&gAnimationFrameKeyNamespaceLabel, animationID, sizeof(fFrameIndex));
+    }
+
+    int32_t fFrameIndex;
+};
+
+struct AnimationFrameValue {
+    SkImageInfo   fInfo;
+    SkCachedData* fData;
+};
+
+// What a lookup finds: the frame, if it was decoded from the same encoded data.
+struct AnimationFrameQuery {
+    const SkData*        fSharedData;
+    AnimationFrameValue* fResult;
+};
+
+struct AnimationFrameRec : public SkResourceCache::Rec {
+    // sharedData is the encoded data that the frame was decoded from, if other players may find
+    // it. Its bytes belong to the players, so they don't count towards bytesUsed().
+    AnimationFrameRec(const AnimationFrameKey& key, const SkImageInfo& info, SkCachedData* data,
+                      sk_sp<SkData> sharedData)
+            : fKey(key), fValue({info, data}), fSharedData(std::move(sharedData)) {
+        fValue.fData->attachToCacheAndRef();
+    }
+    ~AnimationFrameRec() override {
+        fValue.fData->detachFromCacheAndUnref();
+    }
+
+    AnimationFrameKey   fKey;
+    AnimationFrameValue fValue;
+    sk_sp<SkData>       fSharedData;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fValue.fData->size(); }
+    const char* getCategory() const override { return "animation-frame"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fValue.fData->diagnostic_only_getDiscardable();
+    }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const AnimationFrameRec& rec = static_cast<const AnimationFrameRec&>(baseRec);
+        const AnimationFrameQuery* query = static_cast<const AnimationFrameQuery*>(contextData);
+
+        // The key's animation ID is only a hash of the encoded data, so check the data itself.
+        const SkData* recData = rec.fSharedData.get();
+        if (recData != query->fSharedData &&
+            (!recData || !query->fSharedData || !recData->equals(query->fSharedData))) {
+            return false;
+        }
+
+        SkCachedData* tmpData = rec.fValue.fData;
+        tmpData->ref();
+        if (nullptr == tmpData->data()) {
+            tmpData->unref();
+            return false;
+        }
+        *query->fResult = rec.fValue;
+        return true;
+    }
+};
+}  // namespace
+
+// Wraps pixels from the cache in an image, which keeps them locked for as long as it lives. Takes
+// over the caller's ref on data.
+static sk_sp<SkImage> image_from_cached_data(const SkImageInfo& info, SkCachedData* data) {
+    return SkImages::RasterFromPixmap(
+            SkPixmap(info, data->data(), info.minRowBytes()),
+            [](const void*, void* ctx) { static_cast<SkCachedData*>(ctx)->unref(); }, data);
+}
+
+// An animation ID for a player's frames alone.
+static uint64_t new_animation_id() {
+    return ((uint64_t)SkSetFourByteTag('a', 'n', 'i', 'm') << 32) | SkNextID::ImageID();
+}
+
+// An animation ID for the frames of every player of data. Different data may have the same ID, so
+// players check the data before using frames that they find.
+static uint64_t shared_animation_id(const SkData& data) {
+    return SkChecksum::Hash64(data.data(), data.size(), data.size());
+}
+
+static uint64_t animation_id(const SkData* data) {
+    return data ? shared_animation_id(*data) : new_animation_id();
+}
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec)
+        : SkAnimCodecPlayer(std::move(codec), nullptr, new_animation_id(), nullptr) {}
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, sk_sp<SkData> data)
+        : SkAnimCodecPlayer(std::move(codec), data, animation_id(data.get()), nullptr) {}
+
+std::unique_ptr<SkAnimCodecPlayer> SkAnimCodecPlayerPriv::Make(std::unique_ptr<SkCodec> codec,
+                                                               sk_sp<SkData> data,
+                                                               SkResourceCache* localCache) {
+    const uint64_t animationID = animation_id(data.get());
+    return Make(std::move(codec), std::move(data), animationID, localCache);
+}
+
+std::unique_ptr<SkAnimCodecPlayer> SkAnimCodecPlayerPriv::Make(std::unique_ptr<SkCodec> codec,
+                                                               sk_sp<SkData> data,
+                                                               uint64_t animationID,
+                                                               SkResourceCache* localCache) {
+    return std::unique_ptr<SkAnimCodecPlayer>(
+            new SkAnimCodecPlayer(std::move(codec), std::move(data), animationID, localCache));
+}
+
+SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec, sk_sp<SkData> data,
+                                     uint64_t animationID, SkResourceCache* localCache)
+        : fCodec(std::move(codec))
+        , fSharedData(std::move(data))
+        , fAnimationID(animationID)
+        , fLocalCache(localCache) {
     fImageInfo = fCodec->getInfo();
     fFrameInfos = fCodec->getFrameInfo();
-    fImages.resize(fFrameInfos.size());
 
     // change the interpretation of fDuration to a end-time for that frame
     size_t dur = 0;
@@ -45,18 +173,40 @@ SkAnimCodecPlayer::SkAnimCodecPlayer(std::unique_ptr<SkCodec> codec) : fCodec(st
     if (!fTotalDuration) {
         // Static image -- may or may not have returned a single frame info.
         fFrameInfos.clear();
-        fImages.clear();
-        fImages.push_back(SkImages::DeferredFromGenerator(
-                SkCodecImageGenerator::MakeFromCodec(std::move(fCodec))));
+        fStaticImage = SkImages::DeferredFromGenerator(
+                SkCodecImageGenerator::MakeFromCodec(std::move(fCodec)));
     }
 }
 
-SkAnimCodecPlayer::~SkAnimCodecPlayer() {}
+SkAnimCodecPlayer::~SkAnimCodecPlayer() {
+    if (!fSharedData && fTotalDuration) {
+        // No other player can find these frames.
+        if (fLocalCache) {
+            fLocalCache->purgeSharedID(fAnimationID);
+        } else {
+            SkResourceCache::PostPurgeSharedID(fAnimationID);
+        }
+    }
+}
+
+size_t SkAnimCodecPlayer::CachedFrameBytes() {
+    return CachedFrameBytes(nullptr);
+}
+
+size_t SkAnimCodecPlayer::CachedFrameBytes(SkResourceCache* localCache) {
+    size_t bytes = 0;
+    auto visitor = [](const SkResourceCache::Rec& rec, void* context) {
+        if (rec.getKey().getNamespace() == &gAnimationFrameKeyNamespaceLabel) {
+            *static_cast<size_t*>(context) += rec.bytesUsed();
+        }
+    };
+    CHECK_LOCAL(localCache, visitAll, VisitAll, visitor, &bytes);
+    return bytes;
+}
 
 SkISize SkAnimCodecPlayer::dimensions() const {
     if (!fCodec) {
-        auto image = fImages.front();
-        return image ? image->dimensions() : SkISize::MakeEmpty();
+        return fStaticImage ? fStaticImage->dimensions() : SkISize::MakeEmpty();
     }
     if (SkEncodedOriginSwapsWidthHeight(fCodec->getOrigin())) {
         return { fImageInfo.height(), fImageInfo.width() };
@@ -67,33 +217,70 @@ SkISize SkAnimCodecPlayer::dimensions() const {
 sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
     SkASSERT((unsigned)index < fFrameInfos.size());
 
-    if (fImages[index]) {
-        return fImages[index];
+    if (index != fLastIndex || !fLastImage) {
+        AnimationFrameValue cached;
+        AnimationFrameQuery query{fSharedData.get(), &cached};
+        if (CHECK_LOCAL(fLocalCache, find, Find, AnimationFrameKey(fAnimationID, index),
+                        AnimationFrameRec::Visitor, &query)) {
+            fLastImage = image_from_cached_data(cached.fInfo, cached.fData);
+        } else {
+            fLastImage = this->decodeFrame(index);
+        }
+        fLastIndex = index;
     }
+    return fLastImage;
+}
 
-    size_t rb = fImageInfo.minRowBytes();
-    size_t size = fImageInfo.computeByteSize(rb);
-    auto data = SkData::MakeUninitialized(size);
-
-    SkCodec::Options opts;
-    opts.fFrameIndex = index;
-
+sk_sp<SkImage> SkAnimCodecPlayer::decodeFrame(int index) {
     const auto origin = fCodec->getOrigin();
     const auto orientedDims = this->dimensions();
     const auto originMatrix = SkEncodedOriginToMatrix(origin, orientedDims.width(),
                                                               orientedDims.height());
 
-    SkPaint paint;
-    paint.setBlendMode(SkBlendMode::kSrc);
-
     auto imageInfo = fImageInfo;
     if (fFrameInfos[index].fAlphaType != kOpaque_SkAlphaType && imageInfo.isOpaque()) {
         imageInfo = imageInfo.makeAlphaType(kPremul_SkAlphaType);
     }
+    const auto orientedInfo = imageInfo.makeDimensions(orientedDims);
+
+    // The frame is kept in memory from the cache, so that the cache can purge or discard it. With
+    // an origin, it is decoded somewhere else first, and then drawn there through the origin.
+    SkCachedData* cached = CHECK_LOCAL(fLocalCache, newCachedData, NewCachedData,
+                                       orientedInfo.computeMinByteSize());
+    if (!cached) {
+        return nullptr;
+    }
+    SkAutoMalloc storage;
+    void* pixels = cached->writable_data();
+    size_t rb = imageInfo.minRowBytes();
+    if (origin != kDefault_SkEncodedOrigin) {
+        pixels = storage.reset(imageInfo.computeByteSize(rb));
+    }
+
+    SkCodec::Options opts;
+    opts.fFrameIndex = index;
+
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+
     const int requiredFrame = fFrameInfos[index].fRequiredFrame;
-    if (requiredFrame != SkCodec::kNoFrame && fImages[requiredFrame]) {
-        auto requiredImage = fImages[requiredFrame];
-        auto canvas = SkCanvas::MakeRasterDirect(imageInfo, data->writable_data(), rb);
+    sk_sp<SkImage> requiredImage;
+    if (requiredFrame != SkCodec::kNoFrame) {
+        // When playing in order, the required frame is usually the one just returned.
+        if (requiredFrame == fLastIndex) {
+            requiredImage = fLastImage;
+        } else {
+            AnimationFrameValue value;
+            AnimationFrameQuery query{fSharedData.get(), &value};
+            if (CHECK_LOCAL(fLocalCache, find, Find,
+                            AnimationFrameKey(fAnimationID, requiredFrame),
+                            AnimationFrameRec::Visitor, &query)) {
+                requiredImage = image_from_cached_data(value.fInfo, value.fData);
+            }
+        }
+    }
+    if (requiredImage) {
+        auto canvas = SkCanvas::MakeRasterDirect(imageInfo, pixels, rb);
         if (origin != kDefault_SkEncodedOrigin) {
             // The required frame is stored after applying the origin. Undo that,
             // because the codec decodes prior to applying the origin.
@@ -110,30 +297,29 @@ sk_sp<SkImage> SkAnimCodecPlayer::getFrameAt(int index) {
         opts.fPriorFrame = requiredFrame;
     }
 
-    if (SkCodec::kSuccess != fCodec->getPixels(imageInfo, data->writable_data(), rb, &opts)) {
+    if (SkCodec::kSuccess != fCodec->getPixels(imageInfo, pixels, rb, &opts)) {
+        cached->unref();
         return nullptr;
     }
 
-    auto image = SkImages::RasterFromData(imageInfo, std::move(data), rb);
     if (origin != kDefault_SkEncodedOrigin) {
-        imageInfo = imageInfo.makeDimensions(orientedDims);
-        rb = imageInfo.minRowBytes();
-        size = imageInfo.computeByteSize(rb);
-        data = SkData::MakeUninitialized(size);
-        auto canvas = SkCanvas::MakeRasterDirect(imageInfo, data->writable_data(), rb);
+        auto image = SkImages::RasterFromPixmap(SkPixmap(imageInfo, pixels, rb), nullptr,
+                                                nullptr);
+        auto canvas = SkCanvas::MakeRasterDirect(orientedInfo, cached->writable_data(),
+                                                 orientedInfo.minRowBytes());
         canvas->concat(originMatrix);
         canvas->drawImage(image, 0, 0, SkSamplingOptions(), &paint);
-        image = SkImages::RasterFromData(imageInfo, std::move(data), rb);
     }
-    return fImages[index] = image;
+    CHECK_LOCAL(fLocalCache, add, Add,
+                new AnimationFrameRec(AnimationFrameKey(fAnimationID, index), orientedInfo,
+                                      cached, fSharedData));
+    return image_from_cached_data(orientedInfo, cached);
 }
 
 sk_sp<SkImage> SkAnimCodecPlayer::getFrame() {
-    SkASSERT(fTotalDuration > 0 || fImages.size() == 1);
-
     return fTotalDuration > 0
         ? this->getFrameAt(fCurrIndex)
-        : fImages.front();
+        : fStaticImage;
 }
 
 bool SkAnimCodecPlayer::seek(uint32_t msec) {
@@ -0,0 +1,43 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAnimCodecPlayerPriv_DEFINED
+#define SkAnimCodecPlayerPriv_DEFINED
+
+#include "include/codec/SkCodec.h"
+#include "include/core/SkData.h"
+#include "include/core/SkRefCnt.h"
+#include "include/utils/SkAnimCodecPlayer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class SkResourceCache;
+
+// Players that keep their frames in a local SkResourceCache rather than the global one, so that
+// tests can purge and measure their frames without affecting, or being affected by, anything else.
+class SkAnimCodecPlayerPriv {
+public:
+    // Like SkAnimCodecPlayer(codec) if data is null, or SkAnimCodecPlayer(codec, data) if not.
+    static std::unique_ptr<SkAnimCodecPlayer> Make(std::unique_ptr<SkCodec> codec,
+                                                   sk_sp<SkData> data,
+                                                   SkResourceCache* localCache);
+
+    // Like Make(codec, data, localCache), but finds shared frames under animationID rather than
+    // a hash of data, e.g. to make players of different data collide.
+    static std::unique_ptr<SkAnimCodecPlayer> Make(std::unique_ptr<SkCodec> codec,
+                                                   sk_sp<SkData> data,
+                                                   uint64_t animationID,
+                                                   SkResourceCache* localCache);
+
+    static size_t CachedFrameBytes(SkResourceCache* localCache) {
+        return SkAnimCodecPlayer::CachedFrameBytes(localCache);
+    }
+};
+
+#endif  // SkAnimCodecPlayerPriv_DEFINED
@@ -12,6 +12,7 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorPriv.h"
 #include "include/core/SkColorType.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMaskFilter.h"
 #include "include/core/SkPaint.h"
@@ -30,11 +31,14 @@
 #include "include/gpu/GpuTypes.h"
 #include "include/gpu/GrDirectContext.h"
 #include "include/gpu/ganesh/SkSurfaceGanesh.h"
+#include "include/private/SkColorData.h"
 #include "include/private/base/SkFloatBits.h"
 #include "include/private/base/SkTPin.h"
 #include "src/base/SkMathPriv.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkBlurMask.h"
 #include "src/core/SkMask.h"
+#include "src/core/SkMaskBlurFilter.h"
 #include "src/core/SkMaskFilterBase.h"
 #include "src/effects/SkEmbossMaskFilter.h"
 #include "src/gpu/ganesh/GrBlurUtils.h"
@@ -45,9 +49,13 @@
 #include <math.h>
 #include <string.h>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <initializer_list>
+#include <memory>
+#include <vector>
 
 struct GrContextOptions;
 
@@ -586,3 +594,131 @@ DEF_TEST(zero_blur, reporter) {
     SkIPoint offset;
     bitmap.extractAlpha(&alpha, &paint, nullptr, &offset);
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+// Runs work on a thread pool, counting how much it was given.
+class CountingExecutor final : public SkExecutor {
+public:
+    explicit CountingExecutor(int threads) : fPool(SkExecutor::MakeFIFOThreadPool(threads)) {}
+
+    void add(std::function<void(void)> work) override {
+        fAdded.fetch_add(1, std::memory_order_relaxed);
+        fPool->add(std::move(work));
+    }
+    void borrow() override { fPool->borrow(); }
+    int concurrency() const override { return fPool->concurrency(); }
+
+    int added() const { return fAdded.load(std::memory_order_relaxed); }
+
+private:
+    std::unique_ptr<SkExecutor> fPool;
+    std::atomic<int>            fAdded{0};
+};
+}  // namespace
+
+// SkMaskBlurFilter blurs several rows at a time, one per SIMD lane, and large masks in groups of
+// rows on an executor. That must match the scalar code that blurs one row at a time exactly.
+// Padding a mask with empty rows and columns moves every row into a different lane and group, but
+// must only move the blur, never change it. BW, ARGB32 and LCD16 masks are converted to A8 before
+// blurring, and must blur just like the same A8 mask.
+DEF_TEST(MaskBlurFilterRows, reporter) {
+    struct {
+        int    width, height;
+        double sigmaW, sigmaH;
+        bool   inGroups;  // Big enough to blur in groups of rows on the executor.
+    } cases[] = {
+        { 37,  29,   2.5,   2.5, false},
+        {  5,  61,   7.0,   3.0, false},
+        { 61,   5,   3.0,   7.0, false},
+        { 90,  70,  20.0,  20.0, false},
+        {  3,   3, 100.0, 100.0,  true},
+        {300, 260,  40.0,  40.0,  true},
+    };
+    static constexpr int kPadLeft = 5, kPadTop = 3, kPadRight = 2, kPadBottom = 11;
+
+    CountingExecutor executor(3);
+    SkRandom rand;
+    for (const auto& c : cases) {
+        const SkMaskBlurFilter filter{c.sigmaW, c.sigmaH};
+
+        // The same mask of 0s and 255s in each format, and the A8 one padded with 0s.
+        const int paddedW = c.width  + kPadLeft + kPadRight,
+                  paddedH = c.height + kPadTop  + kPadBottom,
+                  bwRB    = (c.width + 7) / 8;
+        std::vector<uint8_t>  a8(c.width * c.height),
+                              bw(bwRB * c.height),
+                              padded(paddedW * paddedH);
+        std::vector<uint32_t> argb(c.width * c.height);
+        std::vector<uint16_t> lcd(c.width * c.height);
+        for (int y = 0; y < c.height; y++) {
+            for (int x = 0; x < c.width; x++) {
+                if (rand.nextULessThan(3) == 0) {
+                    a8[y * c.width + x] = 0xFF;
+                    padded[(y + kPadTop) * paddedW + x + kPadLeft] = 0xFF;
+                    bw[y * bwRB + x / 8] |= 0x80 >> (x % 8);
+                    argb[y * c.width + x] = SkPackARGB32(0xFF, 0xFF, 0xFF, 0xFF);
+                    lcd[y * c.width + x] = SkPack888ToRGB16(0xFF, 0xFF, 0xFF);
+                }
+            }
+        }
+
+        const SkIRect bounds = SkIRect::MakeXYWH(10, 20, c.width, c.height);
+        const SkMask masks[] = {
+            SkMask(a8.data(), bounds, c.width, SkMask::kA8_Format),
+            SkMask(bw.data(), bounds, bwRB, SkMask::kBW_Format),
+            SkMask(reinterpret_cast<const uint8_t*>(argb.data()), bounds,
+                   c.width * sizeof(uint32_t), SkMask::kARGB32_Format),
+            SkMask(reinterpret_cast<const uint8_t*>(lcd.data()), bounds,
+                   c.width * sizeof(uint16_t), SkMask::kLCD16_Format),
+        };
+
+        SkMaskBuilder expected;
+        filter.blurRowByRowForTesting(masks[0], &expected);
+        SkAutoMaskFreeImage freeExpected(expected.image());
+
+        for (const SkMask& mask : masks) {
+            SkMaskBuilder rowByRow, severalRows, onExecutor;
+            filter.blurRowByRowForTesting(mask, &rowByRow);
+            filter.blur(mask, &severalRows);
+            const int addedBefore = executor.added();
+            filter.blurForTesting(mask, &onExecutor, executor);
+            REPORTER_ASSERT(reporter, (executor.added() > addedBefore) == c.inGroups,
+                            "format %d, %dx%d, sigma %g x %g",
+                            (int)mask.fFormat, c.width, c.height, c.sigmaW, c.sigmaH);
+            SkAutoMaskFreeImage freeRowByRow(rowByRow.image()),
+                                freeSeveralRows(severalRows.image()),
+                                freeOnExecutor(onExecutor.image());
+
+            for (const SkMaskBuilder* blurred : {&rowByRow, &severalRows, &onExecutor}) {
+                REPORTER_ASSERT(reporter, expected.fBounds == blurred->fBounds);
+                REPORTER_ASSERT(reporter, 0 == memcmp(expected.fImage, blurred->fImage,
+                                                      expected.computeImageSize()),
+                                "format %d, %s, %dx%d, sigma %g x %g", (int)mask.fFormat,
+                                blurred == &rowByRow    ? "row by row" :
+                                blurred == &severalRows ? "several rows" : "on executor",
+                                c.width, c.height, c.sigmaW, c.sigmaH);
+            }
+        }
+
+        SkMaskBuilder fromPadded;
+        filter.blurForTesting(SkMask(padded.data(),
+                                     SkIRect::MakeXYWH(bounds.fLeft - kPadLeft,
+                                                       bounds.fTop - kPadTop,
+                                                       paddedW, paddedH),
+                                     paddedW, SkMask::kA8_Format),
+                              &fromPadded, executor);
+        SkAutoMaskFreeImage freePadded(fromPadded.image());
+
+        int mismatches = 0;
+        for (int y = fromPadded.fBounds.fTop; y < fromPadded.fBounds.fBottom; y++) {
+            for (int x = fromPadded.fBounds.fLeft; x < fromPadded.fBounds.fRight; x++) {
+                uint8_t want = expected.fBounds.contains(x, y) ? *expected.getAddr8(x, y) : 0;
+                mismatches += *fromPadded.getAddr8(x, y) != want;
+            }
+        }
+        REPORTER_ASSERT(reporter, mismatches == 0, "%dx%d, sigma %g x %g",
+                        c.width, c.height, c.sigmaW, c.sigmaH);
+    }
+}
@@ -11,17 +11,25 @@
 #include "include/codec/SkEncodedOrigin.h"
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkBitmap.h"
+#include "include/core/SkColor.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkPixmap.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkSize.h"
+#include "include/core/SkStream.h"
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
+#include "include/private/SkEncodedInfo.h"
 #include "include/utils/SkAnimCodecPlayer.h"
+#include "modules/skcms/skcms.h"
+#include "src/codec/SkFrameHolder.h"
+#include "src/core/SkResourceCache.h"
+#include "src/utils/SkAnimCodecPlayerPriv.h"
 #include "tests/CodecPriv.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
@@ -626,3 +634,152 @@ DEF_TEST(AnimCodecPlayer, r) {
                         "Mismatched size for frame at 500 ms of %s", test.fFile);
     }
 }
+
+namespace {
+// An animation that needs no decoder library. Each frame keeps the one before and paints a band of
+// rows in colors taken from the encoded bytes, so different data animates differently.
+class BandAnimCodec final : public SkCodec {
+public:
+    static constexpr int kFrames = 6, kWidth = 16, kHeight = 4 * kFrames;
+
+    // Counts the frames that the codec decodes in *decodes.
+    BandAnimCodec(sk_sp<SkData> data, int* decodes)
+            : SkCodec(SkEncodedInfo::Make(kWidth, kHeight, SkEncodedInfo::kRGBA_Color,
+                                          SkEncodedInfo::kOpaque_Alpha, 8),
+                      skcms_PixelFormat_RGBA_8888, SkMemoryStream::Make(data))
+            , fData(std::move(data))
+            , fDecodes(decodes) {
+        for (int i = 0; i < kFrames; i++) {
+            Frame& frame = fFrameHolder.fFrames.emplace_back(i);
+            frame.setXYWH(0, 0, kWidth, kHeight);
+            frame.setDuration(100);
+            frame.setRequiredFrame(i == 0 ? kNoFrame : i - 1);
+        }
+    }
+
+private:
+    struct Frame final : public SkFrame {
+        explicit Frame(int id) : SkFrame(id) {}
+        SkEncodedInfo::Alpha onReportedAlpha() const override {
+            return SkEncodedInfo::kOpaque_Alpha;
+        }
+    };
+    struct FrameHolder final : public SkFrameHolder {
+        const SkFrame* onGetFrame(int i) const override { return &fFrames[i]; }
+        std::vector<Frame> fFrames;
+    };
+
+    SkEncodedImageFormat onGetEncodedFormat() const override {
+        return SkEncodedImageFormat::kGIF;
+    }
+    int onGetFrameCount() override { return kFrames; }
+    bool onGetFrameInfo(int i, FrameInfo* info) const override {
+        if (i < 0 || i >= kFrames) {
+            return false;
+        }
+        if (info) {
+            fFrameHolder.fFrames[i].fillIn(info, true);
+        }
+        return true;
+    }
+    const SkFrameHolder* getFrameHolder() const override { return &fFrameHolder; }
+    bool onRewind() override { return true; }
+
+    Result onGetPixels(const SkImageInfo& info, void* pixels, size_t rowBytes,
+                       const Options& options, int*) override {
+        // SkCodec has already put the frame before this one in pixels.
+        const int i = options.fFrameIndex;
+        const uint8_t* bytes = fData->bytes();
+        const SkColor color = SkColorSetRGB(bytes[i % fData->size()],
+                                            bytes[(i + 1) % fData->size()], 0x80);
+        SkPixmap(info, pixels, rowBytes).erase(color, SkIRect::MakeXYWH(0, i * 4, kWidth, 4));
+        (*fDecodes)++;
+        return kSuccess;
+    }
+
+    sk_sp<SkData> fData;
+    int*          fDecodes;
+    FrameHolder   fFrameHolder;
+};
+}  // namespace
+
+DEF_TEST(AnimCodecPlayer_sharedFrames, r) {
+    // The frames go in a local cache, which no other test purges.
+    SkResourceCache cache(64 * 1024 * 1024);
+
+    static constexpr char kBytes[] = "shared animation";
+    sk_sp<SkData> data = SkData::MakeWithCopy(kBytes, sizeof(kBytes));
+    // The same bytes in another SkData share frames too.
+    sk_sp<SkData> copy = SkData::MakeWithCopy(kBytes, sizeof(kBytes));
+
+    int unsharedDecodes = 0, decodesA = 0, decodesB = 0;
+    auto unshared = SkAnimCodecPlayerPriv::Make(
+            std::make_unique<BandAnimCodec>(data, &unsharedDecodes), nullptr, &cache);
+    auto sharedA = SkAnimCodecPlayerPriv::Make(
+            std::make_unique<BandAnimCodec>(data, &decodesA), data, &cache);
+    auto sharedB = SkAnimCodecPlayerPriv::Make(
+            std::make_unique<BandAnimCodec>(copy, &decodesB), copy, &cache);
+    REPORTER_ASSERT(r, unshared->duration() == 100 * BandAnimCodec::kFrames);
+
+    // Play through twice, the second time after the cache is purged, with player B picking up
+    // frames that player A decoded, and with both seeking backwards at the start.
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1) {
+            cache.purgeAll();
+            REPORTER_ASSERT(r, SkAnimCodecPlayerPriv::CachedFrameBytes(&cache) == 0);
+        }
+        decodesA = decodesB = 0;
+        for (uint32_t msec = 0; msec < unshared->duration(); msec += 50) {
+            unshared->seek(msec);
+            sharedA->seek(msec);
+            sharedB->seek(msec);
+
+            sk_sp<SkImage> expected = unshared->getFrame();
+            sk_sp<SkImage> a = sharedA->getFrame();
+            sk_sp<SkImage> b = sharedB->getFrame();
+            REPORTER_ASSERT(r, expected && a && b);
+            if (!expected || !a || !b) {
+                return;
+            }
+            REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected.get(), a.get()),
+                            "mismatched shared frame at %u ms", msec);
+            REPORTER_ASSERT(r, ToolUtils::equal_pixels(expected.get(), b.get()),
+                            "mismatched shared frame at %u ms", msec);
+            // Asking again for the same frame returns the same image.
+            REPORTER_ASSERT(r, sharedA->getFrame() == a);
+        }
+        REPORTER_ASSERT(r, decodesA == BandAnimCodec::kFrames && decodesB == 0,
+                        "pass %d: A decoded %d frames, B %d", pass, decodesA, decodesB);
+        REPORTER_ASSERT(r, SkAnimCodecPlayerPriv::CachedFrameBytes(&cache) > 0);
+    }
+
+    // Players of different data whose animation IDs collide must not use each other's frames.
+    static constexpr char kOtherBytes[] = "another animation";
+    sk_sp<SkData> other = SkData::MakeWithCopy(kOtherBytes, sizeof(kOtherBytes));
+    int otherDecodes = 0, collidingDecodes = 0;
+    auto otherUnshared = SkAnimCodecPlayerPriv::Make(
+            std::make_unique<BandAnimCodec>(other, &otherDecodes), nullptr, &cache);
+    const uint64_t animationID = 0x1234;
+    auto first = SkAnimCodecPlayerPriv::Make(
+            std::make_unique<BandAnimCodec>(data, &decodesA), data, animationID, &cache);
+    auto colliding = SkAnimCodecPlayerPriv::Make(
+            std::make_unique<BandAnimCodec>(other, &collidingDecodes), other, animationID,
+            &cache);
+    for (uint32_t msec = 0; msec < unshared->duration(); msec += 100) {
+        for (SkAnimCodecPlayer* player : {unshared.get(), otherUnshared.get(), first.get(),
+                                          colliding.get()}) {
+            player->seek(msec);
+        }
+        sk_sp<SkImage> a = first->getFrame();
+        sk_sp<SkImage> b = colliding->getFrame();
+        REPORTER_ASSERT(r, a && b);
+        if (!a || !b) {
+            return;
+        }
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(unshared->getFrame().get(), a.get()),
+                        "mismatched frame at %u ms", msec);
+        REPORTER_ASSERT(r, ToolUtils::equal_pixels(otherUnshared->getFrame().get(), b.get()),
+                        "colliding animation got another's frame at %u ms", msec);
+    }
+    REPORTER_ASSERT(r, collidingDecodes == BandAnimCodec::kFrames);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/codec/SkCodec.h"
+#include "include/codec/SkCodecBatch.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
+#include "tests/Test.h"
+#include "tools/Resources.h"
+#include "tools/ToolUtils.h"
+
+#include <memory>
+#include <vector>
+
+// Batches decode the same pixels as decoding each image with its own codec, whether they run on
+// a thread pool or not, including when images share ICC profiles and some need color transforms.
+DEF_TEST(CodecBatch, r) {
+    const char* kPaths[] = {
+#if defined(SK_CODEC_DECODES_PNG)
+        "images/mandrill_64.png",
+        "images/color_wheel_with_profile.png",
+        "images/purple-displayprofile.png",
+        "images/plane_interlaced.png",
+        "images/index8.png",
+#endif
+#if defined(SK_CODEC_DECODES_JPEG)
+        "images/color_wheel.jpg",
+        "images/icc-v2-gbr.jpg",
+        "images/grayscale.jpg",
+#endif
+        "images/randPixels.bmp",
+        "images/mandrill.wbmp",
+    };
+    const sk_sp<SkColorSpace> kColorSpaces[] = {
+        SkColorSpace::MakeSRGB(),
+        SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB, SkNamedGamut::kDisplayP3),
+    };
+
+    // Each image is decoded twice to each color space, so the batch sees each profile again.
+    std::vector<sk_sp<SkData>> datas;
+    std::vector<SkBitmap> expected;
+    for (int repeat = 0; repeat < 2; repeat++) {
+        for (const sk_sp<SkColorSpace>& colorSpace : kColorSpaces) {
+            for (const char* path : kPaths) {
+                sk_sp<SkData> data = GetResourceAsData(path);
+                if (!data) {
+                    continue;
+                }
+                std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+                REPORTER_ASSERT(r, codec, "%s", path);
+                if (!codec) {
+                    continue;
+                }
+                SkBitmap bm;
+                bm.allocPixels(codec->getInfo().makeColorType(kN32_SkColorType)
+                                               .makeAlphaType(kPremul_SkAlphaType)
+                                               .makeColorSpace(colorSpace));
+                REPORTER_ASSERT(r, codec->getPixels(bm.pixmap()) == SkCodec::kSuccess, "%s", path);
+                datas.push_back(std::move(data));
+                expected.push_back(std::move(bm));
+            }
+        }
+    }
+    // Data that no codec recognizes fails on its own.
+    datas.push_back(SkData::MakeWithCString("not an image"));
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+    for (SkExecutor* exec : {(SkExecutor*)nullptr, executor.get()}) {
+        SkCodecBatch batch(exec);
+        // Decoding with the same batch again reuses its scratch, and its cached answers.
+        for (int pass = 0; pass < 2; pass++) {
+            std::vector<SkBitmap> actual(expected.size());
+            std::vector<SkCodecBatch::Image> images;
+            for (size_t i = 0; i < expected.size(); i++) {
+                actual[i].allocPixels(expected[i].info());
+                images.push_back({datas[i], actual[i].pixmap()});
+            }
+            SkBitmap unused;
+            unused.allocN32Pixels(1, 1);
+            images.push_back({datas.back(), unused.pixmap()});
+
+            std::vector<SkCodec::Result> results = batch.decode(images);
+            REPORTER_ASSERT(r, results.size() == images.size());
+            for (size_t i = 0; i < expected.size(); i++) {
+                REPORTER_ASSERT(r, results[i] == SkCodec::kSuccess, "image %zu", i);
+                REPORTER_ASSERT(r, ToolUtils::equal_pixels(actual[i], expected[i]), "image %zu", i);
+            }
+            REPORTER_ASSERT(r, results.back() == SkCodec::kInvalidInput);
+        }
+    }
+
+    SkCodecBatch batch(executor.get());
+    REPORTER_ASSERT(r, batch.decode(SkSpan<const SkCodecBatch::Image>()).empty());
+}
@@ -5,10 +5,12 @@
  * found in the LICENSE file.
  */
 
+#include "include/codec/SkAppendableStream.h"
 #include "include/codec/SkCodec.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkData.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
@@ -137,25 +139,128 @@ static void test_partial(skiatest::Reporter* r, const char* name, size_t minByte
 }
 
 DEF_TEST(Codec_partial, r) {
-#if 0
-    // FIXME (scroggo): SkPngCodec needs to use SkStreamBuffer in order to
-    // support incremental decoding.
     test_partial(r, "images/plane.png");
     test_partial(r, "images/plane_interlaced.png");
     test_partial(r, "images/yellow_rose.png");
     test_partial(r, "images/index8.png");
     test_partial(r, "images/color_wheel.png");
     test_partial(r, "images/mandrill_256.png");
-    test_partial(r, "images/mandrill_32.png");
+    // The iCCP chunk runs past the middle of the file, and the header must be read to
+    // create the codec.
+    test_partial(r, "images/mandrill_32.png", 2800);
     test_partial(r, "images/arrow.png");
     test_partial(r, "images/randPixels.png");
     test_partial(r, "images/baby_tux.png");
-#endif
+    test_partial(r, "images/mandrill_512_q075.jpg");
+    test_partial(r, "images/CMYK.jpg");
+    test_partial(r, "images/brickwork-texture.jpg");  // progressive
     test_partial(r, "images/box.gif");
     test_partial(r, "images/randPixels.gif", 215);
     test_partial(r, "images/color_wheel.gif");
 }
 
+// Decodes |name| from an SkAppendableStream that receives the data in pieces, and copies only the
+// rows that each call to incrementalDecode() reports as dirty. That copy must match a full decode.
+// If |sequential|, the image is decoded top to bottom in one pass, so each call must report just
+// the rows that its data completed: the rows after those reported before, up to rowsDecoded.
+static void test_dirty_rows(skiatest::Reporter* r, const char* name, bool sequential) {
+    sk_sp<SkData> file = GetResourceAsData(name);
+    if (!file) {
+        SkDebugf("missing resource %s\n", name);
+        return;
+    }
+
+    SkBitmap truth;
+    if (!create_truth(file, &truth)) {
+        ERRORF(r, "Failed to decode %s\n", name);
+        return;
+    }
+
+    auto owned = std::make_unique<SkAppendableStream>();
+    SkAppendableStream* stream = owned.get();
+    size_t appended = file->size() / 2;
+    stream->append(file->bytes(), appended);
+    auto codec = SkCodec::MakeFromStream(std::move(owned));
+    if (!codec) {
+        ERRORF(r, "Failed to create codec for %s with %zu bytes", name, appended);
+        return;
+    }
+
+    const SkImageInfo info = standardize_info(codec.get());
+    SkBitmap incremental, shown;
+    incremental.allocPixels(info);
+    shown.allocPixels(info);
+    if (codec->startIncrementalDecode(info, incremental.getPixels(), incremental.rowBytes()) !=
+        SkCodec::kSuccess) {
+        ERRORF(r, "Failed to start incremental decode of %s", name);
+        return;
+    }
+
+    constexpr size_t kIncrement = 1000;
+    int reportedRows = 0;
+    int rowsReportedBeforeLastCall = 0;
+    while (true) {
+        rowsReportedBeforeLastCall = reportedRows;
+        int rowsDecoded = 0;
+        SkIRect dirtyRows;
+        const SkCodec::Result result = codec->incrementalDecode(&rowsDecoded, &dirtyRows);
+        REPORTER_ASSERT(r, dirtyRows.isEmpty() || (dirtyRows.left() == 0 &&
+                                                   dirtyRows.right() == info.width() &&
+                                                   dirtyRows.top() >= 0 &&
+                                                   dirtyRows.bottom() <= info.height()));
+        for (int y = dirtyRows.top(); y < dirtyRows.bottom(); y++) {
+            memcpy(shown.getAddr(0, y), incremental.getAddr(0, y), info.minRowBytes());
+        }
+
+        if (sequential && !dirtyRows.isEmpty()) {
+            REPORTER_ASSERT(r, dirtyRows.top() == reportedRows,
+                            "%s: rows [%d, %d) reported after [0, %d)", name, dirtyRows.top(),
+                            dirtyRows.bottom(), reportedRows);
+            reportedRows = dirtyRows.bottom();
+        }
+
+        if (result == SkCodec::kSuccess) {
+            break;
+        }
+
+        REPORTER_ASSERT(r, result == SkCodec::kIncompleteInput);
+        if (sequential) {
+            REPORTER_ASSERT(r, reportedRows == rowsDecoded,
+                            "%s: rows [0, %d) reported, but %d decoded", name, reportedRows,
+                            rowsDecoded);
+        }
+
+        if (stream->isFinished()) {
+            ERRORF(r, "Failed to completely decode %s", name);
+            return;
+        }
+
+        const size_t size = std::min(kIncrement, file->size() - appended);
+        stream->append(file->bytes() + appended, size);
+        appended += size;
+        if (appended == file->size()) {
+            stream->finish();
+        }
+    }
+
+    if (sequential) {
+        // Together the disjoint ranges cover the image, each row reported once.
+        REPORTER_ASSERT(r, reportedRows == info.height(), "%s: rows [0, %d) reported of %d", name,
+                        reportedRows, info.height());
+        // The data arrived in pieces, so some rows were reported before the last call.
+        REPORTER_ASSERT(r, rowsReportedBeforeLastCall > 0, "%s", name);
+    }
+
+    compare_bitmaps(r, truth, shown);
+}
+
+DEF_TEST(Codec_partialDirtyRows, r) {
+    test_dirty_rows(r, "images/plane.png", /*sequential=*/true);
+    test_dirty_rows(r, "images/plane_interlaced.png", /*sequential=*/false);
+    test_dirty_rows(r, "images/mandrill_512_q075.jpg", /*sequential=*/true);
+    test_dirty_rows(r, "images/brickwork-texture.jpg", /*sequential=*/false);  // progressive
+}
+
 DEF_TEST(Codec_partialWuffs, r) {
     const char* path = "images/alphabetAnim.gif";
     auto file = GetResourceAsData(path);
@@ -8,6 +8,7 @@
 #include "include/codec/SkAndroidCodec.h"
 #include "include/codec/SkCodec.h"
 #include "include/codec/SkEncodedImageFormat.h"
+#include "include/codec/SkJpegDecoder.h"
 #include "include/codec/SkPngChunkReader.h"
 #include "include/core/SkAlphaType.h"
 #include "include/core/SkBitmap.h"
@@ -17,6 +18,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageGenerator.h"
 #include "include/core/SkImageInfo.h"
@@ -38,6 +40,7 @@
 #include "src/base/SkAutoMalloc.h"
 #include "src/base/SkRandom.h"
 #include "src/codec/SkCodecImageGenerator.h"
+#include "src/codec/SkJpegCodec.h"
 #include "src/core/SkColorSpacePriv.h"
 #include "src/core/SkMD5.h"
 #include "src/core/SkStreamPriv.h"
@@ -1339,7 +1342,6 @@ DEF_TEST(Codec_fallBack, r) {
 
     // Formats that currently do not support incremental decoding
     auto files = {
-            "images/CMYK.jpg",
             "images/color_wheel.ico",
             "images/mandrill.wbmp",
             "images/randPixels.bmp",
@@ -1959,3 +1961,203 @@ DEF_TEST(Codec_kBGR_101010x_XR_SkColorType_supported, r) {
     bool success = codec->getPixels(dstInfo, dstBm.getPixels(), dstBm.rowBytes());
     REPORTER_ASSERT(r, SkCodec::kSuccess == success);
 }
+
+#if defined(SK_CODEC_DECODES_JPEG)
+// Decoding in restart bands on an executor must produce exactly the pixels of a serial decode,
+// including at band edges where chroma upsampling reaches into the neighboring band.
+DEF_TEST(Codec_jpegRestartBands, r) {
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+
+    // 3024x4032 4:2:0 with a restart marker after every row of 189 MCUs, so bands can start
+    // every 8 MCU rows.
+    // The others have no restart markers, or are CMYK, and decode serially either way.
+    const struct {
+        const char* path;
+        bool        inBands;
+    } images[] = {
+        {"images/iphone_13_pro.jpeg",  true},
+        {"images/mandrill_cmyk.jpg",  false},
+        {"images/color_wheel.jpg",    false},
+    };
+    for (const auto& [path, inBands] : images) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkCodec> codec = SkJpegDecoder::Decode(data, nullptr);
+        REPORTER_ASSERT(r, codec, "%s", path);
+        if (!codec) {
+            return;
+        }
+        const SkImageInfo encodedInfo = codec->getInfo();
+        const SkImageInfo infos[] = {
+            encodedInfo,
+            encodedInfo.makeColorType(kBGRA_8888_SkColorType).makeColorSpace(nullptr),
+            encodedInfo.makeColorType(kRGBA_F16_SkColorType)
+                       .makeColorSpace(SkColorSpace::MakeSRGBLinear()),
+            encodedInfo.makeColorType(kRGB_565_SkColorType).makeColorSpace(nullptr),
+        };
+        for (const SkImageInfo& info : infos) {
+            SkBitmap expected, actual;
+            expected.allocPixels(info);
+            actual.allocPixels(info);
+            actual.eraseColor(SK_ColorTRANSPARENT);
+
+            SkCodec::Result result = SkJpegDecoder::Decode(data, nullptr)
+                                             ->getPixels(expected.pixmap());
+            if (result != SkCodec::kSuccess) {
+                // Not every color type is supported for every image.
+                continue;
+            }
+            std::unique_ptr<SkCodec> banded = SkJpegDecoder::Decode(data, nullptr);
+            SkCodec::Options options;
+            options.fExecutor = executor.get();
+            result = banded->getPixels(actual.pixmap(), &options);
+            REPORTER_ASSERT(r, result == SkCodec::kSuccess, "%s, colortype %d",
+                            path, info.colorType());
+            const int bands =
+                    static_cast<SkJpegCodec*>(banded.get())->restartBandsDecodedForTesting();
+            REPORTER_ASSERT(r, inBands ? bands >= 2 : bands == 0, "%s, colortype %d: %d bands",
+                            path, info.colorType(), bands);
+            REPORTER_ASSERT(r, md5(expected) == md5(actual), "%s, colortype %d",
+                            path, info.colorType());
+        }
+    }
+}
+
+// With a region index, subset decodes start at a restart marker partway down the image instead of
+// decoding every row above the subset. That must not change the pixels.
+DEF_TEST(Codec_jpegRegionIndex, r) {
+    sk_sp<SkData> data = GetResourceAsData("images/iphone_13_pro.jpeg");
+    if (!data) {
+        return;
+    }
+    std::unique_ptr<SkCodec> codec = SkJpegDecoder::Decode(data, nullptr);
+    REPORTER_ASSERT(r, codec);
+    sk_sp<SkData> index = SkJpegDecoder::BuildRegionIndex(codec.get());
+    REPORTER_ASSERT(r, index && index->size() < data->size() / 100);
+    if (!index) {
+        return;
+    }
+
+    // The index must match the data it is attached to.
+    std::unique_ptr<SkCodec> other =
+            SkJpegDecoder::Decode(GetResourceAsData("images/mandrill_cmyk.jpg"), nullptr);
+    REPORTER_ASSERT(r, other && !SkJpegDecoder::AttachRegionIndex(other.get(), *index));
+    sk_sp<SkData> truncated = SkData::MakeSubset(index.get(), 0, index->size() - 4);
+    REPORTER_ASSERT(r, !SkJpegDecoder::AttachRegionIndex(codec.get(), *truncated));
+    sk_sp<SkData> corrupt = SkData::MakeWithCopy(index->data(), index->size());
+    static_cast<uint8_t*>(corrupt->writable_data())[index->size() - 1] ^= 1;
+    REPORTER_ASSERT(r, !SkJpegDecoder::AttachRegionIndex(codec.get(), *corrupt));
+
+    // The image has a restart marker after every MCU row, so decoding can start at any multiple
+    // of 8 MCU rows (128 pixels). The middle subset starts at one of these, where the chroma
+    // upsampling of its first row needs the rows above.
+    const SkISize dims = codec->dimensions();
+    const SkIRect subsets[] = {
+        SkIRect::MakeWH(256, 256),
+        SkIRect::MakeXYWH(1001, 16 * 128, 301, 257),
+        SkIRect::MakeXYWH(dims.width() - 256, dims.height() - 256, 256, 256),
+    };
+    for (const SkIRect& subset : subsets) {
+        for (int sampleSize : {1, 2}) {
+            SkBitmap expected, actual;
+            // Returns whether the decode started at a checkpoint.
+            auto decode = [&](SkBitmap* bm, const SkData* regionIndex) {
+                std::unique_ptr<SkCodec> jpeg = SkJpegDecoder::Decode(data, nullptr);
+                if (regionIndex) {
+                    REPORTER_ASSERT(r, SkJpegDecoder::AttachRegionIndex(jpeg.get(), *regionIndex));
+                }
+                const SkJpegCodec* jpegCodec = static_cast<SkJpegCodec*>(jpeg.get());
+                auto androidCodec = SkAndroidCodec::MakeFromCodec(std::move(jpeg));
+                SkAndroidCodec::AndroidOptions options;
+                options.fSubset = &subset;
+                options.fSampleSize = sampleSize;
+                bm->allocPixels(androidCodec->getInfo().makeDimensions(
+                        androidCodec->getSampledSubsetDimensions(sampleSize, subset)));
+                SkCodec::Result result = androidCodec->getAndroidPixels(
+                        bm->info(), bm->getPixels(), bm->rowBytes(), &options);
+                REPORTER_ASSERT(r, result == SkCodec::kSuccess);
+                return jpegCodec->startedAtCheckpointForTesting();
+            };
+            REPORTER_ASSERT(r, !decode(&expected, nullptr));
+            // Only subsets below the first checkpoint can skip rows.
+            REPORTER_ASSERT(r, decode(&actual, index.get()) == (subset.y() > 0),
+                            "subset (%d, %d), sample size %d",
+                            subset.x(), subset.y(), sampleSize);
+            REPORTER_ASSERT(r, md5(expected) == md5(actual), "subset (%d, %d), sample size %d",
+                            subset.x(), subset.y(), sampleSize);
+        }
+    }
+}
+#endif
+
+// Codecs read streams in memory where they are, rather than copying them into buffers first.
+DEF_TEST(Codec_bytesCopiedFromStream, r) {
+    const char* paths[] = {
+#if defined(SK_CODEC_DECODES_PNG)
+        "images/mandrill_512.png",
+        "images/plane_interlaced.png",
+#endif
+#if defined(SK_CODEC_DECODES_JPEG)
+        "images/mandrill_512_q075.jpg",
+#endif
+        "images/randPixels.bmp",
+        "images/mandrill.wbmp",
+    };
+    for (const char* path : paths) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkCodec> inMemory = SkCodec::MakeFromData(data);
+        std::unique_ptr<SkCodec> notInMemory =
+                SkCodec::MakeFromStream(std::make_unique<NotAssetMemStream>(data));
+        if (!inMemory || !notInMemory) {
+            ERRORF(r, "Could not create codecs for %s", path);
+            continue;
+        }
+
+        SkBitmap expected, actual;
+        expected.allocPixels(inMemory->getInfo());
+        actual.allocPixels(inMemory->getInfo());
+        REPORTER_ASSERT(r, inMemory->getPixels(actual.pixmap()) == SkCodec::kSuccess, "%s", path);
+        REPORTER_ASSERT(r, inMemory->bytesCopiedFromStream() == 0, "%s copied %zu bytes", path,
+                        inMemory->bytesCopiedFromStream());
+
+        // A stream that is not in memory has to be copied, but decodes to the same pixels.
+        REPORTER_ASSERT(r, notInMemory->getPixels(expected.pixmap()) == SkCodec::kSuccess,
+                        "%s", path);
+        REPORTER_ASSERT(r, notInMemory->bytesCopiedFromStream() > 0, "%s", path);
+        REPORTER_ASSERT(r, md5(expected) == md5(actual), "%s", path);
+
+        // A second decode, which rewinds, and a scanline decode read in place too.
+        REPORTER_ASSERT(r, inMemory->getPixels(actual.pixmap()) == SkCodec::kSuccess, "%s", path);
+        REPORTER_ASSERT(r, inMemory->bytesCopiedFromStream() == 0, "%s", path);
+        if (inMemory->startScanlineDecode(actual.info()) == SkCodec::kSuccess) {
+            inMemory->getScanlines(actual.getPixels(), actual.height(), actual.rowBytes());
+            REPORTER_ASSERT(r, inMemory->bytesCopiedFromStream() == 0, "%s", path);
+        }
+    }
+
+#if defined(SK_CODEC_DECODES_JPEG)
+    // Bands decoded in parallel copy only the headers they are given.
+    sk_sp<SkData> data = GetResourceAsData("images/iphone_13_pro.jpeg");
+    if (!data) {
+        return;
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(data);
+    REPORTER_ASSERT(r, codec);
+    if (!codec) {
+        return;
+    }
+    SkBitmap bm;
+    bm.allocPixels(codec->getInfo());
+    SkCodec::Options options;
+    options.fExecutor = executor.get();
+    REPORTER_ASSERT(r, codec->getPixels(bm.pixmap(), &options) == SkCodec::kSuccess);
+    REPORTER_ASSERT(r, codec->bytesCopiedFromStream() < data->size() / 100,
+                    "copied %zu of %zu bytes", codec->bytesCopiedFromStream(), data->size());
+#endif
+}
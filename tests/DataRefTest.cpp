@@ -12,6 +12,7 @@
 #include "include/core/SkString.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkMalloc.h"
+#include "src/core/SkDataPriv.h"
 #include "src/core/SkOSFile.h"
 #include "src/utils/SkOSPath.h"
 #include "tests/Test.h"
@@ -171,12 +172,15 @@ static void test_files(skiatest::Reporter* reporter) {
     REPORTER_ASSERT(reporter, r1.get() != nullptr);
     REPORTER_ASSERT(reporter, r1->size() == 26);
     REPORTER_ASSERT(reporter, strncmp(static_cast<const char*>(r1->data()), s, 26) == 0);
+    REPORTER_ASSERT(reporter, SkDataPriv::IsFileMapped(*r1));
 
     int fd = sk_fileno(file);
     sk_sp<SkData> r2(SkData::MakeFromFD(fd));
     REPORTER_ASSERT(reporter, r2.get() != nullptr);
     REPORTER_ASSERT(reporter, r2->size() == 26);
     REPORTER_ASSERT(reporter, strncmp(static_cast<const char*>(r2->data()), s, 26) == 0);
+    REPORTER_ASSERT(reporter, SkDataPriv::IsFileMapped(*r2));
+    REPORTER_ASSERT(reporter, !SkDataPriv::IsFileMapped(*SkData::MakeWithCopy(s, 26)));
 }
 
 DEF_TEST(Data, reporter) {
@@ -7,7 +7,9 @@
 
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
+#include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
 #include "include/core/SkPaint.h"
@@ -19,14 +21,24 @@
 #include "include/core/SkRRect.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkRegion.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkStrokeRec.h"
 #include "include/core/SkSurface.h"
+#include "include/core/SkSurfaceProps.h"
+#include "include/core/SkTileMode.h"
 #include "include/core/SkTypes.h"
 #include "include/effects/SkDashPathEffect.h"
+#include "include/effects/SkGradientShader.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/base/SkRandom.h"
+#include "src/core/SkBlitter.h"
+#include "src/core/SkRasterClip.h"
+#include "src/core/SkScan.h"
 #include "tests/Test.h"
 
 #include <cstdint>
+#include <memory>
 
 // test that we can draw an aa-rect at coordinates > 32K (bigger than fixedpoint)
 static void test_big_aa_rect(skiatest::Reporter* reporter) {
@@ -424,3 +436,145 @@ DEF_TEST(DrawPath, reporter) {
     test_big_aa_rect(reporter);
     test_halfway();
 }
+
+static int count_differing_pixels(const SkBitmap& a, const SkBitmap& b) {
+    int differing = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            differing += *a.getAddr32(x, y) != *b.getAddr32(x, y);
+        }
+    }
+    return differing;
+}
+
+// Big fills draw in bands when the surface has an executor for them. Each band starts walking
+// the path's edges at its own top row, and must draw exactly what one pass over them would.
+DEF_TEST(DrawPathInBands, reporter) {
+    const SkImageInfo info = SkImageInfo::MakeN32Premul(300, 400);
+    constexpr int kBandHeight = 64;  // Matches SkDrawBase.
+
+    SkPath paths[3];
+    // A jagged, self-intersecting star of lines, and the same star with curves.
+    SkRandom rand;
+    for (int i = 0; i < 12000; i++) {
+        SkScalar angle = 2 * SK_ScalarPI * i / 12000 * 7,
+                 r     = 100 + 80 * SkScalarSin(angle * 3.1f) + rand.nextRangeF(0, 15);
+        SkPoint p = {150 + r * SkScalarCos(angle), 200 + r * SkScalarSin(angle)};
+        if (i == 0) {
+            paths[0].moveTo(p);
+            paths[1].moveTo(p);
+        } else {
+            paths[0].lineTo(p);
+            SkPoint c = {p.fX + rand.nextRangeF(-9, 9), p.fY + rand.nextRangeF(-9, 9)};
+            i % 2 ? paths[1].quadTo(c, p) : paths[1].cubicTo(c, {2 * p.fX - c.fX, c.fY}, p);
+        }
+    }
+    // A sheared grid of squares, each wound the same way, so neighbors share sides that run in
+    // opposite directions. Bands start with those edges tied in x.
+    for (int j = 0; j < 50; j++) {
+        for (int i = 0; i < 50; i++) {
+            auto corner = [](int i, int j) {
+                return SkPoint{10 + 5.25f * i + 0.3f * 7.5f * j, 10.5f + 7.5f * j};
+            };
+            paths[2].moveTo(corner(i, j));
+            paths[2].lineTo(corner(i + 1, j));
+            paths[2].lineTo(corner(i + 1, j + 1));
+            paths[2].lineTo(corner(i, j + 1));
+            paths[2].close();
+        }
+    }
+
+    SkPaint gradient;
+    {
+        const SkPoint pts[] = {{0, 0}, {300, 400}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+        gradient.setShader(
+                SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kClamp));
+    }
+    SkPaint solid;
+    solid.setColor(0xff336699);
+
+    enum class Clip { kNone, kRRect, kAARRect, kRegion };
+    const SkRRect clipRRect = SkRRect::MakeRectXY(SkRect::MakeLTRB(7.5f, 3, 290, 397), 40, 40);
+    SkRegion clipRegion;
+    clipRegion.op(SkIRect::MakeLTRB(0, 0, 200, 250), SkRegion::kUnion_Op);
+    clipRegion.op(SkIRect::MakeLTRB(100, 150, 300, 400), SkRegion::kUnion_Op);
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+    REPORTER_ASSERT(reporter, !SkSurfaces::SetPathFillExecutor(SkSurfaces::Null(300, 400).get(),
+                                                                executor.get()));
+
+    for (SkPath& path : paths) {
+    for (SkPathFillType fillType : {SkPathFillType::kWinding, SkPathFillType::kEvenOdd,
+                                    SkPathFillType::kInverseWinding}) {
+    for (bool aa : {false, true}) {
+    for (Clip clip : {Clip::kNone, Clip::kRRect, Clip::kAARRect, Clip::kRegion}) {
+    for (const SkPaint* basePaint : {&solid, &gradient}) {
+        path.setFillType(fillType);
+        SkPaint paint(*basePaint);
+        paint.setAntiAlias(aa);
+
+        auto clip_canvas = [&](SkCanvas* canvas) {
+            switch (clip) {
+                case Clip::kNone:    break;
+                case Clip::kRRect:   canvas->clipRRect(clipRRect, false); break;
+                case Clip::kAARRect: canvas->clipRRect(clipRRect, true); break;
+                case Clip::kRegion:  canvas->clipRegion(clipRegion); break;
+            }
+        };
+        auto draw = [&](SkExecutor* fillExecutor) {
+            sk_sp<SkSurface> surface = SkSurfaces::Raster(info);
+            REPORTER_ASSERT(reporter,
+                            SkSurfaces::SetPathFillExecutor(surface.get(), fillExecutor));
+            SkCanvas* canvas = surface->getCanvas();
+            canvas->clear(SK_ColorWHITE);
+            clip_canvas(canvas);
+            canvas->drawPath(path, paint);
+            SkBitmap bitmap;
+            bitmap.allocPixels(info);
+            surface->readPixels(bitmap, 0, 0);
+            return bitmap;
+        };
+
+        // The device draws in bands exactly when SkBandedFill can split the fill up.
+        SkRasterClip rasterClip(info.bounds());
+        switch (clip) {
+            case Clip::kNone:    break;
+            case Clip::kRRect:   rasterClip.op(clipRRect, SkMatrix::I(), SkClipOp::kIntersect,
+                                               false); break;
+            case Clip::kAARRect: rasterClip.op(clipRRect, SkMatrix::I(), SkClipOp::kIntersect,
+                                               true); break;
+            case Clip::kRegion:  rasterClip.op(clipRegion, SkClipOp::kIntersect); break;
+        }
+        SkBandedFill fill;
+        bool banded = fill.init(path, rasterClip, aa, kBandHeight) && fill.bandCount() >= 2;
+        REPORTER_ASSERT(reporter, banded == !path.isInverseFillType(),
+                        "fill type %d, aa %d, clip %d", (int)fillType, aa, (int)clip);
+
+        SkBitmap whole = draw(nullptr);
+        if (banded) {
+            // Bands may draw in any order.
+            SkBitmap bands;
+            bands.allocPixels(info);
+            bands.eraseColor(SK_ColorWHITE);
+            for (int band = fill.bandCount(); band --> 0;) {
+                SkSTArenaAlloc<2048> alloc;
+                SkBlitter* blitter = SkBlitter::Choose(bands.pixmap(), SkMatrix::I(), paint,
+                                                       &alloc, false, nullptr, SkSurfaceProps());
+                fill.fillBand(band, blitter);
+            }
+            int differing = count_differing_pixels(bands, whole);
+            REPORTER_ASSERT(reporter, differing == 0,
+                            "SkBandedFill: %d pixels differ: fill type %d, aa %d, clip %d",
+                            differing, (int)fillType, aa, (int)clip);
+        }
+        int differing = count_differing_pixels(draw(executor.get()), whole);
+        REPORTER_ASSERT(reporter, differing == 0,
+                        "%d pixels differ: fill type %d, aa %d, clip %d",
+                        differing, (int)fillType, aa, (int)clip);
+    }
+    }
+    }
+    }
+    }
+}
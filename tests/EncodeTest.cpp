@@ -15,20 +15,27 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkString.h"
 #include "include/core/SkSurface.h"
 #include "include/core/SkTypes.h"
+#include "include/core/SkYUVAInfo.h"
+#include "include/core/SkYUVAPixmaps.h"
 #include "include/encode/SkEncoder.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/encode/SkPngEncoder.h"
 #include "include/encode/SkWebpEncoder.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTemplates.h"
+#include "src/base/SkRandom.h"
 #include "src/core/SkImageInfoPriv.h"
+#include "src/core/SkPngFilters.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
@@ -37,9 +44,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 static bool encode(SkEncodedImageFormat format, SkWStream* dst, const SkPixmap& src) {
@@ -343,6 +355,260 @@ DEF_TEST(Encode_PngOptions, r) {
     REPORTER_ASSERT(r, almost_equals(bm0, bm2, 0));
 }
 
+// Returns the rows of a PNG as stored, uncompressed and unfiltered but otherwise untouched, or
+// nothing if libpng fails to read all of it.
+static std::vector<uint8_t> read_png_rows(const SkData& png) {
+    SkMemoryStream stream(png.data(), png.size());
+    std::vector<uint8_t> rows;
+    png_structp pngPtr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+    png_infop infoPtr = png_create_info_struct(pngPtr);
+    if (setjmp(png_jmpbuf(pngPtr))) {
+        png_destroy_read_struct(&pngPtr, &infoPtr, nullptr);
+        return {};
+    }
+    png_set_read_fn(pngPtr, &stream, [](png_structp pngPtr, png_bytep data, size_t length) {
+        if (static_cast<SkStream*>(png_get_io_ptr(pngPtr))->read(data, length) != length) {
+            png_error(pngPtr, "read past the end");
+        }
+    });
+    png_read_info(pngPtr, infoPtr);
+    const size_t rowBytes = png_get_rowbytes(pngPtr, infoPtr);
+    const png_uint_32 height = png_get_image_height(pngPtr, infoPtr);
+    rows.resize(rowBytes * height);
+    for (png_uint_32 y = 0; y < height; y++) {
+        png_read_row(pngPtr, rows.data() + y * rowBytes, nullptr);
+    }
+    // This checks the zlib stream's checksum, and the CRC of every chunk up to the end.
+    png_read_end(pngPtr, nullptr);
+    png_destroy_read_struct(&pngPtr, &infoPtr, nullptr);
+    return rows;
+}
+
+// Encoding with SkOpts' filters, in one band or in several on an executor, must make a valid PNG
+// of the same pixels as libpng's own row writer, for every filter and pixel size.
+DEF_TEST(Encode_PngExecutor, r) {
+    sk_sp<SkImage> mandrill = GetResourceAsImage("images/mandrill_512.png");
+    if (!mandrill) {
+        return;
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+
+    // Each is big enough to split into a few bands.
+    const SkImageInfo infos[] = {
+        SkImageInfo::MakeN32Premul(1024, 800),
+        SkImageInfo::MakeN32(1024, 800, kOpaque_SkAlphaType),
+        SkImageInfo::Make(512, 800, kRGBA_F16_SkColorType, kUnpremul_SkAlphaType),
+        SkImageInfo::Make(1024, 800, kRGB_565_SkColorType, kOpaque_SkAlphaType),
+        SkImageInfo::Make(2048, 1100, kGray_8_SkColorType, kOpaque_SkAlphaType),
+    };
+    for (const SkImageInfo& info : infos) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        SkCanvas canvas(bitmap);
+        canvas.clear(0x80FF8040);
+        canvas.drawImageRect(mandrill, SkRect::MakeWH(info.width(), info.height() / 2),
+                             SkSamplingOptions(SkFilterMode::kLinear));
+
+        // Every filter on its own for the first image, and choosing among them for all of them.
+        std::vector<std::pair<SkPngEncoder::FilterFlag, int>> optionsToTest = {
+            {SkPngEncoder::FilterFlag::kAll, 0},
+            {SkPngEncoder::FilterFlag::kAll, 6},
+        };
+        if (&info == infos) {
+            for (auto filter : {SkPngEncoder::FilterFlag::kNone,
+                                SkPngEncoder::FilterFlag::kSub,
+                                SkPngEncoder::FilterFlag::kUp,
+                                SkPngEncoder::FilterFlag::kAvg,
+                                SkPngEncoder::FilterFlag::kPaeth}) {
+                optionsToTest.push_back({filter, 1});
+            }
+        }
+        for (auto [filters, zlibLevel] : optionsToTest) {
+            SkPngEncoder::Options options;
+            options.fFilterFlags = filters;
+            options.fZLibLevel = zlibLevel;
+            // Encoding row by row goes through libpng's png_write_rows(), and so does Encode()
+            // by default.
+            SkDynamicMemoryWStream byRow, byDefault, skiaFilters, banded;
+            std::unique_ptr<SkEncoder> encoder = SkPngEncoder::Make(&byRow, bitmap.pixmap(),
+                                                                    options);
+            REPORTER_ASSERT(r, encoder && encoder->encodeRows(info.height()));
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&byDefault, bitmap.pixmap(), options));
+            options.fUseSkiaFilters = true;
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&skiaFilters, bitmap.pixmap(), options));
+            options.fUseSkiaFilters = false;
+            options.fExecutor = executor.get();
+            REPORTER_ASSERT(r, SkPngEncoder::Encode(&banded, bitmap.pixmap(), options));
+
+            sk_sp<SkData> byRowData = byRow.detachAsData();
+            REPORTER_ASSERT(r, byRowData->equals(byDefault.detachAsData().get()),
+                            "colortype %d, filters %d, level %d",
+                            info.colorType(), (int)filters, zlibLevel);
+            std::vector<uint8_t> expected = read_png_rows(*byRowData);
+            REPORTER_ASSERT(r, !expected.empty());
+            for (const sk_sp<SkData>& data : {skiaFilters.detachAsData(), banded.detachAsData()}) {
+                // Ending each band's compressed data on a byte boundary should cost little.
+                REPORTER_ASSERT(r, data->size() < byRowData->size() * 1.02 + 64,
+                                "colortype %d, filters %d, level %d: %zu vs %zu bytes",
+                                info.colorType(), (int)filters, zlibLevel,
+                                data->size(), byRowData->size());
+                REPORTER_ASSERT(r, read_png_rows(*data) == expected,
+                                "colortype %d, filters %d, level %d",
+                                info.colorType(), (int)filters, zlibLevel);
+            }
+        }
+    }
+}
+
+static SkBitmap decode_jpeg(const sk_sp<SkData>& jpeg) {
+    SkBitmap bitmap;
+    std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(jpeg);
+    if (!codec || !bitmap.tryAllocPixels(codec->getInfo()) ||
+        codec->getPixels(bitmap.pixmap()) != SkCodec::kSuccess) {
+        return {};
+    }
+    return bitmap;
+}
+
+static bool equal_pixels(const SkBitmap& a, const SkBitmap& b) {
+    if (a.drawsNothing() || a.info() != b.info()) {
+        return false;
+    }
+    for (int y = 0; y < a.height(); ++y) {
+        if (memcmp(a.getAddr(0, y), b.getAddr(0, y), a.info().minRowBytes()) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Encoding in strips codes the same coefficients as a serial encode, so it decodes to exactly the
+// same pixels.
+static void test_jpeg_strips(skiatest::Reporter* r,
+                             SkExecutor* executor,
+                             const char* name,
+                             const std::function<bool(SkWStream*,
+                                                      const SkJpegEncoder::Options&)>& encode) {
+    for (auto downsample : {SkJpegEncoder::Downsample::k420, SkJpegEncoder::Downsample::k444}) {
+        SkJpegEncoder::Options options;
+        options.fQuality = 90;
+        options.fDownsample = downsample;
+        SkDynamicMemoryWStream serial, striped;
+        REPORTER_ASSERT(r, encode(&serial, options));
+        options.fExecutor = executor;
+        REPORTER_ASSERT(r, encode(&striped, options));
+
+        sk_sp<SkData> serialData = serial.detachAsData(),
+                      stripedData = striped.detachAsData();
+        // The strips use the standard Huffman tables rather than optimized ones.
+        REPORTER_ASSERT(r, !serialData->equals(stripedData.get()), "%s", name);
+        REPORTER_ASSERT(r, stripedData->size() < serialData->size() * 1.15,
+                        "%s: %zu vs %zu bytes", name, stripedData->size(), serialData->size());
+        REPORTER_ASSERT(r, equal_pixels(decode_jpeg(stripedData), decode_jpeg(serialData)),
+                        "%s, downsample %d", name, (int)downsample);
+    }
+}
+
+DEF_TEST(Encode_JpegExecutor, r) {
+    sk_sp<SkImage> mandrill = GetResourceAsImage("images/mandrill_512.png");
+    if (!mandrill) {
+        return;
+    }
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(3);
+
+    // Each is big enough to split into a few strips, and the last two have a partial last MCU row.
+    const SkImageInfo infos[] = {
+        SkImageInfo::MakeN32Premul(1024, 800),
+        SkImageInfo::Make(768, 1000, kRGBA_F16_SkColorType, kUnpremul_SkAlphaType),
+        SkImageInfo::Make(1000, 790, kRGB_565_SkColorType, kOpaque_SkAlphaType),
+        SkImageInfo::Make(2048, 1100, kGray_8_SkColorType, kOpaque_SkAlphaType),
+    };
+    for (const SkImageInfo& info : infos) {
+        SkBitmap bitmap;
+        bitmap.allocPixels(info);
+        SkCanvas canvas(bitmap);
+        canvas.clear(0x80FF8040);
+        canvas.drawImageRect(mandrill, SkRect::MakeWH(info.width(), info.height() / 2),
+                             SkSamplingOptions(SkFilterMode::kLinear));
+        SkString name = SkStringPrintf("colortype %d", info.colorType());
+        test_jpeg_strips(r, executor.get(), name.c_str(),
+                         [&](SkWStream* dst, const SkJpegEncoder::Options& options) {
+                             return SkJpegEncoder::Encode(dst, bitmap.pixmap(), options);
+                         });
+    }
+
+    // Strips of a 4:2:0 image start on even rows of the chroma planes.
+    const SkYUVAInfo yuvaInfo({1000, 790},
+                              SkYUVAInfo::PlaneConfig::kY_U_V,
+                              SkYUVAInfo::Subsampling::k420,
+                              kJPEG_Full_SkYUVColorSpace);
+    SkYUVAPixmaps yuva = SkYUVAPixmaps::Allocate(
+            SkYUVAPixmapInfo(yuvaInfo, SkYUVAPixmapInfo::DataType::kUnorm8, nullptr));
+    REPORTER_ASSERT(r, yuva.isValid());
+    for (int i = 0; i < yuva.numPlanes(); ++i) {
+        const SkPixmap& plane = yuva.plane(i);
+        for (int y = 0; y < plane.height(); ++y) {
+            for (int x = 0; x < plane.width(); ++x) {
+                *plane.writable_addr8(x, y) = ((x * (i + 1) + y * y / 7) ^ (x * y >> 6)) & 0xFF;
+            }
+        }
+    }
+    test_jpeg_strips(r, executor.get(), "YUVA",
+                     [&](SkWStream* dst, const SkJpegEncoder::Options& options) {
+                         return SkJpegEncoder::Encode(dst, yuva, nullptr, options);
+                     });
+}
+
+static uint8_t paeth_predictor(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a),
+        pb = std::abs(p - b),
+        pc = std::abs(p - c);
+    return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+}
+
+// SkOpts' PNG filters must match the PNG spec byte for byte, and unfilter back to the same row, for
+// any row length (so that rows end partway through a vector) and any pixel size.
+DEF_TEST(Encode_PngFilterKernels, r) {
+    SkRandom random;
+    for (size_t bpp : {1, 2, 3, 4, 6, 8}) {
+        for (size_t rowBytes : {bpp, bpp * 5, bpp * 11, bpp * 16 + bpp, bpp * 40, bpp * 129}) {
+            std::vector<uint8_t> row(rowBytes), prev(rowBytes), dst(rowBytes);
+            for (size_t i = 0; i < rowBytes; i++) {
+                row[i] = random.nextU();
+                prev[i] = random.nextU();
+            }
+            for (int type = kNone_SkPngFilterType; type <= kLast_SkPngFilterType; type++) {
+                SkOpts::png_filter_row(static_cast<SkPngFilterType>(type), row.data(),
+                                       prev.data(), rowBytes, bpp, dst.data());
+                uint64_t expectedCost = 0;
+                for (size_t i = 0; i < rowBytes; i++) {
+                    const int a = i >= bpp ? row[i - bpp] : 0,
+                              b = prev[i],
+                              c = i >= bpp ? prev[i - bpp] : 0;
+                    const int predictor[] = {0, a, b, (a + b) >> 1, paeth_predictor(a, b, c)};
+                    const uint8_t expected = row[i] - predictor[type];
+                    REPORTER_ASSERT(r, dst[i] == expected, "bpp %zu, rowBytes %zu, type %d, i %zu",
+                                    bpp, rowBytes, type, i);
+                    expectedCost += expected < 128 ? expected : 256 - expected;
+                }
+                // Unfiltering, as SkPngCodec does through libpng, gets the row back.
+                std::vector<uint8_t> unfiltered = dst;
+                SkOpts::png_unfilter_row(static_cast<SkPngFilterType>(type), unfiltered.data(),
+                                         prev.data(), rowBytes, bpp);
+                REPORTER_ASSERT(r, unfiltered == row, "bpp %zu, rowBytes %zu, type %d",
+                                bpp, rowBytes, type);
+                REPORTER_ASSERT(r, SkOpts::png_filtered_row_cost(dst.data(), rowBytes, UINT64_MAX)
+                                   == expectedCost);
+                // Past the limit, any sum of at least the limit will do.
+                REPORTER_ASSERT(r, SkOpts::png_filtered_row_cost(dst.data(), rowBytes,
+                                                                 expectedCost / 2) >=
+                                   expectedCost / 2);
+            }
+        }
+    }
+}
+
 #ifndef SK_BUILD_FOR_GOOGLE3
 DEF_TEST(Encode_WebpQuality, r) {
     SkBitmap bm;
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkExecutor.h"
+#include "src/core/SkTaskGroup.h"
+#include "tests/Test.h"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static void test_executor(skiatest::Reporter* r, SkExecutor& executor) {
+    // A flat batch runs every task exactly once.
+    {
+        std::atomic<int> sum{0};
+        SkTaskGroup group(executor);
+        group.batch(1000, [&](int i) { sum.fetch_add(i, std::memory_order_relaxed); });
+        group.wait();
+        REPORTER_ASSERT(r, sum.load() == 999 * 1000 / 2);
+    }
+
+    // Tasks that add and wait on their own SkTaskGroups must not deadlock,
+    // even when there are many more of them than threads.
+    {
+        std::atomic<int> count{0};
+        SkTaskGroup outer(executor);
+        outer.batch(64, [&](int) {
+            SkTaskGroup inner(executor);
+            inner.batch(64, [&](int) { count.fetch_add(1, std::memory_order_relaxed); });
+            inner.wait();
+        });
+        outer.wait();
+        REPORTER_ASSERT(r, count.load() == 64 * 64);
+    }
+
+    // Work added from outside a task group still gets run.
+    {
+        std::atomic<int> count{0};
+        SkTaskGroup group(executor);
+        for (int i = 0; i < 100; i++) {
+            group.add([&] { count.fetch_add(1, std::memory_order_relaxed); });
+        }
+        group.wait();
+        REPORTER_ASSERT(r, count.load() == 100);
+    }
+
+    // Work run by the pool's own threads knows it's on an executor thread.
+    {
+        std::atomic<int> onExecutorThread{-1};
+        executor.add([&] { onExecutorThread.store(SkIsExecutorThread()); });
+        while (onExecutorThread.load() < 0) {
+            std::this_thread::yield();
+        }
+        REPORTER_ASSERT(r, onExecutorThread.load() == 1);
+    }
+}
+
+DEF_TEST(SkExecutor_FIFO, r) {
+    test_executor(r, *SkExecutor::MakeFIFOThreadPool(4));
+}
+
+DEF_TEST(SkExecutor_LIFO, r) {
+    test_executor(r, *SkExecutor::MakeLIFOThreadPool(4));
+}
+
+DEF_TEST(SkExecutor_WorkStealing, r) {
+    test_executor(r, *SkExecutor::MakeWorkStealingThreadPool(4));
+    test_executor(r, *SkExecutor::MakeWorkStealingThreadPool(1));
+    // Even without borrowing, the pool's own threads can run nested work while they wait.
+    test_executor(r, *SkExecutor::MakeWorkStealingThreadPool(2, /*allowBorrowing=*/false));
+}
+
+DEF_TEST(SkExecutor_WorkStealing_DeepBatch, r) {
+    // More nested work than fits in a thread's deque spills into its inbox.
+    auto executor = SkExecutor::MakeWorkStealingThreadPool(2);
+    std::atomic<int> count{0};
+    SkTaskGroup outer(*executor);
+    outer.add([&] {
+        SkTaskGroup inner(*executor);
+        inner.batch(5000, [&](int) { count.fetch_add(1, std::memory_order_relaxed); });
+        inner.wait();
+    });
+    outer.wait();
+    REPORTER_ASSERT(r, count.load() == 5000);
+}
+
+namespace {
+// Like the default SkExecutor when no thread pool is installed: runs all work immediately.
+class InlineExecutor final : public SkExecutor {
+public:
+    void add(std::function<void(void)> work) override { work(); }
+    int concurrency() const override { return 1; }
+};
+}  // namespace
+
+static void test_parallel_for(skiatest::Reporter* r, SkExecutor& executor) {
+    InlineExecutor inlineExecutor;
+    for (int count : {0, 1, 7, 64, 1000, 4097}) {
+        for (int grain : {1, 3, 64, 10000}) {
+            std::vector<int> hits(count, 0);
+            std::atomic<int> calls{0};
+            SkParallelFor(executor, count, grain, [&](int start, int end) {
+                REPORTER_ASSERT(r, 0 <= start && start < end && end <= count);
+                REPORTER_ASSERT(r, end - start <= grain);
+                REPORTER_ASSERT(r, start % grain == 0);
+                for (int i = start; i < end; i++) {
+                    hits[i]++;
+                }
+                calls.fetch_add(1, std::memory_order_relaxed);
+            });
+            for (int i = 0; i < count; i++) {
+                REPORTER_ASSERT(r, hits[i] == 1);
+            }
+            REPORTER_ASSERT(r, calls.load() == (count + grain - 1) / grain);
+
+            // Summing floats in chunk order must give the same answer no matter the executor.
+            auto sum = [&](SkExecutor& e) {
+                return SkParallelReduce(e, count, grain, 0.0f,
+                                        [](int start, int end) {
+                                            float partial = 0;
+                                            for (int i = start; i < end; i++) {
+                                                partial += 1.0f / (i + 1);
+                                            }
+                                            return partial;
+                                        },
+                                        [](float a, float b) { return a + b; });
+            };
+            REPORTER_ASSERT(r, sum(executor) == sum(inlineExecutor));
+        }
+    }
+}
+
+DEF_TEST(SkParallelFor, r) {
+    InlineExecutor inlineExecutor;
+    test_parallel_for(r, inlineExecutor);
+    test_parallel_for(r, *SkExecutor::MakeFIFOThreadPool(4));
+    test_parallel_for(r, *SkExecutor::MakeWorkStealingThreadPool(3));
+}
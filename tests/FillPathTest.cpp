@@ -5,17 +5,26 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPath.h"
 #include "include/core/SkPathTypes.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkMath.h"
+#include "include/private/base/SkTo.h"
 #include "src/core/SkBlitter.h"
+#include "src/core/SkMask.h"
 #include "src/core/SkScan.h"
 #include "tests/Test.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdlib>
 
 struct FakeBlitter : public SkBlitter {
     FakeBlitter()
@@ -52,3 +61,139 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+// Accumulates whatever it's asked to blit into an A8 bitmap, like the A8 blitter would with
+// kSrcOver, so we can compare scan converters that blit differently.
+struct CoverageBlitter : public SkBlitter {
+    CoverageBlitter(SkBitmap* dst) : fDst(dst) {}
+
+    void blitCoverage(int x, int y, int width, SkAlpha alpha) {
+        for (int i = 0; i < width; i++) {
+            uint8_t* a = fDst->getAddr8(x + i, y);
+            *a = SkToU8(*a + SkMulDiv255Round(alpha, 255 - *a));
+        }
+    }
+
+    void blitH(int x, int y, int width) override {
+        this->blitCoverage(x, y, width, 0xFF);
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        for (int n; (n = *runs) > 0; runs += n, antialias += n, x += n) {
+            this->blitCoverage(x, y, n, *antialias);
+        }
+    }
+
+    void blitV(int x, int y, int height, SkAlpha alpha) override {
+        for (int i = 0; i < height; i++) {
+            this->blitCoverage(x, y + i, 1, alpha);
+        }
+    }
+
+    void blitRect(int x, int y, int width, int height) override {
+        for (int i = 0; i < height; i++) {
+            this->blitH(x, y + i, width);
+        }
+    }
+
+    void blitMask(const SkMask& mask, const SkIRect& clip) override {
+        SkASSERT(mask.fFormat == SkMask::kA8_Format);
+        for (int y = clip.fTop; y < clip.fBottom; y++) {
+            for (int x = clip.fLeft; x < clip.fRight; x++) {
+                this->blitCoverage(x, y, 1, *mask.getAddr8(x, y));
+            }
+        }
+    }
+
+    SkBitmap* fDst;
+};
+
+static int max_diff(const SkBitmap& a, const SkBitmap& b) {
+    int diff = 0;
+    for (int y = 0; y < a.height(); y++) {
+        for (int x = 0; x < a.width(); x++) {
+            diff = std::max(diff, std::abs(*a.getAddr8(x, y) - *b.getAddr8(x, y)));
+        }
+    }
+    return diff;
+}
+
+// The sparse strip scan converter computes each pixel's coverage exactly (up to flattening
+// curves), where AAA approximates it along steep and short edges. So we hold it to a tight
+// tolerance against 16x16 supersampling, and to AAA's own tolerance against the usual AA fill.
+DEF_TEST(FillPathSparseStrips, reporter) {
+    constexpr int kW = 67, kH = 45, kSamples = 16;
+
+    SkPath paths[9];
+    paths[0].addCircle(20.3f, 21.7f, 15.2f);
+    paths[1].addRect(SkRect::MakeLTRB(3.25f, 4.5f, 40.75f, 17.5f));
+    paths[2].moveTo(2, 40).quadTo(30, -10, 60, 40).cubicTo(40, 20, 20, 60, 2, 40);
+    paths[3].addCircle(30, 22, 18).addCircle(30, 22, 10);  // Overlapping, so winding 2.
+    paths[4] = paths[3];
+    paths[4].setFillType(SkPathFillType::kEvenOdd);
+    paths[5].addOval(SkRect::MakeLTRB(-30, -12, 40, 30));  // Partly offscreen, up and left...
+    paths[6].addOval(SkRect::MakeLTRB(40, 20, 120, 80));   // ...and down and right.
+    // A run of small, glyph-like contours.
+    for (int i = 0; i < 8; i++) {
+        float x = 2.3f + i * 8.1f;
+        paths[7].moveTo(x, 30).lineTo(x + 3, 12.5f).lineTo(x + 6.2f, 30).close();
+        paths[7].addCircle(x + 3.1f, 36, 2.6f);
+    }
+    // A long thin sliver, narrower than a pixel.
+    paths[8].moveTo(1, 1).lineTo(66, 44).lineTo(65.6f, 44).close();
+
+    const SkIRect clips[] = {
+        SkIRect::MakeWH(kW, kH),
+        SkIRect::MakeLTRB(5, 7, 50, 31),  // Not aligned to tiles.
+    };
+
+    for (const SkIRect& clip : clips) {
+        for (const SkPath& path : paths) {
+            SkPaint paint;
+            SkBitmap supersampled;
+            supersampled.allocPixels(SkImageInfo::MakeA8(kW * kSamples, kH * kSamples));
+            supersampled.eraseColor(SK_ColorTRANSPARENT);
+            {
+                SkCanvas canvas(supersampled);
+                canvas.scale(kSamples, kSamples);
+                canvas.clipIRect(clip);
+                canvas.drawPath(path, paint);
+            }
+            SkBitmap reference;
+            reference.allocPixels(SkImageInfo::MakeA8(kW, kH));
+            for (int y = 0; y < kH; y++) {
+                for (int x = 0; x < kW; x++) {
+                    int covered = 0;
+                    for (int j = 0; j < kSamples; j++) {
+                        for (int i = 0; i < kSamples; i++) {
+                            covered += *supersampled.getAddr8(x*kSamples + i, y*kSamples + j) != 0;
+                        }
+                    }
+                    *reference.getAddr8(x, y) = SkToU8((covered * 255 + kSamples * kSamples / 2) /
+                                                       (kSamples * kSamples));
+                }
+            }
+
+            SkBitmap expected;
+            expected.allocPixels(SkImageInfo::MakeA8(kW, kH));
+            expected.eraseColor(SK_ColorTRANSPARENT);
+            {
+                SkCanvas canvas(expected);
+                canvas.clipIRect(clip);
+                paint.setAntiAlias(true);
+                canvas.drawPath(path, paint);
+            }
+
+            SkBitmap actual;
+            actual.allocPixels(SkImageInfo::MakeA8(kW, kH));
+            actual.eraseColor(SK_ColorTRANSPARENT);
+            CoverageBlitter blitter(&actual);
+            SkScan::SparseStripFillPath(path, &blitter, path.getBounds().roundOut(), clip);
+
+            int diff = max_diff(actual, reference);
+            REPORTER_ASSERT(reporter, diff <= 20, "diff from supersampled %d", diff);
+            diff = max_diff(actual, expected);
+            REPORTER_ASSERT(reporter, diff <= 64, "diff from anti-aliased %d", diff);
+        }
+    }
+}
@@ -8,8 +8,14 @@
 #include "include/core/SkTypes.h"
 
 #ifdef SK_SUPPORT_PDF
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkDocument.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkRect.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
+#include "include/docs/SkPDFDocument.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTemplates.h"
@@ -19,8 +25,10 @@
 #include "tests/Test.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <memory>
 
 using namespace skia_private;
@@ -177,4 +185,100 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
     REPORTER_ASSERT(r, !emptyDeflateWStream.writeText("FOO"));
 }
 
+DEF_TEST(SkPDF_DeflateCompressor, r) {
+    SkRandom random(654321);
+    const SkDeflateStrategy strategies[] = {SkDeflateStrategy::kDefault,
+                                            SkDeflateStrategy::kFiltered,
+                                            SkDeflateStrategy::kRLE,
+                                            SkDeflateStrategy::kHuffmanOnly};
+    // Sizes on either side of the window sizes chosen for small inputs.
+    for (uint32_t size : {0u, 1u, 250u, 300u, 4096u, 40000u, 70000u}) {
+        AutoTMalloc<uint8_t> buffer(size);
+        for (uint32_t j = 0; j < size; ++j) {
+            // Compressible, with repeats both near and far.
+            buffer[j] = j > 1000 && random.nextBool() ? buffer[j - random.nextRangeU(1, 1000)]
+                                                      : random.nextU() & 0x0f;
+        }
+        for (int level : {-1, 1, 6, 9}) {
+            for (SkDeflateStrategy strategy : strategies) {
+                SkDynamicMemoryWStream dynamicMemoryWStream;
+                REPORTER_ASSERT(r, SkDeflateZlibCompressor()->compress(
+                                           buffer.get(), size, level, strategy,
+                                           &dynamicMemoryWStream));
+                std::unique_ptr<SkStreamAsset> compressed(dynamicMemoryWStream.detachAsStream());
+                std::unique_ptr<SkStreamAsset> decompressed(stream_inflate(r, compressed.get()));
+                if (!decompressed || decompressed->getLength() != size) {
+                    ERRORF(r, "Decompression failed for size %u, level %d, strategy %d.",
+                           (unsigned)size, level, (int)strategy);
+                    continue;
+                }
+                AutoTMalloc<uint8_t> result(size);
+                decompressed->read(result.get(), size);
+                REPORTER_ASSERT(r, size == 0 || !memcmp(result.get(), buffer.get(), size));
+            }
+        }
+    }
+}
+
+namespace {
+// Counts the streams it compresses, and compresses them with zlib.
+class CountingCompressor final : public SkPDF::Compressor {
+public:
+    bool compress(const void* data, size_t size, int compressionLevel,
+                  SkDeflateStrategy strategy, SkWStream* dst) const override {
+        fCount++;
+        return SkDeflateZlibCompressor()->compress(data, size, compressionLevel, strategy, dst);
+    }
+    mutable std::atomic<int> fCount{0};
+};
+}  // namespace
+
+// Small streams go through the given compressor. Large streams that are not in one buffer are
+// compressed a piece at a time instead of being copied. Both round trip.
+DEF_TEST(SkPDF_DeflateCompressStream, r) {
+    CountingCompressor compressor;
+    for (size_t size : {size_t(5000), size_t(3) << 20}) {
+        SkDynamicMemoryWStream content;
+        for (size_t i = 0; i < size; ++i) {
+            content.write8(static_cast<uint8_t>(i % 251 + i / 7919));
+        }
+        std::unique_ptr<SkStreamAsset> src = content.detachAsStream();
+        REPORTER_ASSERT(r, !src->getMemoryBase());
+        int count = compressor.fCount;
+        std::unique_ptr<SkStreamAsset> compressed =
+                SkDeflateCompressStream(&compressor, src.get(), 6, SkDeflateStrategy::kDefault);
+        REPORTER_ASSERT(r, compressed);
+        if (!compressed) {
+            continue;
+        }
+        REPORTER_ASSERT(r, compressor.fCount == count + (size <= 5000 ? 1 : 0));
+        std::unique_ptr<SkStreamAsset> decompressed(stream_inflate(r, compressed.get()));
+        REPORTER_ASSERT(r, decompressed && decompressed->getLength() == size);
+        if (!decompressed || decompressed->getLength() != size) {
+            continue;
+        }
+        SkAssertResult(src->rewind());
+        sk_sp<SkData> expected = SkData::MakeFromStream(src.get(), size),
+                      actual = SkData::MakeFromStream(decompressed.get(), size);
+        REPORTER_ASSERT(r, expected->equals(actual.get()));
+    }
+}
+
+// A document compresses its streams with Metadata::fCompressor when that is set.
+DEF_TEST(SkPDF_MetadataCompressor, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_MetadataCompressor, r);
+    CountingCompressor compressor;
+    SkPDF::Metadata metadata;
+    metadata.fCompressor = &compressor;
+    SkNullWStream stream;
+    sk_sp<SkDocument> doc = SkPDF::MakeDocument(&stream, metadata);
+    SkCanvas* canvas = doc->beginPage(100, 100);
+    SkPaint paint;
+    for (int i = 0; i < 50; ++i) {
+        canvas->drawRect(SkRect::MakeXYWH(i, i, 10, 10), paint);
+    }
+    doc->close();
+    REPORTER_ASSERT(r, compressor.fCount > 0);
+}
+
 #endif
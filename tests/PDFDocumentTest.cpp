@@ -4,6 +4,7 @@
  * Use of this source code is governed by a BSD-style license that can be
  * found in the LICENSE file.
  */
+#include "include/core/SkAnnotation.h"
 #include "include/core/SkBitmap.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
@@ -13,17 +14,28 @@
 #include "include/core/SkFont.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
 #include "include/core/SkPaint.h"
+#include "include/core/SkPicture.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
+#include "include/core/SkTileMode.h"
 #include "include/docs/SkPDFDocument.h"
+#include "include/private/base/SkTo.h"
 #include "src/utils/SkOSPath.h"
 #include "tests/Test.h"
 
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <string>
+#include <vector>
+
+#include "zlib.h"
 
 static void test_empty(skiatest::Reporter* reporter) {
     SkDynamicMemoryWStream stream;
@@ -264,3 +276,272 @@ DEF_TEST(SkPDF_abort_jobs, rep) {
     doc->abort();
 }
 
+static sk_sp<SkData> make_dedup_test_pdf(SkPDF::Metadata metadata) {
+    // Two images with different IDs but the same pixels.
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    bm.eraseColor(SK_ColorRED);
+    bm.erase(SK_ColorBLUE, SkIRect::MakeXYWH(16, 16, 32, 32));
+    SkBitmap copy;
+    copy.allocPixels(bm.info());
+    bm.readPixels(copy.pixmap());
+    sk_sp<SkImage> images[] = {bm.asImage(), copy.asImage()};
+
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    for (int page = 0; page < 3; ++page) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        canvas->drawImage(images[0], 0, 0);
+        canvas->drawImage(images[1], 100, 0);
+        SkPaint paint;
+        paint.setShader(images[page % 2]->makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat,
+                                                    SkSamplingOptions()));
+        canvas->drawRect({0, 100, 200, 300}, paint);
+        // Each page's layer is a separate, but identical, form XObject.
+        canvas->saveLayerAlphaf(nullptr, 0.5f);
+        canvas->drawColor(SK_ColorGREEN);
+        canvas->restore();
+    }
+    doc->close();
+    return stream.detachAsData();
+}
+
+DEF_TEST(SkPDF_deduplicate_by_content, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_deduplicate_by_content, r);
+    sk_sp<SkData> plain = make_dedup_test_pdf(SkPDF::Metadata());
+
+    SkPDF::DeduplicationStats stats;
+    SkPDF::Metadata metadata;
+    metadata.fDeduplicateByContent = true;
+    metadata.fDeduplicationStats = &stats;
+    sk_sp<SkData> deduped = make_dedup_test_pdf(metadata);
+    REPORTER_ASSERT(r, deduped->size() < plain->size());
+    REPORTER_ASSERT(r, stats.fImagesHashed == 2, "%d", stats.fImagesHashed);
+    REPORTER_ASSERT(r, stats.fImageHits == 3, "%d", stats.fImageHits);
+    REPORTER_ASSERT(r, stats.fImagePatternHits == 1, "%d", stats.fImagePatternHits);
+    REPORTER_ASSERT(r, stats.fFormXObjectHits >= 2, "%d", stats.fFormXObjectHits);
+
+    // Hashing on an executor finds the same duplicates.
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool();
+    SkPDF::DeduplicationStats threadedStats;
+    metadata.fExecutor = executor.get();
+    metadata.fDeduplicationStats = &threadedStats;
+    sk_sp<SkData> threaded = make_dedup_test_pdf(metadata);
+    REPORTER_ASSERT(r, threaded->size() == deduped->size());
+    REPORTER_ASSERT(r, threadedStats.fImageHits == stats.fImageHits);
+    REPORTER_ASSERT(r, threadedStats.fFormXObjectHits == stats.fFormXObjectHits);
+}
+
+static sk_sp<SkData> make_object_stream_test_pdf(const SkPDF::Metadata& metadata) {
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    sk_sp<SkData> url = SkData::MakeWithCString("https://skia.org/");
+    // Enough pages, each with its own page and link objects, to fill several object streams.
+    for (int page = 0; page < 30; ++page) {
+        SkCanvas* canvas = doc->beginPage(612, 792);
+        for (int row = 0; row < 10; ++row) {
+            SkRect cell = SkRect::MakeXYWH(36, 36 + 30 * row, 540, 25);
+            canvas->drawRect(cell, SkPaint());
+            SkAnnotateRectWithURL(canvas, cell, url.get());
+        }
+    }
+    doc->close();
+    return stream.detachAsData();
+}
+
+static std::string inflate_pdf_stream(const std::string& data) {
+    std::string result;
+    z_stream zStream = {};
+    if (inflateInit(&zStream) != Z_OK) {
+        return result;
+    }
+    zStream.next_in = (Bytef*)data.data();
+    zStream.avail_in = SkToUInt(data.size());
+    int rc;
+    do {
+        char buffer[4096];
+        zStream.next_out = (Bytef*)buffer;
+        zStream.avail_out = sizeof(buffer);
+        rc = inflate(&zStream, Z_NO_FLUSH);
+        result.append(buffer, sizeof(buffer) - zStream.avail_out);
+    } while (rc == Z_OK);
+    inflateEnd(&zStream);
+    return rc == Z_STREAM_END ? result : std::string();
+}
+
+// Reads the stream object at offset, returning its dictionary in dict and its decoded data.
+static std::string read_pdf_stream(const std::string& pdf, size_t offset, std::string* dict) {
+    size_t dictEnd = pdf.find(" stream\n", offset);
+    size_t length = pdf.find("/Length ", offset);
+    if (dictEnd == std::string::npos || length == std::string::npos || length > dictEnd) {
+        return std::string();
+    }
+    *dict = pdf.substr(offset, dictEnd - offset);
+    std::string data = pdf.substr(dictEnd + strlen(" stream\n"),
+                                  strtoul(pdf.c_str() + length + strlen("/Length "), nullptr, 10));
+    return dict->find("/Filter /FlateDecode") != std::string::npos ? inflate_pdf_stream(data)
+                                                                   : data;
+}
+
+static int pdf_dict_int(const std::string& dict, const char* key) {
+    size_t i = dict.find(key);
+    return i == std::string::npos ? -1 : atoi(dict.c_str() + i + strlen(key));
+}
+
+DEF_TEST(SkPDF_object_streams, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_object_streams, r);
+    sk_sp<SkData> plain = make_object_stream_test_pdf(SkPDF::Metadata());
+
+    SkPDF::Metadata metadata;
+    metadata.fUseObjectStreams = true;
+    sk_sp<SkData> packed = make_object_stream_test_pdf(metadata);
+    REPORTER_ASSERT(r, packed->size() < plain->size());
+
+    const char* pdf = static_cast<const char*>(packed->data());
+    std::string contents(pdf, packed->size());
+    REPORTER_ASSERT(r, contents.rfind("%PDF-1.5\n", 0) == 0);
+    REPORTER_ASSERT(r, contents.find("\ntrailer\n") == std::string::npos);
+
+    // startxref points at the cross-reference stream, which is the last object.
+    size_t startxref = contents.rfind("startxref\n");
+    REPORTER_ASSERT(r, startxref != std::string::npos);
+    size_t xrefOffset = strtoul(pdf + startxref + strlen("startxref\n"), nullptr, 10);
+    REPORTER_ASSERT(r, xrefOffset < startxref);
+    size_t xrefDict = contents.find(" 0 obj\n<</Type /XRef\n", xrefOffset);
+    REPORTER_ASSERT(r, xrefDict != std::string::npos &&
+                       contents.find_first_not_of("0123456789", xrefOffset) == xrefDict);
+
+    // Every object is either at the offset given by its type 1 entry, or in the object stream and
+    // at the index given by its type 2 entry.
+    std::string dict;
+    std::string entries = read_pdf_stream(contents, xrefOffset, &dict);
+    const int size = pdf_dict_int(dict, "/Size ");
+    REPORTER_ASSERT(r, dict.find("/W [1 4 2]") != std::string::npos);
+    REPORTER_ASSERT(r, size > 1 && entries.size() == 7 * SkToSizeT(size), "%d %zu",
+                    size, entries.size());
+    if (entries.size() != 7 * SkToSizeT(size)) {
+        return;
+    }
+    REPORTER_ASSERT(r, atoi(pdf + xrefOffset) == size - 1);
+    auto field = [&entries](int object, int start, int bytes) {
+        uint32_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            value = (value << 8) | (uint8_t)entries[7 * object + start + i];
+        }
+        return value;
+    };
+    REPORTER_ASSERT(r, field(0, 0, 1) == 0);
+    int inStreams = 0;
+    for (int object = 1; object < size; ++object) {
+        const uint32_t type = field(object, 0, 1);
+        if (type == 1) {
+            SkString start = SkStringPrintf("%d 0 obj\n", object);
+            uint32_t offset = field(object, 1, 4);
+            REPORTER_ASSERT(r, offset < contents.size() &&
+                               contents.compare(offset, start.size(), start.c_str()) == 0,
+                            "object %d at %u", object, offset);
+            continue;
+        }
+        REPORTER_ASSERT(r, type == 2, "object %d has type %u", object, type);
+        if (type != 2) {
+            continue;
+        }
+        ++inStreams;
+        const uint32_t objectStream = field(object, 1, 4);
+        const uint32_t index = field(object, 5, 2);
+        REPORTER_ASSERT(r, objectStream > 0 && objectStream < SkToU32(size) &&
+                           field(objectStream, 0, 1) == 1, "object %d in %u", object, objectStream);
+        if (objectStream == 0 || objectStream >= SkToU32(size)) {
+            continue;
+        }
+        std::string streamDict;
+        std::string stream = read_pdf_stream(contents, field(objectStream, 1, 4), &streamDict);
+        REPORTER_ASSERT(r, streamDict.find("/Type /ObjStm") != std::string::npos);
+        REPORTER_ASSERT(r, SkToInt(index) < pdf_dict_int(streamDict, "/N "));
+        // The stream starts with pairs of object numbers and offsets.
+        const char* header = stream.c_str();
+        char* end = nullptr;
+        for (uint32_t i = 0; i < index && header; ++i) {
+            strtoul(header, &end, 10);
+            strtoul(end, &end, 10);
+            header = end;
+        }
+        REPORTER_ASSERT(r, SkToInt(strtoul(header, nullptr, 10)) == object,
+                        "object %d at %u in %u", object, index, objectStream);
+    }
+    REPORTER_ASSERT(r, inStreams > 100, "%d", inStreams);
+
+    // Compressing the object streams on an executor gives the same objects.
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool();
+    metadata.fExecutor = executor.get();
+    sk_sp<SkData> threaded = make_object_stream_test_pdf(metadata);
+    REPORTER_ASSERT(r, threaded->size() == packed->size());
+
+    // PDF/A-1 does not allow object streams, so they are not used for PDF/A documents.
+    metadata.fExecutor = nullptr;
+    metadata.fPDFA = true;
+    sk_sp<SkData> archival = make_object_stream_test_pdf(metadata);
+    contents.assign(static_cast<const char*>(archival->data()), archival->size());
+    REPORTER_ASSERT(r, contents.rfind("%PDF-1.4\n", 0) == 0);
+    REPORTER_ASSERT(r, contents.find("/Type /ObjStm") == std::string::npos);
+    REPORTER_ASSERT(r, contents.find("/Type /XRef") == std::string::npos);
+    REPORTER_ASSERT(r, contents.find("\ntrailer\n") != std::string::npos);
+}
+
+static sk_sp<SkData> make_draw_pages_test_pdf(SkExecutor* executor) {
+    SkBitmap bm;
+    bm.allocN32Pixels(64, 64);
+    bm.eraseColor(SK_ColorRED);
+    sk_sp<SkImage> logo = bm.asImage();
+    sk_sp<SkData> url = SkData::MakeWithCString("https://skia.org/");
+
+    // Pages sharing fonts, images and graphic states, with links between them.
+    std::vector<sk_sp<SkPicture>> pages;
+    for (int page = 0; page < 12; ++page) {
+        SkPictureRecorder recorder;
+        SkCanvas* canvas = recorder.beginRecording(SkRect::MakeWH(612, 792));
+        canvas->drawImage(logo, 36, 36);
+        for (int row = 0; row < 10; ++row) {
+            SkPaint paint;
+            paint.setAlphaf(0.1f * (row + 1));
+            SkRect cell = SkRect::MakeXYWH(36, 136 + 30 * row, 540, 25);
+            canvas->drawRect(cell, paint);
+            SkString text = SkStringPrintf("Page %d, row %d", page, row);
+            canvas->drawString(text, 40, 150 + 30 * row, SkFont(), SkPaint());
+            SkAnnotateRectWithURL(canvas, cell, url.get());
+        }
+        SkString name = SkStringPrintf("page%d", page);
+        SkAnnotateNamedDestination(canvas, {0, 0}, SkData::MakeWithCString(name.c_str()).get());
+        name = SkStringPrintf("page%d", (page + 1) % 12);
+        SkAnnotateLinkToDestination(canvas, SkRect::MakeXYWH(36, 700, 100, 50),
+                                    SkData::MakeWithCString(name.c_str()).get());
+        pages.push_back(recorder.finishRecordingAsPicture());
+    }
+
+    SkPDF::Metadata metadata;
+    metadata.fExecutor = executor;
+    SkDynamicMemoryWStream stream;
+    auto doc = SkPDF::MakeDocument(&stream, metadata);
+    SkPDF::DrawPages(doc.get(), pages);
+    doc->close();
+    return stream.detachAsData();
+}
+
+DEF_TEST(SkPDF_draw_pages, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_draw_pages, r);
+    sk_sp<SkData> serial = make_draw_pages_test_pdf(nullptr);
+    std::string contents(static_cast<const char*>(serial->data()), serial->size());
+    int pageCount = 0;
+    for (size_t i = contents.find("/Type /Page\n"); i != std::string::npos;
+         i = contents.find("/Type /Page\n", i + 1)) {
+        ++pageCount;
+    }
+    REPORTER_ASSERT(r, pageCount == 12, "%d", pageCount);
+
+    // Drawing the pages concurrently gives the same bytes, whatever the thread timing.
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    for (int i = 0; i < 3; ++i) {
+        sk_sp<SkData> threaded = make_draw_pages_test_pdf(executor.get());
+        REPORTER_ASSERT(r, threaded->equals(serial.get()));
+    }
+}
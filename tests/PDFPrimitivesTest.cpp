@@ -12,6 +12,7 @@
 #include "include/core/SkBlendMode.h"
 #include "include/core/SkCanvas.h"
 #include "include/core/SkColor.h"
+#include "include/core/SkData.h"
 #include "include/core/SkDocument.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
@@ -36,9 +37,13 @@
 #include "src/base/SkRandom.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
+#include "src/core/SkResourceCache.h"
+#include "src/core/SkTypefaceCache.h"
 #include "src/pdf/SkClusterator.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
 #include "src/pdf/SkPDFFont.h"
+#include "src/pdf/SkPDFFontCache.h"
+#include "src/pdf/SkPDFGlyphUse.h"
 #include "src/pdf/SkPDFTypes.h"
 #include "src/pdf/SkPDFUnion.h"
 #include "src/pdf/SkPDFUtils.h"
@@ -466,6 +471,55 @@ DEF_TEST(SkPDF_Clusterator, reporter) {
     }
 }
 
+DEF_TEST(SkPDF_FontCache, reporter) {
+    // A local cache, so that tests running in parallel can't add to or purge it.
+    SkResourceCache cache(1024 * 1024);
+    SkTypefaceID id = SkTypefaceCache::NewTypefaceID();
+    constexpr auto kHarfbuzz = SkPDF::Metadata::Subsetter::kHarfbuzz_Subsetter;
+
+    SkPDFGlyphUse glyphs(3, 300);
+    glyphs.set(0);
+    glyphs.set(7);
+    glyphs.set(42);
+    REPORTER_ASSERT(reporter, !SkPDFFontCache::FindSubsetFont(id, kHarfbuzz, glyphs, &cache));
+
+    sk_sp<SkData> subset = SkData::MakeWithCString("subset font");
+    SkPDFFontCache::AddSubsetFont(id, kHarfbuzz, glyphs, subset, &cache);
+    REPORTER_ASSERT(reporter, cache.getTotalBytesUsed() > 0);
+
+    // The same glyphs, even from another document's SkPDFGlyphUse, find the subset.
+    SkPDFGlyphUse sameGlyphs(3, 300);
+    sameGlyphs.set(0);
+    sameGlyphs.set(7);
+    sameGlyphs.set(42);
+    sk_sp<SkData> found = SkPDFFontCache::FindSubsetFont(id, kHarfbuzz, sameGlyphs, &cache);
+    REPORTER_ASSERT(reporter, found && found->equals(subset.get()));
+
+    // Different glyphs, typefaces or kinds of entry do not.
+    SkPDFGlyphUse moreGlyphs(3, 300);
+    moreGlyphs.set(0);
+    moreGlyphs.set(7);
+    moreGlyphs.set(42);
+    moreGlyphs.set(43);
+    REPORTER_ASSERT(reporter, !SkPDFFontCache::FindSubsetFont(id, kHarfbuzz, moreGlyphs, &cache));
+    REPORTER_ASSERT(reporter,
+                    !SkPDFFontCache::FindSubsetFont(SkTypefaceCache::NewTypefaceID(), kHarfbuzz,
+                                                    glyphs, &cache));
+    REPORTER_ASSERT(reporter, !SkPDFFontCache::FindToUnicodeCmap(id, glyphs, true, 300, &cache));
+
+    std::vector<SkScalar> advances = {500, 250, 750};
+    SkPDFFontCache::AddGlyphAdvances(id, glyphs, advances, &cache);
+    std::vector<SkScalar> foundAdvances;
+    REPORTER_ASSERT(reporter,
+                    SkPDFFontCache::FindGlyphAdvances(id, sameGlyphs, &foundAdvances, &cache));
+    REPORTER_ASSERT(reporter, foundAdvances == advances);
+
+    cache.purgeAll();
+    REPORTER_ASSERT(reporter, !SkPDFFontCache::FindSubsetFont(id, kHarfbuzz, glyphs, &cache));
+    REPORTER_ASSERT(reporter,
+                    !SkPDFFontCache::FindGlyphAdvances(id, glyphs, &foundAdvances, &cache));
+}
+
 DEF_TEST(fuzz875632f0, reporter) {
     SkNullWStream stream;
     auto doc = SkPDF::MakeDocument(&stream);
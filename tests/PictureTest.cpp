@@ -11,6 +11,7 @@
 #include "include/core/SkClipOp.h"
 #include "include/core/SkColor.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkFont.h"
 #include "include/core/SkFontStyle.h"
 #include "include/core/SkImage.h" // IWYU pragma: keep
@@ -29,13 +30,17 @@
 #include "include/core/SkStream.h"
 #include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
+#include "include/effects/SkGradientShader.h"
+#include "include/effects/SkImageFilters.h"
 #include "src/base/SkRandom.h"
 #include "src/core/SkBigPicture.h"
 #include "src/core/SkPicturePriv.h"
 #include "src/core/SkRectPriv.h"
 #include "tests/Test.h"
+#include "tools/ToolUtils.h"
 
 #include <cstddef>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -923,3 +928,112 @@ DEF_TEST(Picture_nested_op_count, r) {
     check(make_pic(10, leaf1),  10,  10);
     check(make_pic(10, leaf10), 10, 100);
 }
+
+DEF_TEST(Picture_playbackParallel, r) {
+    enum class Content {
+        kExact,        // Draws the same through any tile.
+        kCrossingPath, // Has an anti-aliased path across a tile edge.
+        kBackdrop,     // Reads pixels outside of the tile.
+    };
+    auto make_pic = [](Content content) {
+        SkRTreeFactory factory;
+        SkPictureRecorder rec;
+        SkCanvas* c = rec.beginRecording({0,0, 300,200}, &factory);
+
+        SkPaint gradient;
+        const SkPoint pts[] = {{0,0}, {300,200}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+        gradient.setShader(SkGradientShader::MakeLinear(pts, colors, nullptr, 2,
+                                                        SkTileMode::kClamp));
+        gradient.setDither(true);
+        c->drawPaint(gradient);
+
+        // Rects draw the same through any tile, anti-aliased or not.
+        SkRandom rand;
+        SkPaint paint;
+        for (int i = 0; i < 50; i++) {
+            paint.setColor(rand.nextU() | 0x80000000);
+            paint.setAntiAlias(i % 2 == 0);
+            SkScalar x = rand.nextRangeScalar(0, 280),
+                     y = rand.nextRangeScalar(0, 180);
+            c->drawRect(SkRect::MakeXYWH(x, y, rand.nextRangeScalar(1, 60),
+                                               rand.nextRangeScalar(1, 60)), paint);
+        }
+
+        // So do glyph masks, even where the text crosses tiles.
+        SkFont font(ToolUtils::create_portable_typeface(), 17);
+        font.setEdging(SkFont::Edging::kAntiAlias);
+        paint.setColor(SK_ColorBLACK);
+        paint.setAntiAlias(true);
+        for (int i = 0; i < 8; i++) {
+            c->drawString("Tiled playback", 5 + 17.3f * i, 20 + 23.7f * i, font, paint);
+        }
+
+        // Anti-aliased paths are drawn the same only when they're inside a single tile, under
+        // both setups below.
+        const SkPoint centers[] = {{30,25}, {110,80}, {185,135}, {227,80}, {285,170}};
+        const SkScalar radii[] = {10, 12, 8, 10, 6};
+        for (int i = 0; i < 5; i++) {
+            paint.setColor(rand.nextU() | 0xff000000);
+            c->drawCircle(centers[i], radii[i], paint);
+        }
+
+        switch (content) {
+            case Content::kExact:
+                break;
+            case Content::kCrossingPath:
+                c->drawCircle({150,100}, 70, paint);
+                break;
+            case Content::kBackdrop: {
+                sk_sp<SkImageFilter> blur = SkImageFilters::Blur(4, 4, nullptr);
+                c->saveLayer(SkCanvas::SaveLayerRec(nullptr, nullptr, blur.get(), 0));
+                c->restore();
+                break;
+            }
+        }
+        return rec.finishRecordingAsPicture();
+    };
+
+    std::unique_ptr<SkExecutor> executor = SkExecutor::MakeFIFOThreadPool(4);
+    const SkISize tileSize = {64, 48};
+    // The first setup culls with the BBH even without tiling.  The second draws the whole
+    // picture into a larger area, where some rects spill out of the picture's cull rect.
+    const std::function<void(SkCanvas*)> setups[] = {
+        [](SkCanvas* c) {
+            c->translate(3, 5);
+            c->clipRect({10,10, 290,190});
+        },
+        [](SkCanvas* c) {
+            c->translate(3, 5);
+            c->scale(0.75f, 0.75f);
+        },
+    };
+    for (Content content : {Content::kExact, Content::kCrossingPath, Content::kBackdrop}) {
+        sk_sp<SkPicture> pic = make_pic(content);
+        const SkBigPicture* big = SkPicturePriv::AsSkBigPicture(pic);
+        REPORTER_ASSERT(r, big);
+
+        for (const auto& setup : setups) {
+            SkBitmap serial, parallel;
+            serial  .allocN32Pixels(300, 200);
+            parallel.allocN32Pixels(300, 200);
+            serial  .eraseColor(SK_ColorWHITE);
+            parallel.eraseColor(SK_ColorWHITE);
+
+            SkCanvas serialCanvas(serial);
+            setup(&serialCanvas);
+            pic->playback(&serialCanvas);
+
+            SkCanvas parallelCanvas(parallel);
+            setup(&parallelCanvas);
+            // Only the exact content is drawn in tiles; the rest falls back to playback().
+            const bool tiled = big->canPlaybackTiled(parallelCanvas.getTotalMatrix(),
+                                                     parallelCanvas.getDeviceClipBounds(),
+                                                     tileSize);
+            REPORTER_ASSERT(r, tiled == (content == Content::kExact));
+            pic->playbackParallel(&parallelCanvas, *executor, tileSize);
+
+            REPORTER_ASSERT(r, ToolUtils::equal_pixels(serial, parallel));
+        }
+    }
+}
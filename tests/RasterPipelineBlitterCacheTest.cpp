@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "include/core/SkBitmap.h"
+#include "include/core/SkBlendMode.h"
+#include "include/core/SkBlender.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkColor.h"
+#include "include/core/SkColorFilter.h"
+#include "include/core/SkColorSpace.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkShader.h"
+#include "include/core/SkTileMode.h"
+#include "include/effects/SkBlenders.h"
+#include "include/effects/SkGradientShader.h"
+#include "src/core/SkCoreBlitters.h"
+#include "tests/Test.h"
+
+#include <cstring>
+
+// Draws a mix of solid-color paints that share cached blitters: the same blend mode and dst with
+// different colors, antialiased and not, memsettable and not.
+static void draw_solid_scene(SkCanvas* canvas) {
+    const SkColor4f colors[] = {
+        {1.0f, 0.0f, 0.0f, 1.0f},
+        {0.0f, 0.5f, 1.0f, 1.0f},
+        {0.2f, 0.4f, 0.6f, 0.5f},
+        {0.9f, 0.1f, 0.3f, 0.5f},
+        {0.0f, 0.0f, 0.0f, 1.0f},
+        {1.0f, 1.0f, 1.0f, 1.0f},
+    };
+    const SkBlendMode modes[] = {SkBlendMode::kSrcOver, SkBlendMode::kSrc, SkBlendMode::kMultiply};
+
+    int i = 0;
+    for (SkBlendMode mode : modes) {
+        for (const SkColor4f& color : colors) {
+            SkPaint paint(color);
+            paint.setBlendMode(mode);
+            paint.setAntiAlias(i % 2 == 1);
+            float x = 3.5f * (i % 6),
+                  y = 5.25f * (i / 6);
+            canvas->drawRect(SkRect::MakeXYWH(x, y, 17.5f, 9.5f), paint);
+            canvas->drawCircle(x + 9, y + 9, 6.5f, paint);
+            i++;
+        }
+    }
+}
+
+// Draws paints with shaders, color filters and blenders, each reused for a few draws.
+static void draw_effect_scene(SkCanvas* canvas) {
+    static const sk_sp<SkShader> gradient = [] {
+        const SkPoint pts[] = {{0, 0}, {32, 24}};
+        const SkColor colors[] = {SK_ColorRED, SK_ColorBLUE};
+        return SkGradientShader::MakeLinear(pts, colors, nullptr, 2, SkTileMode::kMirror);
+    }();
+    static const sk_sp<SkColorFilter> filter =
+            SkColorFilters::Blend(0x8000FF00, SkBlendMode::kMultiply);
+
+    SkPaint paints[3];
+    paints[0].setShader(gradient);
+    paints[0].setDither(true);
+    // SkBlitter::Choose() wraps the shader in a new SkColorFilterShader for every draw.
+    paints[1].setShader(gradient);
+    paints[1].setColorFilter(filter);
+    paints[1].setAlphaf(0.75f);
+    paints[2].setShader(gradient);
+    paints[2].setBlender(SkBlenders::Arithmetic(0, 0.5f, 0.5f, 0, true));
+
+    for (int i = 0; i < 3; i++) {
+        paints[i].setAntiAlias(true);
+        canvas->drawRect(SkRect::MakeXYWH(2.5f + 9 * i, 1.5f, 7.25f, 20), paints[i]);
+        canvas->drawCircle(6 + 9 * i, 17, 4.5f, paints[i]);
+    }
+}
+
+static SkBitmap render(const SkImageInfo& info, void (*draw)(SkCanvas*)) {
+    SkBitmap bitmap;
+    bitmap.allocPixels(info);
+    bitmap.eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(bitmap);
+    draw(&canvas);
+    return bitmap;
+}
+
+DEF_TEST(RasterPipelineBlitterCache, r) {
+    const SkImageInfo infos[] = {
+        SkImageInfo::Make(32, 24, kRGBA_F16Norm_SkColorType, kUnpremul_SkAlphaType),
+        SkImageInfo::Make(32, 24, kRGBA_F16_SkColorType, kPremul_SkAlphaType,
+                          SkColorSpace::MakeSRGBLinear()),
+        SkImageInfo::Make(32, 24, kRGB_565_SkColorType, kOpaque_SkAlphaType),
+        SkImageInfo::Make(32, 24, kRGBA_8888_SkColorType, kUnpremul_SkAlphaType),
+        // Premul 8888 without a color space blits translucent SrcOver rects with
+        // srcover_rgba_8888.
+        SkImageInfo::Make(32, 24, kRGBA_8888_SkColorType, kPremul_SkAlphaType),
+        SkImageInfo::Make(32, 24, kBGRA_8888_SkColorType, kPremul_SkAlphaType),
+    };
+
+    // The cache is shared with any other thread drawing now, which only costs them some misses.
+    // The limit is large enough that they shouldn't evict what this test draws.
+    const int prevLimit = SkRasterPipelineBlitterCache::GetCountLimit();
+    for (const SkImageInfo& info : infos) {
+        for (auto draw : {draw_solid_scene, draw_effect_scene}) {
+            SkRasterPipelineBlitterCache::SetCountLimit(0);
+            SkBitmap expected = render(info, draw);
+
+            SkRasterPipelineBlitterCache::SetCountLimit(256);
+            size_t hits = 0;
+            // Solid colors are cached on their first pass and paints with effects on their second,
+            // so every pass after that should hit the cache.
+            for (int pass = 0; pass < 3; pass++) {
+                hits = SkRasterPipelineBlitterCache::GetThreadHitsForTesting();
+                SkBitmap actual = render(info, draw);
+                REPORTER_ASSERT(r, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                               expected.computeByteSize()),
+                                "colortype %d, pass %d", info.colorType(), pass);
+            }
+            REPORTER_ASSERT(r, SkRasterPipelineBlitterCache::GetThreadHitsForTesting() > hits,
+                            "colortype %d", info.colorType());
+        }
+    }
+    SkRasterPipelineBlitterCache::SetCountLimit(prevLimit);
+}
@@ -5,6 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
+#include "include/core/SkData.h"
+#include "include/core/SkImageInfo.h"
+#include "include/core/SkPaint.h"
+#include "include/core/SkStream.h"
+#include "include/effects/SkRuntimeEffect.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkHalf.h"
 #include "src/base/SkUtils.h"
@@ -17,6 +24,7 @@
 
 #include <cmath>
 #include <numeric>
+#include <string>
 
 using namespace skia_private;
 
@@ -105,11 +113,11 @@ DEF_TEST(SkRasterPipeline_PackBigContext, r) {
 }
 
 DEF_TEST(SkRasterPipeline_LoadStoreConditionMask, reporter) {
-    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0};
+    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0, ~0, ~0, 0, ~0, 0, 0, ~0, ~0};
     alignas(64) int32_t maskCopy[SkRasterPipeline_kMaxStride_highp] = {};
     alignas(64) int32_t src[4 * SkRasterPipeline_kMaxStride_highp] = {};
 
-    static_assert(std::size(mask) == SkRasterPipeline_kMaxStride_highp);
+    static_assert(std::size(mask) >= SkRasterPipeline_kMaxStride_highp);
 
     SkRasterPipeline_<256> p;
     p.append(SkRasterPipelineOp::init_lane_masks);
@@ -148,11 +156,11 @@ DEF_TEST(SkRasterPipeline_LoadStoreConditionMask, reporter) {
 }
 
 DEF_TEST(SkRasterPipeline_LoadStoreLoopMask, reporter) {
-    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0};
+    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0, ~0, ~0, 0, ~0, 0, 0, ~0, ~0};
     alignas(64) int32_t maskCopy[SkRasterPipeline_kMaxStride_highp] = {};
     alignas(64) int32_t src[4 * SkRasterPipeline_kMaxStride_highp] = {};
 
-    static_assert(std::size(mask) == SkRasterPipeline_kMaxStride_highp);
+    static_assert(std::size(mask) >= SkRasterPipeline_kMaxStride_highp);
 
     SkRasterPipeline_<256> p;
     p.append(SkRasterPipelineOp::init_lane_masks);
@@ -191,11 +199,11 @@ DEF_TEST(SkRasterPipeline_LoadStoreLoopMask, reporter) {
 }
 
 DEF_TEST(SkRasterPipeline_LoadStoreReturnMask, reporter) {
-    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0};
+    alignas(64) int32_t mask[]  = {~0, 0, ~0,  0, ~0, ~0, ~0,  0, ~0, ~0, 0, ~0, 0, 0, ~0, ~0};
     alignas(64) int32_t maskCopy[SkRasterPipeline_kMaxStride_highp] = {};
     alignas(64) int32_t src[4 * SkRasterPipeline_kMaxStride_highp] = {};
 
-    static_assert(std::size(mask) == SkRasterPipeline_kMaxStride_highp);
+    static_assert(std::size(mask) >= SkRasterPipeline_kMaxStride_highp);
 
     SkRasterPipeline_<256> p;
     p.append(SkRasterPipelineOp::init_lane_masks);
@@ -234,10 +242,10 @@ DEF_TEST(SkRasterPipeline_LoadStoreReturnMask, reporter) {
 }
 
 DEF_TEST(SkRasterPipeline_MergeConditionMask, reporter) {
-    alignas(64) int32_t mask[]  = { 0,  0, ~0, ~0, 0, ~0, 0, ~0,
-                                   ~0, ~0, ~0, ~0, 0,  0, 0,  0};
+    alignas(64) int32_t mask[]  = { 0,  0, ~0, ~0, 0, ~0, 0, ~0, ~0, 0, ~0,  0, ~0, ~0, 0,  0,
+                                   ~0, ~0, ~0, ~0, 0,  0, 0,  0, ~0, 0,  0, ~0, ~0,  0, ~0, 0};
     alignas(64) int32_t src[4 * SkRasterPipeline_kMaxStride_highp] = {};
-    static_assert(std::size(mask) == (2 * SkRasterPipeline_kMaxStride_highp));
+    static_assert(std::size(mask) >= (2 * SkRasterPipeline_kMaxStride_highp));
 
     SkRasterPipeline_<256> p;
     p.append(SkRasterPipelineOp::init_lane_masks);
@@ -261,13 +269,13 @@ DEF_TEST(SkRasterPipeline_MergeConditionMask, reporter) {
 }
 
 DEF_TEST(SkRasterPipeline_MergeLoopMask, reporter) {
-    alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  // r (condition)
-                                      ~0,  0, ~0,  0, ~0, ~0, ~0, ~0,  // g (loop)
-                                      ~0, ~0, ~0, ~0, ~0, ~0,  0, ~0,  // b (return)
-                                      ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0}; // a (combined)
-    alignas(64) int32_t mask[]     = { 0, ~0, ~0,  0, ~0, ~0, ~0, ~0};
+    alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0, ~0,  0, ~0, ~0, ~0, ~0, ~0, ~0,  // r
+                                      ~0,  0, ~0,  0, ~0, ~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  0, ~0,  0,  // g
+                                      ~0, ~0, ~0, ~0, ~0, ~0,  0, ~0, ~0, ~0, ~0, ~0,  0, ~0, ~0, ~0,  // b
+                                      ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0}; // a
+    alignas(64) int32_t mask[]     = { 0, ~0, ~0,  0, ~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  0, ~0, ~0,  0};
     alignas(64) int32_t src[4 * SkRasterPipeline_kMaxStride_highp] = {};
-    static_assert(std::size(initial) == (4 * SkRasterPipeline_kMaxStride_highp));
+    static_assert(std::size(initial) >= (4 * SkRasterPipeline_kMaxStride_highp));
 
     SkRasterPipeline_<256> p;
     p.append(SkRasterPipelineOp::load_src, initial);
@@ -293,13 +301,13 @@ DEF_TEST(SkRasterPipeline_MergeLoopMask, reporter) {
 }
 
 DEF_TEST(SkRasterPipeline_ReenableLoopMask, reporter) {
-    alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  // r (condition)
-                                      ~0,  0, ~0,  0, ~0, ~0,  0, ~0,  // g (loop)
-                                       0, ~0, ~0, ~0,  0,  0,  0, ~0,  // b (return)
-                                       0,  0, ~0,  0,  0,  0,  0, ~0}; // a (combined)
-    alignas(64) int32_t mask[]     = { 0, ~0,  0,  0,  0,  0, ~0,  0};
+    alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0, ~0,  0, ~0, ~0, ~0, ~0, ~0, ~0,  // r
+                                      ~0,  0, ~0,  0, ~0, ~0,  0, ~0,  0, ~0,  0, ~0, ~0,  0,  0, ~0,  // g
+                                       0, ~0, ~0, ~0,  0,  0,  0, ~0, ~0, ~0,  0, ~0,  0, ~0, ~0, ~0,  // b
+                                       0,  0, ~0,  0,  0,  0,  0, ~0,  0,  0,  0, ~0,  0,  0,  0, ~0}; // a
+    alignas(64) int32_t mask[]     = { 0, ~0,  0,  0,  0,  0, ~0,  0,  0, ~0, ~0,  0,  0, ~0,  0,  0};
     alignas(64) int32_t src[4 * SkRasterPipeline_kMaxStride_highp] = {};
-    static_assert(std::size(initial) == (4 * SkRasterPipeline_kMaxStride_highp));
+    static_assert(std::size(initial) >= (4 * SkRasterPipeline_kMaxStride_highp));
 
     SkRasterPipeline_<256> p;
     p.append(SkRasterPipelineOp::load_src, initial);
@@ -325,15 +333,20 @@ DEF_TEST(SkRasterPipeline_ReenableLoopMask, reporter) {
 }
 
 DEF_TEST(SkRasterPipeline_CaseOp, reporter) {
-    alignas(64) int32_t initial[]        = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  // r (condition)
-                                             0, ~0, ~0,  0, ~0, ~0,  0, ~0,  // g (loop)
-                                            ~0,  0, ~0, ~0,  0,  0,  0, ~0,  // b (return)
-                                             0,  0, ~0,  0,  0,  0,  0, ~0}; // a (combined)
+    alignas(64) int32_t initial[]        = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,    // r (condition)
+                                            ~0,  0, ~0, ~0, ~0, ~0,  0, ~0,
+                                             0, ~0, ~0,  0, ~0, ~0,  0, ~0,    // g (loop)
+                                            ~0,  0,  0, ~0, ~0,  0, ~0, ~0,
+                                            ~0,  0, ~0, ~0,  0,  0,  0, ~0,    // b (return)
+                                             0, ~0, ~0, ~0, ~0,  0, ~0, ~0,
+                                             0,  0, ~0,  0,  0,  0,  0, ~0,    // a (combined)
+                                             0,  0,  0, ~0, ~0,  0,  0, ~0};
     alignas(64) int32_t src[4 * SkRasterPipeline_kMaxStride_highp] = {};
-    static_assert(std::size(initial) == (4 * SkRasterPipeline_kMaxStride_highp));
+    static_assert(std::size(initial) >= (4 * SkRasterPipeline_kMaxStride_highp));
 
-    constexpr int32_t actualValues[] = { 2,  1,  2,  4,  5,  2,  2,  8};
-    static_assert(std::size(actualValues) == SkRasterPipeline_kMaxStride_highp);
+    constexpr int32_t actualValues[] = { 2,  1,  2,  4,  5,  2,  2,  8,
+                                         3,  2,  2,  7,  2,  6,  2,  9};
+    static_assert(std::size(actualValues) >= SkRasterPipeline_kMaxStride_highp);
 
     alignas(64) int32_t caseOpData[2 * SkRasterPipeline_kMaxStride_highp];
     for (size_t index = 0; index < SkOpts::raster_pipeline_highp_stride; ++index) {
@@ -382,12 +395,12 @@ DEF_TEST(SkRasterPipeline_CaseOp, reporter) {
 }
 
 DEF_TEST(SkRasterPipeline_MaskOffLoopMask, reporter) {
-    alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  // r (condition)
-                                      ~0,  0, ~0, ~0,  0,  0,  0, ~0,  // g (loop)
-                                      ~0, ~0,  0, ~0,  0,  0, ~0, ~0,  // b (return)
-                                      ~0,  0,  0, ~0,  0,  0,  0, ~0}; // a (combined)
+    alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0, ~0,  0, ~0, ~0, ~0, ~0,  0, ~0,  // r
+                                      ~0,  0, ~0, ~0,  0,  0,  0, ~0,  0, ~0, ~0,  0, ~0,  0, ~0, ~0,  // g
+                                      ~0, ~0,  0, ~0,  0,  0, ~0, ~0, ~0, ~0,  0,  0, ~0, ~0, ~0,  0,  // b
+                                      ~0,  0,  0, ~0,  0,  0,  0, ~0,  0,  0,  0,  0, ~0,  0,  0,  0}; // a
     alignas(64) int32_t src[4 * SkRasterPipeline_kMaxStride_highp] = {};
-    static_assert(std::size(initial) == (4 * SkRasterPipeline_kMaxStride_highp));
+    static_assert(std::size(initial) >= (4 * SkRasterPipeline_kMaxStride_highp));
 
     SkRasterPipeline_<256> p;
     p.append(SkRasterPipelineOp::load_src, initial);
@@ -411,12 +424,12 @@ DEF_TEST(SkRasterPipeline_MaskOffLoopMask, reporter) {
 }
 
 DEF_TEST(SkRasterPipeline_MaskOffReturnMask, reporter) {
-    alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,  // r (condition)
-                                      ~0,  0, ~0, ~0,  0,  0,  0, ~0,  // g (loop)
-                                      ~0, ~0,  0, ~0,  0,  0, ~0, ~0,  // b (return)
-                                      ~0,  0,  0, ~0,  0,  0,  0, ~0}; // a (combined)
+    alignas(64) int32_t initial[]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0, ~0,  0, ~0, ~0, ~0, ~0,  0, ~0,  // r
+                                      ~0,  0, ~0, ~0,  0,  0,  0, ~0,  0, ~0, ~0,  0, ~0,  0, ~0, ~0,  // g
+                                      ~0, ~0,  0, ~0,  0,  0, ~0, ~0, ~0, ~0,  0,  0, ~0, ~0, ~0,  0,  // b
+                                      ~0,  0,  0, ~0,  0,  0,  0, ~0,  0,  0,  0,  0, ~0,  0,  0,  0}; // a
     alignas(64) int32_t src[4 * SkRasterPipeline_kMaxStride_highp] = {};
-    static_assert(std::size(initial) == (4 * SkRasterPipeline_kMaxStride_highp));
+    static_assert(std::size(initial) >= (4 * SkRasterPipeline_kMaxStride_highp));
 
     SkRasterPipeline_<256> p;
     p.append(SkRasterPipelineOp::load_src, initial);
@@ -491,11 +504,15 @@ DEF_TEST(SkRasterPipeline_CopyFromIndirectUnmasked, r) {
     alignas(64) float dst[5 * SkRasterPipeline_kMaxStride_highp];
 
     // Test with various mixes of indirect offsets.
-    static_assert(SkRasterPipeline_kMaxStride_highp == 8);
-    alignas(64) const uint32_t kOffsets1[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-    alignas(64) const uint32_t kOffsets2[8] = {2, 2, 2, 2, 2, 2, 2, 2};
-    alignas(64) const uint32_t kOffsets3[8] = {0, 2, 0, 2, 0, 2, 0, 2};
-    alignas(64) const uint32_t kOffsets4[8] = {99, 99, 0, 0, 99, 99, 0, 0};
+    static_assert(SkRasterPipeline_kMaxStride_highp <= 16);
+    alignas(64) const uint32_t kOffsets1[16] = {0, 0, 0, 0, 0, 0, 0, 0,
+                                                0, 0, 0, 0, 0, 0, 0, 0};
+    alignas(64) const uint32_t kOffsets2[16] = {2, 2, 2, 2, 2, 2, 2, 2,
+                                                2, 2, 2, 2, 2, 2, 2, 2};
+    alignas(64) const uint32_t kOffsets3[16] = {0, 2, 0, 2, 0, 2, 0, 2,
+                                                0, 2, 0, 2, 0, 2, 0, 2};
+    alignas(64) const uint32_t kOffsets4[16] = {99, 99, 0, 0, 99, 99, 0, 0,
+                                                99, 99, 0, 0, 99, 99, 0, 0};
 
     const int N = SkOpts::raster_pipeline_highp_stride;
 
@@ -563,11 +580,15 @@ DEF_TEST(SkRasterPipeline_CopyFromIndirectUniformUnmasked, r) {
     alignas(64) float dst[5 * SkRasterPipeline_kMaxStride_highp];
 
     // Test with various mixes of indirect offsets.
-    static_assert(SkRasterPipeline_kMaxStride_highp == 8);
-    alignas(64) const uint32_t kOffsets1[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-    alignas(64) const uint32_t kOffsets2[8] = {2, 2, 2, 2, 2, 2, 2, 2};
-    alignas(64) const uint32_t kOffsets3[8] = {0, 2, 0, 2, 0, 2, 0, 2};
-    alignas(64) const uint32_t kOffsets4[8] = {99, ~99u, 0, 0, ~99u, 99, 0, 0};
+    static_assert(SkRasterPipeline_kMaxStride_highp <= 16);
+    alignas(64) const uint32_t kOffsets1[16] = {0, 0, 0, 0, 0, 0, 0, 0,
+                                                0, 0, 0, 0, 0, 0, 0, 0};
+    alignas(64) const uint32_t kOffsets2[16] = {2, 2, 2, 2, 2, 2, 2, 2,
+                                                2, 2, 2, 2, 2, 2, 2, 2};
+    alignas(64) const uint32_t kOffsets3[16] = {0, 2, 0, 2, 0, 2, 0, 2,
+                                                0, 2, 0, 2, 0, 2, 0, 2};
+    alignas(64) const uint32_t kOffsets4[16] = {99, ~99u, 0, 0, ~99u, 99, 0, 0,
+                                                99, ~99u, 0, 0, ~99u, 99, 0, 0};
 
     const int N = SkOpts::raster_pipeline_highp_stride;
 
@@ -634,17 +655,25 @@ DEF_TEST(SkRasterPipeline_CopyToIndirectMasked, r) {
     alignas(64) float dst[5 * SkRasterPipeline_kMaxStride_highp];
 
     // Test with various mixes of indirect offsets.
-    static_assert(SkRasterPipeline_kMaxStride_highp == 8);
-    alignas(64) const uint32_t kOffsets1[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-    alignas(64) const uint32_t kOffsets2[8] = {2, 2, 2, 2, 2, 2, 2, 2};
-    alignas(64) const uint32_t kOffsets3[8] = {0, 2, 0, 2, 0, 2, 0, 2};
-    alignas(64) const uint32_t kOffsets4[8] = {99, ~99u, 0, 0, ~99u, 99, 0, 0};
+    static_assert(SkRasterPipeline_kMaxStride_highp <= 16);
+    alignas(64) const uint32_t kOffsets1[16] = {0, 0, 0, 0, 0, 0, 0, 0,
+                                                0, 0, 0, 0, 0, 0, 0, 0};
+    alignas(64) const uint32_t kOffsets2[16] = {2, 2, 2, 2, 2, 2, 2, 2,
+                                                2, 2, 2, 2, 2, 2, 2, 2};
+    alignas(64) const uint32_t kOffsets3[16] = {0, 2, 0, 2, 0, 2, 0, 2,
+                                                0, 2, 0, 2, 0, 2, 0, 2};
+    alignas(64) const uint32_t kOffsets4[16] = {99, ~99u, 0, 0, ~99u, 99, 0, 0,
+                                                99, ~99u, 0, 0, ~99u, 99, 0, 0};
 
     // Test with various masks.
-    alignas(64) const int32_t kMask1[8]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0};
-    alignas(64) const int32_t kMask2[8]  = {~0,  0, ~0, ~0,  0,  0,  0, ~0};
-    alignas(64) const int32_t kMask3[8]  = {~0, ~0,  0, ~0,  0,  0, ~0, ~0};
-    alignas(64) const int32_t kMask4[8]  = { 0,  0,  0,  0,  0,  0,  0,  0};
+    alignas(64) const int32_t kMask1[16]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,
+                                             ~0, ~0, ~0, ~0, ~0,  0, ~0, ~0};
+    alignas(64) const int32_t kMask2[16]  = {~0,  0, ~0, ~0,  0,  0,  0, ~0,
+                                             ~0,  0, ~0, ~0,  0,  0,  0, ~0};
+    alignas(64) const int32_t kMask3[16]  = {~0, ~0,  0, ~0,  0,  0, ~0, ~0,
+                                             ~0, ~0,  0, ~0,  0,  0, ~0, ~0};
+    alignas(64) const int32_t kMask4[16]  = { 0,  0,  0,  0,  0,  0,  0,  0,
+                                              0,  0,  0,  0,  0,  0,  0,  0};
 
     const int N = SkOpts::raster_pipeline_highp_stride;
 
@@ -720,17 +749,25 @@ DEF_TEST(SkRasterPipeline_SwizzleCopyToIndirectMasked, r) {
     alignas(64) float dst[5 * SkRasterPipeline_kMaxStride_highp];
 
     // Test with various mixes of indirect offsets.
-    static_assert(SkRasterPipeline_kMaxStride_highp == 8);
-    alignas(64) const uint32_t kOffsets1[8] = {0, 0, 0, 0, 0, 0, 0, 0};
-    alignas(64) const uint32_t kOffsets2[8] = {2, 2, 2, 2, 2, 2, 2, 2};
-    alignas(64) const uint32_t kOffsets3[8] = {0, 2, 0, 2, 0, 2, 0, 2};
-    alignas(64) const uint32_t kOffsets4[8] = {99, ~99u, 0, 0, ~99u, 99, 0, 0};
+    static_assert(SkRasterPipeline_kMaxStride_highp <= 16);
+    alignas(64) const uint32_t kOffsets1[16] = {0, 0, 0, 0, 0, 0, 0, 0,
+                                                0, 0, 0, 0, 0, 0, 0, 0};
+    alignas(64) const uint32_t kOffsets2[16] = {2, 2, 2, 2, 2, 2, 2, 2,
+                                                2, 2, 2, 2, 2, 2, 2, 2};
+    alignas(64) const uint32_t kOffsets3[16] = {0, 2, 0, 2, 0, 2, 0, 2,
+                                                0, 2, 0, 2, 0, 2, 0, 2};
+    alignas(64) const uint32_t kOffsets4[16] = {99, ~99u, 0, 0, ~99u, 99, 0, 0,
+                                                99, ~99u, 0, 0, ~99u, 99, 0, 0};
 
     // Test with various masks.
-    alignas(64) const int32_t kMask1[8]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0};
-    alignas(64) const int32_t kMask2[8]  = {~0,  0, ~0, ~0,  0,  0,  0, ~0};
-    alignas(64) const int32_t kMask3[8]  = {~0, ~0,  0, ~0,  0,  0, ~0, ~0};
-    alignas(64) const int32_t kMask4[8]  = { 0,  0,  0,  0,  0,  0,  0,  0};
+    alignas(64) const int32_t kMask1[16]  = {~0, ~0, ~0, ~0, ~0,  0, ~0, ~0,
+                                             ~0, ~0, ~0, ~0, ~0,  0, ~0, ~0};
+    alignas(64) const int32_t kMask2[16]  = {~0,  0, ~0, ~0,  0,  0,  0, ~0,
+                                             ~0,  0, ~0, ~0,  0,  0,  0, ~0};
+    alignas(64) const int32_t kMask3[16]  = {~0, ~0,  0, ~0,  0,  0, ~0, ~0,
+                                             ~0, ~0,  0, ~0,  0,  0, ~0, ~0};
+    alignas(64) const int32_t kMask4[16]  = { 0,  0,  0,  0,  0,  0,  0,  0,
+                                              0,  0,  0,  0,  0,  0,  0,  0};
 
     // Test with various swizzle permutations.
     struct TestPattern {
@@ -873,16 +910,20 @@ DEF_TEST(SkRasterPipeline_TraceVar, r) {
         TArray<int> fBuffer;
     };
 
-    static_assert(SkRasterPipeline_kMaxStride_highp == 8);
-    alignas(64) static constexpr int32_t  kMaskOn   [8] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
-    alignas(64) static constexpr int32_t  kMaskOff  [8] = { 0,  0,  0,  0,  0,  0,  0,  0};
-    alignas(64) static constexpr uint32_t kIndirect0[8] = { 0,  0,  0,  0,  0,  0,  0,  0};
-    alignas(64) static constexpr uint32_t kIndirect1[8] = { 1,  1,  1,  1,  1,  1,  1,  1};
-    alignas(64) int32_t kData333[8];
-    alignas(64) int32_t kData555[8];
-    alignas(64) int32_t kData666[8];
-    alignas(64) int32_t kData777[16];
-    alignas(64) int32_t kData999[16];
+    static_assert(SkRasterPipeline_kMaxStride_highp <= 16);
+    alignas(64) static constexpr int32_t  kMaskOn   [16] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+                                                            ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
+    alignas(64) static constexpr int32_t  kMaskOff  [16] = { 0,  0,  0,  0,  0,  0,  0,  0,
+                                                             0,  0,  0,  0,  0,  0,  0,  0};
+    alignas(64) static constexpr uint32_t kIndirect0[16] = { 0,  0,  0,  0,  0,  0,  0,  0,
+                                                             0,  0,  0,  0,  0,  0,  0,  0};
+    alignas(64) static constexpr uint32_t kIndirect1[16] = { 1,  1,  1,  1,  1,  1,  1,  1,
+                                                             1,  1,  1,  1,  1,  1,  1,  1};
+    alignas(64) int32_t kData333[16];
+    alignas(64) int32_t kData555[16];
+    alignas(64) int32_t kData666[16];
+    alignas(64) int32_t kData777[32];
+    alignas(64) int32_t kData999[32];
     std::fill(kData333,     kData333 + N,   333);
     std::fill(kData555,     kData555 + N,   555);
     std::fill(kData666,     kData666 + N,   666);
@@ -957,9 +998,11 @@ DEF_TEST(SkRasterPipeline_TraceLine, r) {
         TArray<int> fBuffer;
     };
 
-    static_assert(SkRasterPipeline_kMaxStride_highp == 8);
-    alignas(64) static constexpr int32_t kMaskOn [8] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
-    alignas(64) static constexpr int32_t kMaskOff[8] = { 0,  0,  0,  0,  0,  0,  0,  0};
+    static_assert(SkRasterPipeline_kMaxStride_highp <= 16);
+    alignas(64) static constexpr int32_t kMaskOn [16] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+                                                         ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
+    alignas(64) static constexpr int32_t kMaskOff[16] = { 0,  0,  0,  0,  0,  0,  0,  0,
+                                                          0,  0,  0,  0,  0,  0,  0,  0};
 
     TestTraceHook trace;
     SkArenaAlloc alloc(/*firstHeapAllocation=*/256);
@@ -1006,9 +1049,11 @@ DEF_TEST(SkRasterPipeline_TraceEnterExit, r) {
         TArray<int> fBuffer;
     };
 
-    static_assert(SkRasterPipeline_kMaxStride_highp == 8);
-    alignas(64) static constexpr int32_t kMaskOn [8] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
-    alignas(64) static constexpr int32_t kMaskOff[8] = { 0,  0,  0,  0,  0,  0,  0,  0};
+    static_assert(SkRasterPipeline_kMaxStride_highp <= 16);
+    alignas(64) static constexpr int32_t kMaskOn [16] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+                                                         ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
+    alignas(64) static constexpr int32_t kMaskOff[16] = { 0,  0,  0,  0,  0,  0,  0,  0,
+                                                          0,  0,  0,  0,  0,  0,  0,  0};
 
     TestTraceHook trace;
     SkArenaAlloc alloc(/*firstHeapAllocation=*/256);
@@ -1049,9 +1094,11 @@ DEF_TEST(SkRasterPipeline_TraceScope, r) {
         TArray<int> fBuffer;
     };
 
-    static_assert(SkRasterPipeline_kMaxStride_highp == 8);
-    alignas(64) static constexpr int32_t kMaskOn [8] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
-    alignas(64) static constexpr int32_t kMaskOff[8] = { 0,  0,  0,  0,  0,  0,  0,  0};
+    static_assert(SkRasterPipeline_kMaxStride_highp <= 16);
+    alignas(64) static constexpr int32_t kMaskOn [16] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+                                                         ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
+    alignas(64) static constexpr int32_t kMaskOff[16] = { 0,  0,  0,  0,  0,  0,  0,  0,
+                                                          0,  0,  0,  0,  0,  0,  0,  0};
 
     TestTraceHook trace;
     SkArenaAlloc alloc(/*firstHeapAllocation=*/256);
@@ -1093,11 +1140,15 @@ DEF_TEST(SkRasterPipeline_CopySlotsMasked, r) {
         {SkRasterPipelineOp::copy_4_slots_masked, 4},
     };
 
-    static_assert(SkRasterPipeline_kMaxStride_highp == 8);
-    alignas(64) const int32_t kMask1[8] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
-    alignas(64) const int32_t kMask2[8] = { 0,  0,  0,  0,  0,  0,  0,  0};
-    alignas(64) const int32_t kMask3[8] = {~0,  0, ~0, ~0, ~0, ~0,  0, ~0};
-    alignas(64) const int32_t kMask4[8] = { 0, ~0,  0,  0,  0, ~0, ~0,  0};
+    static_assert(SkRasterPipeline_kMaxStride_highp <= 16);
+    alignas(64) const int32_t kMask1[16] = {~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0,
+                                            ~0, ~0, ~0, ~0, ~0, ~0, ~0, ~0};
+    alignas(64) const int32_t kMask2[16] = { 0,  0,  0,  0,  0,  0,  0,  0,
+                                             0,  0,  0,  0,  0,  0,  0,  0};
+    alignas(64) const int32_t kMask3[16] = {~0,  0, ~0, ~0, ~0, ~0,  0, ~0,
+                                            ~0,  0, ~0, ~0, ~0, ~0,  0, ~0};
+    alignas(64) const int32_t kMask4[16] = { 0, ~0,  0,  0,  0, ~0, ~0,  0,
+                                             0, ~0,  0,  0,  0, ~0, ~0,  0};
 
     const int N = SkOpts::raster_pipeline_highp_stride;
 
@@ -3382,3 +3433,272 @@ DEF_TEST(SkRasterPipeline_stack_rewind, r) {
         stack.validate(r);
     }
 }
+
+DEF_TEST(SkRasterPipeline_fusion, r) {
+    // Fused stages must produce exactly what the stages they replace would have. We compare
+    // against the same pipelines with a pair of swap_rb (an exact no-op) breaking up each run.
+    uint32_t src[64], img[16 * 16];
+    for (int i = 0; i < 64; i++) {
+        // Premul, with alpha running through [0,255].
+        uint32_t a = (i * 4 + 3) & 0xff;
+        src[i] = (a << 24) | ((a/2) << 16) | ((a/3) << 8) | (a/5);
+    }
+    for (int i = 0; i < 16 * 16; i++) {
+        img[i] = 0xff000000 | (uint32_t)(i * 0x010203);
+    }
+    SkRasterPipeline_GatherCtx gather;
+    gather.pixels = img;
+    gather.stride = 16;
+    gather.width  = 16;
+    gather.height = 16;
+    const float translate[]      = {-3.25f, 1.5f},
+                scaleTranslate[] = {0.25f, 0.5f, 1.75f, -0.5f};
+    float scratch[4 * 64];
+
+    enum class Case { kSrcOver, kTranslate, kScaleTranslate };
+    auto draw = [&](Case c, bool highp, bool fuse, uint32_t dst[64]) {
+        for (int i = 0; i < 64; i++) {
+            dst[i] = 0x80402010 + i;
+        }
+        SkRasterPipeline_MemoryCtx srcCtx     = {src, 0},
+                                   dstCtx     = {dst, 0},
+                                   scratchCtx = {scratch, 0};
+        auto maybe_break_run = [&](SkRasterPipeline* p) {
+            if (!fuse) {
+                p->append(SkRasterPipelineOp::swap_rb);
+                p->append(SkRasterPipelineOp::swap_rb);
+            }
+        };
+
+        SkRasterPipeline_<256> p;
+        switch (c) {
+            case Case::kSrcOver:
+                p.append(SkRasterPipelineOp::load_8888, &srcCtx);
+                p.append(SkRasterPipelineOp::load_8888_dst, &dstCtx);
+                p.append(SkRasterPipelineOp::srcover);
+                maybe_break_run(&p);
+                p.append(SkRasterPipelineOp::store_8888, &dstCtx);
+                break;
+            case Case::kTranslate:
+            case Case::kScaleTranslate:
+                p.append(SkRasterPipelineOp::seed_shader);
+                maybe_break_run(&p);
+                if (c == Case::kTranslate) {
+                    p.append(SkRasterPipelineOp::matrix_translate, translate);
+                } else {
+                    p.append(SkRasterPipelineOp::matrix_scale_translate, scaleTranslate);
+                }
+                p.append(SkRasterPipelineOp::gather_8888, &gather);
+                p.append(SkRasterPipelineOp::store_8888, &dstCtx);
+                break;
+        }
+        if (highp) {
+            // store_f32 only exists in highp, so this forces the whole pipeline there.
+            p.append(SkRasterPipelineOp::store_f32, &scratchCtx);
+        }
+        // Use a width that leaves a tail at every stride.
+        p.run(0,0,61,1);
+    };
+
+    for (Case c : {Case::kSrcOver, Case::kTranslate, Case::kScaleTranslate}) {
+        for (bool highp : {false, true}) {
+            uint32_t fused[64], unfused[64];
+            draw(c, highp, /*fuse=*/true,  fused);
+            draw(c, highp, /*fuse=*/false, unfused);
+            for (int i = 0; i < 64; i++) {
+                if (fused[i] != unfused[i]) {
+                    ERRORF(r, "case %d, highp %d, pixel %d: fused %08x, unfused %08x",
+                           (int)c, highp, i, fused[i], unfused[i]);
+                }
+            }
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_fusionAcrossBranch, r) {
+    // Branch offsets count stages, so a run that a branch jumps over must not be fused.
+    alignas(64) float slots[4 * SkRasterPipeline_kMaxStride_highp] = {};
+    const int N = SkOpts::raster_pipeline_highp_stride;
+
+    alignas(64) static constexpr float kColorDarkRed[4] = {0.5f, 0.0f, 0.0f, 0.75f};
+    alignas(64) static constexpr float kColorGreen[4]   = {0.0f, 1.0f, 0.0f, 1.0f};
+    const float translate[] = {1.0f, 2.0f};
+    const int offset = 4;
+
+    SkArenaAlloc alloc(/*firstHeapAllocation=*/256);
+    SkRasterPipeline p(&alloc);
+    p.append_constant_color(&alloc, kColorGreen);                 // assign green
+    p.append(SkRasterPipelineOp::jump, &offset);                  // jump to store_src
+    p.append(SkRasterPipelineOp::seed_shader);                    // (not executed)
+    p.append(SkRasterPipelineOp::matrix_translate, translate);    // (not executed)
+    p.append_constant_color(&alloc, kColorDarkRed);               // (not executed)
+    p.append(SkRasterPipelineOp::store_src, slots);
+    p.run(0,0,1,1);
+
+    float* destPtr = &slots[0];
+    for (int checkSlot = 0; checkSlot < 4; ++checkSlot) {
+        for (int checkLane = 0; checkLane < N; ++checkLane) {
+            REPORTER_ASSERT(r, *destPtr == kColorGreen[checkSlot]);
+            ++destPtr;
+        }
+    }
+}
+
+DEF_TEST(SkRasterPipeline_stageHistogram, r) {
+    uint32_t rgba[4] = {};
+    SkRasterPipeline_MemoryCtx ptr = {rgba, 0};
+
+    SkRasterPipeline::SetStageHistogramEnabled(true);
+    SkRasterPipeline_<256> p;
+    p.append(SkRasterPipelineOp::load_8888, &ptr);
+    p.append(SkRasterPipelineOp::swap_rb);
+    p.append(SkRasterPipelineOp::force_opaque);
+    p.append(SkRasterPipelineOp::store_8888, &ptr);
+    p.run(0,0,4,1);
+    auto compiled = p.compile();
+    compiled(0,0,4,1);
+    SkRasterPipeline::SetStageHistogramEnabled(false);
+
+    SkDynamicMemoryWStream stream;
+    SkRasterPipeline::DumpStageHistogram(&stream);
+    sk_sp<SkData> dump = stream.detachAsData();
+    std::string text((const char*)dump->data(), dump->size());
+
+    // Other tests may be running pipelines too, so we can only look for our own runs of stages.
+    for (const char* run : {"\tload_8888\tswap_rb\n",
+                            "\tswap_rb\tforce_opaque\tstore_8888\n"}) {
+        REPORTER_ASSERT(r, text.find(run) != std::string::npos, "missing %s", run);
+    }
+}
+
+DEF_TEST(SkRasterPipeline_stageProfile, r) {
+    // Enough pixels for a few full strides and a tail, in lowp and highp alike.
+    constexpr int kWidth = 61;
+    uint32_t src[kWidth], expected[kWidth], actual[kWidth];
+    for (int i = 0; i < kWidth; i++) {
+        src[i] = 0x01020304 * i;
+    }
+    float scratch[4 * kWidth];
+    SkRasterPipeline_MemoryCtx srcCtx      = {src, 0},
+                               expectedCtx = {expected, 0},
+                               actualCtx   = {actual, 0},
+                               scratchCtx  = {scratch, 0};
+
+    auto draw = [&](SkRasterPipeline_MemoryCtx* dst, bool highp, bool compiled, bool profiled) {
+        SkRasterPipeline_<256> p;
+        if (profiled) {
+            // Only this pipeline is profiled, so other tests' pipelines are left alone.
+            p.enableStageProfiling();
+        }
+        p.append(SkRasterPipelineOp::load_8888, &srcCtx);
+        p.append(SkRasterPipelineOp::swap_rb);
+        if (highp) {
+            // store_f32 only exists in highp.
+            p.append(SkRasterPipelineOp::store_f32, &scratchCtx);
+        }
+        p.append(SkRasterPipelineOp::store_8888, dst);
+        if (compiled) {
+            p.compile()(0,0,kWidth,1);
+        } else {
+            p.run(0,0,kWidth,1);
+        }
+    };
+
+    for (bool highp : {false, true}) {
+        draw(&expectedCtx, highp, /*compiled=*/false, /*profiled=*/false);
+
+        // Profiling must not change what the pipeline draws.
+        for (bool compiled : {false, true}) {
+            memset(actual, 0, sizeof(actual));
+            draw(&actualCtx, highp, compiled, /*profiled=*/true);
+            REPORTER_ASSERT(r, 0 == memcmp(expected, actual, sizeof(actual)),
+                            "highp %d, compiled %d", highp, compiled);
+        }
+    }
+
+    // Other tests may be running pipelines too, so we can only check that our own runs counted.
+    bool sawSwap = false,
+         sawStore = false;
+    for (const SkRasterPipeline::StageProfile& stage : SkRasterPipeline::GetStageProfile()) {
+        REPORTER_ASSERT(r, stage.calls > 0);
+        REPORTER_ASSERT(r, stage.pixels >= stage.calls);
+        if (stage.op == SkRasterPipelineOp::swap_rb) {
+            sawSwap = true;
+            REPORTER_ASSERT(r, stage.pixels >= 4 * kWidth);
+            REPORTER_ASSERT(r, stage.calls  >= 4);
+        }
+        if (stage.op == SkRasterPipelineOp::store_f32) {
+            sawStore = true;
+            REPORTER_ASSERT(r, stage.pixels >= 2 * kWidth);
+        }
+    }
+    REPORTER_ASSERT(r, sawSwap);
+    REPORTER_ASSERT(r, sawStore);
+}
+
+DEF_TEST(SkRasterPipeline_stageProfileBranches, r) {
+    // SkSL control flow compiles to branch stages, which jump a count of stages. Profiling puts
+    // a mark after every stage, so it must not send those branches to the wrong stage.
+    auto [effect, error] = SkRuntimeEffect::MakeForShader(SkString(R"(
+        half4 main(float2 p) {
+            int n = int(mod(p.x, 7));
+            half4 color = half4(0, 0, 0, 1);
+            for (int i = 0; i < 8; i++) {
+                if (i >= n) {
+                    break;
+                }
+                color.r += 0.125;
+            }
+            if (p.y < 4) {
+                color.g = 1;
+            } else {
+                color.b = half(n) / 8;
+            }
+            return color;
+        }
+    )"));
+    REPORTER_ASSERT(r, effect, "%s", error.c_str());
+    if (!effect) {
+        return;
+    }
+
+    auto draw = [&] {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(37, 9);
+        SkCanvas canvas(bitmap);
+        SkPaint paint;
+        // A new shader for each draw, so none can reuse a blitter built without profiling.
+        paint.setShader(effect->makeShader(/*uniforms=*/nullptr, /*children=*/{}));
+        canvas.drawPaint(paint);
+        return bitmap;
+    };
+
+    SkBitmap expected = draw();
+    SkRasterPipeline::SetStageProfilingEnabled(true);
+    SkBitmap actual = draw();
+    SkRasterPipeline::SetStageProfilingEnabled(false);
+
+    for (int y = 0; y < expected.height(); y++) {
+        for (int x = 0; x < expected.width(); x++) {
+            REPORTER_ASSERT(r, expected.getColor(x, y) == actual.getColor(x, y),
+                            "(%d, %d): %08x vs %08x",
+                            x, y, expected.getColor(x, y), actual.getColor(x, y));
+        }
+    }
+
+    bool sawBranch = false;
+    for (const SkRasterPipeline::StageProfile& stage : SkRasterPipeline::GetStageProfile()) {
+        switch (stage.op) {
+            case SkRasterPipelineOp::jump:
+            case SkRasterPipelineOp::branch_if_all_lanes_active:
+            case SkRasterPipelineOp::branch_if_any_lanes_active:
+            case SkRasterPipelineOp::branch_if_no_lanes_active:
+            case SkRasterPipelineOp::branch_if_no_active_lanes_eq:
+                sawBranch = true;
+                break;
+            default:
+                break;
+        }
+    }
+    REPORTER_ASSERT(r, sawBranch);
+}
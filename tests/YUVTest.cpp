@@ -7,24 +7,43 @@
 
 #include "include/codec/SkCodec.h"
 #include "include/codec/SkEncodedOrigin.h"
+#include "include/core/SkBitmap.h"
+#include "include/core/SkCanvas.h"
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
+#include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
+#include "include/core/SkMatrix.h"
+#include "include/core/SkPaint.h"
 #include "include/core/SkPixmap.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSamplingOptions.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkShader.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
+#include "include/core/SkTileMode.h"
 #include "include/core/SkTypes.h"
 #include "include/core/SkYUVAInfo.h"
 #include "include/core/SkYUVAPixmaps.h"
 #include "include/effects/SkColorMatrix.h"
 #include "include/encode/SkJpegEncoder.h"
 #include "include/private/base/SkTo.h"
+#include "src/core/SkBitmapCache.h"
+#include "src/core/SkCachedData.h"
+#include "src/core/SkResourceCache.h"
+#include "src/core/SkYUVPlanesCache.h"
+#include "src/image/SkImage_Base.h"
+#include "src/image/SkImage_Lazy.h"
 #include "tests/Test.h"
 #include "tools/Resources.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <iterator>
 #include <memory>
 #include <utility>
 
@@ -207,6 +226,146 @@ DEF_TEST(Jpeg_YUV_Encode, r) {
     }
 }
 
+// Returns the largest difference in any channel of any pixel of a and b.
+static int max_channel_diff(const SkPixmap& a, const SkPixmap& b) {
+    int maxDiff = 0;
+    for (int y = 0; y < a.height(); ++y) {
+        for (int x = 0; x < a.width(); ++x) {
+            const uint8_t* pa = static_cast<const uint8_t*>(a.addr(x, y));
+            const uint8_t* pb = static_cast<const uint8_t*>(b.addr(x, y));
+            for (int c = 0; c < 4; ++c) {
+                maxDiff = std::max(maxDiff, std::abs(pa[c] - pb[c]));
+            }
+        }
+    }
+    return maxDiff;
+}
+
+// Images from DeferredYUVAFromEncodedData() draw on the raster backend from their YUVA planes,
+// which are cached in place of RGBA pixels, and look like the codec's own RGBA decode.
+DEF_TEST(Jpeg_YUV_RasterDraw, r) {
+    // The images are cached here, so other tests can't purge them from under the checks below.
+    SkResourceCache cache(64 * 1024 * 1024);
+    auto make = [&](sk_sp<SkImage> image) {
+        if (image) {
+            static_cast<SkImage_Lazy*>(as_IB(image.get()))->setLocalCacheForTesting(&cache);
+        }
+        return image;
+    };
+
+    struct {
+        const char* path;
+        // Whether repeat tiling samples the planes rather than RGBA pixels.
+        bool        tilesPlanes;
+    } cases[] = {
+            {"images/color_wheel.jpg", false},
+            {"images/mandrill_h1v1.jpg", true},   // 4:4:4
+            {"images/mandrill_h2v1.jpg", false},
+            {"images/mandrill_512_q075.jpg", false},
+            // 4:2:0 at 439x154, so the chroma planes have an extra column past the image's edge.
+            {"images/cropped_mandrill.jpg", false},
+    };
+    for (const auto& [path, tilesPlanes] : cases) {
+        sk_sp<SkData> data = GetResourceAsData(path);
+        if (!data) {
+            continue;
+        }
+        sk_sp<SkImage> yuvaImage = make(SkImages::DeferredYUVAFromEncodedData(data));
+        sk_sp<SkImage> rgbaImage = make(SkImages::DeferredFromEncodedData(data));
+        REPORTER_ASSERT(r, yuvaImage && rgbaImage, "%s", path);
+        if (!yuvaImage || !rgbaImage) {
+            continue;
+        }
+
+        // Unpremul pixels keep both images on raster pipeline blitters. The legacy blitters,
+        // which the RGBA image could otherwise use, filter a little differently.
+        const SkImageInfo info = SkImageInfo::MakeN32(yuvaImage->width(), yuvaImage->height(),
+                                                      kUnpremul_SkAlphaType);
+        auto draw = [&](const SkImage* image, const SkSamplingOptions& sampling,
+                        SkCanvas::SrcRectConstraint constraint) {
+            SkBitmap bm;
+            bm.allocPixels(info);
+            SkCanvas canvas(bm);
+            canvas.clear(SK_ColorTRANSPARENT);
+            canvas.drawImage(image, 0, 0, sampling);
+            // A copy of the middle of the image in the top left quarter. It is offset by whole
+            // pixels, where chroma sampled from the planes lines up with the codec's upsampling.
+            const int w = image->width() / 2, h = image->height() / 2;
+            const SkRect src = SkRect::MakeXYWH(w / 2, h / 2, w, h);
+            const SkRect dst = SkRect::MakeWH(w, h);
+            canvas.drawImageRect(image, src, dst, sampling, nullptr, constraint);
+            return bm;
+        };
+
+        const SkSamplingOptions samplings[] = {
+                SkSamplingOptions(),
+                SkSamplingOptions(SkFilterMode::kLinear),
+                SkSamplingOptions(SkCubicResampler::Mitchell()),
+        };
+        for (int i = 0; i < (int)std::size(samplings); ++i) {
+            const SkSamplingOptions& sampling = samplings[i];
+            SkBitmap expected = draw(rgbaImage.get(), sampling, SkCanvas::kFast_SrcRectConstraint);
+            SkBitmap actual = draw(yuvaImage.get(), sampling, SkCanvas::kFast_SrcRectConstraint);
+            // libjpeg converts in fixed point. Bicubic overshoot is clamped after the conversion
+            // to RGB rather than before, so sharp edges differ more.
+            const int kTolerance = sampling.useCubic ? 16 : 2;
+            const int diff = max_channel_diff(expected.pixmap(), actual.pixmap());
+            REPORTER_ASSERT(r, diff <= kTolerance, "%s, sampling %d: off by %d", path, i, diff);
+        }
+
+        // The planes are cached for the image, and the RGBA pixels are not.
+        SkYUVAPixmaps planes;
+        sk_sp<SkCachedData> cached(
+                SkYUVPlanesCache::FindAndRef(yuvaImage->uniqueID(), &planes, &cache));
+        REPORTER_ASSERT(r, cached, "%s", path);
+        auto rgbaCached = [&] {
+            SkBitmap bm;
+            return SkBitmapCache::Find(SkBitmapCacheDesc::Make(yuvaImage.get()), &bm, &cache);
+        };
+        REPORTER_ASSERT(r, !rgbaCached(), "%s", path);
+
+        // Repeat tiling matches the RGBA pixels too. Images with subsampled chroma are tiled from
+        // RGBA pixels.
+        auto drawRepeated = [&](const SkImage* image) {
+            SkBitmap bm;
+            bm.allocPixels(info.makeWH(image->width() * 2, image->height() * 2));
+            SkCanvas canvas(bm);
+            SkPaint paint;
+            paint.setShader(image->makeShader(SkTileMode::kRepeat, SkTileMode::kRepeat,
+                                              SkSamplingOptions(SkFilterMode::kLinear),
+                                              SkMatrix::Translate(image->width() * 0.5f,
+                                                                  image->height() * 0.5f)));
+            canvas.drawPaint(paint);
+            return bm;
+        };
+        {
+            SkBitmap expected = drawRepeated(rgbaImage.get());
+            SkBitmap actual = drawRepeated(yuvaImage.get());
+            const int diff = max_channel_diff(expected.pixmap(), actual.pixmap());
+            REPORTER_ASSERT(r, diff <= 2, "%s, repeated: off by %d", path, diff);
+        }
+        REPORTER_ASSERT(r, rgbaCached() == !tilesPlanes, "%s", path);
+
+        // A filtered draw within a strict src rect needs RGBA pixels.
+        draw(yuvaImage.get(), SkSamplingOptions(SkFilterMode::kLinear),
+             SkCanvas::kStrict_SrcRectConstraint);
+        REPORTER_ASSERT(r, rgbaCached(), "%s", path);
+    }
+
+    // Images the codec can't decode to planes draw from RGBA pixels as usual.
+    sk_sp<SkData> png = GetResourceAsData("images/mandrill_64.png");
+    if (png) {
+        sk_sp<SkImage> images[] = {make(SkImages::DeferredYUVAFromEncodedData(png)),
+                                   make(SkImages::DeferredFromEncodedData(png))};
+        SkBitmap bms[2];
+        for (int i = 0; i < 2; ++i) {
+            bms[i].allocN32Pixels(images[i]->width(), images[i]->height());
+            SkCanvas(bms[i]).drawImage(images[i], 0, 0);
+        }
+        REPORTER_ASSERT(r, max_channel_diff(bms[0].pixmap(), bms[1].pixmap()) == 0);
+    }
+}
+
 // Be sure that the two matrices are inverses of each other
 // (i.e. rgb2yuv and yuv2rgb
 DEF_TEST(YUVMath, reporter) {
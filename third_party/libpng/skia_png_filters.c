@@ -0,0 +1,77 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Built as part of libpng, with PNG_FILTER_OPTIMIZATIONS=skia_png_init_filter_functions, so that
+// png_init_filter_functions() calls it after installing libpng's own unfilter functions.
+
+#include "pngpriv.h"
+#include "skia_png_filters.h"
+
+// Threads may start reading PNGs, and so load gUnfilterRow, while another thread sets it.
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+
+    static void* volatile gUnfilterRow = NULL;
+
+    static skia_png_unfilter_row_proc load_unfilter_row(void) {
+        return (skia_png_unfilter_row_proc)_InterlockedCompareExchangePointer(&gUnfilterRow,
+                                                                               NULL, NULL);
+    }
+    static void store_unfilter_row(skia_png_unfilter_row_proc proc) {
+        _InterlockedExchangePointer(&gUnfilterRow, (void*)proc);
+    }
+#else
+    static skia_png_unfilter_row_proc gUnfilterRow = NULL;
+
+    static skia_png_unfilter_row_proc load_unfilter_row(void) {
+        return __atomic_load_n(&gUnfilterRow, __ATOMIC_ACQUIRE);
+    }
+    static void store_unfilter_row(skia_png_unfilter_row_proc proc) {
+        __atomic_store_n(&gUnfilterRow, proc, __ATOMIC_RELEASE);
+    }
+#endif
+
+void skia_png_set_unfilter_row(skia_png_unfilter_row_proc proc) {
+    if (proc != NULL) {
+        store_unfilter_row(proc);
+    }
+}
+
+// Only installed once gUnfilterRow is set, and it is never unset.
+static void unfilter_row(int filter, png_row_infop row_info, png_bytep row,
+                         png_const_bytep prev_row) {
+    load_unfilter_row()(filter, row, prev_row, row_info->rowbytes,
+                        (row_info->pixel_depth + 7) >> 3);
+}
+
+static void unfilter_row_sub(png_row_infop row_info, png_bytep row, png_const_bytep prev_row) {
+    unfilter_row(PNG_FILTER_VALUE_SUB, row_info, row, prev_row);
+}
+
+static void unfilter_row_up(png_row_infop row_info, png_bytep row, png_const_bytep prev_row) {
+    unfilter_row(PNG_FILTER_VALUE_UP, row_info, row, prev_row);
+}
+
+static void unfilter_row_avg(png_row_infop row_info, png_bytep row, png_const_bytep prev_row) {
+    unfilter_row(PNG_FILTER_VALUE_AVG, row_info, row, prev_row);
+}
+
+static void unfilter_row_paeth(png_row_infop row_info, png_bytep row, png_const_bytep prev_row) {
+    unfilter_row(PNG_FILTER_VALUE_PAETH, row_info, row, prev_row);
+}
+
+void skia_png_init_filter_functions(png_structp pp, unsigned int bpp) {
+    (void)bpp;
+    if (load_unfilter_row() == NULL) {
+        // Keep libpng's own unfilter functions.
+        return;
+    }
+    pp->read_filter[PNG_FILTER_VALUE_SUB - 1]   = unfilter_row_sub;
+    pp->read_filter[PNG_FILTER_VALUE_UP - 1]    = unfilter_row_up;
+    pp->read_filter[PNG_FILTER_VALUE_AVG - 1]   = unfilter_row_avg;
+    pp->read_filter[PNG_FILTER_VALUE_PAETH - 1] = unfilter_row_paeth;
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright 2026 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef skia_png_filters_DEFINED
+#define skia_png_filters_DEFINED
+
+// Lets Skia unfilter the rows that libpng reads with its own SIMD code. libpng has no public API
+// for this, so skia_png_filters.c plugs into the PNG_FILTER_OPTIMIZATIONS hook that libpng uses
+// for its own SSE2 and NEON code, in place of the SSE2 code. The GN and Bazel builds of libpng do
+// this for x86, and define SK_LIBPNG_HAS_SKIA_FILTERS when they do.
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Unfilters the rowBytes bytes of row in place. filter is the PNG filter type, from 1 (Sub) to 4
+// (Paeth), prev is the unfiltered row above, or zeros for the first row, and bpp is the number of
+// bytes per pixel, rounded up to at least 1.
+typedef void (*skia_png_unfilter_row_proc)(int filter, unsigned char* row,
+                                           const unsigned char* prev, size_t rowBytes,
+                                           size_t bpp);
+
+// Images that libpng starts reading after this unfilter their rows with proc. Until then, libpng
+// uses its own portable code. This is safe to call while other threads read PNGs. A null proc is
+// ignored, and a later proc may replace an earlier one even for images already being read, so
+// every proc must unfilter exactly as the PNG spec says.
+void skia_png_set_unfilter_row(skia_png_unfilter_row_proc proc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // skia_png_filters_DEFINED
@@ -46,7 +46,8 @@ bool CollectImages(CommandLineFlags::StringArray dir, skia_private::TArray<SkStr
 void SetCtxOptions(struct GrContextOptions*);
 
 /**
- *  Enable, disable, or force analytic anti-aliasing using --analyticAA and --forceAnalyticAA.
+ *  Enable, disable, or force analytic anti-aliasing using --analyticAA and --forceAnalyticAA,
+ *  or switch to sparse strip anti-aliasing with --sparseStripAA.
  */
 void SetAnalyticAA();
 
@@ -71,6 +71,14 @@ private:
     void triggerTraceEvent(const uint8_t* categoryEnabledFlag, const char* eventName,
                            const char* arg1Name, const uint8_t& arg1Type, const uint64_t& arg1Val,
                            const char* arg2Name, const uint8_t& arg2Type, const uint64_t& arg2Val);
+
+    /** A Perfetto counter track holds a single value, so like TRACE_COUNTER2 when Perfetto backs
+     * the Android framework's tracing, this gives each argument of a counter event its own track,
+     * named "<counterName>-<argName>".
+     */
+    void triggerCounterEvents(const uint8_t* categoryEnabledFlag, const char* counterName,
+                              int numArgs, const char** argNames, const uint8_t* argTypes,
+                              const uint64_t* argValues);
 };
 
 #endif